@@ -549,13 +549,40 @@ void ParseCommandLine(int argc, const char* argv[],
         })
         .Help(samplingFrequencyHelp);
 
+    const auto growPolicyHelp = TString::Join(
+        "Controls how trees are grown. Possible values are ",
+        GetEnumAllNames<EGrowingPolicy>(),
+        ". SymmetricTree is used by default");
+    parser.AddLongOption("grow-policy")
+        .RequiredArgument("string")
+        .Handler1T<EGrowingPolicy>([plainJsonPtr](const EGrowingPolicy policy) {
+            (*plainJsonPtr)["grow_policy"] = ToString(policy);
+        })
+        .Help(growPolicyHelp);
+
+    parser.AddLongOption("max-leaves")
+        .RequiredArgument("int")
+        .Handler1T<ui32>([plainJsonPtr](ui32 maxLeaves) {
+            (*plainJsonPtr)["max_leaves"] = maxLeaves;
+        })
+        .Help("Maximum number of leaves in a tree, used only with Depthwise grow policy. 31 by default");
+
     parser
         .AddLongOption("subsample")
         .RequiredArgument("Float")
         .Handler1T<float>([plainJsonPtr](float rate) {
             (*plainJsonPtr)["subsample"] = rate;
         })
-        .Help("Controls sample rate for bagging. Could be used iff bootstrap-type is Poisson, Bernoulli. Possible values are from (0, 1]; 0.66 by default."
+        .Help("Controls sample rate for bagging. Could be used iff bootstrap-type is Poisson, Bernoulli, MVS or GOSS. Possible values are from (0, 1]; 0.66 by default."
+        );
+
+    parser
+        .AddLongOption("goss-top-fraction")
+        .RequiredArgument("Float")
+        .Handler1T<float>([plainJsonPtr](float fraction) {
+            (*plainJsonPtr)["goss_top_fraction"] = fraction;
+        })
+        .Help("Fraction of objects with largest gradients that are always taken by GOSS bootstrap, the rest of subsample is taken uniformly from other objects. Should be less than subsample; 0.2 by default."
         );
 
     parser
@@ -637,6 +664,20 @@ void ParseCommandLine(int argc, const char* argv[],
             (*plainJsonPtr).InsertValue("store_all_simple_ctr", true);
         });
 
+    parser.AddLongOption("streaming-online-ctrs",
+                         "Do not keep online ctr values of all candidate feature combinations in memory, calculate them one ctr at a time during score calculation. Only recently used combinations are cached, see --online-ctr-cache-size. CPU only")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr).InsertValue("streaming_online_ctrs", true);
+        });
+
+    parser.AddLongOption("online-ctr-cache-size",
+                         "Memory for online ctr values of recently used feature combinations with --streaming-online-ctrs, shared by all permutations; 4gb by default. CPU only")
+        .RequiredArgument("SIZE")
+        .Handler1T<TString>([plainJsonPtr](const TString& cacheSize) {
+            (*plainJsonPtr).InsertValue("online_ctr_cache_size", cacheSize);
+        });
+
     parser.AddLongOption("one-hot-max-size")
         .RequiredArgument("size_t")
         .Handler1T<size_t>([plainJsonPtr](const size_t oneHotMaxSize) {
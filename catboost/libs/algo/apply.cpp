@@ -38,7 +38,6 @@ TVector<TVector<double>> ApplyModelMulti(
     TVector<double> approxesFlat;
     approxesFlat.yresize(docCount * approxesDimension);
     if (docCount > 0) {
-        const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(*rawObjectsData);
         const int threadCount = executorThreadCount + 1; // one for current thread
         const int minBlockSize = ceil(10000.0 / sqrt(end - begin + 1)); // for 1 iteration it will be 7k docs, for 10k iterations it will be 100 docs.
         const int effectiveBlockCount = Min(threadCount, (docCount + minBlockSize - 1) / minBlockSize);
@@ -46,14 +45,7 @@ TVector<TVector<double>> ApplyModelMulti(
         TLocalExecutor::TExecRangeParams blockParams(0, docCount);
         blockParams.SetBlockCount(effectiveBlockCount);
 
-        const auto featuresLayout = rawObjectsData->GetFeaturesLayout();
-        const auto getFeatureDataPtr = [&](ui32 flatFeatureIdx) -> const float* {
-            return GetRawFeatureDataBeginPtr(
-                *rawObjectsData,
-                *featuresLayout,
-                consecutiveSubsetBegin,
-                flatFeatureIdx);
-        };
+        const TRawFeaturesDataForApply featuresData(model, *rawObjectsData, columnReorderMap);
         const auto applyOnBlock = [&](int blockId) {
             TVector<TConstArrayRef<float>> repackedFeatures(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
             const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
@@ -61,11 +53,11 @@ TVector<TVector<double>> ApplyModelMulti(
             const int blockSize = blockLastIdx - blockFirstIdx;
             if (columnReorderMap.empty()) {
                 for (size_t i = 0; i < model.ObliviousTrees.GetFlatFeatureVectorExpectedSize(); ++i) {
-                    repackedFeatures[i] = MakeArrayRef(getFeatureDataPtr(i) + blockFirstIdx, blockSize);
+                    repackedFeatures[i] = featuresData.GetBlock(i, blockFirstIdx, blockSize);
                 }
             } else {
                 for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
-                    repackedFeatures[origIdx] = MakeArrayRef(getFeatureDataPtr(sourceIdx) + blockFirstIdx, blockSize);
+                    repackedFeatures[origIdx] = featuresData.GetBlock(sourceIdx, blockFirstIdx, blockSize);
                 }
             }
             model.CalcFlatTransposed(
@@ -211,16 +203,7 @@ TModelCalcerOnPool::TModelCalcerOnPool(
     BlockParams.SetBlockCount(threadCount);
     ThreadCalcers.resize(BlockParams.GetBlockCount());
 
-    const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(*RawObjectsData);
-    const auto& featuresLayout = *RawObjectsData->GetFeaturesLayout();
-
-    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx) -> const float* {
-        return GetRawFeatureDataBeginPtr(
-            *RawObjectsData,
-            featuresLayout,
-            consecutiveSubsetBegin,
-            flatFeatureIdx);
-    };
+    const TRawFeaturesDataForApply featuresData(model, *RawObjectsData, columnReorderMap);
 
     executor->ExecRange([&](int blockId) {
         TVector<TConstArrayRef<float>> repackedFeatures(Model->ObliviousTrees.GetFlatFeatureVectorExpectedSize());
@@ -228,11 +211,11 @@ TModelCalcerOnPool::TModelCalcerOnPool(
         const int blockLastId = Min(BlockParams.LastId, blockFirstId + BlockParams.GetBlockSize());
         if (columnReorderMap.empty()) {
             for (ui32 i = 0; i < Model->ObliviousTrees.GetFlatFeatureVectorExpectedSize(); ++i) {
-                repackedFeatures[i] = MakeArrayRef(getFeatureDataBeginPtr(i) + blockFirstId, blockLastId - blockFirstId);
+                repackedFeatures[i] = featuresData.GetBlock(i, blockFirstId, blockLastId - blockFirstId);
             }
         } else {
             for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
-                repackedFeatures[origIdx] = MakeArrayRef(getFeatureDataBeginPtr(sourceIdx) + blockFirstId, blockLastId - blockFirstId);
+                repackedFeatures[origIdx] = featuresData.GetBlock(sourceIdx, blockFirstId, blockLastId - blockFirstId);
             }
         }
         auto floatAccessor = [&repackedFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
@@ -0,0 +1,523 @@
+#include <catboost/libs/algo/binary_features_pack_stats.h>
+#include <catboost/libs/algo/compact_bucket_stats.h>
+#include <catboost/libs/algo/pairwise_scoring.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/getopt/small/last_getopt.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/random/shuffle.h>
+#include <util/stream/format.h>
+#include <util/stream/output.h>
+#include <util/system/hp_timer.h>
+
+/**
+ * Benchmark of bucket stats accumulation in UpdateWeighted/UpdateDeltaCount.
+ * Documents with random derivatives are added to stats at random indices directly and via compact
+ * float stats flushed after blocks of (stats size * documents per stat) documents. Best time of
+ * several runs is printed in milliseconds for each stats size.
+ *
+ * With --packs stats of 8 binary features packed into TBinaryFeaturesPack are accumulated for each depth
+ * instead: for each feature separately (leaf index and bin are calculated and stats are updated per feature)
+ * and for the whole pack (see binary_features_pack_stats.h), with and without random permutation of documents.
+ *
+ * With --tree one symmetric tree of depth --max-depth is grown on random features: stats of all features
+ * are calculated at each level from scratch and from documents on the smallest side of the last split only,
+ * stats of the other side are differences with stats of previous level kept while they fit into --cache-size
+ * (as in TBucketStatsCache). With --pairs-per-doc pairwise stats are calculated instead of per-object ones.
+ * Best time of each level and the sum for the tree (with selection of the smallest sides for reuse) are printed
+ * in milliseconds, calculation is single-threaded.
+ */
+
+struct TBenchmarkParams {
+    int DocCount = 0;
+    int MinStatsSize = 0;
+    int MaxStatsSize = 0;
+    TVector<int> DocsPerStat;
+    int Repeat = 0;
+    ui64 Seed = 0;
+    bool Packs = false;
+    int MaxDepth = 0;
+    bool Tree = false;
+    int FeatureCount = 0;
+    int BucketCount = 0;
+    int ApproxDimension = 0;
+    int PairsPerDoc = 0;
+    ui64 CacheSizeMb = 0;
+};
+
+static void UpdateDirect(
+    const TVector<ui32>& singleIdx,
+    const double* derivatives,
+    const float* weights,
+    NCB::TIndexRange<int> docIndexRange,
+    TBucketStats* stats
+) {
+    for (int doc : docIndexRange.Iter()) {
+        TBucketStats& leafStats = stats[singleIdx[doc]];
+        leafStats.SumWeightedDelta += derivatives[doc];
+        leafStats.SumWeight += weights[doc];
+    }
+}
+
+// stats are zeroed before each run if not nullptr
+template <class TUpdate>
+static double MeasureBestMilliseconds(int repeat, TVector<TBucketStats>* stats, const TUpdate& update) {
+    double best = Max<double>();
+    for (auto runIdx : xrange(repeat)) {
+        Y_UNUSED(runIdx);
+        if (stats) {
+            Fill(stats->begin(), stats->end(), TBucketStats{0, 0, 0, 0});
+        }
+        THPTimer timer;
+        update();
+        best = Min(best, timer.Passed() * 1000);
+    }
+    return best;
+}
+
+static void BenchmarkBinaryFeaturesPacks(
+    const TBenchmarkParams& params,
+    const TVector<double>& derivatives,
+    const TVector<float>& weights,
+    TFastRng64* rng
+) {
+    constexpr int featureCount = sizeof(NCB::TBinaryFeaturesPack) * CHAR_BIT;
+    const NCB::TIndexRange<int> docIndexRange(0, params.DocCount);
+
+    TVector<NCB::TBinaryFeaturesPack> packs(params.DocCount);
+    for (auto& pack : packs) {
+        pack = rng->Uniform(1 << featureCount);
+    }
+
+    Cout << "depth\tpermutation\tper_feature\tper_pack" << Endl;
+    for (int depth = 0; depth <= params.MaxDepth; ++depth) {
+        TVector<ui32> leaves(params.DocCount);
+        for (auto& leaf : leaves) {
+            leaf = rng->Uniform(1 << depth);
+        }
+        for (bool hasPermutation : {false, true}) {
+            TVector<ui32> permutation(params.DocCount);
+            Iota(permutation.begin(), permutation.end(), 0);
+            if (hasPermutation) {
+                Shuffle(permutation.begin(), permutation.end(), *rng);
+            }
+
+            TVector<ui32> singleIdx(params.DocCount);
+            TVector<TBucketStats> featuresStats(featureCount * (2 << depth));
+            const double perFeatureMilliseconds = MeasureBestMilliseconds(params.Repeat, &featuresStats, [&] () {
+                for (auto bitIdx : xrange(featureCount)) {
+                    for (int doc : docIndexRange.Iter()) {
+                        singleIdx[doc] = 2 * leaves[doc] + ((packs[permutation[doc]] >> bitIdx) & 1);
+                    }
+                    UpdateDirect(
+                        singleIdx,
+                        derivatives.data(),
+                        weights.data(),
+                        docIndexRange,
+                        featuresStats.data() + bitIdx * (2 << depth)
+                    );
+                }
+            });
+
+            TVector<TBucketStats> packHalvesStats(GetPackHalvesStatsSize(depth));
+            const double perPackMilliseconds = MeasureBestMilliseconds(params.Repeat, &packHalvesStats, [&] () {
+                for (int doc : docIndexRange.Iter()) {
+                    singleIdx[doc] = (leaves[doc] << LeafAndPackIdxPackBits) | packs[permutation[doc]];
+                }
+                UpdatePackHalves(
+                    singleIdx,
+                    derivatives.data(),
+                    weights.data(),
+                    docIndexRange,
+                    &TBucketStats::SumWeightedDelta,
+                    &TBucketStats::SumWeight,
+                    packHalvesStats.data()
+                );
+                for (auto bitIdx : xrange(featureCount)) {
+                    GetPackedBinaryFeatureStats(
+                        packHalvesStats.data(),
+                        bitIdx,
+                        /*leafBegin*/ 0,
+                        /*leafEnd*/ 1 << depth,
+                        featuresStats.data() + bitIdx * (2 << depth)
+                    );
+                }
+            });
+
+            Cout << depth << '\t' << hasPermutation
+                << '\t' << Prec(perFeatureMilliseconds, PREC_POINT_DIGITS, 2)
+                << '\t' << Prec(perPackMilliseconds, PREC_POINT_DIGITS, 2) << Endl;
+        }
+    }
+}
+
+// stats are [dim][leaf][bucket]
+static void CalcTreeLevelStats(
+    const TVector<ui8>& bins,
+    const TVector<TIndexType>& leaves,
+    const TVector<ui32>& docs,
+    const TVector<TVector<double>>& derivatives,
+    const TVector<float>& weights,
+    int bucketCount,
+    int leafCount,
+    TVector<TBucketStats>* stats
+) {
+    const int dimStatsSize = leafCount * bucketCount;
+    stats->assign(derivatives.size() * dimStatsSize, TBucketStats{0, 0, 0, 0});
+    for (auto dim : xrange(derivatives.size())) {
+        const double* dimDerivatives = derivatives[dim].data();
+        TBucketStats* dimStats = stats->data() + dim * dimStatsSize;
+        for (ui32 doc : docs) {
+            TBucketStats& bucketStats = dimStats[leaves[doc] * bucketCount + bins[doc]];
+            bucketStats.SumWeightedDelta += dimDerivatives[doc];
+            bucketStats.SumWeight += weights[doc];
+        }
+    }
+}
+
+// leaves of the other side than smallestSplitSideValue are set to differences of prevLevelStats and their siblings
+static void RestoreTreeLevelStats(
+    const TVector<TBucketStats>& prevLevelStats,
+    int approxDimension,
+    int bucketCount,
+    int depth,
+    bool smallestSplitSideValue,
+    TVector<TBucketStats>* stats
+) {
+    const int prevDimStatsSize = (1 << (depth - 1)) * bucketCount;
+    const int smallSideBegin = smallestSplitSideValue ? prevDimStatsSize : 0;
+    const int otherSideBegin = prevDimStatsSize - smallSideBegin;
+    for (auto dim : xrange(approxDimension)) {
+        const TBucketStats* prevDimStats = prevLevelStats.data() + dim * prevDimStatsSize;
+        TBucketStats* dimStats = stats->data() + dim * 2 * prevDimStatsSize;
+        for (auto statIdx : xrange(prevDimStatsSize)) {
+            TBucketStats& otherSideStats = dimStats[otherSideBegin + statIdx];
+            otherSideStats = prevDimStats[statIdx];
+            otherSideStats.Remove(dimStats[smallSideBegin + statIdx]);
+        }
+    }
+}
+
+// if prevLevelStats != nullptr pairs have a document on the smallest side of the last split
+static void CalcTreeLevelPairwiseStats(
+    const TVector<ui8>& bins,
+    const TVector<TIndexType>& leaves,
+    const TVector<double>& derivatives,
+    const TFlatPairsInfo& pairs,
+    int bucketCount,
+    int depth,
+    const TPairwiseStats* prevLevelStats,
+    bool smallestSplitSideValue,
+    TPairwiseStats* stats
+) {
+    const int leafCount = 1 << depth;
+    const auto getBucket = [&bins] (ui32 doc) { return bins[doc]; };
+    stats->DerSums = ComputeDerSums(
+        derivatives, leafCount, bucketCount, leaves, getBucket, NCB::TIndexRange<int>(leaves.ysize()));
+    stats->PairWeightStatistics = ComputePairWeightStatistics(
+        pairs, leafCount, bucketCount, leaves, getBucket, NCB::TIndexRange<int>(pairs.ysize()));
+    if (prevLevelStats) {
+        RestoreStatsFromPrevLevel(*prevLevelStats, depth, smallestSplitSideValue, stats);
+    }
+}
+
+static void BenchmarkTree(
+    const TBenchmarkParams& params,
+    const TVector<float>& weights,
+    TFastRng64* rng
+) {
+    const bool isPairwise = params.PairsPerDoc > 0;
+    const int approxDimension = isPairwise ? 1 : params.ApproxDimension;
+    const int bucketCount = params.BucketCount;
+
+    TVector<TVector<ui8>> features(params.FeatureCount, TVector<ui8>(params.DocCount));
+    for (auto& bins : features) {
+        for (auto& bin : bins) {
+            bin = rng->Uniform(bucketCount);
+        }
+    }
+    TVector<TVector<double>> derivatives(approxDimension, TVector<double>(params.DocCount));
+    for (auto& dimDerivatives : derivatives) {
+        for (auto& derivative : dimDerivatives) {
+            derivative = rng->GenRandReal1() * 2 - 1;
+        }
+    }
+    // pairs are in queries of 32 consecutive documents
+    TFlatPairsInfo pairs;
+    for (auto doc : xrange(isPairwise ? params.DocCount : 0)) {
+        const ui32 queryBegin = doc - doc % 32;
+        const ui32 querySize = Min<ui32>(32, params.DocCount - queryBegin);
+        for (auto pairIdx : xrange(params.PairsPerDoc)) {
+            Y_UNUSED(pairIdx);
+            pairs.emplace_back(doc, queryBegin + rng->Uniform(querySize), rng->GenRandReal1());
+        }
+    }
+
+    TVector<ui32> allDocs(params.DocCount);
+    Iota(allDocs.begin(), allDocs.end(), 0);
+    TVector<TIndexType> leaves(params.DocCount, 0);
+    TVector<ui32> smallestSplitSideDocs;
+    TFlatPairsInfo smallestSplitSidePairs;
+    bool smallestSplitSideValue = false;
+
+    // stats of previous level of first features that fit into cache
+    TVector<TVector<TBucketStats>> prevLevelStats;
+    TVector<TPairwiseStats> prevLevelPairwiseStats;
+
+    double treeFromScratchMilliseconds = 0;
+    double treeReuseMilliseconds = 0;
+    // used are documents for per-object stats and pairs for pairwise stats when stats are reused
+    Cout << "depth\tfrom_scratch\treuse\tused\treused_features" << Endl;
+    for (int depth = 0; depth < params.MaxDepth; ++depth) {
+        const int leafCount = 1 << depth;
+        const ui64 featureStatsSize = isPairwise ?
+            GetPairwiseStatsSize(leafCount, bucketCount) :
+            sizeof(TBucketStats) * approxDimension * leafCount * bucketCount;
+
+        // stats of the last level are not reused
+        const int cachedFeatureCount = (depth + 1 < params.MaxDepth) ?
+            (int)Min<ui64>(params.FeatureCount, (params.CacheSizeMb << 20) / featureStatsSize) : 0;
+
+        const double fromScratchMilliseconds = MeasureBestMilliseconds(params.Repeat, nullptr, [&] () {
+            TVector<TBucketStats> stats;
+            TPairwiseStats pairwiseStats;
+            for (const auto& bins : features) {
+                if (isPairwise) {
+                    CalcTreeLevelPairwiseStats(
+                        bins,
+                        leaves,
+                        derivatives[0],
+                        pairs,
+                        bucketCount,
+                        depth,
+                        /*prevLevelStats*/ nullptr,
+                        /*smallestSplitSideValue*/ false,
+                        &pairwiseStats
+                    );
+                } else {
+                    CalcTreeLevelStats(bins, leaves, allDocs, derivatives, weights, bucketCount, leafCount, &stats);
+                }
+            }
+        });
+
+        TVector<TVector<TBucketStats>> levelStats(isPairwise ? 0 : cachedFeatureCount);
+        TVector<TPairwiseStats> levelPairwiseStats(isPairwise ? cachedFeatureCount : 0);
+        const int prevLevelFeatureCount = isPairwise ? prevLevelPairwiseStats.ysize() : prevLevelStats.ysize();
+        const double reuseMilliseconds = MeasureBestMilliseconds(params.Repeat, nullptr, [&] () {
+            TVector<TBucketStats> stats;
+            TPairwiseStats pairwiseStats;
+            for (auto featureIdx : xrange(params.FeatureCount)) {
+                const auto& bins = features[featureIdx];
+                const bool hasPrevLevelStats = featureIdx < prevLevelFeatureCount;
+                if (isPairwise) {
+                    CalcTreeLevelPairwiseStats(
+                        bins,
+                        leaves,
+                        derivatives[0],
+                        hasPrevLevelStats ? smallestSplitSidePairs : pairs,
+                        bucketCount,
+                        depth,
+                        hasPrevLevelStats ? &prevLevelPairwiseStats[featureIdx] : nullptr,
+                        smallestSplitSideValue,
+                        featureIdx < cachedFeatureCount ? &levelPairwiseStats[featureIdx] : &pairwiseStats
+                    );
+                    continue;
+                }
+                auto* featureStats = featureIdx < cachedFeatureCount ? &levelStats[featureIdx] : &stats;
+                if (hasPrevLevelStats) {
+                    CalcTreeLevelStats(
+                        bins,
+                        leaves,
+                        smallestSplitSideDocs,
+                        derivatives,
+                        weights,
+                        bucketCount,
+                        leafCount,
+                        featureStats
+                    );
+                    RestoreTreeLevelStats(
+                        prevLevelStats[featureIdx],
+                        approxDimension,
+                        bucketCount,
+                        depth,
+                        smallestSplitSideValue,
+                        featureStats
+                    );
+                } else {
+                    CalcTreeLevelStats(bins, leaves, allDocs, derivatives, weights, bucketCount, leafCount, featureStats);
+                }
+            }
+        });
+        treeFromScratchMilliseconds += fromScratchMilliseconds;
+        treeReuseMilliseconds += reuseMilliseconds;
+        Cout << depth
+            << '\t' << Prec(fromScratchMilliseconds, PREC_POINT_DIGITS, 2)
+            << '\t' << Prec(reuseMilliseconds, PREC_POINT_DIGITS, 2)
+            << '\t' << (isPairwise ?
+                (depth ? smallestSplitSidePairs.size() : pairs.size()) :
+                (depth ? smallestSplitSideDocs.size() : allDocs.size()))
+            << '\t' << prevLevelFeatureCount << Endl;
+        prevLevelStats.swap(levelStats);
+        prevLevelPairwiseStats.swap(levelPairwiseStats);
+
+        // split by the middle border of a random feature
+        const auto& splitBins = features[rng->Uniform(params.FeatureCount)];
+        int trueCount = 0;
+        for (auto doc : xrange(params.DocCount)) {
+            const bool splitValue = splitBins[doc] >= bucketCount / 2;
+            leaves[doc] |= TIndexType(splitValue) << depth;
+            trueCount += splitValue;
+        }
+        // selection of the smallest side is needed only for reuse of stats
+        THPTimer selectionTimer;
+        smallestSplitSideValue = trueCount * 2 <= params.DocCount;
+        smallestSplitSideDocs.clear();
+        for (auto doc : xrange(params.DocCount)) {
+            if (bool((leaves[doc] >> depth) & 1) == smallestSplitSideValue) {
+                smallestSplitSideDocs.push_back(doc);
+            }
+        }
+        smallestSplitSidePairs.clear();
+        for (const auto& pair : pairs) {
+            if (bool((leaves[pair.WinnerId] >> depth) & 1) == smallestSplitSideValue
+                || bool((leaves[pair.LoserId] >> depth) & 1) == smallestSplitSideValue)
+            {
+                smallestSplitSidePairs.push_back(pair);
+            }
+        }
+        treeReuseMilliseconds += selectionTimer.Passed() * 1000;
+    }
+    Cout << "tree\t" << Prec(treeFromScratchMilliseconds, PREC_POINT_DIGITS, 2)
+        << '\t' << Prec(treeReuseMilliseconds, PREC_POINT_DIGITS, 2) << Endl;
+}
+
+int main(int argc, char** argv) {
+    using namespace NLastGetopt;
+
+    TBenchmarkParams params;
+    TOpts opts = NLastGetopt::TOpts::Default();
+    opts.AddLongOption("docs").RequiredArgument("INT")
+        .DefaultValue(1 << 23)
+        .StoreResult(&params.DocCount);
+    opts.AddLongOption("min-stats").RequiredArgument("INT")
+        .DefaultValue(1 << 10)
+        .StoreResult(&params.MinStatsSize);
+    opts.AddLongOption("max-stats").RequiredArgument("INT")
+        .DefaultValue(1 << 20)
+        .StoreResult(&params.MaxStatsSize);
+    opts.AddLongOption("docs-per-stat").RequiredArgument("LIST")
+        .Help("Comma separated numbers of documents per stat in a block of compact stats")
+        .DefaultValue("2,4,8,16")
+        .SplitHandler(&params.DocsPerStat, ',');
+    opts.AddLongOption("repeat").RequiredArgument("INT")
+        .DefaultValue(3)
+        .StoreResult(&params.Repeat);
+    opts.AddLongOption("seed").RequiredArgument("INT")
+        .DefaultValue(0)
+        .StoreResult(&params.Seed);
+    opts.AddLongOption("packs")
+        .Help("Benchmark stats of binary features packs instead of compact stats")
+        .NoArgument()
+        .SetFlag(&params.Packs);
+    opts.AddLongOption("max-depth").RequiredArgument("INT")
+        .Help("Maximal depth for --packs, depth of tree for --tree")
+        .DefaultValue(8)
+        .StoreResult(&params.MaxDepth);
+    opts.AddLongOption("tree")
+        .Help("Benchmark stats of all features for each level of a tree instead of compact stats")
+        .NoArgument()
+        .SetFlag(&params.Tree);
+    opts.AddLongOption("features").RequiredArgument("INT")
+        .Help("Number of features for --tree")
+        .DefaultValue(500)
+        .StoreResult(&params.FeatureCount);
+    opts.AddLongOption("buckets").RequiredArgument("INT")
+        .Help("Number of buckets of features for --tree")
+        .DefaultValue(255)
+        .StoreResult(&params.BucketCount);
+    opts.AddLongOption("approx-dimension").RequiredArgument("INT")
+        .Help("Approx dimension (number of classes) for --tree")
+        .DefaultValue(10)
+        .StoreResult(&params.ApproxDimension);
+    opts.AddLongOption("pairs-per-doc").RequiredArgument("INT")
+        .Help("Pairs per document for --tree, pairwise stats are calculated if positive")
+        .DefaultValue(0)
+        .StoreResult(&params.PairsPerDoc);
+    opts.AddLongOption("cache-size").RequiredArgument("INT")
+        .Help("Memory for stats of previous level for --tree, MB")
+        .DefaultValue(4096)
+        .StoreResult(&params.CacheSizeMb);
+    opts.SetFreeArgsNum(0);
+    TOptsParseResult args(&opts, argc, argv);
+
+    CB_ENSURE(params.DocCount > 0, "Number of documents should be positive");
+    CB_ENSURE(params.MinStatsSize > 0 && params.MinStatsSize <= params.MaxStatsSize, "Bad range of stats sizes");
+    CB_ENSURE(params.Repeat > 0, "Number of runs should be positive");
+
+    TFastRng64 rng(params.Seed);
+    TVector<double> derivatives(params.DocCount);
+    TVector<float> weights(params.DocCount);
+    for (auto doc : xrange(params.DocCount)) {
+        derivatives[doc] = rng.GenRandReal1() * 2 - 1;
+        weights[doc] = rng.GenRandReal1();
+    }
+    if (params.Packs) {
+        CB_ENSURE(params.MaxDepth >= 0, "Maximal depth should be non-negative");
+        BenchmarkBinaryFeaturesPacks(params, derivatives, weights, &rng);
+        return 0;
+    }
+    if (params.Tree) {
+        CB_ENSURE(params.MaxDepth > 0, "Depth of tree should be positive");
+        CB_ENSURE(params.FeatureCount > 0, "Number of features should be positive");
+        CB_ENSURE(params.BucketCount > 0 && params.BucketCount <= 256, "Number of buckets should be in [1, 256]");
+        CB_ENSURE(params.ApproxDimension > 0, "Approx dimension should be positive");
+        BenchmarkTree(params, weights, &rng);
+        return 0;
+    }
+    const NCB::TIndexRange<int> docIndexRange(0, params.DocCount);
+
+    Cout << "stats\tdirect";
+    for (int docsPerStat : params.DocsPerStat) {
+        Cout << "\tcompact_" << docsPerStat;
+    }
+    Cout << Endl;
+    for (int statsSize = params.MinStatsSize; statsSize <= params.MaxStatsSize; statsSize *= 2) {
+        TVector<ui32> singleIdx(params.DocCount);
+        for (auto& idx : singleIdx) {
+            idx = rng.Uniform(statsSize);
+        }
+        TVector<TBucketStats> stats(statsSize);
+        Cout << statsSize << '\t' << Prec(
+            MeasureBestMilliseconds(params.Repeat, &stats, [&] () {
+                UpdateDirect(singleIdx, derivatives.data(), weights.data(), docIndexRange, stats.data());
+            }),
+            PREC_POINT_DIGITS,
+            2
+        );
+        for (int docsPerStat : params.DocsPerStat) {
+            TVector<TCompactBucketStats> compactStats;
+            compactStats.yresize(statsSize);
+            const double milliseconds = MeasureBestMilliseconds(params.Repeat, &stats, [&] () {
+                UpdateCompact(
+                    singleIdx,
+                    derivatives.data(),
+                    weights.data(),
+                    docIndexRange,
+                    &TBucketStats::SumWeightedDelta,
+                    &TBucketStats::SumWeight,
+                    statsSize * docsPerStat,
+                    &compactStats,
+                    stats.data()
+                );
+            });
+            Cout << '\t' << Prec(milliseconds, PREC_POINT_DIGITS, 2);
+        }
+        Cout << Endl;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "calc_score_cache.h"
+
+#include <catboost/libs/data_new/columns.h>
+#include <catboost/libs/index_range/index_range.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+#include <climits>
+
+/* Features packed into TBinaryFeaturesPack share one byte per document, so stats of all features of a pack
+ * are accumulated in one pass over documents: each document is added to stats of values of both 4-bit
+ * halves of its pack, then stats of each feature are summed from 16 values of the half with its bit.
+ * Stats of pack halves of all leaves (2 * 16 per leaf) fit into L2 cache for all depths.
+ *
+ * algo/benchmark (bucket_stats_benchmark --packs, 8M documents, 8 features in a pack): one pass over a pack
+ * is 5-8 times faster than 8 passes over its features for depths 0-8, with and without permutation.
+ */
+constexpr int PackHalfBitCount = sizeof(NCB::TBinaryFeaturesPack) * CHAR_BIT / 2;
+constexpr int PackHalfValueCount = 1 << PackHalfBitCount;
+constexpr int PackHalvesStatsSizePerLeaf = 2 * PackHalfValueCount;
+constexpr int LeafAndPackIdxPackBits = sizeof(NCB::TBinaryFeaturesPack) * CHAR_BIT;
+
+
+inline int GetPackHalvesStatsSize(int depth) {
+    return PackHalvesStatsSizePerLeaf << depth;
+}
+
+
+// Add sums of derivatives and weights (1 if weights == nullptr) on docIndexRange
+// to (stats[leaf][half][halfValue].*derSum, stats[leaf][half][halfValue].*weightSum),
+// leafAndPackIdx[doc] is (leaf << LeafAndPackIdxPackBits) | pack
+template <typename TFullIndexType>
+inline void UpdatePackHalves(
+    const TVector<TFullIndexType>& leafAndPackIdx,
+    const double* derivatives,
+    const float* weights,
+    NCB::TIndexRange<int> docIndexRange,
+    double TBucketStats::* derSum,
+    double TBucketStats::* weightSum,
+    TBucketStats* stats // [leaf][half][halfValue]
+) {
+    for (int doc : docIndexRange.Iter()) {
+        const ui32 leafAndPack = leafAndPackIdx[doc];
+        const double weight = weights ? weights[doc] : 1.0;
+        TBucketStats* leafStats = stats + (leafAndPack >> LeafAndPackIdxPackBits) * PackHalvesStatsSizePerLeaf;
+        TBucketStats& lowHalfStats = leafStats[leafAndPack & (PackHalfValueCount - 1)];
+        lowHalfStats.*derSum += derivatives[doc];
+        lowHalfStats.*weightSum += weight;
+        TBucketStats& highHalfStats =
+            leafStats[PackHalfValueCount + ((leafAndPack >> PackHalfBitCount) & (PackHalfValueCount - 1))];
+        highHalfStats.*derSum += derivatives[doc];
+        highHalfStats.*weightSum += weight;
+    }
+}
+
+
+// Set stats of bins 0 and 1 of a packed feature for leaves in [leafBegin, leafEnd)
+// to sums of stats of values of its pack half, stats are [leaf][bin]
+inline void GetPackedBinaryFeatureStats(
+    const TBucketStats* packHalvesStats, // [leaf][half][halfValue]
+    ui8 bitIdx,
+    int leafBegin,
+    int leafEnd,
+    TBucketStats* stats
+) {
+    const int halfIdx = bitIdx / PackHalfBitCount;
+    const int bitInHalf = bitIdx % PackHalfBitCount;
+    for (int leaf : xrange(leafBegin, leafEnd)) {
+        TBucketStats* leafStats = stats + 2 * leaf;
+        leafStats[0] = TBucketStats{0, 0, 0, 0};
+        leafStats[1] = TBucketStats{0, 0, 0, 0};
+        const TBucketStats* halfStats =
+            packHalvesStats + leaf * PackHalvesStatsSizePerLeaf + halfIdx * PackHalfValueCount;
+        for (int halfValue : xrange(PackHalfValueCount)) {
+            leafStats[(halfValue >> bitInHalf) & 1].Add(halfStats[halfValue]);
+        }
+    }
+}
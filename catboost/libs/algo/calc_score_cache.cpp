@@ -13,7 +13,41 @@ bool IsSamplingPerTree(const NCatboostOptions::TObliviousTreeLearnerOptions& fit
     return fitParams.SamplingFrequency.Get() == ESamplingFrequency::PerTree;
 }
 
-TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetStats(const TSplitCandidate& split, int splitStatsCount, bool* areStatsDirty) {
+void TPairwiseStats::Add(const TPairwiseStats& rhs) {
+    Y_ASSERT(DerSums.size() == rhs.DerSums.size());
+
+    for (auto leafIdx : xrange(DerSums.size())) {
+        auto& dst = DerSums[leafIdx];
+        const auto& add = rhs.DerSums[leafIdx];
+
+        Y_ASSERT(dst.size() == add.size());
+
+        for (auto bucketIdx : xrange(dst.size())) {
+            dst[bucketIdx] += add[bucketIdx];
+        }
+    }
+
+    Y_ASSERT(PairWeightStatistics.GetXSize() == rhs.PairWeightStatistics.GetXSize());
+    Y_ASSERT(PairWeightStatistics.GetYSize() == rhs.PairWeightStatistics.GetYSize());
+
+    for (auto leafIdx1 : xrange(PairWeightStatistics.GetYSize())) {
+        auto dst1 = PairWeightStatistics[leafIdx1];
+        const auto add1 = rhs.PairWeightStatistics[leafIdx1];
+
+        for (auto leafIdx2 : xrange(PairWeightStatistics.GetXSize())) {
+            auto& dst2 = dst1[leafIdx2];
+            const auto& add2 = add1[leafIdx2];
+
+            Y_ASSERT(dst2.size() == add2.size());
+
+            for (auto bucketIdx : xrange(dst2.size())) {
+                dst2[bucketIdx].Add(add2[bucketIdx]);
+            }
+        }
+    }
+}
+
+TVector<TBucketStats, TPoolAllocator>* TBucketStatsCache::GetStats(const TSplitCandidate& split, int splitStatsCount, bool* areStatsDirty) {
     TVector<TBucketStats, TPoolAllocator>* splitStats;
     with_lock(Lock) {
         if (Stats.contains(split) && Stats[split] != nullptr) {
@@ -21,20 +55,65 @@ TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetStats(const TSplitC
             Y_ASSERT(splitStats->ysize() >= splitStatsCount);
             *areStatsDirty = false;
         } else {
+            const ui64 splitStatsSize = sizeof(TBucketStats) * MaxBodyTailCount * ApproxDimension * splitStatsCount;
+            if (MemoryPool->MemoryAllocated() + PairwiseStatsSize + splitStatsSize > MaxSize) {
+                return nullptr;
+            }
             splitStats = new TVector<TBucketStats, TPoolAllocator>(MemoryPool.Get());
             splitStats->yresize(MaxBodyTailCount * ApproxDimension * splitStatsCount);
             Stats[split] = splitStats;
             *areStatsDirty = true;
         }
     }
-    return *splitStats;
+    return splitStats;
+}
+
+static ui64 GetPairwiseStatsSize(const TPairwiseStats& stats) {
+    const ui64 leafCount = stats.DerSums.size();
+    return leafCount ? GetPairwiseStatsSize(leafCount, stats.DerSums[0].size()) : 0;
+}
+
+const TPairwiseStats* TBucketStatsCache::GetPairwiseStats(const TSplitCandidate& split, int depth) {
+    with_lock(Lock) {
+        const auto statsIt = PairwiseStats.find(split);
+        if (statsIt != PairwiseStats.end() && statsIt->second->Depth == depth) {
+            return &statsIt->second->Stats;
+        }
+    }
+    return nullptr;
+}
+
+void TBucketStatsCache::SetPairwiseStats(const TSplitCandidate& split, int depth, TPairwiseStats&& stats) {
+    const ui64 statsSize = GetPairwiseStatsSize(stats);
+    with_lock(Lock) {
+        auto& cachedStats = PairwiseStats[split];
+        if (cachedStats) {
+            PairwiseStatsSize -= GetPairwiseStatsSize(cachedStats->Stats);
+        }
+        if (MemoryPool->MemoryAllocated() + PairwiseStatsSize + statsSize > MaxSize) {
+            PairwiseStats.erase(split);
+            return;
+        }
+        if (!cachedStats) {
+            cachedStats = MakeHolder<TPairwiseStatsAtDepth>();
+        }
+        cachedStats->Depth = depth;
+        // TArray2D is not movable
+        cachedStats->Stats.DerSums = std::move(stats.DerSums);
+        cachedStats->Stats.PairWeightStatistics.Swap(stats.PairWeightStatistics);
+        PairwiseStatsSize += statsSize;
+    }
 }
 
 void TBucketStatsCache::GarbageCollect() {
-    if (MemoryPool->MemoryWaste() > InitialSize) { // limit memory overhead
+    // limit memory overhead, stats are recalculated at first level of tree anyway
+    if (MemoryPool->MemoryWaste() > InitialSize || MemoryPool->MemoryAllocated() >= MaxSize) {
         Stats.clear();
         MemoryPool->Clear();
     }
+    // pairwise stats are never used at first level of tree
+    PairwiseStats.clear();
+    PairwiseStatsSize = 0;
 }
 
 TVector<TBucketStats> TBucketStatsCache::GetStatsInUse(int segmentCount,
@@ -215,8 +294,15 @@ static int GetMaxTailFinish(const TVector<TFold>& folds, int bodyTailIdx) {
     return maxTailFinish;
 }
 
-void TCalcScoreFold::Create(const TVector<TFold>& folds, bool isPairwiseScoring, int defaultCalcStatsObjBlockSize, float sampleRate) {
+void TCalcScoreFold::Create(
+    const TVector<TFold>& folds,
+    bool isPairwiseScoring,
+    int defaultCalcStatsObjBlockSize,
+    float sampleRate,
+    bool isSampledBySampleWeights
+) {
     BernoulliSampleRate = sampleRate;
+    IsSampledBySampleWeights = isSampledBySampleWeights;
     Y_ASSERT(BernoulliSampleRate > 0.0f && BernoulliSampleRate <= 1.0f);
     DocCount = folds[0].GetLearnSampleCount();
     Y_ASSERT(DocCount > 0);
@@ -251,6 +337,9 @@ void TCalcScoreFold::Create(const TVector<TFold>& folds, bool isPairwiseScoring,
         }
     }
     DefaultCalcStatsObjBlockSize = defaultCalcStatsObjBlockSize;
+    SparseFeaturesStatsData.Destroy();
+    BinaryFeaturesPackStatsData.clear();
+    SmallestSplitSidePairsData.Destroy();
 }
 
 template <typename TSrcRef, typename TGetElementFunc, typename TDstRef>
@@ -367,10 +456,13 @@ void TCalcScoreFold::SelectSmallestSplitSide(int curDepth, const TCalcScoreFold&
         SelectBlockFromFold(fold, srcBlock, dstBlock);
     }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
     SetPermutationBlockSizeAndCalcStatsRanges(FoldPermutationBlockSizeNotSet, FoldPermutationBlockSizeNotSet);
+    SparseFeaturesStatsData.Destroy();
+    BinaryFeaturesPackStatsData.clear();
+    SmallestSplitSidePairsData.Destroy();
 }
 
 void TCalcScoreFold::Sample(const TFold& fold, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor) {
-    SetSampledControl(indices.ysize(), rand);
+    SetSampledControl(fold, indices.ysize(), rand);
 
     TVectorSlicing srcBlocks;
     TVectorSlicing dstBlocks;
@@ -403,6 +495,9 @@ void TCalcScoreFold::Sample(const TFold& fold, const TVector<TIndexType>& indice
         (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? fold.PermutationBlockSize : FoldPermutationBlockSizeNotSet,
         (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? DocCount : FoldPermutationBlockSizeNotSet
     );
+    SparseFeaturesStatsData.Destroy();
+    BinaryFeaturesPackStatsData.clear();
+    SmallestSplitSidePairsData.Destroy();
 }
 
 void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
@@ -427,6 +522,9 @@ void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLo
         const auto srcControlRef = srcBlock.GetConstRef(Control);
         SetElements(srcControlRef, srcBlock.GetConstRef(indices), GetElement<TIndexType>, dstBlock.GetRef(Indices), &ignored);
     }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+    SparseFeaturesStatsData.Destroy();
+    BinaryFeaturesPackStatsData.clear();
+    SmallestSplitSidePairsData.Destroy();
 }
 
 int TCalcScoreFold::GetApproxDimension() const {
@@ -449,6 +547,57 @@ const NCB::IIndexRangesGenerator<int>& TCalcScoreFold::GetCalcStatsIndexRanges()
     return *CalcStatsIndexRanges;
 }
 
+const TCalcScoreFold::TSparseFeaturesStatsData& TCalcScoreFold::GetSparseFeaturesStatsData(
+    int depth,
+    const std::function<void(TSparseFeaturesStatsData*)>& calcFunc
+) const {
+    with_lock(SparseFeaturesStatsDataLock) {
+        if (!SparseFeaturesStatsData || (SparseFeaturesStatsData->Depth != depth)) {
+            SparseFeaturesStatsData = MakeHolder<TSparseFeaturesStatsData>();
+            calcFunc(SparseFeaturesStatsData.Get());
+            SparseFeaturesStatsData->Depth = depth;
+        }
+    }
+    return *SparseFeaturesStatsData;
+}
+
+const TVector<TBucketStats>& TCalcScoreFold::GetBinaryFeaturesPackStats(
+    const NCB::TBinaryFeaturesPack* packs,
+    int depth,
+    const std::function<void(TVector<TBucketStats>*)>& calcFunc
+) const {
+    TBinaryFeaturesPackStatsData* packStatsData = nullptr;
+    with_lock(BinaryFeaturesPackStatsDataLock) {
+        auto& packStatsDataHolder = BinaryFeaturesPackStatsData[packs];
+        if (!packStatsDataHolder) {
+            packStatsDataHolder = MakeHolder<TBinaryFeaturesPackStatsData>();
+        }
+        packStatsData = packStatsDataHolder.Get();
+    }
+    // stats of different packs are calculated in parallel
+    with_lock(packStatsData->Lock) {
+        if (packStatsData->Depth != depth) {
+            calcFunc(&packStatsData->Stats);
+            packStatsData->Depth = depth;
+        }
+    }
+    return packStatsData->Stats;
+}
+
+const TFlatPairsInfo& TCalcScoreFold::GetSmallestSplitSidePairs(
+    int depth,
+    const std::function<void(TFlatPairsInfo*)>& calcFunc
+) const {
+    with_lock(SmallestSplitSidePairsDataLock) {
+        if (!SmallestSplitSidePairsData || (SmallestSplitSidePairsData->Depth != depth)) {
+            SmallestSplitSidePairsData = MakeHolder<TSmallestSplitSidePairsData>();
+            calcFunc(&SmallestSplitSidePairsData->Pairs);
+            SmallestSplitSidePairsData->Depth = depth;
+        }
+    }
+    return SmallestSplitSidePairsData->Pairs;
+}
+
 void TCalcScoreFold::SetSmallestSideControl(int curDepth, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
     Y_ASSERT(curDepth > 0);
 
@@ -485,11 +634,18 @@ void TCalcScoreFold::SetSmallestSideControl(int curDepth, int docCount, const TU
     }
 }
 
-void TCalcScoreFold::SetSampledControl(int docCount, TRestorableFastRng64* rand) {
+void TCalcScoreFold::SetSampledControl(const TFold& fold, int docCount, TRestorableFastRng64* rand) {
     if (BernoulliSampleRate == 1.0f || IsPairwiseScoring) {
         Fill(Control.begin(), Control.end(), true);
         return;
     }
+    if (IsSampledBySampleWeights) {
+        // objects are already selected in Bootstrap, unselected ones have zero weight
+        for (int docIdx = 0; docIdx < docCount; ++docIdx) {
+            Control[docIdx] = fold.SampleWeights[docIdx] != 0.0f;
+        }
+        return;
+    }
     for (int docIdx = 0; docIdx < docCount; ++docIdx) {
         Control[docIdx] = rand->GenRandReal1() < BernoulliSampleRate;
     }
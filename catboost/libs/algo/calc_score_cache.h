@@ -6,18 +6,25 @@
 #include "split.h"
 
 #include <catboost/libs/data_new/columns.h>
+#include <catboost/libs/data_types/pair.h>
 #include <catboost/libs/index_range/index_range.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/options/restrictions.h>
 #include <catboost/libs/options/oblivious_tree_options.h>
 
+#include <library/binsaver/bin_saver.h>
+#include <library/containers/2d_array/2d_array.h>
+
 #include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
 #include <util/generic/ptr.h>
 #include <util/memory/pool.h>
 #include <util/system/info.h>
 #include <util/system/atomic.h>
 #include <util/system/spinlock.h>
 
+#include <functional>
+
 bool IsSamplingPerTree(const NCatboostOptions::TObliviousTreeLearnerOptions& fitParams);
 
 
@@ -44,8 +51,14 @@ static inline const TData* GetDataPtr(const TVector<TData, TAlloc>& data, size_t
     return GetDataPtr(TConstArrayRef<TData>(data), offset);
 }
 
+static inline bool IsGradientBasedSampling(const NCatboostOptions::TOption<NCatboostOptions::TBootstrapConfig>& samplingConfig) {
+    const EBootstrapType bootstrapType = samplingConfig->GetBootstrapType();
+    return bootstrapType == EBootstrapType::MVS || bootstrapType == EBootstrapType::GOSS;
+}
+
+// fraction of objects used for score calculation, gradient based sampling selects them in Bootstrap by nonzero weights
 static inline float GetBernoulliSampleRate(const NCatboostOptions::TOption<NCatboostOptions::TBootstrapConfig>& samplingConfig) {
-    if (samplingConfig->GetBootstrapType() == EBootstrapType::Bernoulli) {
+    if (samplingConfig->GetBootstrapType() == EBootstrapType::Bernoulli || IsGradientBasedSampling(samplingConfig)) {
         return samplingConfig->GetTakenFraction();
     }
     return 1.0f;
@@ -83,6 +96,35 @@ struct TBucketStats {
 
 static_assert(std::is_pod<TBucketStats>::value, "TBucketStats must be pod to avoid memory initialization in yresize");
 
+struct TBucketPairWeightStatistics {
+    double SmallerBorderWeightSum = 0.0; // The weight sum of pair elements with smaller border.
+    double GreaterBorderRightWeightSum = 0.0; // The weight sum of pair elements with greater border.
+
+    void Add(const TBucketPairWeightStatistics& rhs) {
+        SmallerBorderWeightSum += rhs.SmallerBorderWeightSum;
+        GreaterBorderRightWeightSum += rhs.GreaterBorderRightWeightSum;
+    }
+    void Remove(const TBucketPairWeightStatistics& rhs) {
+        SmallerBorderWeightSum -= rhs.SmallerBorderWeightSum;
+        GreaterBorderRightWeightSum -= rhs.GreaterBorderRightWeightSum;
+    }
+    SAVELOAD(SmallerBorderWeightSum, GreaterBorderRightWeightSum);
+};
+
+
+struct TPairwiseStats {
+    TVector<TVector<double>> DerSums; // [leafCount][bucketCount]
+    TArray2D<TVector<TBucketPairWeightStatistics>> PairWeightStatistics; // [leafCount][leafCount][bucketCount]
+
+    void Add(const TPairwiseStats& rhs);
+    SAVELOAD(DerSums, PairWeightStatistics);
+};
+
+inline ui64 GetPairwiseStatsSize(ui64 leafCount, ui64 bucketCount) {
+    return sizeof(double) * leafCount * bucketCount
+        + sizeof(TBucketPairWeightStatistics) * leafCount * leafCount * bucketCount;
+}
+
 inline static int CountNonCtrBuckets(
     const TVector<int>& splitCounts,
     const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
@@ -103,27 +145,48 @@ inline static int CountNonCtrBuckets(
     return nonCtrBucketCount;
 }
 
+/* Stats of split candidates from previous tree level.
+ * Cache memory is bounded by maxSize: when it is exhausted, stats of new candidates are not cached
+ * and are calculated from scratch at each level.
+ * Pairwise stats have size of previous level only and are kept within one tree.
+ */
 struct TBucketStatsCache {
     THashMap<TSplitCandidate, THolder<TVector<TBucketStats, TPoolAllocator>>> Stats;
-    inline void Create(const TVector<TFold>& folds, int bucketCount, int depth) {
+    inline void Create(const TVector<TFold>& folds, int bucketCount, int depth, ui64 maxSize = Max<ui64>()) {
         ApproxDimension = folds[0].GetApproxDimension();
         MaxBodyTailCount = GetMaxBodyTailCount(folds);
-        InitialSize = sizeof(TBucketStats) * bucketCount * (1U << depth) * ApproxDimension * MaxBodyTailCount;
+        MaxSize = maxSize;
+        InitialSize = Min<ui64>(
+            sizeof(TBucketStats) * bucketCount * (1U << depth) * ApproxDimension * MaxBodyTailCount,
+            MaxSize);
         if (InitialSize == 0) {
             InitialSize = NSystemInfo::GetPageSize();
         }
         MemoryPool = new TMemoryPool(InitialSize);
     }
-    TVector<TBucketStats, TPoolAllocator>& GetStats(const TSplitCandidate& split, int statsCount, bool* areStatsDirty);
+    // returns nullptr if stats are not cached and there is no memory left in cache for them
+    TVector<TBucketStats, TPoolAllocator>* GetStats(const TSplitCandidate& split, int statsCount, bool* areStatsDirty);
+    // returns nullptr if pairwise stats of split at depth are not cached
+    const TPairwiseStats* GetPairwiseStats(const TSplitCandidate& split, int depth);
+    // stats are dropped if there is no memory left in cache for them
+    void SetPairwiseStats(const TSplitCandidate& split, int depth, TPairwiseStats&& stats);
     void GarbageCollect();
     static TVector<TBucketStats> GetStatsInUse(int segmentCount,
         int segmentSize,
         int statsCount,
         const TVector<TBucketStats, TPoolAllocator>& cachedStats);
 private:
+    struct TPairwiseStatsAtDepth {
+        int Depth = 0;
+        TPairwiseStats Stats;
+    };
+
+    THashMap<TSplitCandidate, THolder<TPairwiseStatsAtDepth>> PairwiseStats;
+    ui64 PairwiseStatsSize = 0;
     THolder<TMemoryPool> MemoryPool;
     TAdaptiveLock Lock;
     size_t InitialSize = 0;
+    ui64 MaxSize = Max<ui64>();
     int MaxBodyTailCount = 0;
     int ApproxDimension = 0;
 };
@@ -212,7 +275,13 @@ struct TCalcScoreFold {
     int CtrDataPermutationBlockSize = FoldPermutationBlockSizeNotSet;
 
 
-    void Create(const TVector<TFold>& folds, bool isPairwiseScoring, int defaultCalcStatsObjBlockSize, float sampleRate = 1.0f);
+    void Create(
+        const TVector<TFold>& folds,
+        bool isPairwiseScoring,
+        int defaultCalcStatsObjBlockSize,
+        float sampleRate = 1.0f,
+        bool isSampledBySampleWeights = false
+    );
     void SelectSmallestSplitSide(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor);
     void Sample(const TFold& fold, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor);
     void UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
@@ -226,6 +295,55 @@ struct TCalcScoreFold {
     // for data with queries - query indices, object indices otherwise
     const NCB::IIndexRangesGenerator<int>& GetCalcStatsIndexRanges() const;
 
+    /* Stats of sparse features are accumulated only over their non-default values, stats of the default
+     * bucket are derived from sums over all documents of each leaf.
+     * This data depends on documents in fold and their leaf indices, so it is dropped when they change.
+     */
+    struct TSparseFeaturesStatsData {
+        int Depth = -1;
+        TVector<ui32> DocByFeaturesIdx; // index in fold by index in features buckets arrays, Max<ui32>() if not in fold
+        TVector<TBucketStats> LeafStats; // [bodyTail & approxDim][leaf], for per-object scoring
+        TVector<double> LeafDerSums; // [leaf], for pairwise scoring
+    };
+
+    // thread-safe, calcFunc is called to fill data if there is no data for this depth yet
+    const TSparseFeaturesStatsData& GetSparseFeaturesStatsData(
+        int depth,
+        const std::function<void(TSparseFeaturesStatsData*)>& calcFunc
+    ) const;
+
+    /* Stats of features packed into TBinaryFeaturesPack are summed from stats of values of their packs,
+     * see binary_features_pack_stats.h.
+     * These stats depend on documents in fold and their leaf indices, so they are dropped when they change.
+     */
+    struct TBinaryFeaturesPackStatsData {
+        int Depth = -1;
+        TVector<TBucketStats> Stats; // [bodyTail & approxDim][leaf][half][halfValue]
+        TAdaptiveLock Lock;
+    };
+
+    // thread-safe, calcFunc is called to fill stats if there are no stats of this pack for this depth yet
+    const TVector<TBucketStats>& GetBinaryFeaturesPackStats(
+        const NCB::TBinaryFeaturesPack* packs,
+        int depth,
+        const std::function<void(TVector<TBucketStats>*)>& calcFunc
+    ) const;
+
+    /* With pairwise stats of previous tree level only pairs with a document on the smallest side of the last split
+     * are used to calculate pairwise stats, see RestoreStatsFromPrevLevel.
+     * These pairs depend on leaf indices, so they are dropped when they change.
+     */
+    struct TSmallestSplitSidePairsData {
+        int Depth = -1;
+        TFlatPairsInfo Pairs;
+    };
+
+    // thread-safe, calcFunc is called to fill pairs if there are no pairs for this depth yet
+    const TFlatPairsInfo& GetSmallestSplitSidePairs(
+        int depth,
+        const std::function<void(TFlatPairsInfo*)>& calcFunc
+    ) const;
+
 private:
     inline void ClearBodyTail() {
         for (auto& bodyTail : BodyTailArr) {
@@ -236,7 +354,7 @@ private:
     template <typename TFoldType>
     void SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock, TSlice dstBlock);
     void SetSmallestSideControl(int curDepth, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
-    void SetSampledControl(int docCount, TRestorableFastRng64* rand);
+    void SetSampledControl(const TFold& fold, int docCount, TRestorableFastRng64* rand);
 
     void CreateBlocksAndUpdateQueriesInfoByControl(
         NPar::TLocalExecutor* localExecutor,
@@ -255,11 +373,22 @@ private:
     int BodyTailCount;
     int ApproxDimension;
     float BernoulliSampleRate;
+    bool IsSampledBySampleWeights;
     bool HasPairwiseWeights;
     bool IsPairwiseScoring;
     int DefaultCalcStatsObjBlockSize;
 
     THolder<NCB::IIndexRangesGenerator<int>> CalcStatsIndexRanges;
+
+    mutable THolder<TSparseFeaturesStatsData> SparseFeaturesStatsData;
+    mutable TAdaptiveLock SparseFeaturesStatsDataLock;
+
+    // by packs data without subset indexing
+    mutable THashMap<const NCB::TBinaryFeaturesPack*, THolder<TBinaryFeaturesPackStatsData>> BinaryFeaturesPackStatsData;
+    mutable TAdaptiveLock BinaryFeaturesPackStatsDataLock;
+
+    mutable THolder<TSmallestSplitSidePairsData> SmallestSplitSidePairsData;
+    mutable TAdaptiveLock SmallestSplitSidePairsDataLock;
 };
 
 struct TStats3D {
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "calc_score_cache.h"
+
+#include <catboost/libs/index_range/index_range.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+
+/* Each document updates TBucketStats (32 bytes) at a random index, so when stats do not fit into L2 cache
+ * UpdateWeighted and UpdateDeltaCount are bound by memory latency. For such stats sizes sums are
+ * accumulated in blocks of documents into a compact float array (8 bytes per bucket) that fits into L2
+ * and then flushed to stats.
+ *
+ * Thresholds are taken from algo/benchmark (bucket_stats_benchmark, 8M documents, 2 MB L2):
+ *  - up to 32768 stats the direct update is as fast or faster, flushing costs more than it saves;
+ *  - from 65536 to 262144 stats the compact update is 1.2-2.3 times faster;
+ *  - from 524288 stats the compact array does not fit into L2 either and there is no gain.
+ * Flushing touches all stats, so a block has 8 documents per stat on average: shorter blocks lose
+ * most of the gain, longer ones give little.
+ *
+ * Precision: 8 documents per stat is only the average, with skewed buckets one bucket can get up to
+ * the whole block (2^19-2^21 documents) summed in float. Sums of unit weights are exact counts (block
+ * is shorter than 2^24), other sums lose precision as a random walk of roundings: with a quarter of
+ * 8M documents in 1-8 buckets, relative errors were at most 3e-6 of sums of absolute values.
+ * Flushing each bucket after a bounded number of additions needs a per document counter, which made
+ * the compact update as slow as the direct one.
+ */
+constexpr int CompactStatsMinSize = 1 << 16; // 2 MB of TBucketStats
+constexpr int CompactStatsMaxSize = 1 << 18; // 2 MB of TCompactBucketStats
+constexpr int CompactStatsBlockSizePerStat = 8;
+
+
+// A pair of TBucketStats sums in float, 4 times more compact than TBucketStats
+struct TCompactBucketStats {
+    float SumDer;
+    float SumWeight;
+};
+
+
+inline int GetCompactStatsBlockSize(int statsSize) {
+    return statsSize * CompactStatsBlockSizePerStat;
+}
+
+inline bool UseCompactStats(int statsSize, NCB::TIndexRange<int> docIndexRange) {
+    return (statsSize >= CompactStatsMinSize) && (statsSize <= CompactStatsMaxSize)
+        && (docIndexRange.GetSize() >= GetCompactStatsBlockSize(statsSize));
+}
+
+
+// Add sums of derivatives and weights (1 if weights == nullptr) on docIndexRange
+// to (stats[idx].*derSum, stats[idx].*weightSum) via compactStats flushed after each blockSize documents
+template <typename TFullIndexType>
+inline void UpdateCompact(
+    const TVector<TFullIndexType>& singleIdx,
+    const double* derivatives,
+    const float* weights,
+    NCB::TIndexRange<int> docIndexRange,
+    double TBucketStats::* derSum,
+    double TBucketStats::* weightSum,
+    int blockSize,
+    TVector<TCompactBucketStats>* compactStats, // of stats size
+    TBucketStats* stats
+) {
+    TCompactBucketStats* compactStatsData = compactStats->data();
+    const int statsSize = compactStats->ysize();
+    for (int blockBegin = docIndexRange.Begin; blockBegin < docIndexRange.End; blockBegin += blockSize) {
+        const int blockEnd = Min(blockBegin + blockSize, docIndexRange.End);
+        Fill(compactStats->begin(), compactStats->end(), TCompactBucketStats{0.0f, 0.0f});
+        if (weights == nullptr) {
+            for (int doc = blockBegin; doc < blockEnd; ++doc) {
+                TCompactBucketStats& leafStats = compactStatsData[singleIdx[doc]];
+                leafStats.SumDer += (float)derivatives[doc];
+                leafStats.SumWeight += 1.0f;
+            }
+        } else {
+            for (int doc = blockBegin; doc < blockEnd; ++doc) {
+                TCompactBucketStats& leafStats = compactStatsData[singleIdx[doc]];
+                leafStats.SumDer += (float)derivatives[doc];
+                leafStats.SumWeight += weights[doc];
+            }
+        }
+        for (int statIdx = 0; statIdx < statsSize; ++statIdx) {
+            stats[statIdx].*derSum += compactStatsData[statIdx].SumDer;
+            stats[statIdx].*weightSum += compactStatsData[statIdx].SumWeight;
+        }
+    }
+}
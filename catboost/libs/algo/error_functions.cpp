@@ -2,8 +2,9 @@
 
 #include <util/generic/xrange.h>
 
-template <int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta>
+template <class TCalcer, int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta>
 void IDerCalcer::CalcDersRangeImpl(
+    const TCalcer& calcer,
     int start,
     int count,
     const double* approxes,
@@ -12,11 +13,11 @@ void IDerCalcer::CalcDersRangeImpl(
     const float* weights,
     TDers* ders,
     double* firstDers
-) const {
-    Y_ASSERT(UseExpApprox == IsExpApprox);
+) {
+    Y_ASSERT(UseExpApprox == calcer.GetIsExpApprox());
     Y_ASSERT(HasDelta == (approxDeltas != nullptr));
     Y_ASSERT(UseTDers == (ders != nullptr) && (ders != nullptr) == (firstDers == nullptr));
-    Y_ASSERT(MaxDerivativeOrder <= MaxSupportedDerivativeOrder);
+    Y_ASSERT(MaxDerivativeOrder <= (int)calcer.GetMaxSupportedDerivativeOrder());
     Y_ASSERT((MaxDerivativeOrder > 1) <= (ders != nullptr));
     for (int i = start; i < start + count; ++i) {
         double updatedApprox = approxes[i];
@@ -24,15 +25,15 @@ void IDerCalcer::CalcDersRangeImpl(
             updatedApprox = UpdateApprox<UseExpApprox>(updatedApprox, approxDeltas[i]);
         }
         if (UseTDers) {
-            ders[i].Der1 = CalcDer(updatedApprox, targets[i]);
+            ders[i].Der1 = calcer.CalcDer(updatedApprox, targets[i]);
         } else {
-            firstDers[i] = CalcDer(updatedApprox, targets[i]);
+            firstDers[i] = calcer.CalcDer(updatedApprox, targets[i]);
         }
         if (MaxDerivativeOrder >= 2) {
-            ders[i].Der2 = CalcDer2(updatedApprox, targets[i]);
+            ders[i].Der2 = calcer.CalcDer2(updatedApprox, targets[i]);
         }
         if (MaxDerivativeOrder >= 3) {
-            ders[i].Der3 = CalcDer3(updatedApprox, targets[i]);
+            ders[i].Der3 = calcer.CalcDer3(updatedApprox, targets[i]);
         }
     }
     if (weights != nullptr) {
@@ -56,7 +57,9 @@ static constexpr int EncodeImplParameters(int maxDerivativeOrder, bool useTDers,
     return maxDerivativeOrder * 8 + useTDers * 4 + isExpApprox * 2 + hasDelta;
 }
 
-void IDerCalcer::CalcDersRange(
+template <class TCalcer>
+void IDerCalcer::CalcDersRangeWithCalcer(
+    const TCalcer& calcer,
     int start,
     int count,
     int maxDerivativeOrder,
@@ -66,47 +69,116 @@ void IDerCalcer::CalcDersRange(
     const float* weights,
     TDers* ders,
     double* firstDers
-) const {
+) {
     const bool hasDelta = approxDeltas != nullptr;
     const bool useTDers = ders != nullptr;
-    switch (EncodeImplParameters(maxDerivativeOrder, useTDers, IsExpApprox, hasDelta)) {
+    switch (EncodeImplParameters(maxDerivativeOrder, useTDers, calcer.GetIsExpApprox(), hasDelta)) {
         case EncodeImplParameters(1, false, false, false):
-            return CalcDersRangeImpl<1, false, false, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, false, false, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(1, false, false, true):
-            return CalcDersRangeImpl<1, false, false, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, false, false, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(1, false, true, false):
-            return CalcDersRangeImpl<1, false, true, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, false, true, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(1, false, true, true):
-            return CalcDersRangeImpl<1, false, true, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, false, true, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(1, true, false, false):
-            return CalcDersRangeImpl<1, true, false, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, true, false, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(1, true, false, true):
-            return CalcDersRangeImpl<1, true, false, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, true, false, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(1, true, true, false):
-            return CalcDersRangeImpl<1, true, true, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, true, true, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(1, true, true, true):
-            return CalcDersRangeImpl<1, true, true, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 1, true, true, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(2, true, false, false):
-            return CalcDersRangeImpl<2, true, false, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 2, true, false, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(2, true, false, true):
-            return CalcDersRangeImpl<2, true, false, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 2, true, false, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(2, true, true, false):
-            return CalcDersRangeImpl<2, true, true, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 2, true, true, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(2, true, true, true):
-            return CalcDersRangeImpl<2, true, true, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 2, true, true, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(3, true, false, false):
-            return CalcDersRangeImpl<3, true, false, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 3, true, false, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(3, true, false, true):
-            return CalcDersRangeImpl<3, true, false, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 3, true, false, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(3, true, true, false):
-            return CalcDersRangeImpl<3, true, true, false>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 3, true, true, false>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         case EncodeImplParameters(3, true, true, true):
-            return CalcDersRangeImpl<3, true, true, true>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+            return CalcDersRangeImpl<TCalcer, 3, true, true, true>(calcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
         default:
             Y_ASSERT(false);
     }
 }
 
+void IDerCalcer::CalcDersRange(
+    int start,
+    int count,
+    int maxDerivativeOrder,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) const {
+    CalcDersRangeWithCalcer(*this, start, count, maxDerivativeOrder, approxes, approxDeltas, targets, weights, ders, firstDers);
+}
+
+template <class TError>
+void TDerCalcerWithInlineDers<TError>::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* firstDers
+) const {
+    CalcDersRangeWithCalcer(
+        static_cast<const TError&>(*this),
+        start,
+        count,
+        /*maxDerivativeOrder*/ 1,
+        approxes,
+        approxDeltas,
+        targets,
+        weights,
+        /*ders*/ nullptr,
+        firstDers);
+}
+
+template <class TError>
+void TDerCalcerWithInlineDers<TError>::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    const int maxDerivativeOrder = calcThirdDer ? 3 : Min(GetMaxSupportedDerivativeOrder(), 2u);
+    CalcDersRangeWithCalcer(
+        static_cast<const TError&>(*this),
+        start,
+        count,
+        maxDerivativeOrder,
+        approxes,
+        approxDeltas,
+        targets,
+        weights,
+        ders,
+        /*firstDers*/ nullptr);
+}
+
+template class TDerCalcerWithInlineDers<TRMSEError>;
+template class TDerCalcerWithInlineDers<TQuantileError>;
+template class TDerCalcerWithInlineDers<TLqError>;
+template class TDerCalcerWithInlineDers<TLogLinQuantileError>;
+template class TDerCalcerWithInlineDers<TMAPError>;
+template class TDerCalcerWithInlineDers<TPoissonError>;
+
 namespace {
     template <int Capacity>
     class TExpForwardView {
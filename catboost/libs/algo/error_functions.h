@@ -119,8 +119,9 @@ private:
         CB_ENSURE(false, "Not implemented");
     }
 
-    template <int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta>
-    void CalcDersRangeImpl(
+    template <class TCalcer, int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta>
+    static void CalcDersRangeImpl(
+        const TCalcer& calcer,
         int start,
         int count,
         const double* approxes,
@@ -129,7 +130,7 @@ private:
         const float* weights,
         TDers* ders,
         double* firstDers
-    ) const;
+    );
 
     void CalcDersRange(
         int start,
@@ -142,6 +143,57 @@ private:
         TDers* ders,
         double* firstDers
     ) const;
+
+protected:
+    /**
+     * Per object derivatives over range computed with CalcDer/CalcDer2/CalcDer3 of calcer.
+     * If TCalcer is a final error class, derivative calls are resolved statically and inlined into range loops.
+     */
+    template <class TCalcer>
+    static void CalcDersRangeWithCalcer(
+        const TCalcer& calcer,
+        int start,
+        int count,
+        int maxDerivativeOrder,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders,
+        double* firstDers
+    );
+};
+
+/**
+ * Base of final error classes with per object CalcDer/CalcDer2/CalcDer3:
+ * range derivatives are instantiated for TError, so there are no virtual calls per object.
+ * TError should declare IDerCalcer as friend to give access to its derivatives.
+ */
+template <class TError>
+class TDerCalcerWithInlineDers : public IDerCalcer {
+public:
+    using IDerCalcer::IDerCalcer;
+
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* firstDers
+    ) const override;
+
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
 };
 
 class TCrossEntropyError final : public IDerCalcer {
@@ -173,18 +225,20 @@ public:
     ) const override;
 };
 
-class TRMSEError final : public IDerCalcer {
+class TRMSEError final : public TDerCalcerWithInlineDers<TRMSEError> {
 public:
     static constexpr double RMSE_DER2 = -1.0;
     static constexpr double RMSE_DER3 = 0.0;
 
     explicit TRMSEError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlineDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
 private:
+    friend class IDerCalcer;
+
     double CalcDer(double approx, float target) const override {
         return target - approx;
     }
@@ -198,21 +252,21 @@ private:
     }
 };
 
-class TQuantileError final : public IDerCalcer {
+class TQuantileError final : public TDerCalcerWithInlineDers<TQuantileError> {
 public:
     static constexpr double QUANTILE_DER2_AND_DER3 = 0.0;
 
     const double Alpha;
 
     explicit TQuantileError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlineDers(isExpApprox)
     , Alpha(0.5)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
     TQuantileError(double alpha, bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlineDers(isExpApprox)
     , Alpha(alpha)
     {
         Y_ASSERT(Alpha > -1e-6 && Alpha < 1.0 + 1e-6);
@@ -220,6 +274,8 @@ public:
     }
 
 private:
+    friend class IDerCalcer;
+
     double CalcDer(double approx, float target) const override {
         return (target - approx > 0) ? Alpha : -(1 - Alpha);
     }
@@ -233,12 +289,12 @@ private:
     }
 };
 
-class TLqError final : public IDerCalcer {
+class TLqError final : public TDerCalcerWithInlineDers<TLqError> {
 public:
     const double Q;
 
     TLqError(double q, bool isExpApprox)
-    : IDerCalcer(isExpApprox, /*maxDerivativeOrder*/ q >= 2 ?  3 : 1)
+    : TDerCalcerWithInlineDers(isExpApprox, /*maxDerivativeOrder*/ q >= 2 ?  3 : 1)
     , Q(q)
     {
         Y_ASSERT(Q >= 1);
@@ -246,6 +302,8 @@ public:
     }
 
 private:
+    friend class IDerCalcer;
+
     double CalcDer(double approx, float target) const override {
         const double absLoss = abs(approx - target);
         const double absLossQ = std::pow(absLoss, Q - 1);
@@ -263,21 +321,21 @@ private:
     }
 };
 
-class TLogLinQuantileError final : public IDerCalcer {
+class TLogLinQuantileError final : public TDerCalcerWithInlineDers<TLogLinQuantileError> {
 public:
     static constexpr double QUANTILE_DER2_AND_DER3 = 0.0;
 
     const double Alpha;
 
     explicit TLogLinQuantileError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlineDers(isExpApprox)
     , Alpha(0.5)
     {
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
 
     TLogLinQuantileError(double alpha, bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlineDers(isExpApprox)
     , Alpha(alpha)
     {
         Y_ASSERT(Alpha > -1e-6 && Alpha < 1.0 + 1e-6);
@@ -285,6 +343,8 @@ public:
     }
 
 private:
+    friend class IDerCalcer;
+
     double CalcDer(double approxExp, float target) const override {
         return (target - approxExp > 0) ? Alpha * approxExp : -(1 - Alpha) * approxExp;
     }
@@ -298,17 +358,19 @@ private:
     }
 };
 
-class TMAPError final : public IDerCalcer {
+class TMAPError final : public TDerCalcerWithInlineDers<TMAPError> {
 public:
     static constexpr double MAPE_DER2_AND_DER3 = 0.0;
 
     explicit TMAPError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlineDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
 private:
+    friend class IDerCalcer;
+
     double CalcDer(double approx, float target) const override {
         return (target - approx > 0) ? 1 / target : -1 / target;
     }
@@ -322,15 +384,17 @@ private:
     }
 };
 
-class TPoissonError final : public IDerCalcer {
+class TPoissonError final : public TDerCalcerWithInlineDers<TPoissonError> {
 public:
     explicit TPoissonError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlineDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
 
 private:
+    friend class IDerCalcer;
+
     double CalcDer(double approxExp, float target) const override {
         return target - approxExp;
     }
@@ -344,6 +408,13 @@ private:
     }
 };
 
+extern template class TDerCalcerWithInlineDers<TRMSEError>;
+extern template class TDerCalcerWithInlineDers<TQuantileError>;
+extern template class TDerCalcerWithInlineDers<TLqError>;
+extern template class TDerCalcerWithInlineDers<TLogLinQuantileError>;
+extern template class TDerCalcerWithInlineDers<TMAPError>;
+extern template class TDerCalcerWithInlineDers<TPoissonError>;
+
 class TMultiClassError final : public IDerCalcer {
 public:
     explicit TMultiClassError(bool isExpApprox)
@@ -360,16 +431,12 @@ public:
         THessianInfo* der2
     ) const override {
         const int approxDimension = approx.ysize();
+        Y_ASSERT(der->ysize() == approxDimension);
 
-        TVector<double> softmax(approxDimension);
+        // der holds softmax until hessian is calculated, so no per object buffer is allocated
+        auto& softmax = *der;
         CalcSoftmax(approx, &softmax);
 
-        for (int dim = 0; dim < approxDimension; ++dim) {
-            (*der)[dim] = -softmax[dim];
-        }
-        int targetClass = static_cast<int>(target);
-        (*der)[targetClass] += 1;
-
         if (der2 != nullptr) {
             Y_ASSERT(der2->HessianType == EHessianType::Symmetric &&
                      der2->ApproxDimension == approxDimension);
@@ -382,6 +449,12 @@ public:
             }
         }
 
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            (*der)[dim] = -softmax[dim];
+        }
+        int targetClass = static_cast<int>(target);
+        (*der)[targetClass] += 1;
+
         if (weight != 1) {
             for (int dim = 0; dim < approxDimension; ++dim) {
                 (*der)[dim] *= weight;
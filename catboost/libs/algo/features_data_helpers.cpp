@@ -1 +1,68 @@
 #include "features_data_helpers.h"
+
+#include <util/generic/cast.h>
+#include <util/generic/mapfindptr.h>
+
+
+namespace NCB {
+
+    TRawFeaturesDataForApply::TRawFeaturesDataForApply(
+        const TFullModel& model,
+        const TRawObjectsDataProvider& rawObjectsData,
+        const THashMap<ui32, ui32>& columnReorderMap
+    )
+        : RawObjectsData(rawObjectsData)
+        , ConsecutiveSubsetBegin(GetConsecutiveSubsetBegin(rawObjectsData))
+    {
+        const auto& featuresLayout = *rawObjectsData.GetFeaturesLayout();
+        for (const auto& floatFeature : model.ObliviousTrees.FloatFeatures) {
+            if (!floatFeature.UsedInModel()) {
+                continue;
+            }
+            ui32 flatFeatureIdx = SafeIntegerCast<ui32>(floatFeature.FlatFeatureIndex);
+            if (!columnReorderMap.empty()) {
+                const ui32* dataFlatFeatureIdx = MapFindPtr(columnReorderMap, flatFeatureIdx);
+                if (!dataFlatFeatureIdx) {
+                    continue;
+                }
+                flatFeatureIdx = *dataFlatFeatureIdx;
+            }
+            const auto feature = rawObjectsData.GetFloatFeature(
+                featuresLayout.GetInternalFeatureIdx(flatFeatureIdx)
+            );
+            if (feature && !dynamic_cast<const TFloatValuesHolder*>(*feature)) {
+                // subset is consecutive, so values in subset order are values for objects
+                DensifiedFeatures.emplace(
+                    flatFeatureIdx,
+                    dynamic_cast<const TSparseFloatValuesHolder&>(**feature).GetSubsetData().ExtractValues()
+                );
+            }
+        }
+    }
+
+    TConstArrayRef<float> TRawFeaturesDataForApply::GetBlock(
+        ui32 flatFeatureIdx,
+        size_t begin,
+        size_t size
+    ) const {
+        if (const auto* densifiedFeature = MapFindPtr(DensifiedFeatures, flatFeatureIdx)) {
+            return TConstArrayRef<float>(*densifiedFeature).Slice(begin, size);
+        }
+        const auto& featuresLayout = *RawObjectsData.GetFeaturesLayout();
+        if (featuresLayout.GetExternalFeatureType(flatFeatureIdx) == EFeatureType::Float) {
+            const auto feature = RawObjectsData.GetFloatFeature(
+                featuresLayout.GetInternalFeatureIdx(flatFeatureIdx)
+            );
+            if (feature && !dynamic_cast<const TFloatValuesHolder*>(*feature)) {
+                // sparse and not used in model
+                return TConstArrayRef<float>();
+            }
+        }
+        return MakeArrayRef(
+            GetRawFeatureDataBeginPtr(RawObjectsData, featuresLayout, ConsecutiveSubsetBegin, flatFeatureIdx)
+                + begin,
+            size
+        );
+    }
+
+}
@@ -2,6 +2,11 @@
 
 #include <catboost/libs/data_new/objects.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/model/model.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/vector.h>
 
 
 namespace NCB {
@@ -14,8 +19,11 @@ namespace NCB {
 
         const ui32 internalFeatureIdx = featuresLayout.GetInternalFeatureIdx(flatFeatureIdx);
         if (featuresLayout.GetExternalFeatureType(flatFeatureIdx) == EFeatureType::Float) {
-            return (*(*(**rawObjectsData.GetFloatFeature(internalFeatureIdx)).GetArrayData().GetSrc()
-                    )).data() + consecutiveSubsetBegin;
+            const auto* denseFeature = dynamic_cast<const TFloatValuesHolder*>(
+                *rawObjectsData.GetFloatFeature(internalFeatureIdx)
+            );
+            CB_ENSURE_INTERNAL(denseFeature, "Float feature #" << flatFeatureIdx << " is not dense");
+            return (*(*denseFeature->GetArrayData().GetSrc())).data() + consecutiveSubsetBegin;
         } else {
             return reinterpret_cast<const float*>((*(*(**rawObjectsData.GetCatFeature(internalFeatureIdx))
                     .GetArrayData().GetSrc())).data()) + consecutiveSubsetBegin;
@@ -32,4 +40,25 @@ namespace NCB {
         return *maybeConsecutiveSubsetBegin;
     }
 
+    /* Raw features data for model application.
+     * Dense features are accessed in place, sparse float features used in the model are densified
+     * (features not used in the model are not accessed by model application code).
+     */
+    class TRawFeaturesDataForApply {
+    public:
+        TRawFeaturesDataForApply(
+            const TFullModel& model,
+            const TRawObjectsDataProvider& rawObjectsData,
+            const THashMap<ui32, ui32>& columnReorderMap // model flat index -> data flat index
+        );
+
+        // for objects [begin, begin + size)
+        TConstArrayRef<float> GetBlock(ui32 flatFeatureIdx, size_t begin, size_t size) const;
+
+    private:
+        const TRawObjectsDataProvider& RawObjectsData;
+        ui32 ConsecutiveSubsetBegin;
+        THashMap<ui32, TVector<float>> DensifiedFeatures; // flatFeatureIdx -> values
+    };
+
 }
@@ -263,6 +263,26 @@ void TFold::DropEmptyCTRs() {
     }
 }
 
+void TFold::TrimOnlineCTRByMemory(size_t maxMemoryUsage) {
+    TVector<std::pair<ui64, TProjection>> lastUseAndProjections;
+    for (const auto* ctrs : {&OnlineSingleCtrs, &OnlineCTR}) {
+        for (const auto& projCtr : *ctrs) {
+            const auto lastUse = CtrLastUse.find(projCtr.first);
+            lastUseAndProjections.emplace_back(lastUse == CtrLastUse.end() ? 0 : lastUse->second, projCtr.first);
+        }
+    }
+    StableSort(lastUseAndProjections, [] (const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    size_t memoryUsage = 0;
+    for (const auto& lastUseAndProjection : lastUseAndProjections) {
+        const auto& proj = lastUseAndProjection.second;
+        memoryUsage += GetCtr(proj).GetMemoryUsage();
+        if (memoryUsage > maxMemoryUsage) {
+            GetCtrs(proj).erase(proj);
+            CtrLastUse.erase(proj);
+        }
+    }
+}
+
 void TFold::AssignTarget(TMaybeData<TConstArrayRef<float>> target, const TVector<TTargetClassifier>& targetClassifiers) {
     ui32 learnSampleCount = GetLearnSampleCount();
     if (target.Defined()) {
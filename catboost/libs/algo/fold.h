@@ -80,6 +80,7 @@ struct TFold {
     TVector<TVector<int>> LearnTargetClass;
     TVector<int> TargetClassesCount;
     ui32 PermutationBlockSize = FoldPermutationBlockSizeNotSet;
+    TProjectionBucketsHash ProjectionBuckets; // for projections the ctr candidates of the current tree are built on
 
     TOnlineCTRHash& GetCtrs(const TProjection& proj) {
         return proj.HasSingleFeature() ? OnlineSingleCtrs : OnlineCTR;
@@ -125,6 +126,14 @@ struct TFold {
         }
     }
 
+    // marks online ctrs of the projection as recently used for TrimOnlineCTRByMemory
+    void TouchCTR(const TProjection& proj) {
+        CtrLastUse[proj] = ++CtrUseCounter;
+    }
+
+    // drops least recently used online ctrs until memory used by the rest is not greater than maxMemoryUsage
+    void TrimOnlineCTRByMemory(size_t maxMemoryUsage);
+
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
 
     void SaveApproxes(IOutputStream* s) const;
@@ -168,6 +177,8 @@ private:
 
     TOnlineCTRHash OnlineSingleCtrs;
     TOnlineCTRHash OnlineCTR;
+    THashMap<TProjection, ui64> CtrLastUse;
+    ui64 CtrUseCounter = 0;
 
 
     void AssignTarget(NCB::TMaybeData<TConstArrayRef<float>> target,
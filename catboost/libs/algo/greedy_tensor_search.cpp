@@ -14,8 +14,12 @@
 #include <library/dot_product/dot_product.h>
 #include <library/fast_log/fast_log.h>
 
+#include <util/datetime/cputimer.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
 #include <util/string/builder.h>
 #include <util/system/mem_info.h>
+#include <util/system/rusage.h>
 
 
 using namespace NCB;
@@ -23,7 +27,17 @@ using namespace NCB;
 
 constexpr size_t MAX_ONLINE_CTR_FEATURES = 50;
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds) {
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, const TLearnContext& ctx) {
+    const auto& catFeatureParams = ctx.Params.CatFeatureParams.Get();
+    if (catFeatureParams.StreamingOnlineCtrs.Get()) {
+        // cache size is shared by all learn folds and averaging fold
+        const ui64 foldCacheSize =
+            ParseMemorySizeDescription(catFeatureParams.OnlineCtrCacheSize.Get()) / (ctx.LearnProgress.Folds.size() + 1);
+        for (auto& fold : folds) {
+            fold->TrimOnlineCTRByMemory(foldCacheSize);
+        }
+        return;
+    }
     for (auto& fold : folds) {
         fold->TrimOnlineCTR(MAX_ONLINE_CTR_FEATURES);
     }
@@ -207,12 +221,13 @@ static void AddSimpleCtrs(const TQuantizedForCPUObjectsDataProvider& learnObject
     );
 }
 
-static void AddTreeCtrs(const TQuantizedForCPUObjectsDataProvider& learnObjectsData,
+static void AddTreeCtrs(const TTrainingForCPUDataProviders& data,
                         const TSplitTree& currentTree,
                         TFold* fold,
                         TLearnContext* ctx,
                         TBucketStatsCache* statsFromPrevTree,
                         TCandidateList* candList) {
+    const auto& learnObjectsData = *data.Learn->ObjectsData;
     const auto& quantizedFeaturesInfo = *learnObjectsData.GetQuantizedFeaturesInfo();
     const auto& featuresLayout = *learnObjectsData.GetFeaturesLayout();
     const ui32 oneHotMaxSize = ctx->Params.CatFeatureParams.Get().OneHotMaxSize;
@@ -230,11 +245,20 @@ static void AddTreeCtrs(const TQuantizedForCPUObjectsDataProvider& learnObjectsD
         seenProj.insert(ctrSplit.Projection);
     }
 
+    // buckets of projections are reused only if online ctrs are not limited by ctr_leaf_count_limit
+    const bool storeProjectionBuckets =
+        ctx->Params.CatFeatureParams->CtrLeafCountLimit >= learnObjectsData.GetObjectCount();
+    EraseNodesIf(
+        fold->ProjectionBuckets,
+        [&] (const auto& projectionBuckets) { return !seenProj.contains(projectionBuckets.first); }
+    );
+
     TSeenProjHash addedProjHash;
     for (const auto& baseProj : seenProj) {
         if (baseProj.IsEmpty()) {
             continue;
         }
+        bool isBaseOfAddedProj = false;
         featuresLayout.IterateOverAvailableFeatures<EFeatureType::Categorical>(
             [&](TCatFeatureIdx catFeatureIdx) {
                 const bool isOneHot =
@@ -255,11 +279,17 @@ static void AddTreeCtrs(const TQuantizedForCPUObjectsDataProvider& learnObjectsD
                 }
 
                 addedProjHash.insert(proj);
+                isBaseOfAddedProj = true;
 
                 AddCtrsToCandList(*fold, *ctx, proj, candList);
                 fold->GetCtrRef(proj);
             }
         );
+        if (storeProjectionBuckets && isBaseOfAddedProj && !fold->ProjectionBuckets.contains(baseProj)) {
+            TProjectionBuckets baseProjBuckets;
+            CalcProjectionBuckets(data, *fold, baseProj, ctx, &baseProjBuckets);
+            fold->ProjectionBuckets.emplace(baseProj, std::move(baseProjBuckets));
+        }
     }
     if (ctx->UseTreeLevelCaching()) {
         THashSet<TSplitCandidate> candidatesToErase;
@@ -317,19 +347,56 @@ static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
     }
 }
 
-static void CalcBestScore(const TTrainingForCPUDataProviders& data,
+namespace {
+    using TAllCtrs = std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>;
+
+    /* Thread utilization of score calculation: busy time relative to wall time of all threads.
+     * Busy time is user CPU time of the process, so that only actual work of tasks and of their nested
+     * doc block tasks is counted, and not time threads spend waiting for nested tasks in WAIT_COMPLETE
+     * (it is spent blocked or yielding in kernel).
+     */
+    struct TScoreCalcUtilization {
+        double BusySeconds = 0;
+        double WallSeconds = 0;
+        int ThreadCount = 1;
+
+        double Get() const {
+            return WallSeconds > 0 ? BusySeconds / (WallSeconds * ThreadCount) : 1.0;
+        }
+    };
+
+    struct TScoreCalcTask {
+        int CandidateIdx;
+        int SubCandidateIdx;
+        int Cost;
+    };
+}
+
+/* Candidates, which online ctrs are kept after calculation, are scored as one flat list of
+ * (candidate, subcandidate) tasks ordered by decreasing bucket count, so that threads are balanced
+ * both when there are few candidates with many subcandidates and when there are many small candidates.
+ * Each task also parallelizes stats calculation over document blocks in the same executor.
+ * Candidates with ctrs dropped after calculation are processed one by one to bound memory.
+ * With streaming online ctrs, candidates which ctrs are not cached are processed one by one too,
+ * and only values of one ctr of the candidate projection are kept while its subcandidates are scored.
+ * calcScores(allCtrs, splitCandidate, &scores) is called for each subcandidate,
+ * results are in allScores[candIdx][subCandidateIdx].
+ */
+template <class TScores, class TCalcScores>
+static void CalcScoresForCandidates(const TTrainingForCPUDataProviders& data,
         const TVector<int>& splitCounts,
-        int currentDepth,
-        ui64 randSeed,
-        double scoreStDev,
+        const TCalcScores& calcScores,
         TCandidateList* candidateList,
         TFold* fold,
-        TLearnContext* ctx) {
+        TLearnContext* ctx,
+        TScoreCalcUtilization* utilization,
+        TVector<TVector<TScores>>* allScores) {
     CB_ENSURE(static_cast<ui32>(ctx->LocalExecutor->GetThreadCount()) == ctx->Params.SystemOptions->NumThreads - 1);
-    const TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
     TCandidateList& candList = *candidateList;
-    ctx->LocalExecutor->ExecRange([&](int id) {
-        auto& candidate = candList[id];
+    const THPTimer wallTimer;
+    const TDuration userTimeAtStart = TRusage::Get().Utime;
+
+    const auto computeCtrIfNeeded = [&](const TCandidatesInfoList& candidate) {
         if (candidate.Candidates[0].SplitCandidate.Type == ESplitType::OnlineCtr) {
             const auto& proj = candidate.Candidates[0].SplitCandidate.Ctr.Projection;
             if (fold->GetCtrRef(proj).Feature.empty()) {
@@ -340,37 +407,314 @@ static void CalcBestScore(const TTrainingForCPUDataProviders& data,
                                   &fold->GetCtrRef(proj));
             }
         }
-        TVector<TVector<double>> allScores(candidate.Candidates.size());
-        ctx->LocalExecutor->ExecRange([&](int oneCandidate) {
-            if (candidate.Candidates[oneCandidate].SplitCandidate.Type == ESplitType::OnlineCtr) {
-                const auto& proj = candidate.Candidates[oneCandidate].SplitCandidate.Ctr.Projection;
-                Y_ASSERT(!fold->GetCtrRef(proj).Feature.empty());
+    };
+    const auto calcScoresWithFoldCtrs = [&](const TCandidatesInfoList& candidate, int oneCandidate, TScores* scores) {
+        const auto& splitCandidate = candidate.Candidates[oneCandidate].SplitCandidate;
+        if (splitCandidate.Type == ESplitType::OnlineCtr) {
+            Y_ASSERT(!fold->GetCtrRef(splitCandidate.Ctr.Projection).Feature.empty());
+        }
+        calcScores(fold->GetAllCtrs(), splitCandidate, scores);
+    };
+
+    const bool isStreamingOnlineCtrs = ctx->Params.CatFeatureParams->StreamingOnlineCtrs.Get();
+    TVector<int> keptCtrCandidates;
+    TVector<int> droppedCtrCandidates;
+    TVector<int> streamedCtrCandidates;
+    for (int candIdx : xrange(candList.ysize())) {
+        const auto& splitCandidate = candList[candIdx].Candidates[0].SplitCandidate;
+        if (isStreamingOnlineCtrs && splitCandidate.Type == ESplitType::OnlineCtr) {
+            if (fold->GetCtrRef(splitCandidate.Ctr.Projection).Feature.empty()) {
+                streamedCtrCandidates.push_back(candIdx);
+                continue;
             }
-            TVector<TScoreBin> scoreBins;
-            CalcStatsAndScores(*data.Learn->ObjectsData,
+            fold->TouchCTR(splitCandidate.Ctr.Projection);
+        }
+        if (candList[candIdx].ShouldDropCtrAfterCalc) {
+            droppedCtrCandidates.push_back(candIdx);
+        } else {
+            keptCtrCandidates.push_back(candIdx);
+        }
+    }
+
+    allScores->clear();
+    allScores->resize(candList.size());
+    TVector<TScoreCalcTask> tasks;
+    for (int candIdx : keptCtrCandidates) {
+        (*allScores)[candIdx].resize(candList[candIdx].Candidates.size());
+        for (int oneCandidate : xrange(candList[candIdx].Candidates.ysize())) {
+            const auto& split = candList[candIdx].Candidates[oneCandidate].SplitCandidate;
+            const int cost = GetSplitCount(splitCounts, *data.Learn->ObjectsData->GetQuantizedFeaturesInfo(), split);
+            tasks.push_back({candIdx, oneCandidate, cost});
+        }
+    }
+    ctx->LocalExecutor->ExecRange([&](int idx) {
+        computeCtrIfNeeded(candList[keptCtrCandidates[idx]]);
+    }, 0, keptCtrCandidates.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    StableSort(tasks, [](const TScoreCalcTask& lhs, const TScoreCalcTask& rhs) {
+        return lhs.Cost > rhs.Cost;
+    });
+    ctx->LocalExecutor->ExecRange([&](int taskIdx) {
+        const auto& task = tasks[taskIdx];
+        calcScoresWithFoldCtrs(candList[task.CandidateIdx], task.SubCandidateIdx, &(*allScores)[task.CandidateIdx][task.SubCandidateIdx]);
+    }, 0, tasks.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    ctx->LocalExecutor->ExecRange([&](int idx) {
+        const int candIdx = droppedCtrCandidates[idx];
+        auto& candidate = candList[candIdx];
+        computeCtrIfNeeded(candidate);
+        (*allScores)[candIdx].resize(candidate.Candidates.size());
+        ctx->LocalExecutor->ExecRange([&](int oneCandidate) {
+            calcScoresWithFoldCtrs(candidate, oneCandidate, &(*allScores)[candIdx][oneCandidate]);
+        }, NPar::TLocalExecutor::TExecRangeParams(0, candidate.Candidates.ysize())
+         , NPar::TLocalExecutor::WAIT_COMPLETE);
+        if (candidate.Candidates[0].SplitCandidate.Type == ESplitType::OnlineCtr) {
+            fold->GetCtrRef(candidate.Candidates[0].SplitCandidate.Ctr.Projection).Feature.clear();
+        }
+    }, 0, droppedCtrCandidates.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    ctx->LocalExecutor->ExecRange([&](int idx) {
+        const int candIdx = streamedCtrCandidates[idx];
+        const auto& candidate = candList[candIdx];
+        (*allScores)[candIdx].resize(candidate.Candidates.size());
+        const auto& proj = candidate.Candidates[0].SplitCandidate.Ctr.Projection;
+        TOnlineCTRHash streamedCtrs;
+        TOnlineCTR& streamedCtr = streamedCtrs[proj];
+        const TAllCtrs allStreamedCtrs(streamedCtrs, streamedCtrs);
+        ComputeOnlineCTRsByOne(
+            data,
+            *fold,
+            proj,
+            ctx,
+            [&] (int ctrIdx) {
+                TVector<int> ctrSubCandidates;
+                for (int oneCandidate : xrange(candidate.Candidates.ysize())) {
+                    if (candidate.Candidates[oneCandidate].SplitCandidate.Ctr.CtrIdx == ctrIdx) {
+                        ctrSubCandidates.push_back(oneCandidate);
+                    }
+                }
+                ctx->LocalExecutor->ExecRange([&](int subCandidateIdx) {
+                    const int oneCandidate = ctrSubCandidates[subCandidateIdx];
+                    calcScores(
+                        allStreamedCtrs,
+                        candidate.Candidates[oneCandidate].SplitCandidate,
+                        &(*allScores)[candIdx][oneCandidate]);
+                }, NPar::TLocalExecutor::TExecRangeParams(0, ctrSubCandidates.ysize())
+                 , NPar::TLocalExecutor::WAIT_COMPLETE);
+            },
+            &streamedCtr);
+        // unique value counts are used for model size regularization, values are dropped as for ShouldDropCtrAfterCalc
+        TOnlineCTR& foldCtr = fold->GetCtrRef(proj);
+        foldCtr.UniqueValuesCount = streamedCtr.UniqueValuesCount;
+        foldCtr.CounterUniqueValuesCount = streamedCtr.CounterUniqueValuesCount;
+    }, 0, streamedCtrCandidates.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    utilization->BusySeconds += (TRusage::Get().Utime - userTimeAtStart).SecondsFloat();
+    utilization->WallSeconds += wallTimer.Passed();
+    utilization->ThreadCount = ctx->LocalExecutor->GetThreadCount() + 1;
+}
+
+static void CalcBestScore(const TTrainingForCPUDataProviders& data,
+        const TVector<int>& splitCounts,
+        int currentDepth,
+        ui64 randSeed,
+        double scoreStDev,
+        TCandidateList* candidateList,
+        TFold* fold,
+        TLearnContext* ctx,
+        TScoreCalcUtilization* utilization) {
+    const TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
+    const auto calcScores = [&](const TAllCtrs& allCtrs, const TSplitCandidate& splitCandidate, TVector<double>* scores) {
+        TVector<TScoreBin> scoreBins;
+        CalcStatsAndScores(*data.Learn->ObjectsData,
+                           splitCounts,
+                           allCtrs,
+                           ctx->SampledDocs,
+                           ctx->SmallestSplitSideDocs,
+                           fold,
+                           pairs,
+                           ctx->Params,
+                           splitCandidate,
+                           currentDepth,
+                           ctx->UseTreeLevelCaching(),
+                           ctx->LocalExecutor,
+                           &ctx->PrevTreeLevelStats,
+                           /*stats3d*/nullptr,
+                           /*pairwiseStats*/nullptr,
+                           &scoreBins);
+        *scores = GetScores(scoreBins);
+    };
+    TVector<TVector<TVector<double>>> allScores;
+    CalcScoresForCandidates(data, splitCounts, calcScores, candidateList, fold, ctx, utilization, &allScores);
+
+    TCandidateList& candList = *candidateList;
+    for (int candIdx : xrange(candList.ysize())) {
+        SetBestScore(randSeed + candIdx, allScores[candIdx], scoreStDev, &candList[candIdx].Candidates);
+    }
+}
+
+// allLeafScoreBins[candIdx][subCandidateIdx][leaf][binIdx], see CalcStatsAndLeafScores
+static void CalcLeafScoreBins(const TTrainingForCPUDataProviders& data,
+        const TVector<int>& splitCounts,
+        int currentDepth,
+        TCandidateList* candidateList,
+        TFold* fold,
+        TLearnContext* ctx,
+        TScoreCalcUtilization* utilization,
+        TVector<TVector<TVector<TVector<TScoreBin>>>>* allLeafScoreBins) {
+    const auto calcScoreBins = [&](const TAllCtrs& allCtrs, const TSplitCandidate& splitCandidate, TVector<TVector<TScoreBin>>* leafScoreBins) {
+        CalcStatsAndLeafScores(*data.Learn->ObjectsData,
                                splitCounts,
-                               fold->GetAllCtrs(),
+                               allCtrs,
                                ctx->SampledDocs,
                                ctx->SmallestSplitSideDocs,
-                               fold,
-                               pairs,
+                               *fold,
                                ctx->Params,
-                               candidate.Candidates[oneCandidate].SplitCandidate,
+                               splitCandidate,
                                currentDepth,
                                ctx->UseTreeLevelCaching(),
                                ctx->LocalExecutor,
                                &ctx->PrevTreeLevelStats,
-                               /*stats3d*/nullptr,
-                               /*pairwiseStats*/nullptr,
-                               &scoreBins);
-            allScores[oneCandidate] = GetScores(scoreBins);
-        }, NPar::TLocalExecutor::TExecRangeParams(0, candidate.Candidates.ysize())
-         , NPar::TLocalExecutor::WAIT_COMPLETE);
-        if (candidate.Candidates[0].SplitCandidate.Type == ESplitType::OnlineCtr && candidate.ShouldDropCtrAfterCalc) {
-            fold->GetCtrRef(candidate.Candidates[0].SplitCandidate.Ctr.Projection).Feature.clear();
+                               leafScoreBins);
+    };
+    CalcScoresForCandidates(data, splitCounts, calcScoreBins, candidateList, fold, ctx, utilization, allLeafScoreBins);
+}
+
+static size_t CalcMaxFeatureValueCount(const TCandidateList& candList, TFold* fold) {
+    size_t maxFeatureValueCount = 1;
+    for (const auto& candidate : candList) {
+        const auto& split = candidate.Candidates[0].SplitCandidate;
+        if (split.Type == ESplitType::OnlineCtr) {
+            const auto& proj = split.Ctr.Projection;
+            maxFeatureValueCount = Max(maxFeatureValueCount, fold->GetCtrRef(proj).GetMaxUniqueValueCount());
+        }
+    }
+    return maxFeatureValueCount;
+}
+
+// penalizes ctrs that are not used in the model yet by their unique value count
+static double CalcModelSizeRegMultiplier(const TCandidateInfo& candidate,
+        size_t maxFeatureValueCount,
+        TFold* fold,
+        const TLearnContext& ctx) {
+    if (candidate.SplitCandidate.Type != ESplitType::OnlineCtr) {
+        return 1.0;
+    }
+    const TProjection& projection = candidate.SplitCandidate.Ctr.Projection;
+    const ECtrType ctrType = ctx.CtrsHelper.GetCtrInfo(projection)[candidate.SplitCandidate.Ctr.CtrIdx].Type;
+    if (ctx.LearnProgress.UsedCtrSplits.contains(std::make_pair(ctrType, projection))) {
+        return 1.0;
+    }
+    return pow(
+        1 + fold->GetCtrRef(projection).GetUniqueValueCountForType(ctrType) / static_cast<double>(maxFeatureValueCount),
+        -ctx.Params.ObliviousTreeOptions->ModelSizeReg.Get()
+    );
+}
+
+static void PrepareCtrForSplit(const TTrainingForCPUDataProviders& data,
+        const TSplit& split,
+        TFold* fold,
+        TLearnContext* ctx) {
+    if (split.Type != ESplitType::OnlineCtr) {
+        return;
+    }
+    const TProjection& proj = split.Ctr.Projection;
+    const ECtrType ctrType = ctx->CtrsHelper.GetCtrInfo(proj)[split.Ctr.CtrIdx].Type;
+    ctx->LearnProgress.UsedCtrSplits.insert(std::make_pair(ctrType, proj));
+    fold->TouchCTR(proj);
+    if (fold->GetCtrRef(proj).Feature.empty()) {
+        ComputeOnlineCTRs(data,
+                          *fold,
+                          proj,
+                          ctx,
+                          &fold->GetCtrRef(proj));
+        if (ctx->UseTreeLevelCaching()) {
+            DropStatsForProjection(*fold, *ctx, proj, &ctx->PrevTreeLevelStats);
         }
-        SetBestScore(randSeed + id, allScores, scoreStDev, &candidate.Candidates);
-    }, 0, candList.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+}
+
+namespace {
+    struct TLeafSplit {
+        int LeafIdx = 0;
+        TSplit Split;
+        double Score = MINIMAL_SCORE;
+        double Gain = 0;
+    };
+}
+
+/* Selects the best split for every leaf of the current depth by randomized score and then keeps at most
+ * maxNewLeafCount leaves with the largest gain of score over the leaf without split, gain is calculated
+ * with the same score function as used for split selection.
+ * Result is ordered by leaf index.
+ */
+static TVector<TLeafSplit> SelectLeafSplits(ui64 randSeed,
+        double scoreStDev,
+        const TVector<TVector<TVector<TVector<TScoreBin>>>>& allLeafScoreBins,
+        const TCandidateList& candList,
+        ui32 maxNewLeafCount,
+        int currentDepth,
+        TFold* fold,
+        const TLearnContext& ctx) {
+    const size_t maxFeatureValueCount = CalcMaxFeatureValueCount(candList, fold);
+    TVector<TVector<double>> modelSizeRegMultipliers(candList.size());
+    for (int candIdx : xrange(candList.ysize())) {
+        for (const auto& candidate : candList[candIdx].Candidates) {
+            modelSizeRegMultipliers[candIdx].push_back(CalcModelSizeRegMultiplier(candidate, maxFeatureValueCount, fold, ctx));
+        }
+    }
+
+    TRestorableFastRng64 rand(randSeed);
+    const int leafCount = 1 << currentDepth;
+    TVector<TLeafSplit> leafSplits;
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        TLeafSplit best;
+        best.LeafIdx = leaf;
+        for (int candIdx : xrange(candList.ysize())) {
+            for (int subCandidateIdx : xrange(candList[candIdx].Candidates.ysize())) {
+                const auto& scoreBins = allLeafScoreBins[candIdx][subCandidateIdx][leaf];
+                const double multiplier = modelSizeRegMultipliers[candIdx][subCandidateIdx];
+                for (int binIdx = 0; binIdx + 1 < scoreBins.ysize(); ++binIdx) {
+                    const double score = TRandomScore(scoreBins[binIdx].GetScore(), scoreStDev).GetInstance(rand) * multiplier;
+                    if (score > best.Score) {
+                        best.Score = score;
+                        best.Split = TSplit(candList[candIdx].Candidates[subCandidateIdx].SplitCandidate, binIdx);
+                        best.Gain = scoreBins[binIdx].GetScore() - scoreBins.back().GetScore();
+                    }
+                }
+            }
+        }
+        if (best.Score != MINIMAL_SCORE && best.Gain > 0) {
+            leafSplits.push_back(best);
+        }
+    }
+    if (leafSplits.size() > maxNewLeafCount) {
+        PartialSort(leafSplits.begin(), leafSplits.begin() + maxNewLeafCount, leafSplits.end(),
+            [] (const TLeafSplit& lhs, const TLeafSplit& rhs) { return lhs.Gain > rhs.Gain; });
+        leafSplits.resize(maxNewLeafCount);
+        Sort(leafSplits, [] (const TLeafSplit& lhs, const TLeafSplit& rhs) { return lhs.LeafIdx < rhs.LeafIdx; });
+    }
+    return leafSplits;
+}
+
+static TCandidateList CreateCandidateList(const TTrainingForCPUDataProviders& data,
+        const TSplitTree& currentSplitTree,
+        TFold* fold,
+        TLearnContext* ctx) {
+    TCandidateList candList;
+    AddFloatFeatures(*data.Learn->ObjectsData, ctx, &ctx->PrevTreeLevelStats, &candList);
+    AddOneHotFeatures(*data.Learn->ObjectsData, ctx, &ctx->PrevTreeLevelStats, &candList);
+    AddSimpleCtrs(*data.Learn->ObjectsData, fold, ctx, &ctx->PrevTreeLevelStats, &candList);
+    AddTreeCtrs(data, currentSplitTree, fold, ctx, &ctx->PrevTreeLevelStats, &candList);
+
+    if (ctx->Params.CatFeatureParams->StreamingOnlineCtrs.Get()) {
+        // ctrs which are not cached are not materialized, see CalcScoresForCandidates
+        return candList;
+    }
+    auto IsInCache = [&fold](const TProjection& proj) -> bool {return fold->GetCtrRef(proj).Feature.empty();};
+    auto cpuUsedRamLimit = ParseMemorySizeDescription(ctx->Params.SystemOptions->CpuUsedRamLimit.Get());
+    const ui32 sampleCount = data.Learn->ObjectsData->GetObjectCount() + data.GetTestSampleCount();
+    SelectCtrsToDropAfterCalc(cpuUsedRamLimit, sampleCount, ctx->Params.SystemOptions->NumThreads, IsInCache, &candList);
+    return candList;
 }
 
 void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
@@ -381,10 +725,9 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
                         TLearnContext* ctx,
                         TSplitTree* resSplitTree) {
     TSplitTree currentSplitTree;
-    TrimOnlineCTRcache({fold});
+    TrimOnlineCTRcache({fold}, *ctx);
 
     ui32 learnSampleCount = data.Learn->ObjectsData->GetObjectCount();
-    ui32 testSampleCount = data.GetTestSampleCount();
     TVector<TIndexType> indices(learnSampleCount); // always for all documents
     CATBOOST_INFO_LOG << "\n";
 
@@ -392,6 +735,7 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         MapTensorSearchStart(ctx);
     }
 
+    TScoreCalcUtilization scoreCalcUtilization;
     const bool isSamplingPerTree = IsSamplingPerTree(ctx->Params.ObliviousTreeOptions);
     if (isSamplingPerTree) {
         if (!ctx->Params.SystemOptions->IsSingleHost()) {
@@ -404,17 +748,12 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         }
     }
     const bool isPairwiseScoring = IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction());
+    const bool isDepthwise = ctx->Params.ObliviousTreeOptions->GrowingPolicy == EGrowingPolicy::Depthwise;
+    const ui32 maxLeaves = ctx->Params.ObliviousTreeOptions->MaxLeaves;
+    ui32 leafCount = 1; // non-symmetric trees only
 
     for (ui32 curDepth = 0; curDepth < ctx->Params.ObliviousTreeOptions->MaxDepth; ++curDepth) {
-        TCandidateList candList;
-        AddFloatFeatures(*data.Learn->ObjectsData, ctx, &ctx->PrevTreeLevelStats, &candList);
-        AddOneHotFeatures(*data.Learn->ObjectsData, ctx, &ctx->PrevTreeLevelStats, &candList);
-        AddSimpleCtrs(*data.Learn->ObjectsData, fold, ctx, &ctx->PrevTreeLevelStats, &candList);
-        AddTreeCtrs(*data.Learn->ObjectsData, currentSplitTree, fold, ctx, &ctx->PrevTreeLevelStats, &candList);
-
-        auto IsInCache = [&fold](const TProjection& proj) -> bool {return fold->GetCtrRef(proj).Feature.empty();};
-        auto cpuUsedRamLimit = ParseMemorySizeDescription(ctx->Params.SystemOptions->CpuUsedRamLimit.Get());
-        SelectCtrsToDropAfterCalc(cpuUsedRamLimit, learnSampleCount + testSampleCount, ctx->Params.SystemOptions->NumThreads, IsInCache, &candList);
+        TCandidateList candList = CreateCandidateList(data, currentSplitTree, fold, ctx);
 
         CheckInterrupted(); // check after long-lasting operation
         if (!isSamplingPerTree) {
@@ -430,6 +769,51 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             ctx->Params.ObliviousTreeOptions->RandomStrength
             * CalcDerivativesStDevFromZero(*fold, ctx->Params.BoostingOptions->BoostingType)
             * CalcDerivativesStDevFromZeroMultiplier(learnSampleCount, modelLength);
+
+        if (isDepthwise) {
+            Y_ASSERT(ctx->Params.SystemOptions->IsSingleHost());
+            const ui64 randSeed = ctx->Rand.GenRand();
+            TVector<TVector<TVector<TVector<TScoreBin>>>> allLeafScoreBins;
+            CalcLeafScoreBins(data, splitCounts, curDepth, &candList, fold, ctx, &scoreCalcUtilization, &allLeafScoreBins);
+            const auto leafSplits = SelectLeafSplits(
+                randSeed,
+                scoreStDev,
+                allLeafScoreBins,
+                candList,
+                maxLeaves - leafCount,
+                curDepth,
+                fold,
+                *ctx);
+
+            fold->DropEmptyCTRs();
+            CheckInterrupted(); // check after long-lasting operation
+            profile.AddOperation(TStringBuilder() << "Calc scores " << curDepth);
+
+            if (leafSplits.empty()) {
+                break;
+            }
+            for (const auto& leafSplit : leafSplits) {
+                PrepareCtrForSplit(data, leafSplit.Split, fold, ctx);
+                SetPermutedIndices(leafSplit.Split, *data.Learn->ObjectsData, curDepth + 1, *fold, &indices, ctx->LocalExecutor, leafSplit.LeafIdx);
+                currentSplitTree.AddLeafSplit(leafSplit.Split, curDepth, leafSplit.LeafIdx);
+                CATBOOST_INFO_LOG << "leaf " << leafSplit.LeafIdx << ": " << BuildDescription(*ctx->Layout, leafSplit.Split)
+                    << " score " << leafSplit.Score << " gain " << leafSplit.Gain << "\n";
+            }
+            if (isSamplingPerTree) {
+                ctx->SampledDocs.UpdateIndices(indices, ctx->LocalExecutor);
+                if (ctx->UseTreeLevelCaching()) {
+                    ctx->SmallestSplitSideDocs.SelectSmallestSplitSide(curDepth + 1, ctx->SampledDocs, ctx->LocalExecutor);
+                }
+            }
+            profile.AddOperation(TStringBuilder() << "Select best splits " << curDepth);
+
+            leafCount += leafSplits.size();
+            if (leafCount >= maxLeaves) {
+                break;
+            }
+            continue;
+        }
+
         if (!ctx->Params.SystemOptions->IsSingleHost()) {
             if (isPairwiseScoring) {
                 MapRemotePairwiseCalcScore(scoreStDev, &candList, ctx);
@@ -438,17 +822,10 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             }
         } else {
             const ui64 randSeed = ctx->Rand.GenRand();
-            CalcBestScore(data, splitCounts, currentSplitTree.GetDepth(), randSeed, scoreStDev, &candList, fold, ctx);
+            CalcBestScore(data, splitCounts, currentSplitTree.GetDepth(), randSeed, scoreStDev, &candList, fold, ctx, &scoreCalcUtilization);
         }
 
-        size_t maxFeatureValueCount = 1;
-        for (const auto& candidate : candList) {
-            const auto& split = candidate.Candidates[0].SplitCandidate;
-            if (split.Type == ESplitType::OnlineCtr) {
-                const auto& proj = split.Ctr.Projection;
-                maxFeatureValueCount = Max(maxFeatureValueCount, fold->GetCtrRef(proj).GetMaxUniqueValueCount());
-            }
-        }
+        const size_t maxFeatureValueCount = CalcMaxFeatureValueCount(candList, fold);
 
         fold->DropEmptyCTRs();
         CheckInterrupted(); // check after long-lasting operation
@@ -460,17 +837,8 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             for (const auto& candidate : subList.Candidates) {
                 double score = candidate.BestScore.GetInstance(ctx->Rand);
                 // CATBOOST_INFO_LOG << BuildDescription(ctx->Layout, candidate.SplitCandidate) << " = " << score << "\t";
-                TProjection projection = candidate.SplitCandidate.Ctr.Projection;
-                ECtrType ctrType = ctx->CtrsHelper.GetCtrInfo(projection)[candidate.SplitCandidate.Ctr.CtrIdx].Type;
-
-                if (candidate.SplitCandidate.Type == ESplitType::OnlineCtr &&
-                    !ctx->LearnProgress.UsedCtrSplits.contains(std::make_pair(ctrType, projection)) &&
-                    score != MINIMAL_SCORE)
-                {
-                    score *= pow(
-                        1 + fold->GetCtrRef(projection).GetUniqueValueCountForType(ctrType) / static_cast<double>(maxFeatureValueCount),
-                        -ctx->Params.ObliviousTreeOptions->ModelSizeReg.Get()
-                    );
+                if (score != MINIMAL_SCORE) {
+                    score *= CalcModelSizeRegMultiplier(candidate, maxFeatureValueCount, fold, *ctx);
                 }
                 if (score > bestScore) {
                     bestScore = score;
@@ -483,26 +851,8 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             break;
         }
         Y_ASSERT(bestSplitCandidate != nullptr);
-        if (bestSplitCandidate->SplitCandidate.Type == ESplitType::OnlineCtr) {
-            TProjection projection = bestSplitCandidate->SplitCandidate.Ctr.Projection;
-            ECtrType ctrType = ctx->CtrsHelper.GetCtrInfo(projection)[bestSplitCandidate->SplitCandidate.Ctr.CtrIdx].Type;
-
-            ctx->LearnProgress.UsedCtrSplits.insert(std::make_pair(ctrType, projection));
-        }
         auto bestSplit = TSplit(bestSplitCandidate->SplitCandidate, bestSplitCandidate->BestBinBorderId);
-        if (bestSplit.Type == ESplitType::OnlineCtr) {
-            const auto& proj = bestSplit.Ctr.Projection;
-            if (fold->GetCtrRef(proj).Feature.empty()) {
-                ComputeOnlineCTRs(data,
-                                  *fold,
-                                  proj,
-                                  ctx,
-                                  &fold->GetCtrRef(proj));
-                if (ctx->UseTreeLevelCaching()) {
-                    DropStatsForProjection(*fold, *ctx, proj, &ctx->PrevTreeLevelStats);
-                }
-            }
-        }
+        PrepareCtrForSplit(data, bestSplit, fold, ctx);
 
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             SetPermutedIndices(bestSplit, *data.Learn->ObjectsData, curDepth + 1, *fold, &indices, ctx->LocalExecutor);
@@ -534,5 +884,8 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             break;
         }
     }
+    if (ctx->Params.SystemOptions->IsSingleHost()) {
+        CATBOOST_DEBUG_LOG << "Score calculation thread utilization " << scoreCalcUtilization.Get() << Endl;
+    }
     *resSplitTree = std::move(currentSplitTree);
 }
@@ -7,7 +7,7 @@
 
 #include <util/generic/vector.h>
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds);
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, const TLearnContext& ctx);
 
 void GreedyTensorSearch(const NCB::TTrainingForCPUDataProviders& data,
                         const TVector<int>& splitCounts,
@@ -28,10 +28,17 @@ static inline ui8 GetFeatureSplitIdx(const TSplit& split) {
     return split.BinBorder;
 }
 
+// sparse bins are decoded to denseBinsStorage because they are accessed by permutation
 static inline const ui8* GetFloatHistogram(
     const TSplit& split,
-    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    TVector<ui8>* denseBinsStorage
 ) {
+    const auto* sparseBins = objectsDataProvider.GetFloatFeatureSparseBins((ui32)split.FeatureIdx);
+    if (sparseBins) {
+        *denseBinsStorage = sparseBins->ExtractValues();
+        return denseBinsStorage->data();
+    }
     return *(*objectsDataProvider.GetFloatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc();
 }
 
@@ -42,8 +49,8 @@ static inline const ui32* GetRemappedCatFeatures(
     return *(*objectsDataProvider.GetCatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc();
 }
 
-template <typename TCount, bool (*CmpOp)(TCount, TCount), int vectorWidth>
-void BuildIndicesKernel(const ui32* permutation, const TCount* histogram, TCount value, int level, TIndexType* indices) {
+template <typename TCount, bool (*CmpOp)(TCount, TCount), int vectorWidth, typename THistogram>
+void BuildIndicesKernel(const ui32* permutation, THistogram histogram, TCount value, int level, TIndexType* indices) {
     Y_ASSERT(vectorWidth == 4);
     const ui32 perm0 = permutation[0];
     const ui32 perm1 = permutation[1];
@@ -63,16 +70,27 @@ void BuildIndicesKernel(const ui32* permutation, const TCount* histogram, TCount
     indices[3] = idx3 + CmpOp(hist3, value) * level;
 }
 
-template <typename TCount, bool (*CmpOp)(TCount, TCount)>
+// histogram is a raw array or an accessor with operator[] like TPackedBinaryBins
+// if leafIdx is defined (non-symmetric trees) only objects in this leaf are updated
+template <typename TCount, bool (*CmpOp)(TCount, TCount), typename THistogram>
 void OfflineCtrBlock(const NPar::TLocalExecutor::TExecRangeParams& params,
                      int blockIdx,
                      const ui32* permutation,
-                     const TCount* histogram,
+                     THistogram histogram,
                      TCount value,
                      int level,
-                     TIndexType* indices) {
+                     TIndexType* indices,
+                     TMaybe<TIndexType> leafIdx = Nothing()) {
     const int blockStart = blockIdx * params.GetBlockSize();
     const int nextBlockStart = Min<ui64>(blockStart + params.GetBlockSize(), params.LastId);
+    if (leafIdx) {
+        for (int doc = blockStart; doc < nextBlockStart; ++doc) {
+            if (indices[doc] == *leafIdx) {
+                indices[doc] += CmpOp(histogram[permutation[doc]], value) * level;
+            }
+        }
+        return;
+    }
     constexpr int vectorWidth = 4;
     int doc;
     for (doc = blockStart; doc + vectorWidth <= nextBlockStart; doc += vectorWidth) {
@@ -89,7 +107,8 @@ void SetPermutedIndices(const TSplit& split,
                         int curDepth,
                         const TFold& fold,
                         TVector<TIndexType>* indices,
-                        NPar::TLocalExecutor* localExecutor) {
+                        NPar::TLocalExecutor* localExecutor,
+                        TMaybe<TIndexType> leafIdx) {
     CB_ENSURE(curDepth > 0);
 
     const int blockSize = 1000;
@@ -99,16 +118,29 @@ void SetPermutedIndices(const TSplit& split,
     const int splitWeight = 1 << (curDepth - 1);
     TIndexType* indicesData = indices->data();
     if (split.Type == ESplitType::FloatFeature) {
+        const auto packedBinaryBins = objectsDataProvider.GetFloatFeaturePackedBinaryBins((ui32)split.FeatureIdx);
+        TVector<ui8> denseBinsStorage;
+        const ui8* histogram =
+            packedBinaryBins ? nullptr : GetFloatHistogram(split, objectsDataProvider, &denseBinsStorage);
         localExecutor->ExecRange([&](int blockIdx) {
-            OfflineCtrBlock<ui8, IsTrueHistogram>(blockParams, blockIdx,
-                fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
-                GetFloatHistogram(split, objectsDataProvider),
-                GetFeatureSplitIdx(split), splitWeight, indicesData);
+            if (packedBinaryBins) {
+                OfflineCtrBlock<ui8, IsTrueHistogram>(blockParams, blockIdx,
+                    fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
+                    *packedBinaryBins,
+                    GetFeatureSplitIdx(split), splitWeight, indicesData, leafIdx);
+            } else {
+                OfflineCtrBlock<ui8, IsTrueHistogram>(blockParams, blockIdx,
+                    fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
+                    histogram,
+                    GetFeatureSplitIdx(split), splitWeight, indicesData, leafIdx);
+            }
         }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
     } else if (split.Type == ESplitType::OnlineCtr) {
         auto& ctr = fold.GetCtr(split.Ctr.Projection);
         localExecutor->ExecRange([&] (int i) {
-            indicesData[i] += GetCtrSplit(split, i, ctr) * splitWeight;
+            if (!leafIdx || indicesData[i] == *leafIdx) {
+                indicesData[i] += GetCtrSplit(split, i, ctr) * splitWeight;
+            }
         }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
     } else {
         Y_ASSERT(split.Type == ESplitType::OneHotFeature);
@@ -116,7 +148,7 @@ void SetPermutedIndices(const TSplit& split,
             OfflineCtrBlock<ui32, IsTrueOneHotFeature>(blockParams, blockIdx,
                 fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
                 GetRemappedCatFeatures(split, objectsDataProvider),
-                (ui32)split.BinBorder, splitWeight, indicesData);
+                (ui32)split.BinBorder, splitWeight, indicesData, leafIdx);
         }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
     }
 }
@@ -152,8 +184,8 @@ int GetRedundantSplitIdx(const TVector<bool>& isLeafEmpty) {
 
 // Get OnlineCTRs associated with a fold
 static TVector<const TOnlineCTR*> GetOnlineCtrs(const TFold& fold, const TSplitTree& tree) {
-    TVector<const TOnlineCTR*> onlineCtrs(tree.GetDepth());
-    for (int splitIdx = 0; splitIdx < tree.GetDepth(); ++splitIdx) {
+    TVector<const TOnlineCTR*> onlineCtrs(tree.Splits.size());
+    for (int splitIdx = 0; splitIdx < tree.Splits.ysize(); ++splitIdx) {
         const auto& split = tree.Splits[splitIdx];
         if (split.Type == ESplitType::OnlineCtr) {
             onlineCtrs[splitIdx] = &fold.GetCtr(split.Ctr.Projection);
@@ -183,28 +215,53 @@ static void BuildIndicesForDataset(const TSplitTree& tree,
         permutation = permutationStorage.data();
     }
 
+    TVector<TVector<ui8>> denseBinsStorage(tree.Splits.size());
+    TVector<const ui8*> floatHistograms(tree.Splits.size(), nullptr);
+    for (int splitIdx = 0; splitIdx < tree.Splits.ysize(); ++splitIdx) {
+        const auto& split = tree.Splits[splitIdx];
+        if ((split.Type == ESplitType::FloatFeature) &&
+            !objectsDataProvider.GetFloatFeaturePackedBinaryBins((ui32)split.FeatureIdx))
+        {
+            floatHistograms[splitIdx] =
+                GetFloatHistogram(split, objectsDataProvider, &denseBinsStorage[splitIdx]);
+        }
+    }
+
     const int blockSize = 1000;
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, (int)sampleCount);
     blockParams.SetBlockSize(blockSize);
 
     auto updateLearnIndex = [&](int blockIdx) {
-        for (int splitIdx = 0; splitIdx < tree.GetDepth(); ++splitIdx) {
+        for (int splitIdx = 0; splitIdx < tree.Splits.ysize(); ++splitIdx) {
             const auto& split = tree.Splits[splitIdx];
-            const int splitWeight = 1 << splitIdx;
+            const int splitWeight = 1 << tree.GetSplitDepth(splitIdx);
+            const TMaybe<TIndexType> leafIdx = tree.IsOblivious()
+                ? Nothing()
+                : MakeMaybe<TIndexType>(tree.SplitLeafIndices[splitIdx]);
             if (split.Type == ESplitType::FloatFeature) {
-                OfflineCtrBlock<ui8, IsTrueHistogram>(blockParams, blockIdx, permutation,
-                    GetFloatHistogram(split, objectsDataProvider),
-                    GetFeatureSplitIdx(split), splitWeight, indices);
+                const auto packedBinaryBins =
+                    objectsDataProvider.GetFloatFeaturePackedBinaryBins((ui32)split.FeatureIdx);
+                if (packedBinaryBins) {
+                    OfflineCtrBlock<ui8, IsTrueHistogram>(blockParams, blockIdx, permutation,
+                        *packedBinaryBins,
+                        GetFeatureSplitIdx(split), splitWeight, indices, leafIdx);
+                } else {
+                    OfflineCtrBlock<ui8, IsTrueHistogram>(blockParams, blockIdx, permutation,
+                        floatHistograms[splitIdx],
+                        GetFeatureSplitIdx(split), splitWeight, indices, leafIdx);
+                }
             } else if (split.Type == ESplitType::OnlineCtr) {
                 const TOnlineCTR& splitOnlineCtr = *onlineCtrs[splitIdx];
                 NPar::TLocalExecutor::BlockedLoopBody(blockParams, [&](int doc) {
-                    indices[doc] += GetCtrSplit(split, doc + docOffset, splitOnlineCtr) * splitWeight;
+                    if (!leafIdx || indices[doc] == *leafIdx) {
+                        indices[doc] += GetCtrSplit(split, doc + docOffset, splitOnlineCtr) * splitWeight;
+                    }
                 })(blockIdx);
             } else {
                 Y_ASSERT(split.Type == ESplitType::OneHotFeature);
                 OfflineCtrBlock<ui32, IsTrueOneHotFeature>(blockParams, blockIdx, permutation,
                     GetRemappedCatFeatures(split, objectsDataProvider),
-                    (ui32)split.BinBorder, splitWeight, indices);
+                    (ui32)split.BinBorder, splitWeight, indices, leafIdx);
             }
         }
     };
@@ -267,26 +324,18 @@ void BinarizeFeatures(const TFullModel& model,
     TVector<ui32> transposedHash(docCount * model.GetUsedCatFeaturesCount());
     TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * docCount);
 
-    const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(rawObjectsData);
-    const auto& featuresLayout = *rawObjectsData.GetFeaturesLayout();
-    const ui32 flatFeaturesCount = featuresLayout.GetExternalFeatureCount();
+    const ui32 flatFeaturesCount = rawObjectsData.GetFeaturesLayout()->GetExternalFeatureCount();
 
-    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx) -> const float* {
-        return GetRawFeatureDataBeginPtr(
-            rawObjectsData,
-            featuresLayout,
-            consecutiveSubsetBegin,
-            flatFeatureIdx);
-    };
+    const TRawFeaturesDataForApply featuresData(model, rawObjectsData, columnReorderMap);
 
     TVector<TConstArrayRef<float>> repackedFeatures(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
     if (columnReorderMap.empty()) {
         for (ui32 i = 0; i < flatFeaturesCount; ++i) {
-            repackedFeatures[i] = MakeArrayRef(getFeatureDataBeginPtr(i) + start, docCount);
+            repackedFeatures[i] = featuresData.GetBlock(i, start, docCount);
         }
     } else {
         for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
-            repackedFeatures[origIdx] = MakeArrayRef(getFeatureDataBeginPtr(sourceIdx) + start, docCount);
+            repackedFeatures[origIdx] = featuresData.GetBlock(sourceIdx, start, docCount);
         }
     }
 
@@ -318,6 +367,7 @@ TVector<ui8> BinarizeFeatures(const TFullModel& model, const NCB::TRawObjectsDat
 }
 
 TVector<TIndexType> BuildIndicesForBinTree(const TFullModel& model, const TVector<ui8>& binarizedFeatures, size_t treeId) {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Leaf indices calculation is not supported for models with non-symmetric trees");
     if (model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() == 0) {
         return TVector<TIndexType>();
     }
@@ -9,14 +9,17 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/maybe.h>
 #include <util/generic/vector.h>
 
+// if leafIdx is defined (non-symmetric trees) split is applied only to objects in this leaf
 void SetPermutedIndices(const TSplit& split,
                         const NCB::TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
                         int curDepth,
                         const TFold& fold,
                         TVector<TIndexType>* indices,
-                        NPar::TLocalExecutor* localExecutor);
+                        NPar::TLocalExecutor* localExecutor,
+                        TMaybe<TIndexType> leafIdx = Nothing());
 
 TVector<bool> GetIsLeafEmpty(int curDepth, const TVector<TIndexType>& indices);
 
@@ -1,5 +1,11 @@
 #include "index_hash_calcer.h"
 
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
 /// Compute reindexHash and reindex hash values in range [begin,end).
 size_t ComputeReindexHash(ui64 topSize,
                           TDenseHash<ui64, ui32>* reindexHashPtr,
@@ -74,3 +80,133 @@ size_t UpdateReindexHash(TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui
     }
     return reindexHash.Size();
 }
+
+/// Reindex keys from range [0, keyCount) in range [begin,end) without a hash map.
+size_t ReindexDenseKeys(ui64 keyCount,
+                        ui64* begin,
+                        ui64* learnEnd,
+                        ui64* end,
+                        NPar::TLocalExecutor* localExecutor,
+                        size_t* learnKeyCount) {
+    enum : ui32 {
+        NotPresent = 0,
+        PresentOnLearn = 1,
+        PresentOnTestOnly = 2
+    };
+    const int learnDocCount = SafeIntegerCast<int>(learnEnd - begin);
+    const int docCount = SafeIntegerCast<int>(end - begin);
+    NPar::TLocalExecutor::TExecRangeParams docBlockParams(0, docCount);
+    if (docCount > 0) {
+        docBlockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+    }
+    const int docBlockCount = docBlockParams.GetBlockCount();
+
+    // keys present in blocks of docs are marked in per block bitmaps, so blocks are processed concurrently
+    constexpr ui64 KeysPerWord = 64;
+    const int keyWordCount = SafeIntegerCast<int>(CeilDiv<ui64>(keyCount, KeysPerWord));
+    TVector<TVector<ui64>> learnKeyBits(docBlockCount);
+    TVector<TVector<ui64>> testKeyBits(docBlockCount);
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            learnKeyBits[blockIdx].yresize(keyWordCount);
+            testKeyBits[blockIdx].yresize(keyWordCount);
+            ui64* learnBits = learnKeyBits[blockIdx].data();
+            ui64* testBits = testKeyBits[blockIdx].data();
+            Fill(learnBits, learnBits + keyWordCount, 0);
+            Fill(testBits, testBits + keyWordCount, 0);
+            NPar::TLocalExecutor::BlockedLoopBody(docBlockParams, [&] (int docIdx) {
+                const ui64 key = begin[docIdx];
+                Y_ASSERT(key < keyCount);
+                ui64* bits = docIdx < learnDocCount ? learnBits : testBits;
+                bits[key / KeysPerWord] |= ui64(1) << (key % KeysPerWord);
+            })(blockIdx);
+        },
+        0,
+        docBlockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    // blocked prefix sums of present keys: merge bitmaps and count keys by blocks of whole words,
+    // then number them within blocks
+    NPar::TLocalExecutor::TExecRangeParams keyBlockParams(0, keyWordCount);
+    if (keyWordCount > 0) {
+        keyBlockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+    }
+    const int keyBlockCount = keyBlockParams.GetBlockCount();
+    TVector<ui32> keyToValue;
+    keyToValue.yresize(keyCount);
+    ui32* keyToValueData = keyToValue.data();
+    TVector<ui32> learnValueOffsets(keyBlockCount + 1, 0);
+    TVector<ui32> testValueOffsets(keyBlockCount + 1, 0);
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            ui32 learnCount = 0;
+            ui32 testCount = 0;
+            NPar::TLocalExecutor::BlockedLoopBody(keyBlockParams, [&] (int wordIdx) {
+                ui64 learnWord = 0;
+                ui64 testWord = 0;
+                for (int docBlockIdx : xrange(docBlockCount)) {
+                    learnWord |= learnKeyBits[docBlockIdx][wordIdx];
+                    testWord |= testKeyBits[docBlockIdx][wordIdx];
+                }
+                const ui64 wordBegin = wordIdx * KeysPerWord;
+                const ui64 wordEnd = Min(wordBegin + KeysPerWord, keyCount);
+                for (ui64 key : xrange(wordBegin, wordEnd)) {
+                    const ui64 mask = ui64(1) << (key - wordBegin);
+                    if (learnWord & mask) {
+                        keyToValueData[key] = PresentOnLearn;
+                        ++learnCount;
+                    } else if (testWord & mask) {
+                        keyToValueData[key] = PresentOnTestOnly;
+                        ++testCount;
+                    } else {
+                        keyToValueData[key] = NotPresent;
+                    }
+                }
+            })(blockIdx);
+            learnValueOffsets[blockIdx + 1] = learnCount;
+            testValueOffsets[blockIdx + 1] = testCount;
+        },
+        0,
+        keyBlockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+    for (int blockIdx = 0; blockIdx < keyBlockCount; ++blockIdx) {
+        learnValueOffsets[blockIdx + 1] += learnValueOffsets[blockIdx];
+    }
+    testValueOffsets[0] = learnValueOffsets.back();
+    for (int blockIdx = 0; blockIdx < keyBlockCount; ++blockIdx) {
+        testValueOffsets[blockIdx + 1] += testValueOffsets[blockIdx];
+    }
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            ui32 learnValue = learnValueOffsets[blockIdx];
+            ui32 testValue = testValueOffsets[blockIdx];
+            NPar::TLocalExecutor::BlockedLoopBody(keyBlockParams, [&] (int wordIdx) {
+                const ui64 wordBegin = wordIdx * KeysPerWord;
+                const ui64 wordEnd = Min(wordBegin + KeysPerWord, keyCount);
+                for (ui64 key : xrange(wordBegin, wordEnd)) {
+                    if (keyToValueData[key] == PresentOnLearn) {
+                        keyToValueData[key] = learnValue++;
+                    } else if (keyToValueData[key] == PresentOnTestOnly) {
+                        keyToValueData[key] = testValue++;
+                    }
+                }
+            })(blockIdx);
+        },
+        0,
+        keyBlockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    localExecutor->ExecRange(
+        [=] (int docIdx) {
+            begin[docIdx] = keyToValueData[begin[docIdx]];
+        },
+        docBlockParams,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    *learnKeyCount = learnValueOffsets.back();
+    return testValueOffsets.back();
+}
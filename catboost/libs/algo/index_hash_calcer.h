@@ -6,6 +6,7 @@
 #include <catboost/libs/helpers/clear_array.h>
 
 #include <library/containers/dense_hash/dense_hash.h>
+#include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/utility.h>
 
@@ -57,6 +58,36 @@ inline void CalcHashes(const TProjection& proj,
     }
 
     for (const TBinFeature& feature : proj.BinFeatures) {
+        const auto packedBinaryBins = objectsDataProvider.GetFloatFeaturePackedBinaryBins((ui32)feature.FloatFeature);
+        if (packedBinaryBins) {
+            featuresSubsetIndexing.ForEach(
+                [feature, hashArr, bins = *packedBinaryBins] (ui32 i, ui32 srcIdx) {
+                    const bool isTrueFeature = IsTrueHistogram(bins[srcIdx], (ui8)feature.SplitIdx);
+                    hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
+                }
+            );
+            continue;
+        }
+        const auto* sparseBins = objectsDataProvider.GetFloatFeatureSparseBins((ui32)feature.FloatFeature);
+        if (sparseBins) {
+            const auto subsetBins = sparseBins->GetSubset(featuresSubsetIndexing);
+            const ui64 isTrueDefault = IsTrueHistogram(subsetBins.GetDefaultValue(), (ui8)feature.SplitIdx);
+            ui32 i = 0;
+            subsetBins.ForEachNonDefault(
+                [&] (ui32 nonDefaultIdx, ui8 featureValue) {
+                    for (; i < nonDefaultIdx; ++i) {
+                        hashArr[i] = CalcHash(hashArr[i], isTrueDefault);
+                    }
+                    const bool isTrueFeature = IsTrueHistogram(featureValue, (ui8)feature.SplitIdx);
+                    hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
+                    ++i;
+                }
+            );
+            for (; i < subsetBins.GetSize(); ++i) {
+                hashArr[i] = CalcHash(hashArr[i], isTrueDefault);
+            }
+            continue;
+        }
         NCB::SubsetWithAlternativeIndexing(
             objectsDataProvider.GetFloatFeature((ui32)feature.FloatFeature),
             &featuresSubsetIndexing
@@ -100,3 +131,15 @@ size_t ComputeReindexHash(ui64 topSize, TDenseHash<ui64, ui32>* reindexHashPtr,
 /// If a hash value is not present in reindexHash, then update reindexHash for that value.
 /// @return the size of updated reindexHash.
 size_t UpdateReindexHash(TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui64* end);
+
+/// Reindex keys from range [0, keyCount) in range [begin,end) without a hash map.
+/// Keys present in [begin,learnEnd) are mapped to [0, learnKeyCount) in increasing order,
+/// keys present only in [learnEnd,end) are mapped to the following values.
+/// Memory and time are linear in keyCount, so use it for keyCount comparable with end - begin.
+/// @return the number of distinct keys, learnKeyCount is set to the number of distinct keys in [begin,learnEnd).
+size_t ReindexDenseKeys(ui64 keyCount,
+                        ui64* begin,
+                        ui64* learnEnd,
+                        ui64* end,
+                        NPar::TLocalExecutor* localExecutor,
+                        size_t* learnKeyCount);
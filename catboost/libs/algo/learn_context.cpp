@@ -16,6 +16,7 @@
 #include <util/generic/xrange.h>
 #include <util/folder/path.h>
 #include <util/system/fs.h>
+#include <util/system/info.h>
 #include <util/stream/file.h>
 
 
@@ -279,15 +280,24 @@ bool TLearnContext::UseTreeLevelCaching() const {
     return UseTreeLevelCachingFlag;
 }
 
+ui64 GetTreeLevelCacheSizeLimit(const NCatboostOptions::TCatBoostOptions& params) {
+    const ui64 usedRamLimit = ParseMemorySizeDescription(params.SystemOptions->CpuUsedRamLimit.Get());
+    return Min<ui64>(usedRamLimit, NSystemInfo::TotalMemorySize()) / 4;
+}
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
     ui32 approxDimension) {
 
-    const ui32 maxLeafCount = 1 << params.ObliviousTreeOptions->MaxDepth;
-    // TODO(nikitxskv): Pairwise scoring doesn't use statistics from previous tree level. Need to fix it.
+    const ui64 maxLeafCount = 1ull << params.ObliviousTreeOptions->MaxDepth;
+    const ui64 maxBucketCount = params.DataProcessingOptions->FloatFeaturesBinarization->BorderCount.Get() + 1;
+    // cache is bounded by memory limit, so it is used if stats of at least one float feature fit into it,
+    // pairwise stats are cached up to the level before the last one
+    const ui64 featureStatsSize = IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()) ?
+        GetPairwiseStatsSize(maxLeafCount / 2, maxBucketCount) :
+        sizeof(TBucketStats) * maxBucketCount * maxLeafCount * approxDimension * maxBodyTailCount;
     return (
         IsSamplingPerTree(params.ObliviousTreeOptions) &&
-        !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()) &&
-        maxLeafCount * approxDimension * maxBodyTailCount < 64 * 1 * 10);
+        featureStatsSize <= GetTreeLevelCacheSizeLimit(params));
 }
@@ -138,6 +138,9 @@ private:
     bool UseTreeLevelCachingFlag;
 };
 
+// memory limit for stats of split candidates cached between tree levels
+ui64 GetTreeLevelCacheSizeLimit(const NCatboostOptions::TCatBoostOptions& params);
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
@@ -9,6 +9,7 @@
 #include <catboost/libs/helpers/resource_constrained_executor.h>
 #include <catboost/libs/model/model.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/bitops.h>
 #include <util/generic/utility.h>
 #include <util/stream/format.h>
@@ -337,25 +338,106 @@ static inline void CountOnlineCTRTotal(const TVector<ui64>& hashArr, int sampleC
     }
 }
 
-void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
-                       const TFold& fold,
-                       const TProjection& proj,
-                       const TLearnContext* ctx,
-                       TOnlineCTR* dst) {
-    const TCtrHelper& ctrHelper = ctx->CtrsHelper;
-    const auto& ctrInfo = ctrHelper.GetCtrInfo(proj);
-    dst->Feature.resize(ctrInfo.size());
-    size_t learnSampleCount = data.Learn->GetObjectCount();
-    const TVector<size_t>& testOffsets = data.CalcTestOffsets();
-    size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
+static const TProjectionBuckets* FindBaseProjectionBuckets(const TFold& fold,
+                                                           const TProjection& proj,
+                                                           int* extendingCatFeature) {
+    if (fold.ProjectionBuckets.empty() || proj.GetFullProjectionLength() < 2) {
+        return nullptr;
+    }
+    for (int catFeature : proj.CatFeatures) {
+        TProjection baseProj = proj;
+        baseProj.CatFeatures.erase(Find(baseProj.CatFeatures, catFeature));
+        if (const auto* baseBuckets = fold.ProjectionBuckets.FindPtr(baseProj)) {
+            *extendingCatFeature = catFeature;
+            return baseBuckets;
+        }
+    }
+    return nullptr;
+}
+
+// Bucket ids of the base projection extended by catFeature.
+// Keys baseBucket * catValueCount + catValue are dense enough to be reindexed without a hash map
+// if the base projection has few buckets, otherwise they are reindexed with a hash map as usual.
+static size_t ExtendProjectionBuckets(const TTrainingForCPUDataProviders& data,
+                                      const TFold& fold,
+                                      const TProjectionBuckets& baseBuckets,
+                                      int catFeature,
+                                      NPar::TLocalExecutor* localExecutor,
+                                      TVector<ui64>* hashArr,
+                                      size_t* learnBucketCount) {
+    const size_t learnSampleCount = data.Learn->GetObjectCount();
+    const size_t totalSampleCount = baseBuckets.Buckets.size();
+    const auto& quantizedFeaturesInfo = *data.Learn->ObjectsData->GetQuantizedFeaturesInfo();
+    // perfect hashed values of learn and test objects are in [0, OnAll)
+    const ui64 catValueCount = quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(catFeature)).OnAll;
+
+    hashArr->yresize(totalSampleCount);
+    ui64* hashArrData = hashArr->data();
+    const ui32* baseBucketsData = baseBuckets.Buckets.data();
+    if (learnSampleCount > 0) {
+        SubsetWithAlternativeIndexing(
+            data.Learn->ObjectsData->GetCatFeature((ui32)catFeature),
+            &fold.LearnPermutationFeaturesSubset
+        ).ParallelForEach(
+            [=] (ui32 i, ui32 featureValue) {
+                hashArrData[i] = baseBucketsData[i] * catValueCount + featureValue;
+            },
+            localExecutor
+        );
+    }
+    for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
+        const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+        (*data.Test[testIdx]->ObjectsData->GetCatFeature((ui32)catFeature))->GetArrayData()
+            .ParallelForEach(
+                [=] (ui32 i, ui32 featureValue) {
+                    hashArrData[docOffset + i] = baseBucketsData[docOffset + i] * catValueCount + featureValue;
+                },
+                localExecutor
+            );
+        docOffset += testSampleCount;
+    }
+
+    const ui64 keyCount = baseBuckets.BucketCount * catValueCount;
+    if (keyCount <= 2 * totalSampleCount && keyCount <= (ui64)Max<int>()) {
+        return ReindexDenseKeys(
+            keyCount,
+            hashArrData,
+            hashArrData + learnSampleCount,
+            hashArrData + totalSampleCount,
+            localExecutor,
+            learnBucketCount);
+    }
+    TDenseHash<ui64, ui32> reindexHash;
+    reindexHash.MakeEmpty(learnSampleCount);
+    *learnBucketCount = ComputeReindexHash(Max<ui64>(), &reindexHash, hashArrData, hashArrData + learnSampleCount);
+    return UpdateReindexHash(&reindexHash, hashArrData + learnSampleCount, hashArrData + totalSampleCount);
+}
+
+// Bucket ids of projection values for learn objects in fold permutation order followed by test objects.
+// @return the bucket count, learnBucketCount is set to the count of buckets present on learn
+static size_t CalcBucketIds(const TTrainingForCPUDataProviders& data,
+                            const TFold& fold,
+                            const TProjection& proj,
+                            ui64 topSize,
+                            NPar::TLocalExecutor* localExecutor,
+                            TVector<ui64>* hashArrPtr,
+                            size_t* learnBucketCount) {
+    const size_t learnSampleCount = data.Learn->GetObjectCount();
+    const size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
+
+    // bucket ids only have to be consistent unless the buckets are limited by topSize
+    if (topSize >= learnSampleCount) {
+        int extendingCatFeature = 0;
+        if (const auto* baseBuckets = FindBaseProjectionBuckets(fold, proj, &extendingCatFeature)) {
+            return ExtendProjectionBuckets(data, fold, *baseBuckets, extendingCatFeature, localExecutor, hashArrPtr, learnBucketCount);
+        }
+    }
 
     const auto& quantizedFeaturesInfo = *data.Learn->ObjectsData->GetQuantizedFeaturesInfo();
 
-    using THashArr = TVector<ui64>;
     using TRehashHash = TDenseHash<ui64, ui32>;
-    Y_STATIC_THREAD(THashArr) tlsHashArr;
     Y_STATIC_THREAD(TRehashHash) rehashHashTlsVal;
-    TVector<ui64>& hashArr = tlsHashArr.Get();
+    TVector<ui64>& hashArr = *hashArrPtr;
     if (proj.IsSingleCatFeature()) {
         // Shortcut for simple ctrs
         Clear(&hashArr, totalSampleCount);
@@ -413,18 +495,42 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
         }
         rehashHashTlsVal.Get().MakeEmpty(Min(learnSampleCount, approxBucketsCount));
     }
-    ui64 topSize = ctx->Params.CatFeatureParams->CtrLeafCountLimit;
-    if (proj.IsSingleCatFeature() && ctx->Params.CatFeatureParams->StoreAllSimpleCtrs) {
-        topSize = Max<ui64>();
-    }
     auto leafCount = ComputeReindexHash(topSize, rehashHashTlsVal.GetPtr(), hashArr.begin(), hashArr.begin() + learnSampleCount);
-    dst->CounterUniqueValuesCount = dst->UniqueValuesCount = leafCount;
+    *learnBucketCount = leafCount;
 
     for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
         const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
         leafCount = UpdateReindexHash(rehashHashTlsVal.GetPtr(), hashArr.begin() + docOffset, hashArr.begin() + docOffset + testSampleCount);
         docOffset += testSampleCount;
     }
+    return leafCount;
+}
+
+// onCtrCalculated(ctrIdx) is called when dst->Feature[ctrIdx] is calculated
+template <class TOnCtrCalculated>
+static void ComputeOnlineCTRsImpl(const TTrainingForCPUDataProviders& data,
+                                  const TFold& fold,
+                                  const TProjection& proj,
+                                  const TLearnContext* ctx,
+                                  TOnCtrCalculated&& onCtrCalculated,
+                                  TOnlineCTR* dst) {
+    const TCtrHelper& ctrHelper = ctx->CtrsHelper;
+    const auto& ctrInfo = ctrHelper.GetCtrInfo(proj);
+    dst->Feature.resize(ctrInfo.size());
+    size_t learnSampleCount = data.Learn->GetObjectCount();
+    const TVector<size_t>& testOffsets = data.CalcTestOffsets();
+    size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
+
+    using THashArr = TVector<ui64>;
+    Y_STATIC_THREAD(THashArr) tlsHashArr;
+    TVector<ui64>& hashArr = tlsHashArr.Get();
+    ui64 topSize = ctx->Params.CatFeatureParams->CtrLeafCountLimit;
+    if (proj.IsSingleCatFeature() && ctx->Params.CatFeatureParams->StoreAllSimpleCtrs) {
+        topSize = Max<ui64>();
+    }
+    size_t learnLeafCount = 0;
+    const size_t leafCount = CalcBucketIds(data, fold, proj, topSize, ctx->LocalExecutor, &hashArr, &learnLeafCount);
+    dst->CounterUniqueValuesCount = dst->UniqueValuesCount = learnLeafCount;
 
     TVector<int> counterCTRTotal;
     int counterCTRDenominator = 0;
@@ -500,9 +606,54 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
                 ctrBorderCount,
                 &dst->Feature[ctrIdx]);
         }
+        onCtrCalculated(ctrIdx);
     }
 }
 
+void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
+                       const TFold& fold,
+                       const TProjection& proj,
+                       const TLearnContext* ctx,
+                       TOnlineCTR* dst) {
+    ComputeOnlineCTRsImpl(data, fold, proj, ctx, [] (int /*ctrIdx*/) {}, dst);
+}
+
+void ComputeOnlineCTRsByOne(const TTrainingForCPUDataProviders& data,
+                            const TFold& fold,
+                            const TProjection& proj,
+                            const TLearnContext* ctx,
+                            const std::function<void(int ctrIdx)>& onCtrCalculated,
+                            TOnlineCTR* dst) {
+    ComputeOnlineCTRsImpl(
+        data,
+        fold,
+        proj,
+        ctx,
+        [&] (int ctrIdx) {
+            onCtrCalculated(ctrIdx);
+            dst->Feature[ctrIdx].Clear();
+        },
+        dst);
+}
+
+void CalcProjectionBuckets(const TTrainingForCPUDataProviders& data,
+                           const TFold& fold,
+                           const TProjection& proj,
+                           const TLearnContext* ctx,
+                           TProjectionBuckets* dst) {
+    TVector<ui64> hashArr;
+    size_t learnBucketCount = 0;
+    dst->BucketCount = CalcBucketIds(data, fold, proj, Max<ui64>(), ctx->LocalExecutor, &hashArr, &learnBucketCount);
+    dst->LearnBucketCount = learnBucketCount;
+    dst->Buckets.yresize(hashArr.size());
+    ctx->LocalExecutor->ExecRange(
+        [&] (int docIdx) {
+            dst->Buckets[docIdx] = hashArr[docIdx];
+        },
+        NPar::TLocalExecutor::TExecRangeParams(0, hashArr.ysize()).SetBlockCountToThreadCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 void CalcFinalCtrsImpl(
     const ECtrType ctrType,
     const ui64 ctrLeafCountLimit,
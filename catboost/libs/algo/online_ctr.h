@@ -33,6 +33,17 @@ struct TOnlineCTR {
     size_t GetMaxUniqueValueCount() const {
         return Max(UniqueValuesCount, CounterUniqueValuesCount);
     }
+    size_t GetMemoryUsage() const {
+        size_t memoryUsage = 0;
+        for (const auto& ctr : Feature) {
+            for (size_t border = 0; border < ctr.GetYSize(); ++border) {
+                for (size_t prior = 0; prior < ctr.GetXSize(); ++prior) {
+                    memoryUsage += ctr[border][prior].capacity();
+                }
+            }
+        }
+        return memoryUsage;
+    }
     size_t GetUniqueValueCountForType(ECtrType type) const {
         if (ECtrType::Counter == type) {
             return CounterUniqueValuesCount;
@@ -44,6 +55,19 @@ struct TOnlineCTR {
 
 using TOnlineCTRHash = THashMap<TProjection, TOnlineCTR>;
 
+/* Bucket ids of projection values for learn objects in fold permutation order followed by test objects.
+ * Values present on learn have ids in [0, LearnBucketCount), values present only on test follow them.
+ * ComputeOnlineCTRs builds buckets of a projection extended by one categorical feature from these
+ * instead of hashing all features of the projection again.
+ */
+struct TProjectionBuckets {
+    TVector<ui32> Buckets;
+    ui32 LearnBucketCount = 0;
+    ui32 BucketCount = 0;
+};
+
+using TProjectionBucketsHash = THashMap<TProjection, TProjectionBuckets>;
+
 inline ui8 CalcCTR(float countInClass, int totalCount, float prior, float shift, float norm, int borderCount) {
     float ctr = (countInClass + prior) / (totalCount + 1);
     return (ctr + shift) / norm * borderCount;
@@ -59,6 +83,23 @@ void ComputeOnlineCTRs(const NCB::TTrainingForCPUDataProviders& data,
                        const TLearnContext* ctx,
                        TOnlineCTR* dst);
 
+/* Streaming variant of ComputeOnlineCTRs: values of one ctr of the projection are kept at a time,
+ * onCtrCalculated(ctrIdx) is called when dst->Feature[ctrIdx] is filled, after that it is freed.
+ * Unique value counts of dst are set as in ComputeOnlineCTRs.
+ */
+void ComputeOnlineCTRsByOne(const NCB::TTrainingForCPUDataProviders& data,
+                            const TFold& fold,
+                            const TProjection& proj,
+                            const TLearnContext* ctx,
+                            const std::function<void(int ctrIdx)>& onCtrCalculated,
+                            TOnlineCTR* dst);
+
+void CalcProjectionBuckets(const NCB::TTrainingForCPUDataProviders& data,
+                           const TFold& fold,
+                           const TProjection& proj,
+                           const TLearnContext* ctx,
+                           TProjectionBuckets* dst);
+
 class TCtrValueTable;
 
 
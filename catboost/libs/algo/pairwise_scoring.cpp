@@ -6,35 +6,34 @@
 
 #include <emmintrin.h>
 
-void TPairwiseStats::Add(const TPairwiseStats& rhs) {
-    Y_ASSERT(DerSums.size() == rhs.DerSums.size());
-
-    for (auto leafIdx : xrange(DerSums.size())) {
-        auto& dst = DerSums[leafIdx];
-        const auto& add = rhs.DerSums[leafIdx];
-
-        Y_ASSERT(dst.size() == add.size());
-
-        for (auto bucketIdx : xrange(dst.size())) {
-            dst[bucketIdx] += add[bucketIdx];
-        }
-    }
-
-    Y_ASSERT(PairWeightStatistics.GetXSize() == rhs.PairWeightStatistics.GetXSize());
-    Y_ASSERT(PairWeightStatistics.GetYSize() == rhs.PairWeightStatistics.GetYSize());
-
-    for (auto leafIdx1 : xrange(PairWeightStatistics.GetYSize())) {
-        auto dst1 = PairWeightStatistics[leafIdx1];
-        const auto add1 = rhs.PairWeightStatistics[leafIdx1];
-
-        for (auto leafIdx2 : xrange(PairWeightStatistics.GetXSize())) {
-            auto& dst2 = dst1[leafIdx2];
-            const auto& add2 = add1[leafIdx2];
-
-            Y_ASSERT(dst2.size() == add2.size());
-
-            for (auto bucketIdx : xrange(dst2.size())) {
-                dst2[bucketIdx].Add(add2[bucketIdx]);
+void RestoreStatsFromPrevLevel(
+    const TPairwiseStats& prevLevelStats,
+    int depth,
+    bool smallestSplitSideValue,
+    TPairwiseStats* stats
+) {
+    Y_ASSERT(depth > 0);
+    const int prevLeafCount = 1 << (depth - 1);
+    Y_ASSERT(prevLevelStats.DerSums.ysize() == prevLeafCount);
+    Y_ASSERT(stats->DerSums.ysize() == 2 * prevLeafCount);
+    // last split sets the highest bit of leaf index
+    const int smallSideBegin = smallestSplitSideValue ? prevLeafCount : 0;
+    const int otherSideBegin = prevLeafCount - smallSideBegin;
+
+    auto& weightSums = stats->PairWeightStatistics;
+    for (auto prevLeaf1 : xrange(prevLeafCount)) {
+        const int otherLeaf1 = otherSideBegin + prevLeaf1;
+        const int smallLeaf1 = smallSideBegin + prevLeaf1;
+        for (auto prevLeaf2 : xrange(prevLeafCount)) {
+            const int otherLeaf2 = otherSideBegin + prevLeaf2;
+            const int smallLeaf2 = smallSideBegin + prevLeaf2;
+            // pairs of other three pairs of leaves have a document on the smallest side
+            auto& dst = weightSums[otherLeaf1][otherLeaf2];
+            dst = prevLevelStats.PairWeightStatistics[prevLeaf1][prevLeaf2];
+            for (auto bucketIdx : xrange(dst.size())) {
+                dst[bucketIdx].Remove(weightSums[otherLeaf1][smallLeaf2][bucketIdx]);
+                dst[bucketIdx].Remove(weightSums[smallLeaf1][otherLeaf2][bucketIdx]);
+                dst[bucketIdx].Remove(weightSums[smallLeaf1][smallLeaf2][bucketIdx]);
             }
         }
     }
@@ -7,29 +7,6 @@
 
 #include <catboost/libs/index_range/index_range.h>
 
-#include <library/binsaver/bin_saver.h>
-
-struct TBucketPairWeightStatistics {
-    double SmallerBorderWeightSum = 0.0; // The weight sum of pair elements with smaller border.
-    double GreaterBorderRightWeightSum = 0.0; // The weight sum of pair elements with greater border.
-
-    void Add(const TBucketPairWeightStatistics& rhs) {
-        SmallerBorderWeightSum += rhs.SmallerBorderWeightSum;
-        GreaterBorderRightWeightSum += rhs.GreaterBorderRightWeightSum;
-    }
-    SAVELOAD(SmallerBorderWeightSum, GreaterBorderRightWeightSum);
-};
-
-
-struct TPairwiseStats {
-    TVector<TVector<double>> DerSums; // [leafCount][bucketCount]
-    TArray2D<TVector<TBucketPairWeightStatistics>> PairWeightStatistics; // [leafCount][leafCount][bucketCount]
-
-    void Add(const TPairwiseStats& rhs);
-    SAVELOAD(DerSums, PairWeightStatistics);
-};
-
-
 // TGetBucketFunc is of type ui32(ui32 docId)
 template <class TGetBucketFunc>
 inline TVector<TVector<double>> ComputeDerSums(
@@ -85,6 +62,18 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     return weightSums;
 }
 
+/* Pair weight stats of pairs of leaves at depth > 0 that are both on the other side of the last split than
+ * smallestSplitSideValue are differences of stats of their pair of parents at previous level and stats of
+ * the other three pairs of their siblings, so only pairs with a document on the smallest side of the last split
+ * are used to calculate PairWeightStatistics, stats of such pairs of leaves are restored here.
+ */
+void RestoreStatsFromPrevLevel(
+    const TPairwiseStats& prevLevelStats,
+    int depth,
+    bool smallestSplitSideValue,
+    TPairwiseStats* stats
+);
+
 void CalculatePairwiseScore(
     const TPairwiseStats& pairwiseStats,
     int bucketCount,
@@ -1,5 +1,7 @@
 #include "score_calcer.h"
 
+#include "binary_features_pack_stats.h"
+#include "compact_bucket_stats.h"
 #include "index_calcer.h"
 #include "online_predictor.h"
 
@@ -92,11 +94,11 @@ inline static const TOnlineCTR& GetCtr(
 
 // Helper function for calculating index of leaf for each document given a new split.
 // Calculates indices when a permutation is given.
-template <typename TBucketIndexType, typename TFullIndexType>
+template <typename TBucketIndex, typename TFullIndexType>
 inline static void SetSingleIndex(
     const TCalcScoreFold& fold,
     const TStatsIndexer& indexer,
-    TBucketIndexType* bucketIndex,
+    TBucketIndex bucketIndex, // raw array or accessor with operator[] like TPackedBinaryBins
     const ui32* bucketIndexing, // can be nullptr for simple case, use bucketBeginOffset instead then
     const int bucketBeginOffset,
     const int permBlockSize,
@@ -171,10 +173,14 @@ inline static void BuildSingleIndex(
         const int docInDataProviderBeginOffset = simpleIndexing ? fold.FeaturesSubsetBegin : 0;
 
         if (split.Type == ESplitType::FloatFeature) {
+            // stats of sparse features are calculated without leaf indices, see CalcSparseStatsKernel
+            Y_ASSERT(!objectsDataProvider.GetFloatFeatureSparseBins((ui32)split.FeatureIdx));
+            // stats of packed binary features are summed from stats of their packs, see CalcBinaryFeaturesPackStats
+            Y_ASSERT(!objectsDataProvider.GetFloatFeaturePackedBinaryBins((ui32)split.FeatureIdx));
             SetSingleIndex(
                 fold,
                 indexer,
-                *((*objectsDataProvider.GetFloatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc()),
+                objectsDataProvider.GetFloatFeatureRawSrcData((ui32)split.FeatureIdx),
                 docInDataProviderIndexing,
                 docInDataProviderBeginOffset,
                 fold.NonCtrDataPermutationBlockSize,
@@ -205,8 +211,25 @@ inline static void UpdateWeighted(
     const double* weightedDer,
     const float* sampleWeights,
     NCB::TIndexRange<int> docIndexRange,
+    int statsSize,
+    TVector<TCompactBucketStats>* compactStats, // buffer, resized if compact stats are used
     TBucketStats* stats
 ) {
+    if (UseCompactStats(statsSize, docIndexRange)) {
+        compactStats->yresize(statsSize);
+        UpdateCompact(
+            singleIdx,
+            weightedDer,
+            sampleWeights,
+            docIndexRange,
+            &TBucketStats::SumWeightedDelta,
+            &TBucketStats::SumWeight,
+            GetCompactStatsBlockSize(statsSize),
+            compactStats,
+            stats
+        );
+        return;
+    }
     for (int doc : docIndexRange.Iter()) {
         TBucketStats& leafStats = stats[singleIdx[doc]];
         leafStats.SumWeightedDelta += weightedDer[doc];
@@ -222,8 +245,25 @@ inline static void UpdateDeltaCount(
     const double* derivatives,
     const float* learnWeights,
     NCB::TIndexRange<int> docIndexRange,
+    int statsSize,
+    TVector<TCompactBucketStats>* compactStats, // buffer, resized if compact stats are used
     TBucketStats* stats
 ) {
+    if (UseCompactStats(statsSize, docIndexRange)) {
+        compactStats->yresize(statsSize);
+        UpdateCompact(
+            singleIdx,
+            derivatives,
+            learnWeights,
+            docIndexRange,
+            &TBucketStats::SumDelta,
+            &TBucketStats::Count,
+            GetCompactStatsBlockSize(statsSize),
+            compactStats,
+            stats
+        );
+        return;
+    }
     if (learnWeights == nullptr) {
         for (int doc : docIndexRange.Iter()) {
             TBucketStats& leafStats = stats[singleIdx[doc]];
@@ -273,12 +313,17 @@ inline static void CalcStatsKernel(
 
         int tailFinishInRange = Min((int)bt.TailFinish, docIndexRange.End);
 
+        const int statsSize = indexer.CalcSize(depth);
+        TVector<TCompactBucketStats> compactStats;
+
         if (isPlainMode) {
             UpdateWeighted(
                 singleIdx,
                 GetDataPtr(bt.SampleWeightedDerivatives[dim]),
                 sampleWeightsData,
                 NCB::TIndexRange<int>(docIndexRange.Begin, tailFinishInRange),
+                statsSize,
+                &compactStats,
                 stats
             );
         } else {
@@ -288,6 +333,8 @@ inline static void CalcStatsKernel(
                     GetDataPtr(bt.WeightedDerivatives[dim]),
                     weightsData,
                     NCB::TIndexRange<int>(docIndexRange.Begin, Min((int)bt.BodyFinish, docIndexRange.End)),
+                    statsSize,
+                    &compactStats,
                     stats
                 );
             }
@@ -297,6 +344,183 @@ inline static void CalcStatsKernel(
                     GetDataPtr(bt.SampleWeightedDerivatives[dim]),
                     sampleWeightsData,
                     NCB::TIndexRange<int>(Max((int)bt.BodyFinish, docIndexRange.Begin), tailFinishInRange),
+                    statsSize,
+                    &compactStats,
+                    stats
+                );
+            }
+        }
+    }
+}
+
+// Sums over all documents of each leaf and positions of documents in fold for stats of sparse features
+static void CalcSparseFeaturesStatsData(
+    const TCalcScoreFold& fold,
+    ui32 featuresObjectCount,
+    bool isPairwiseScoring,
+    bool isPlainMode,
+    int depth,
+    TCalcScoreFold::TSparseFeaturesStatsData* data
+) {
+    const int docCount = fold.GetDocCount();
+    const ui32* docInFeaturesIndexing = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
+    data->DocByFeaturesIdx.assign(featuresObjectCount, Max<ui32>());
+    for (int doc : xrange(docCount)) {
+        data->DocByFeaturesIdx[docInFeaturesIndexing[doc]] = doc;
+    }
+
+    const int leafCount = 1 << depth;
+    if (isPairwiseScoring) {
+        const double* weightedDerivativesData = GetDataPtr(fold.BodyTailArr[0].WeightedDerivatives[0]);
+        data->LeafDerSums.assign(leafCount, 0.0);
+        for (int doc : xrange(docCount)) {
+            data->LeafDerSums[fold.Indices[doc]] += weightedDerivativesData[doc];
+        }
+        return;
+    }
+
+    // stats of leaves are stats of a feature with a single bucket
+    const TStatsIndexer leafIndexer(/*bucketCount*/ 1);
+    const int approxDimension = fold.GetApproxDimension();
+    data->LeafStats.yresize(fold.GetBodyTailCount() * approxDimension * leafCount);
+    for (int bodyTailIdx : xrange(fold.GetBodyTailCount())) {
+        for (int dim : xrange(approxDimension)) {
+            CalcStatsKernel(
+                /*isCaching*/ false,
+                fold.Indices,
+                fold,
+                isPlainMode,
+                leafIndexer,
+                depth,
+                fold.BodyTailArr[bodyTailIdx],
+                dim,
+                NCB::TIndexRange<int>(0, docCount),
+                data->LeafStats.data() + (bodyTailIdx * approxDimension + dim) * leafCount
+            );
+        }
+    }
+}
+
+
+// Same as CalcStatsKernel on all documents for bins stored as TSparseArray.
+// Stats of leaves are added to the default bucket, then documents with non-default bins are moved from it.
+inline static void CalcSparseStatsKernel(
+    bool isCaching,
+    const TSparseArray<ui8, ui32>& bins,
+    const TCalcScoreFold::TSparseFeaturesStatsData& sparseData,
+    const TCalcScoreFold& fold,
+    bool isPlainMode,
+    const TStatsIndexer& indexer,
+    int depth,
+    int bodyTailIdx,
+    int dim,
+    TBucketStats* stats
+) {
+    Y_ASSERT(!isCaching || depth > 0);
+    if (isCaching) {
+        Fill(
+            stats + indexer.CalcSize(depth - 1),
+            stats + indexer.CalcSize(depth),
+            TBucketStats{0, 0, 0, 0}
+        );
+    } else {
+        Fill(stats, stats + indexer.CalcSize(depth), TBucketStats{0, 0, 0, 0});
+    }
+
+    const int leafCount = 1 << depth;
+    const ui8 defaultBin = bins.GetDefaultValue();
+    const TBucketStats* leafStats =
+        sparseData.LeafStats.data() + (bodyTailIdx * fold.GetApproxDimension() + dim) * leafCount;
+    for (int leaf : xrange(leafCount)) {
+        stats[indexer.GetIndex(leaf, defaultBin)].Add(leafStats[leaf]);
+    }
+
+    const TCalcScoreFold::TBodyTail& bt = fold.BodyTailArr[bodyTailIdx];
+    const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+    const float* weightsData = hasPairwiseWeights ?
+        GetDataPtr(bt.PairwiseWeights) : GetDataPtr(fold.LearnWeights);
+    const float* sampleWeightsData = hasPairwiseWeights ?
+        GetDataPtr(bt.SamplePairwiseWeights) : GetDataPtr(fold.SampleWeights);
+    const double* weightedDerivativesData = GetDataPtr(bt.WeightedDerivatives[dim]);
+    const double* sampleWeightedDerivativesData = GetDataPtr(bt.SampleWeightedDerivatives[dim]);
+    const ui32 bodyFinish = bt.BodyFinish;
+    const ui32 tailFinish = bt.TailFinish;
+
+    bins.ForEachNonDefault(
+        [&] (ui32 featuresIdx, ui8 bin) {
+            const ui32 doc = sparseData.DocByFeaturesIdx[featuresIdx];
+            if (doc >= tailFinish) { // also if not in fold
+                return;
+            }
+            TBucketStats docStats{0, 0, 0, 0};
+            if (isPlainMode || (doc >= bodyFinish)) {
+                docStats.SumWeightedDelta = sampleWeightedDerivativesData[doc];
+                docStats.SumWeight = sampleWeightsData[doc];
+            } else {
+                docStats.SumDelta = weightedDerivativesData[doc];
+                docStats.Count = weightsData ? weightsData[doc] : 1.0;
+            }
+            const TIndexType leaf = fold.Indices[doc];
+            stats[indexer.GetIndex(leaf, bin)].Add(docStats);
+            stats[indexer.GetIndex(leaf, defaultBin)].Remove(docStats);
+        }
+    );
+}
+
+// Same as CalcStatsKernel for values of halves of a binary features pack,
+// leafAndPackIdx[doc] is (leaf << LeafAndPackIdxPackBits) | pack
+template <typename TFullIndexType>
+inline static void CalcBinaryFeaturesPackStatsKernel(
+    const TVector<TFullIndexType>& leafAndPackIdx,
+    const TCalcScoreFold& fold,
+    bool isPlainMode,
+    int depth,
+    const TCalcScoreFold::TBodyTail& bt,
+    int dim,
+    NCB::TIndexRange<int> docIndexRange,
+    TBucketStats* stats // [leaf][half][halfValue]
+) {
+    Fill(stats, stats + GetPackHalvesStatsSize(depth), TBucketStats{0, 0, 0, 0});
+
+    if (bt.TailFinish > docIndexRange.Begin) {
+        const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+        const float* weightsData = hasPairwiseWeights ?
+            GetDataPtr(bt.PairwiseWeights) : GetDataPtr(fold.LearnWeights);
+        const float* sampleWeightsData = hasPairwiseWeights ?
+            GetDataPtr(bt.SamplePairwiseWeights) : GetDataPtr(fold.SampleWeights);
+
+        int tailFinishInRange = Min((int)bt.TailFinish, docIndexRange.End);
+
+        if (isPlainMode) {
+            UpdatePackHalves(
+                leafAndPackIdx,
+                GetDataPtr(bt.SampleWeightedDerivatives[dim]),
+                sampleWeightsData,
+                NCB::TIndexRange<int>(docIndexRange.Begin, tailFinishInRange),
+                &TBucketStats::SumWeightedDelta,
+                &TBucketStats::SumWeight,
+                stats
+            );
+        } else {
+            if (bt.BodyFinish > docIndexRange.Begin) {
+                UpdatePackHalves(
+                    leafAndPackIdx,
+                    GetDataPtr(bt.WeightedDerivatives[dim]),
+                    weightsData,
+                    NCB::TIndexRange<int>(docIndexRange.Begin, Min((int)bt.BodyFinish, docIndexRange.End)),
+                    &TBucketStats::SumDelta,
+                    &TBucketStats::Count,
+                    stats
+                );
+            }
+            if (tailFinishInRange > bt.BodyFinish) {
+                UpdatePackHalves(
+                    leafAndPackIdx,
+                    GetDataPtr(bt.SampleWeightedDerivatives[dim]),
+                    sampleWeightsData,
+                    NCB::TIndexRange<int>(Max((int)bt.BodyFinish, docIndexRange.Begin), tailFinishInRange),
+                    &TBucketStats::SumWeightedDelta,
+                    &TBucketStats::SumWeight,
                     stats
                 );
             }
@@ -304,6 +528,81 @@ inline static void CalcStatsKernel(
     }
 }
 
+// Stats of values of halves of a binary features pack over all documents in fold, one pass for all packed features
+template <typename TFullIndexType>
+static void CalcBinaryFeaturesPackStats(
+    const TCalcScoreFold& fold,
+    const TBinaryFeaturesPack* packs, // without subset indexing
+    bool isPlainMode,
+    int depth,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TBucketStats>* stats // [bodyTail & approxDim][leaf][half][halfValue]
+) {
+    const int approxDimension = fold.GetApproxDimension();
+    const int packHalvesStatsSize = GetPackHalvesStatsSize(depth);
+    const int statsCount = fold.GetBodyTailCount() * approxDimension * packHalvesStatsSize;
+    const TStatsIndexer leafAndPackIndexer(1 << LeafAndPackIdxPackBits);
+
+    const bool simpleIndexing = fold.NonCtrDataPermutationBlockSize == fold.GetDocCount();
+    const ui32* docInDataProviderIndexing =
+        simpleIndexing ?
+        nullptr
+        : fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
+    const int docInDataProviderBeginOffset = simpleIndexing ? fold.FeaturesSubsetBegin : 0;
+
+    TVector<TFullIndexType> leafAndPackIdx;
+    leafAndPackIdx.yresize(fold.GetDocCount());
+
+    stats->clear();
+    NCB::MapMerge(
+        localExecutor,
+        fold.GetCalcStatsIndexRanges(),
+        /*mapFunc*/[&](NCB::TIndexRange<int> indexRange, TVector<TBucketStats>* output) {
+            NCB::TIndexRange<int> docIndexRange = fold.HasQueryInfo() ?
+                NCB::TIndexRange<int>(
+                    fold.LearnQueriesInfo[indexRange.Begin].Begin,
+                    (indexRange.End == 0) ? 0 : fold.LearnQueriesInfo[indexRange.End - 1].End
+                )
+                : indexRange;
+
+            SetSingleIndex(
+                fold,
+                leafAndPackIndexer,
+                packs,
+                docInDataProviderIndexing,
+                docInDataProviderBeginOffset,
+                fold.NonCtrDataPermutationBlockSize,
+                docIndexRange,
+                &leafAndPackIdx
+            );
+
+            output->yresize(statsCount);
+            for (int bodyTailIdx : xrange(fold.GetBodyTailCount())) {
+                for (int dim : xrange(approxDimension)) {
+                    CalcBinaryFeaturesPackStatsKernel(
+                        leafAndPackIdx,
+                        fold,
+                        isPlainMode,
+                        depth,
+                        fold.BodyTailArr[bodyTailIdx],
+                        dim,
+                        docIndexRange,
+                        output->data() + (bodyTailIdx * approxDimension + dim) * packHalvesStatsSize
+                    );
+                }
+            }
+        },
+        /*mergeFunc*/[&](TVector<TBucketStats>* output, TVector<TVector<TBucketStats>>&& addVector) {
+            for (const auto& addItem : addVector) {
+                for (int i : xrange(statsCount)) {
+                    (*output)[i].Add(addItem[i]);
+                }
+            }
+        },
+        stats
+    );
+}
+
 inline static void FixUpStats(
     int depth,
     const TStatsIndexer& indexer,
@@ -324,21 +623,24 @@ inline static void FixUpStats(
 }
 
 
-template <typename TFullIndexType, typename TIsCaching>
-static void CalcStatsImpl(
+/* If prevLevelStats != nullptr pairs contain only pairs with a document on the smallest side of the last split,
+ * pair weight stats of the other side are restored from prevLevelStats, see RestoreStatsFromPrevLevel.
+ */
+static void CalcPairwiseStatsImpl(
     const TCalcScoreFold& fold,
     const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
     const TFlatPairsInfo& pairs,
     const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
     const TSplitCandidate& split,
     const TStatsIndexer& indexer,
-    const TIsCaching& /*isCaching*/,
-    bool /*isPlainMode*/,
     int depth,
-    int /*splitStatsCount*/,
+    const TPairwiseStats* prevLevelStats,
+    bool smallestSplitSideValue,
     NPar::TLocalExecutor* localExecutor,
     TPairwiseStats* stats
 ) {
+    Y_ASSERT(!prevLevelStats || depth > 0);
+
     const int approxDimension = fold.GetApproxDimension();
     const int leafCount = 1 << depth;
 
@@ -355,6 +657,9 @@ static void CalcStatsImpl(
     const auto pairCount = pairs.ysize();
     const auto pairPart = CeilDiv(pairCount, blockCount);
 
+    const TSparseArray<ui8, ui32>* sparseBins = (split.Type == ESplitType::FloatFeature) ?
+        objectsDataProvider.GetFloatFeatureSparseBins((ui32)split.FeatureIdx) : nullptr;
+
     NCB::MapMerge(
         localExecutor,
         fold.GetCalcStatsIndexRanges(),
@@ -397,15 +702,44 @@ static void CalcStatsImpl(
                     GetCtr(allCtrs, ctr.Projection).Feature[ctr.CtrIdx][ctr.TargetBorderIdx][ctr.PriorIdx];
                 setOutput([buckets](ui32 docIdx) { return buckets[docIdx]; });
             } else if (split.Type == ESplitType::FloatFeature) {
-                const ui8* bucketSrcData =
-                    *((*objectsDataProvider.GetFloatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc());
                 const ui32* bucketIndexing
                     = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
-                setOutput(
-                    [bucketSrcData, bucketIndexing](ui32 docIdx) {
-                        return bucketSrcData[bucketIndexing[docIdx]];
-                    }
-                );
+                const auto packedBinaryBins =
+                    objectsDataProvider.GetFloatFeaturePackedBinaryBins((ui32)split.FeatureIdx);
+                if (sparseBins) {
+                    // der sums are calculated from non-default bins only after merge
+                    output->DerSums.assign(leafCount, TVector<double>(indexer.BucketCount, 0.0));
+                    auto pairWeightStatistics = ComputePairWeightStatistics(
+                        pairs,
+                        leafCount,
+                        indexer.BucketCount,
+                        fold.Indices,
+                        [bucketIndexing, &bins = *sparseBins](ui32 docIdx) {
+                            const ui32 featuresIdx = bucketIndexing[docIdx];
+                            const auto nonDefaultIndices = bins.GetIndices();
+                            const auto it = LowerBound(nonDefaultIndices.begin(), nonDefaultIndices.end(), featuresIdx);
+                            if ((it != nonDefaultIndices.end()) && (*it == featuresIdx)) {
+                                return bins.GetValues()[it - nonDefaultIndices.begin()];
+                            }
+                            return bins.GetDefaultValue();
+                        },
+                        pairIndexRange
+                    );
+                    output->PairWeightStatistics.Swap(pairWeightStatistics);
+                } else if (packedBinaryBins) {
+                    setOutput(
+                        [bucketSrcData = *packedBinaryBins, bucketIndexing](ui32 docIdx) {
+                            return bucketSrcData[bucketIndexing[docIdx]];
+                        }
+                    );
+                } else {
+                    const ui8* bucketSrcData = objectsDataProvider.GetFloatFeatureRawSrcData((ui32)split.FeatureIdx);
+                    setOutput(
+                        [bucketSrcData, bucketIndexing](ui32 docIdx) {
+                            return bucketSrcData[bucketIndexing[docIdx]];
+                        }
+                    );
+                }
             } else {
                 Y_ASSERT(split.Type == ESplitType::OneHotFeature);
                 const ui32* bucketSrcData =
@@ -426,6 +760,41 @@ static void CalcStatsImpl(
         },
         stats
     );
+
+    if (sparseBins) {
+        const auto& sparseData = fold.GetSparseFeaturesStatsData(
+            depth,
+            [&] (TCalcScoreFold::TSparseFeaturesStatsData* data) {
+                CalcSparseFeaturesStatsData(
+                    fold,
+                    sparseBins->GetSize(),
+                    /*isPairwiseScoring*/ true,
+                    /*isPlainMode*/ true,
+                    depth,
+                    data
+                );
+            }
+        );
+        const ui8 defaultBin = sparseBins->GetDefaultValue();
+        for (int leaf : xrange(leafCount)) {
+            stats->DerSums[leaf][defaultBin] += sparseData.LeafDerSums[leaf];
+        }
+        sparseBins->ForEachNonDefault(
+            [&] (ui32 featuresIdx, ui8 bin) {
+                const ui32 doc = sparseData.DocByFeaturesIdx[featuresIdx];
+                if (doc >= (ui32)docCount) { // not in fold
+                    return;
+                }
+                auto& leafDerSums = stats->DerSums[fold.Indices[doc]];
+                leafDerSums[bin] += weightedDerivativesData[doc];
+                leafDerSums[defaultBin] -= weightedDerivativesData[doc];
+            }
+        );
+    }
+
+    if (prevLevelStats) {
+        RestoreStatsFromPrevLevel(*prevLevelStats, depth, smallestSplitSideValue, stats);
+    }
 }
 
 
@@ -446,11 +815,6 @@ static void CalcStatsImpl(
 ) {
     Y_ASSERT(!isCaching || depth > 0);
 
-    const int docCount = fold.GetDocCount();
-
-    TVector<TFullIndexType> singleIdx;
-    singleIdx.yresize(docCount);
-
     const int statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
     const int filledSplitStatsCount = indexer.CalcSize(depth);
 
@@ -464,64 +828,152 @@ static void CalcStatsImpl(
         }
     };
 
-    NCB::MapMerge(
-        localExecutor,
-        fold.GetCalcStatsIndexRanges(),
-        /*mapFunc*/[&](NCB::TIndexRange<int> indexRange, TBucketStatsRefOptionalHolder* output) {
-            NCB::TIndexRange<int> docIndexRange = fold.HasQueryInfo() ?
-                NCB::TIndexRange<int>(
-                    fold.LearnQueriesInfo[indexRange.Begin].Begin,
-                    (indexRange.End == 0) ? 0 : fold.LearnQueriesInfo[indexRange.End - 1].End
-                )
-                : indexRange;
-
-            BuildSingleIndex(fold, objectsDataProvider, allCtrs, split, indexer, docIndexRange, &singleIdx);
-
-            if (output->NonInited()) {
-                (*output) = TBucketStatsRefOptionalHolder(statsCount);
-            } else {
-                Y_ASSERT(docIndexRange.Begin == 0);
+    const TSparseArray<ui8, ui32>* sparseBins = (split.Type == ESplitType::FloatFeature) ?
+        objectsDataProvider.GetFloatFeatureSparseBins((ui32)split.FeatureIdx) : nullptr;
+    const TMaybe<TPackedBinaryBins> packedBinaryBins = (split.Type == ESplitType::FloatFeature) ?
+        objectsDataProvider.GetFloatFeaturePackedBinaryBins((ui32)split.FeatureIdx) : Nothing();
+    if (sparseBins) {
+        const auto& sparseData = fold.GetSparseFeaturesStatsData(
+            depth,
+            [&] (TCalcScoreFold::TSparseFeaturesStatsData* data) {
+                CalcSparseFeaturesStatsData(
+                    fold,
+                    sparseBins->GetSize(),
+                    /*isPairwiseScoring*/ false,
+                    isPlainMode,
+                    depth,
+                    data
+                );
             }
-
-            forEachBodyTailAndApproxDimension(
-                [&](int bodyTailIdx, int dim, int bucketStatsArrayBegin) {
-                    TBucketStats* statsSubset = output->GetData().Data() + bucketStatsArrayBegin;
-                    CalcStatsKernel(
-                        isCaching && (indexRange.Begin == 0),
-                        singleIdx,
+        );
+        if (stats->NonInited()) {
+            (*stats) = TBucketStatsRefOptionalHolder(statsCount);
+        }
+        forEachBodyTailAndApproxDimension(
+            [&](int bodyTailIdx, int dim, int bucketStatsArrayBegin) {
+                CalcSparseStatsKernel(
+                    isCaching,
+                    *sparseBins,
+                    sparseData,
+                    fold,
+                    isPlainMode,
+                    indexer,
+                    depth,
+                    bodyTailIdx,
+                    dim,
+                    stats->GetData().Data() + bucketStatsArrayBegin
+                );
+            }
+        );
+    } else if (packedBinaryBins) {
+        Y_ASSERT(indexer.BucketCount == 2);
+        const auto& packStats = fold.GetBinaryFeaturesPackStats(
+            packedBinaryBins->Packs,
+            depth,
+            [&] (TVector<TBucketStats>* packHalvesStats) {
+                if (depth + LeafAndPackIdxPackBits <= 16) {
+                    CalcBinaryFeaturesPackStats<ui16>(
                         fold,
+                        packedBinaryBins->Packs,
                         isPlainMode,
-                        indexer,
                         depth,
-                        fold.BodyTailArr[bodyTailIdx],
-                        dim,
-                        docIndexRange,
-                        statsSubset
+                        localExecutor,
+                        packHalvesStats
+                    );
+                } else {
+                    CalcBinaryFeaturesPackStats<ui32>(
+                        fold,
+                        packedBinaryBins->Packs,
+                        isPlainMode,
+                        depth,
+                        localExecutor,
+                        packHalvesStats
                     );
                 }
-            );
-        },
-        /*mergeFunc*/[&](
-            TBucketStatsRefOptionalHolder* output,
-            TVector<TBucketStatsRefOptionalHolder>&& addVector
-        ) {
-            forEachBodyTailAndApproxDimension(
-                [&](int /*bodyTailIdx*/, int /*dim*/, int bucketStatsArrayBegin) {
-                    TBucketStats* outputStatsSubset =
-                        output->GetData().Data() + bucketStatsArrayBegin;
-
-                    for (const auto& addItem : addVector) {
-                        const TBucketStats* addStatsSubset =
-                            addItem.GetData().Data() + bucketStatsArrayBegin;
-                        for (size_t i : xrange(filledSplitStatsCount)) {
-                            (outputStatsSubset + i)->Add(*(addStatsSubset + i));
+            }
+        );
+        if (stats->NonInited()) {
+            (*stats) = TBucketStatsRefOptionalHolder(statsCount);
+        }
+        const int leafCount = 1 << depth;
+        const int packHalvesStatsSize = GetPackHalvesStatsSize(depth);
+        forEachBodyTailAndApproxDimension(
+            [&](int bodyTailIdx, int dim, int bucketStatsArrayBegin) {
+                GetPackedBinaryFeatureStats(
+                    packStats.data() + (bodyTailIdx * fold.GetApproxDimension() + dim) * packHalvesStatsSize,
+                    packedBinaryBins->BitIdx,
+                    // with caching only stats of the new half of leaves are calculated, as in CalcStatsKernel
+                    /*leafBegin*/ isCaching ? leafCount / 2 : 0,
+                    leafCount,
+                    stats->GetData().Data() + bucketStatsArrayBegin
+                );
+            }
+        );
+    } else {
+        const int docCount = fold.GetDocCount();
+
+        TVector<TFullIndexType> singleIdx;
+        singleIdx.yresize(docCount);
+
+        NCB::MapMerge(
+            localExecutor,
+            fold.GetCalcStatsIndexRanges(),
+            /*mapFunc*/[&](NCB::TIndexRange<int> indexRange, TBucketStatsRefOptionalHolder* output) {
+                NCB::TIndexRange<int> docIndexRange = fold.HasQueryInfo() ?
+                    NCB::TIndexRange<int>(
+                        fold.LearnQueriesInfo[indexRange.Begin].Begin,
+                        (indexRange.End == 0) ? 0 : fold.LearnQueriesInfo[indexRange.End - 1].End
+                    )
+                    : indexRange;
+
+                BuildSingleIndex(fold, objectsDataProvider, allCtrs, split, indexer, docIndexRange, &singleIdx);
+
+                if (output->NonInited()) {
+                    (*output) = TBucketStatsRefOptionalHolder(statsCount);
+                } else {
+                    Y_ASSERT(docIndexRange.Begin == 0);
+                }
+
+                forEachBodyTailAndApproxDimension(
+                    [&](int bodyTailIdx, int dim, int bucketStatsArrayBegin) {
+                        TBucketStats* statsSubset = output->GetData().Data() + bucketStatsArrayBegin;
+                        CalcStatsKernel(
+                            isCaching && (indexRange.Begin == 0),
+                            singleIdx,
+                            fold,
+                            isPlainMode,
+                            indexer,
+                            depth,
+                            fold.BodyTailArr[bodyTailIdx],
+                            dim,
+                            docIndexRange,
+                            statsSubset
+                        );
+                    }
+                );
+            },
+            /*mergeFunc*/[&](
+                TBucketStatsRefOptionalHolder* output,
+                TVector<TBucketStatsRefOptionalHolder>&& addVector
+            ) {
+                forEachBodyTailAndApproxDimension(
+                    [&](int /*bodyTailIdx*/, int /*dim*/, int bucketStatsArrayBegin) {
+                        TBucketStats* outputStatsSubset =
+                            output->GetData().Data() + bucketStatsArrayBegin;
+
+                        for (const auto& addItem : addVector) {
+                            const TBucketStats* addStatsSubset =
+                                addItem.GetData().Data() + bucketStatsArrayBegin;
+                            for (size_t i : xrange(filledSplitStatsCount)) {
+                                (outputStatsSubset + i)->Add(*(addStatsSubset + i));
+                            }
                         }
                     }
-                }
-            );
-        },
-        stats
-    );
+                );
+            },
+            stats
+        );
+    }
 
     if (isCaching) {
         forEachBodyTailAndApproxDimension(
@@ -663,7 +1115,8 @@ static void CalculateNonPairwiseScore(
     const TFold& initialFold,
     const TSplitCandidate& split,
     bool isPlainMode,
-    const int leafCount,
+    int leafBegin,
+    int leafEnd,
     const float l2Regularizer,
     const TStatsIndexer& indexer,
     const TBucketStats* splitStats,
@@ -671,6 +1124,7 @@ static void CalculateNonPairwiseScore(
     TVector<TScoreBin>* scoreBins
 ) {
     const int approxDimension = fold.GetApproxDimension();
+    const int leafCount = leafEnd - leafBegin;
 
     scoreBins->assign(indexer.BucketCount, TScoreBin());
 
@@ -679,7 +1133,8 @@ static void CalculateNonPairwiseScore(
         int docCount = initialFold.BodyTailArr[bodyTailIdx].BodyFinish;
         for (int dim = 0; dim < approxDimension; ++dim) {
             const TBucketStats* stats = splitStats
-                + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
+                + (bodyTailIdx * approxDimension + dim) * splitStatsCount
+                + indexer.GetIndex(leafBegin, 0);
             if (isPlainMode) {
                 UpdateScoreBin(
                     stats,
@@ -793,7 +1248,6 @@ void CalcStatsAndScores(
         }
     };
 
-    // Pairwise scoring doesn't use statistics from previous tree level
     if (isPairwiseScoring) {
         CB_ENSURE(!stats3d, "Pairwise scoring is incompatible with stats3d calculation");
 
@@ -801,7 +1255,37 @@ void CalcStatsAndScores(
         if (pairwiseStats == nullptr) {
             pairwiseStats = &localPairwiseStats;
         }
-        selectCalcStatsImpl(/*isCaching*/ std::false_type(), fold, /*splitStatsCount*/0, pairwiseStats);
+        // all documents are in fold, prevLevelData is used only for the smallest side of the last split
+        const TPairwiseStats* prevLevelPairwiseStats = (useTreeLevelCaching && depth > 0) ?
+            statsFromPrevTree->GetPairwiseStats(split, depth - 1) : nullptr; // thread-safe access
+        const TFlatPairsInfo& usedPairs = prevLevelPairwiseStats ?
+            prevLevelData.GetSmallestSplitSidePairs(
+                depth,
+                [&] (TFlatPairsInfo* smallestSplitSidePairs) {
+                    const int lastSplitBit = depth - 1;
+                    const auto isOnSmallestSplitSide = [&] (ui32 docIdx) {
+                        return bool((fold.Indices[docIdx] >> lastSplitBit) & 1) == prevLevelData.SmallestSplitSideValue;
+                    };
+                    for (const auto& pair : pairs) {
+                        if (isOnSmallestSplitSide(pair.WinnerId) || isOnSmallestSplitSide(pair.LoserId)) {
+                            smallestSplitSidePairs->push_back(pair);
+                        }
+                    }
+                }
+            ) : pairs;
+        CalcPairwiseStatsImpl(
+            fold,
+            objectsDataProvider,
+            usedPairs,
+            allCtrs,
+            split,
+            indexer,
+            depth,
+            prevLevelPairwiseStats,
+            prevLevelData.SmallestSplitSideValue,
+            localExecutor,
+            pairwiseStats
+        );
 
         if (scoreBins) {
             const float pairwiseBucketWeightPriorReg =
@@ -815,6 +1299,14 @@ void CalcStatsAndScores(
                 scoreBins
             );
         }
+        // stats of the last level are not used
+        if (useTreeLevelCaching && depth + 1 < int(fitParams.ObliviousTreeOptions->MaxDepth)) {
+            statsFromPrevTree->SetPairwiseStats(
+                split,
+                depth,
+                pairwiseStats == &localPairwiseStats ? std::move(localPairwiseStats) : TPairwiseStats(*pairwiseStats)
+            );
+        }
     } else {
         CB_ENSURE(!pairwiseStats, "Per-object scoring is incompatible with pairwiseStats calculation");
         TBucketStatsRefOptionalHolder extOrInSplitStats;
@@ -822,7 +1314,16 @@ void CalcStatsAndScores(
 
         const auto& treeOptions = fitParams.ObliviousTreeOptions.Get();
 
-        if (!useTreeLevelCaching) {
+        bool areStatsDirty = true;
+        TVector<TBucketStats, TPoolAllocator>* splitStatsFromCache = nullptr;
+        if (useTreeLevelCaching) {
+            splitStatsFromCache = statsFromPrevTree->GetStats(
+                split,
+                indexer.CalcSize(treeOptions.MaxDepth),
+                &areStatsDirty); // thread-safe access
+        }
+
+        if (splitStatsFromCache == nullptr) {
             splitStatsCount = indexer.CalcSize(depth);
             const int statsCount =
                 fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
@@ -842,10 +1343,7 @@ void CalcStatsAndScores(
             );
         } else {
             splitStatsCount = indexer.CalcSize(treeOptions.MaxDepth);
-            bool areStatsDirty;
-            TVector<TBucketStats, TPoolAllocator>& splitStatsFromCache =
-                statsFromPrevTree->GetStats(split, splitStatsCount, &areStatsDirty); // thread-safe access
-            extOrInSplitStats = TBucketStatsRefOptionalHolder(splitStatsFromCache);
+            extOrInSplitStats = TBucketStatsRefOptionalHolder(*splitStatsFromCache);
             if (depth == 0 || areStatsDirty) {
                 selectCalcStatsImpl(
                     /*isCaching*/ std::false_type(),
@@ -865,7 +1363,7 @@ void CalcStatsAndScores(
                 TBucketStatsCache::GetStatsInUse(fold.GetBodyTailCount() * fold.GetApproxDimension(),
                     splitStatsCount,
                     indexer.CalcSize(depth),
-                    splitStatsFromCache
+                    *splitStatsFromCache
                 ).swap(stats3d->Stats);
                 stats3d->BucketCount = bucketCount;
                 stats3d->MaxLeafCount = 1U << depth;
@@ -878,6 +1376,7 @@ void CalcStatsAndScores(
                 *initialFold,
                 split,
                 isPlainMode,
+                /*leafBegin*/ 0,
                 leafCount,
                 l2Regularizer,
                 indexer,
@@ -889,6 +1388,86 @@ void CalcStatsAndScores(
     }
 }
 
+void CalcStatsAndLeafScores(
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TVector<int>& splitsCount,
+    const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
+    const TCalcScoreFold& fold,
+    const TCalcScoreFold& prevLevelData,
+    const TFold& initialFold,
+    const NCatboostOptions::TCatBoostOptions& fitParams,
+    const TSplitCandidate& split,
+    int depth,
+    bool useTreeLevelCaching,
+    NPar::TLocalExecutor* localExecutor,
+    TBucketStatsCache* statsFromPrevTree,
+    TVector<TVector<TScoreBin>>* leafScoreBins
+) {
+    TStats3D stats3d;
+    CalcStatsAndScores(
+        objectsDataProvider,
+        splitsCount,
+        allCtrs,
+        fold,
+        prevLevelData,
+        &initialFold,
+        TFlatPairsInfo(),
+        fitParams,
+        split,
+        depth,
+        useTreeLevelCaching,
+        localExecutor,
+        statsFromPrevTree,
+        &stats3d,
+        /*pairwiseStats*/ nullptr,
+        /*scoreBins*/ nullptr
+    );
+    const TStatsIndexer indexer(stats3d.BucketCount);
+    const int leafCount = 1 << depth;
+    const bool isPlainMode = IsPlainMode(fitParams.BoostingOptions->BoostingType);
+    const float l2Regularizer = static_cast<float>(fitParams.ObliviousTreeOptions->L2Reg);
+    const int splitStatsCount = indexer.CalcSize(depth);
+    leafScoreBins->resize(leafCount);
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        CalculateNonPairwiseScore(
+            fold,
+            initialFold,
+            split,
+            isPlainMode,
+            leaf,
+            leaf + 1,
+            l2Regularizer,
+            indexer,
+            GetDataPtr(stats3d.Stats),
+            splitStatsCount,
+            &(*leafScoreBins)[leaf]
+        );
+    }
+
+    // last score bin of every leaf is not used for splits, it holds the score of the leaf without split
+    const int approxDimension = fold.GetApproxDimension();
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        TScoreBin& noSplitScoreBin = (*leafScoreBins)[leaf].back();
+        for (int bodyTailIdx = 0; bodyTailIdx < fold.GetBodyTailCount(); ++bodyTailIdx) {
+            const double sumAllWeights = initialFold.BodyTailArr[bodyTailIdx].BodySumWeight;
+            const int docCount = initialFold.BodyTailArr[bodyTailIdx].BodyFinish;
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                const TBucketStats* stats = GetDataPtr(stats3d.Stats)
+                    + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
+                TBucketStats leafStats{0, 0, 0, 0};
+                for (int bucket = 0; bucket < indexer.BucketCount; ++bucket) {
+                    leafStats.Add(stats[indexer.GetIndex(leaf, bucket)]);
+                }
+                const double leafAvrg = isPlainMode
+                    ? CalcAverage(leafStats.SumWeightedDelta, leafStats.SumWeight, l2Regularizer, sumAllWeights, docCount)
+                    : CalcAverage(leafStats.SumDelta, leafStats.Count, l2Regularizer, sumAllWeights, docCount);
+                noSplitScoreBin.DP += CountDp(leafAvrg, leafStats);
+                noSplitScoreBin.D2 += CountD2(leafAvrg, leafStats);
+            }
+        }
+    }
+}
+
 TVector<TScoreBin> GetScoreBins(
     const TStats3D& stats,
     ESplitType splitType,
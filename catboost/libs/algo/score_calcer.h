@@ -38,6 +38,28 @@ void CalcStatsAndScores(
     TVector<TScoreBin>* scoreBins // can be nullptr, if so - don't calc and return this data (used in dictributed mode now)
 );
 
+/* Same as CalcStatsAndScores for per-object scoring, but score bins are calculated separately for each leaf
+ * of the current depth (leafScoreBins[leaf][splitIdx]), this is used for non-symmetric trees where each leaf
+ * gets its own split.
+ * leafScoreBins[leaf].back() holds the score of the leaf without split, so that gains of splitting different
+ * leaves can be compared.
+ */
+void CalcStatsAndLeafScores(
+    const NCB::TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TVector<int>& splitsCount,
+    const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
+    const TCalcScoreFold& fold,
+    const TCalcScoreFold& prevLevelData,
+    const TFold& initialFold,
+    const NCatboostOptions::TCatBoostOptions& fitParams,
+    const TSplitCandidate& split,
+    int depth,
+    bool useTreeLevelCaching,
+    NPar::TLocalExecutor* localExecutor,
+    TBucketStatsCache* statsFromPrevTree,
+    TVector<TVector<TScoreBin>>* leafScoreBins
+);
+
 TVector<TScoreBin> GetScoreBins(
     const TStats3D& stats,
     ESplitType splitType,
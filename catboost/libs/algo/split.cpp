@@ -1,6 +1,8 @@
 #include "split.h"
 #include "learn_context.h"
 
+#include <util/generic/ylimits.h>
+
 using namespace NCB;
 
 
@@ -70,3 +72,34 @@ int GetSplitCount(
         return (int)quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(split.FeatureIdx)).OnLearnOnly;
     }
 }
+
+// ::Save of TVector writes 0xffffffff followed by ui64 size for large sizes, so this can't be a count of splits
+static const ui32 LargeSizeEscape = 0xffffffff;
+static const ui64 NonSymmetricSplitTreeMarker = Max<ui64>();
+
+void TSplitTree::Save(IOutputStream* s) const {
+    if (IsOblivious()) {
+        ::Save(s, Splits);
+        return;
+    }
+    ::SaveMany(s, LargeSizeEscape, NonSymmetricSplitTreeMarker, Splits, SplitDepths, SplitLeafIndices);
+}
+
+void TSplitTree::Load(IInputStream* s) {
+    SplitDepths.clear();
+    SplitLeafIndices.clear();
+    ui32 splitCount;
+    ::Load(s, splitCount);
+    ui64 largeSplitCount = splitCount;
+    if (splitCount == LargeSizeEscape) {
+        ::Load(s, largeSplitCount);
+        if (largeSplitCount == NonSymmetricSplitTreeMarker) {
+            ::LoadMany(s, Splits, SplitDepths, SplitLeafIndices);
+            return;
+        }
+    }
+    Splits.resize(largeSplitCount);
+    for (auto& split : Splits) {
+        ::Load(s, split);
+    }
+}
@@ -125,20 +125,47 @@ struct TSplit : public TSplitCandidate {
 struct TSplitTree {
     TVector<TSplit> Splits;
 
+    /* Non-symmetric (depthwise) trees only, empty for symmetric trees.
+     * Splits[i] is applied at level SplitDepths[i] only to objects in leaf SplitLeafIndices[i] of previous
+     * levels, so leaf indices have the same layout as for symmetric trees of the same depth: objects in
+     * leaves without split go to the false side on all following levels.
+     */
+    TVector<int> SplitDepths;
+    TVector<int> SplitLeafIndices;
+
     void AddSplit(const TSplit& split) {
+        Y_ASSERT(SplitDepths.empty());
+        Splits.push_back(split);
+    }
+
+    // splits must be added in nondecreasing order of depth
+    void AddLeafSplit(const TSplit& split, int depth, int leafIdx) {
+        Y_ASSERT(SplitDepths.size() == Splits.size());
+        Y_ASSERT(SplitDepths.empty() || SplitDepths.back() <= depth);
         Splits.push_back(split);
+        SplitDepths.push_back(depth);
+        SplitLeafIndices.push_back(leafIdx);
     }
 
     void DeleteSplit(int splitIdx) {
+        Y_ASSERT(SplitDepths.empty());
         Splits.erase(Splits.begin() + splitIdx);
     }
 
+    inline bool IsOblivious() const {
+        return SplitDepths.empty();
+    }
+
+    inline int GetSplitDepth(int splitIdx) const {
+        return IsOblivious() ? splitIdx : SplitDepths[splitIdx];
+    }
+
     inline int GetLeafCount() const {
-        return 1 << Splits.ysize();
+        return 1 << GetDepth();
     }
 
     inline int GetDepth() const {
-        return Splits.ysize();
+        return IsOblivious() ? Splits.ysize() : SplitDepths.back() + 1;
     }
     TVector<TBinFeature> GetBinFeatures() const {
         TVector<TBinFeature> result;
@@ -170,8 +197,10 @@ struct TSplitTree {
         return result;
     }
 
-    Y_SAVELOAD_DEFINE(Splits)
-    SAVELOAD(Splits);
+    // symmetric trees are saved in the same layout as before non-symmetric trees, so older snapshots are loaded
+    void Save(IOutputStream* s) const;
+    void Load(IInputStream* s);
+    SAVELOAD(Splits, SplitDepths, SplitLeafIndices);
 };
 
 struct TTreeStats {
@@ -2,6 +2,11 @@
 
 #include <catboost/libs/helpers/restorable_rng.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
 THolder<IDerCalcer> BuildError(
     const NCatboostOptions::TCatBoostOptions& params,
     const TMaybe<TCustomObjectiveDescriptor>& descriptor
@@ -155,6 +160,143 @@ static void GenerateBernoulliWeightsForPairs(
     }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
+static void CalcGradientNorms(
+    int learnSampleCount,
+    const TFold& fold,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<double>* gradientNorms
+) {
+    const auto& weightedDerivatives = fold.BodyTailArr[0].WeightedDerivatives;
+    const int approxDimension = weightedDerivatives.ysize();
+    gradientNorms->yresize(learnSampleCount);
+    double* gradientNormsData = gradientNorms->data();
+    localExecutor->ExecRange([&](int i) {
+        if (approxDimension == 1) {
+            gradientNormsData[i] = Abs(weightedDerivatives[0][i]);
+        } else {
+            double sumOfSquares = 0;
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                sumOfSquares += Sqr(weightedDerivatives[dim][i]);
+            }
+            gradientNormsData[i] = sqrt(sumOfSquares);
+        }
+    }, NPar::TLocalExecutor::TExecRangeParams(0, learnSampleCount).SetBlockSize(4000)
+     , NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+/* Gradients are partitioned around pivots like in quickselect, so expected time is linear.
+ */
+double CalcMvsThreshold(double sampleSize, TVector<double>* gradients) {
+    double smallGradientsSum = 0; // gradients below the threshold, objects are taken with probability g / mu
+    double largeGradientsCount = 0; // gradients above the threshold, objects are always taken
+    double threshold = 0;
+    auto begin = gradients->begin();
+    auto end = gradients->end();
+    while (begin != end) {
+        const double pivot = *(begin + (end - begin) / 2);
+        const auto lessEnd = std::partition(begin, end, [=](double g) { return g < pivot; });
+        const auto equalEnd = std::partition(lessEnd, end, [=](double g) { return g == pivot; });
+        const double lessSum = Accumulate(begin, lessEnd, 0.0);
+        if (pivot == 0 || (smallGradientsSum + lessSum) / pivot + largeGradientsCount + (end - lessEnd) > sampleSize) {
+            // threshold is above pivot
+            smallGradientsSum += lessSum + pivot * (equalEnd - lessEnd);
+            begin = equalEnd;
+        } else {
+            largeGradientsCount += end - lessEnd;
+            threshold = pivot;
+            end = lessEnd;
+        }
+    }
+    if (sampleSize > largeGradientsCount && smallGradientsSum > 0) {
+        return smallGradientsSum / (sampleSize - largeGradientsCount);
+    }
+    return threshold;
+}
+
+TVector<ui32> SelectGossTopObjects(TConstArrayRef<double> gradients, int topCount, TRestorableFastRng64* rand) {
+    const int objectCount = SafeIntegerCast<int>(gradients.size());
+    topCount = Min(topCount, objectCount);
+    TVector<ui64> tieBreakers;
+    tieBreakers.yresize(objectCount);
+    for (auto& tieBreaker : tieBreakers) {
+        tieBreaker = rand->GenRand();
+    }
+    TVector<ui32> objects = xrange<ui32>(objectCount);
+    NthElement(
+        objects.begin(),
+        objects.begin() + topCount,
+        objects.end(),
+        [&] (ui32 lhs, ui32 rhs) {
+            return gradients[lhs] > gradients[rhs]
+                || (gradients[lhs] == gradients[rhs] && tieBreakers[lhs] < tieBreakers[rhs]);
+        }
+    );
+    objects.resize(topCount);
+    return objects;
+}
+
+/* Objects with larger gradients are more important for split scores, so they are taken
+ * with larger probability p, and weights of taken objects are 1 / p to keep estimates unbiased.
+ * MVS: p = min(1, g / mu), mu is chosen so that expected sample size is takenFraction of all objects.
+ * GOSS: gossTopFraction of objects with top gradients are always taken, others are taken uniformly.
+ */
+static void GenerateGradientBasedWeights(
+    int learnSampleCount,
+    EBootstrapType bootstrapType,
+    float takenFraction,
+    float gossTopFraction,
+    NPar::TLocalExecutor* localExecutor,
+    TRestorableFastRng64* rand,
+    TFold* fold
+) {
+    TVector<double> gradientNorms;
+    CalcGradientNorms(learnSampleCount, *fold, localExecutor, &gradientNorms);
+
+    double mvsThreshold = 0;
+    TVector<ui8> isGossTop;
+    double gossRestProbability = 1.0;
+    // all gradients are zero, so there is nothing to prefer
+    bool isUniform = false;
+    if (bootstrapType == EBootstrapType::MVS) {
+        TVector<double> reorderedGradientNorms(gradientNorms);
+        mvsThreshold = CalcMvsThreshold(takenFraction * learnSampleCount, &reorderedGradientNorms);
+        isUniform = mvsThreshold == 0;
+    } else {
+        Y_ASSERT(bootstrapType == EBootstrapType::GOSS);
+        const int topCount = Max<int>(1, gossTopFraction * learnSampleCount);
+        isGossTop.resize(learnSampleCount, 0);
+        double maxGradientNorm = 0;
+        for (ui32 objectIdx : SelectGossTopObjects(gradientNorms, topCount, rand)) {
+            isGossTop[objectIdx] = true;
+            maxGradientNorm = Max(maxGradientNorm, gradientNorms[objectIdx]);
+        }
+        gossRestProbability = (takenFraction - gossTopFraction) / (1.0 - gossTopFraction);
+        isUniform = maxGradientNorm == 0;
+    }
+
+    const ui64 randSeed = rand->GenRand();
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, learnSampleCount);
+    blockParams.SetBlockSize(1000);
+    localExecutor->ExecRange([&](int blockIdx) {
+        TRestorableFastRng64 rand(randSeed + blockIdx);
+        rand.Advance(10); // reduce correlation between RNGs in different threads
+        const double* gradientNormsData = gradientNorms.data();
+        const ui8* isGossTopData = isGossTop.data();
+        float* sampleWeightsData = fold->SampleWeights.data();
+        NPar::TLocalExecutor::BlockedLoopBody(blockParams, [=,&rand](int i) {
+            double probability = takenFraction;
+            if (!isUniform) {
+                if (bootstrapType == EBootstrapType::MVS) {
+                    probability = Min(1.0, gradientNormsData[i] / mvsThreshold);
+                } else {
+                    probability = isGossTopData[i] ? 1.0 : gossRestProbability;
+                }
+            }
+            sampleWeightsData[i] = rand.GenRandReal1() < probability ? 1.0 / probability : 0.0f;
+        })(blockIdx);
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 static void CalcWeightedData(
     int learnSampleCount,
     EBoostingType boostingType,
@@ -230,6 +372,19 @@ void Bootstrap(
                 Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1);
             }
             break;
+        case EBootstrapType::MVS:
+        case EBootstrapType::GOSS:
+            Y_ASSERT(!isPairwiseScoring);
+            GenerateGradientBasedWeights(
+                learnSampleCount,
+                bootstrapType,
+                takenFraction,
+                params.ObliviousTreeOptions->BootstrapConfig->GetGossTopFraction(),
+                localExecutor,
+                rand,
+                fold
+            );
+            break;
         default:
             CB_ENSURE(false, "Not supported bootstrap type on CPU: " << bootstrapType);
     }
@@ -14,6 +14,7 @@
 #include <library/binsaver/bin_saver.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 
 
@@ -48,6 +49,13 @@ void Bootstrap(const NCatboostOptions::TCatBoostOptions& params,
                NPar::TLocalExecutor* localExecutor,
                TRestorableFastRng64* rand);
 
+/// Threshold mu such that sum of min(1, g / mu) over gradients equals sampleSize for MVS bootstrap.
+/// Gradients are reordered. Returns zero if all gradients are zero.
+double CalcMvsThreshold(double sampleSize, TVector<double>* gradients);
+
+/// Indices of exactly topCount objects with the largest gradients for GOSS bootstrap, ties are broken randomly.
+TVector<ui32> SelectGossTopObjects(TConstArrayRef<double> gradients, int topCount, TRestorableFastRng64* rand);
+
 THolder<IDerCalcer> BuildError(const NCatboostOptions::TCatBoostOptions& params, const TMaybe<TCustomObjectiveDescriptor>&);
 
 void CalcWeightedDerivatives(
@@ -94,8 +94,16 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             trainFolds.push_back(&ctx->LearnProgress.Folds[foldId]);
         }
 
-        TrimOnlineCTRcache(trainFolds);
-        TrimOnlineCTRcache({ &ctx->LearnProgress.AveragingFold });
+        for (const auto& split : bestSplitTree.Splits) {
+            if (split.Type == ESplitType::OnlineCtr) {
+                for (auto* foldPtr : trainFolds) {
+                    foldPtr->TouchCTR(split.Ctr.Projection);
+                }
+                ctx->LearnProgress.AveragingFold.TouchCTR(split.Ctr.Projection);
+            }
+        }
+        TrimOnlineCTRcache(trainFolds, *ctx);
+        TrimOnlineCTRcache({ &ctx->LearnProgress.AveragingFold }, *ctx);
         {
             TVector<TFold*> allFolds = trainFolds;
             allFolds.push_back(&ctx->LearnProgress.AveragingFold);
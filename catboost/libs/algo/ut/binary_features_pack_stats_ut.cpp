@@ -0,0 +1,69 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/algo/binary_features_pack_stats.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(BinaryFeaturesPackStats) {
+    Y_UNIT_TEST(PackedFeaturesStatsAreSameAsFeaturesStats) {
+        constexpr int featureCount = sizeof(NCB::TBinaryFeaturesPack) * CHAR_BIT;
+        const int depth = 3;
+        const int leafCount = 1 << depth;
+        const int docCount = 1000;
+        TFastRng64 rng(0);
+        TVector<ui32> leaves(docCount);
+        TVector<NCB::TBinaryFeaturesPack> packs(docCount);
+        TVector<ui32> leafAndPackIdx(docCount);
+        TVector<double> derivatives(docCount);
+        TVector<float> weights(docCount);
+        for (auto doc : xrange(docCount)) {
+            leaves[doc] = rng.Uniform(leafCount);
+            packs[doc] = rng.Uniform(1 << featureCount);
+            leafAndPackIdx[doc] = (leaves[doc] << LeafAndPackIdxPackBits) | packs[doc];
+            derivatives[doc] = rng.GenRandReal1() * 2.0 - 1.0;
+            weights[doc] = rng.GenRandReal1();
+        }
+
+        for (bool hasWeights : {false, true}) {
+            const float* weightsData = hasWeights ? weights.data() : nullptr;
+            const NCB::TIndexRange<int> docIndexRange(100, docCount);
+
+            TVector<TBucketStats> packHalvesStats(GetPackHalvesStatsSize(depth), TBucketStats{0, 0, 0, 0});
+            UpdatePackHalves(
+                leafAndPackIdx,
+                derivatives.data(),
+                weightsData,
+                docIndexRange,
+                &TBucketStats::SumDelta,
+                &TBucketStats::Count,
+                packHalvesStats.data()
+            );
+
+            for (auto bitIdx : xrange(featureCount)) {
+                TVector<TBucketStats> expectedStats(2 * leafCount, TBucketStats{0, 0, 0, 0});
+                for (int doc : docIndexRange.Iter()) {
+                    TBucketStats& bucketStats = expectedStats[2 * leaves[doc] + ((packs[doc] >> bitIdx) & 1)];
+                    bucketStats.SumDelta += derivatives[doc];
+                    bucketStats.Count += hasWeights ? weights[doc] : 1.0;
+                }
+
+                // stats of leaves before leafBegin are kept
+                TVector<TBucketStats> stats(2 * leafCount, TBucketStats{1, 1, 1, 1});
+                const int leafBegin = 2;
+                GetPackedBinaryFeatureStats(packHalvesStats.data(), bitIdx, leafBegin, leafCount, stats.data());
+
+                for (auto statIdx : xrange(2 * leafCount)) {
+                    if (statIdx < 2 * leafBegin) {
+                        UNIT_ASSERT_VALUES_EQUAL(stats[statIdx].SumDelta, 1.0);
+                        UNIT_ASSERT_VALUES_EQUAL(stats[statIdx].Count, 1.0);
+                        continue;
+                    }
+                    UNIT_ASSERT_DOUBLES_EQUAL(stats[statIdx].SumDelta, expectedStats[statIdx].SumDelta, 1e-9);
+                    UNIT_ASSERT_DOUBLES_EQUAL(stats[statIdx].Count, expectedStats[statIdx].Count, 1e-9);
+                    UNIT_ASSERT_VALUES_EQUAL(stats[statIdx].SumWeightedDelta, 0.0);
+                    UNIT_ASSERT_VALUES_EQUAL(stats[statIdx].SumWeight, 0.0);
+                }
+            }
+        }
+    }
+}
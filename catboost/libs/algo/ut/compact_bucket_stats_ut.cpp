@@ -0,0 +1,66 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/algo/compact_bucket_stats.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(CompactBucketStats) {
+    Y_UNIT_TEST(UsedOnlyForRangesOfWholeBlocks) {
+        const int blockSize = GetCompactStatsBlockSize(CompactStatsMinSize);
+        UNIT_ASSERT(!UseCompactStats(CompactStatsMinSize - 1, NCB::TIndexRange<int>(0, 1 << 30)));
+        UNIT_ASSERT(!UseCompactStats(CompactStatsMaxSize + 1, NCB::TIndexRange<int>(0, 1 << 30)));
+        UNIT_ASSERT(!UseCompactStats(CompactStatsMinSize, NCB::TIndexRange<int>(1, blockSize)));
+        UNIT_ASSERT(UseCompactStats(CompactStatsMinSize, NCB::TIndexRange<int>(1, blockSize + 1)));
+    }
+
+    Y_UNIT_TEST(CompactStatsAreCloseToDoubleStats) {
+        const int statsSize = CompactStatsMinSize;
+        // several blocks, the last one is not full
+        const int docCount = 2 * GetCompactStatsBlockSize(statsSize) + 1000;
+        TFastRng64 rng(0);
+        TVector<ui32> singleIdx(docCount);
+        TVector<double> derivatives(docCount);
+        TVector<float> weights(docCount);
+        for (auto doc : xrange(docCount)) {
+            // a few heavy buckets with many documents too
+            singleIdx[doc] = rng.Uniform(4) == 0 ? rng.Uniform(8) : rng.Uniform(statsSize);
+            derivatives[doc] = rng.GenRandReal1() * 200.0 - 100.0;
+            weights[doc] = rng.GenRandReal1() * 2.0;
+        }
+
+        for (bool hasWeights : {false, true}) {
+            const float* weightsData = hasWeights ? weights.data() : nullptr;
+            const NCB::TIndexRange<int> docIndexRange(500, docCount);
+            UNIT_ASSERT(UseCompactStats(statsSize, docIndexRange));
+
+            TVector<TBucketStats> expectedStats(statsSize, TBucketStats{0, 0, 0, 0});
+            for (int doc : docIndexRange.Iter()) {
+                expectedStats[singleIdx[doc]].SumDelta += derivatives[doc];
+                expectedStats[singleIdx[doc]].Count += hasWeights ? weights[doc] : 1.0;
+            }
+
+            TVector<TBucketStats> stats(statsSize, TBucketStats{0, 0, 0, 0});
+            TVector<TCompactBucketStats> compactStats;
+            compactStats.yresize(statsSize);
+            UpdateCompact(
+                singleIdx,
+                derivatives.data(),
+                weightsData,
+                docIndexRange,
+                &TBucketStats::SumDelta,
+                &TBucketStats::Count,
+                GetCompactStatsBlockSize(statsSize),
+                &compactStats,
+                stats.data()
+            );
+
+            for (auto statIdx : xrange(statsSize)) {
+                const double tolerance = 1e-5 * (1.0 + Abs(expectedStats[statIdx].Count) * 100.0);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats[statIdx].SumDelta, expectedStats[statIdx].SumDelta, tolerance);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats[statIdx].Count, expectedStats[statIdx].Count, tolerance);
+                UNIT_ASSERT_VALUES_EQUAL(stats[statIdx].SumWeightedDelta, 0.0);
+                UNIT_ASSERT_VALUES_EQUAL(stats[statIdx].SumWeight, 0.0);
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/algo/error_functions.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <cmath>
+
+Y_UNIT_TEST_SUITE(TErrorFunctionsTest) {
+    Y_UNIT_TEST(TestRMSEDersRange) {
+        TFastRng64 rng(0);
+        const int objectCount = 100;
+        TVector<double> approxes(objectCount);
+        TVector<double> deltas(objectCount);
+        TVector<float> targets(objectCount);
+        TVector<float> weights(objectCount);
+        for (auto i : xrange(objectCount)) {
+            approxes[i] = rng.GenRandReal1() - 0.5;
+            deltas[i] = rng.GenRandReal1() - 0.5;
+            targets[i] = rng.GenRandReal1();
+            weights[i] = rng.GenRandReal1() + 0.5;
+        }
+        const TRMSEError error(/*isExpApprox*/ false);
+
+        TVector<TDers> ders(objectCount);
+        error.CalcDersRange(1, objectCount - 1, /*calcThirdDer*/ true, approxes.data(), deltas.data(), targets.data(), weights.data(), ders.data());
+        TVector<double> firstDers(objectCount);
+        error.CalcFirstDerRange(1, objectCount - 1, approxes.data(), deltas.data(), targets.data(), weights.data(), firstDers.data());
+        for (auto i : xrange(1, objectCount)) {
+            const double expectedDer = (targets[i] - approxes[i] - deltas[i]) * weights[i];
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der1, expectedDer, 1e-9);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der2, -weights[i], 1e-9);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der3, 0.0, 1e-9);
+            UNIT_ASSERT_DOUBLES_EQUAL(firstDers[i], expectedDer, 1e-9);
+        }
+    }
+
+    Y_UNIT_TEST(TestPoissonDersRange) {
+        TFastRng64 rng(1);
+        const int objectCount = 50;
+        TVector<double> approxExps(objectCount);
+        TVector<float> targets(objectCount);
+        for (auto i : xrange(objectCount)) {
+            approxExps[i] = std::exp(rng.GenRandReal1() - 0.5);
+            targets[i] = rng.Uniform(5);
+        }
+        const TPoissonError error(/*isExpApprox*/ true);
+
+        TVector<TDers> ders(objectCount);
+        error.CalcDersRange(0, objectCount, /*calcThirdDer*/ false, approxExps.data(), nullptr, targets.data(), nullptr, ders.data());
+        for (auto i : xrange(objectCount)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der1, targets[i] - approxExps[i], 1e-9);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der2, -approxExps[i], 1e-9);
+        }
+    }
+
+    Y_UNIT_TEST(TestMultiClassDers) {
+        const TMultiClassError error(/*isExpApprox*/ false);
+        const TVector<double> approx = {0.5, -1.0, 2.0};
+        const float target = 1;
+        const float weight = 2;
+        TVector<double> der(approx.size());
+        THessianInfo der2(approx.ysize(), EHessianType::Symmetric);
+        error.CalcDersMulti(approx, target, weight, &der, &der2);
+
+        double expSum = 0;
+        for (double value : approx) {
+            expSum += std::exp(value);
+        }
+        TVector<double> softmax;
+        for (double value : approx) {
+            softmax.push_back(std::exp(value) / expSum);
+        }
+        int idx = 0;
+        for (auto dimY : xrange(approx.size())) {
+            const double expectedDer = ((dimY == target ? 1 : 0) - softmax[dimY]) * weight;
+            UNIT_ASSERT_DOUBLES_EQUAL(der[dimY], expectedDer, 1e-6);
+            UNIT_ASSERT_DOUBLES_EQUAL(der2.Data[idx++], softmax[dimY] * (softmax[dimY] - 1) * weight, 1e-6);
+            for (auto dimX : xrange(dimY + 1, approx.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(der2.Data[idx++], softmax[dimY] * softmax[dimX] * weight, 1e-6);
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/algo/fold.h>
+
+static TProjection MakeCatFeaturesProjection(const TVector<int>& catFeatures) {
+    TProjection proj;
+    proj.CatFeatures = catFeatures;
+    return proj;
+}
+
+static void AddOnlineCtr(const TProjection& proj, size_t memoryUsage, TFold* fold) {
+    TOnlineCTR& ctr = fold->GetCtrRef(proj);
+    ctr.Feature.resize(1);
+    ctr.Feature[0].SetSizes(1, 1);
+    ctr.Feature[0][0][0] = TVector<ui8>(memoryUsage);
+}
+
+static bool HasOnlineCtr(const TFold& fold, const TProjection& proj) {
+    return fold.GetCtrs(proj).contains(proj);
+}
+
+Y_UNIT_TEST_SUITE(TFoldTest) {
+    Y_UNIT_TEST(TrimOnlineCTRByMemoryDropsLeastRecentlyUsed) {
+        const size_t ctrMemoryUsage = 1000;
+        const TProjection single0 = MakeCatFeaturesProjection({0});
+        const TProjection single1 = MakeCatFeaturesProjection({1});
+        const TProjection combination01 = MakeCatFeaturesProjection({0, 1});
+        const TProjection single2 = MakeCatFeaturesProjection({2});
+        const TProjection notUsed = MakeCatFeaturesProjection({3});
+
+        TFold fold;
+        for (const auto& proj : {single0, single1, combination01, single2, notUsed}) {
+            AddOnlineCtr(proj, ctrMemoryUsage, &fold);
+            UNIT_ASSERT_VALUES_EQUAL(fold.GetCtr(proj).GetMemoryUsage(), ctrMemoryUsage);
+        }
+        for (const auto& proj : {single0, single1, combination01, single2, single0}) {
+            fold.TouchCTR(proj);
+        }
+
+        fold.TrimOnlineCTRByMemory(5 * ctrMemoryUsage);
+        for (const auto& proj : {single0, single1, combination01, single2, notUsed}) {
+            UNIT_ASSERT(HasOnlineCtr(fold, proj));
+        }
+
+        fold.TrimOnlineCTRByMemory(5 * ctrMemoryUsage / 2);
+        UNIT_ASSERT(HasOnlineCtr(fold, single0));
+        UNIT_ASSERT(HasOnlineCtr(fold, single2));
+        UNIT_ASSERT(!HasOnlineCtr(fold, combination01));
+        UNIT_ASSERT(!HasOnlineCtr(fold, single1));
+        UNIT_ASSERT(!HasOnlineCtr(fold, notUsed));
+
+        fold.TouchCTR(single2);
+        fold.TrimOnlineCTRByMemory(ctrMemoryUsage);
+        UNIT_ASSERT(HasOnlineCtr(fold, single2));
+        UNIT_ASSERT(!HasOnlineCtr(fold, single0));
+
+        fold.TrimOnlineCTRByMemory(0);
+        UNIT_ASSERT(!HasOnlineCtr(fold, single2));
+    }
+}
@@ -0,0 +1,53 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/algo/index_hash_calcer.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(IndexHashCalcer) {
+    Y_UNIT_TEST(ReindexDenseKeysMatchesReindexHash) {
+        TFastRng64 rng(0);
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        for (ui64 keyCount : {1, 10, 64, 1000}) {
+            for (size_t learnCount : {0, 1, 100, 2000}) {
+                const size_t testCount = 300;
+                TVector<ui64> keys(learnCount + testCount);
+                for (auto& key : keys) {
+                    key = rng.Uniform(keyCount);
+                }
+                TVector<ui64> reindexedByHash = keys;
+                TDenseHash<ui64, ui32> reindexHash;
+                const size_t learnValueCountByHash = ComputeReindexHash(
+                    Max<ui64>(),
+                    &reindexHash,
+                    reindexedByHash.begin(),
+                    reindexedByHash.begin() + learnCount);
+                const size_t valueCountByHash = UpdateReindexHash(
+                    &reindexHash,
+                    reindexedByHash.begin() + learnCount,
+                    reindexedByHash.end());
+
+                TVector<ui64> reindexed = keys;
+                size_t learnValueCount = 0;
+                const size_t valueCount = ReindexDenseKeys(
+                    keyCount,
+                    reindexed.begin(),
+                    reindexed.begin() + learnCount,
+                    reindexed.end(),
+                    &localExecutor,
+                    &learnValueCount);
+
+                UNIT_ASSERT_VALUES_EQUAL(learnValueCount, learnValueCountByHash);
+                UNIT_ASSERT_VALUES_EQUAL(valueCount, valueCountByHash);
+                for (auto i : xrange(keys.size())) {
+                    UNIT_ASSERT(reindexed[i] < valueCount);
+                    UNIT_ASSERT(i >= learnCount || reindexed[i] < learnValueCount);
+                    for (auto j : xrange(i)) {
+                        UNIT_ASSERT_VALUES_EQUAL(reindexed[i] == reindexed[j], keys[i] == keys[j]);
+                    }
+                }
+            }
+        }
+    }
+}
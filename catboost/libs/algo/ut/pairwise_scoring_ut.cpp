@@ -3,6 +3,9 @@
 #include <catboost/libs/algo/pairwise_leaves_calculation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
 static double CalculateScore(const TVector<double>& avrg, const TVector<double>& sumDer, const TArray2D<double>& sumWeights) {
     double score = 0;
     for (int x = 0; x < sumDer.ysize(); ++x) {
@@ -185,4 +188,78 @@ Y_UNIT_TEST_SUITE(PairwiseScoringTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(scoreBins1[1].DP, scoreBins2[1].DP, 1e-6);
         UNIT_ASSERT_DOUBLES_EQUAL(scoreBins1[2].DP, scoreBins2[2].DP, 1e-6);
     }
+
+    Y_UNIT_TEST(PairWeightStatisticsRestoredFromPrevLevelAreSameAsCalculated) {
+        const int depth = 2;
+        const int leafCount = 1 << depth;
+        const int bucketCount = 5;
+        const int docCount = 200;
+        const int pairCount = 1000;
+        TFastRng64 rng(0);
+        TVector<TIndexType> leafIndices(docCount);
+        TVector<TIndexType> prevLeafIndices(docCount);
+        TVector<ui8> bucketIndices(docCount);
+        TVector<double> ders(docCount);
+        for (auto docId : xrange(docCount)) {
+            leafIndices[docId] = rng.Uniform(leafCount);
+            prevLeafIndices[docId] = leafIndices[docId] & (leafCount / 2 - 1);
+            bucketIndices[docId] = rng.Uniform(bucketCount);
+            ders[docId] = rng.GenRandReal1() * 2.0 - 1.0;
+        }
+        TFlatPairsInfo pairs;
+        for (auto pairIdx : xrange(pairCount)) {
+            Y_UNUSED(pairIdx);
+            pairs.emplace_back(rng.Uniform(docCount), rng.Uniform(docCount), rng.GenRandReal1());
+        }
+        const auto getBucket = [&](ui32 docId) { return bucketIndices[docId]; };
+        const NCB::TIndexRange<int> docIndexRange(docCount);
+        const NCB::TIndexRange<int> pairIndexRange(pairCount);
+
+        TPairwiseStats prevLevelStats;
+        prevLevelStats.DerSums = ComputeDerSums(ders, leafCount / 2, bucketCount, prevLeafIndices, getBucket, docIndexRange);
+        prevLevelStats.PairWeightStatistics = ComputePairWeightStatistics(
+            pairs, leafCount / 2, bucketCount, prevLeafIndices, getBucket, pairIndexRange);
+
+        TPairwiseStats expectedStats;
+        expectedStats.PairWeightStatistics = ComputePairWeightStatistics(
+            pairs, leafCount, bucketCount, leafIndices, getBucket, pairIndexRange);
+
+        for (bool smallestSplitSideValue : {false, true}) {
+            TFlatPairsInfo smallestSplitSidePairs;
+            for (const auto& pair : pairs) {
+                if (bool(leafIndices[pair.WinnerId] >> (depth - 1)) == smallestSplitSideValue
+                    || bool(leafIndices[pair.LoserId] >> (depth - 1)) == smallestSplitSideValue)
+                {
+                    smallestSplitSidePairs.push_back(pair);
+                }
+            }
+            TPairwiseStats stats;
+            stats.DerSums = ComputeDerSums(ders, leafCount, bucketCount, leafIndices, getBucket, docIndexRange);
+            stats.PairWeightStatistics = ComputePairWeightStatistics(
+                smallestSplitSidePairs,
+                leafCount,
+                bucketCount,
+                leafIndices,
+                getBucket,
+                NCB::TIndexRange<int>(smallestSplitSidePairs.ysize()));
+            RestoreStatsFromPrevLevel(prevLevelStats, depth, smallestSplitSideValue, &stats);
+
+            for (auto leaf1 : xrange(leafCount)) {
+                for (auto leaf2 : xrange(leafCount)) {
+                    const auto& weightSums = stats.PairWeightStatistics[leaf1][leaf2];
+                    const auto& expectedWeightSums = expectedStats.PairWeightStatistics[leaf1][leaf2];
+                    for (auto bucketIdx : xrange(bucketCount)) {
+                        UNIT_ASSERT_DOUBLES_EQUAL(
+                            weightSums[bucketIdx].SmallerBorderWeightSum,
+                            expectedWeightSums[bucketIdx].SmallerBorderWeightSum,
+                            1e-6);
+                        UNIT_ASSERT_DOUBLES_EQUAL(
+                            weightSums[bucketIdx].GreaterBorderRightWeightSum,
+                            expectedWeightSums[bucketIdx].GreaterBorderRightWeightSum,
+                            1e-6);
+                    }
+                }
+            }
+        }
+    }
 }
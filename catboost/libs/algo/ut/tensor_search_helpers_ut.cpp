@@ -0,0 +1,78 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/algo/tensor_search_helpers.h>
+#include <catboost/libs/helpers/restorable_rng.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(TensorSearchHelpers) {
+    Y_UNIT_TEST(MvsThresholdGivesSampleSize) {
+        TFastRng64 rng(0);
+        for (size_t objectCount : {1, 10, 1000}) {
+            for (double sampleRate : {0.1, 0.5, 0.9}) {
+                TVector<double> gradients(objectCount);
+                for (auto& gradient : gradients) {
+                    // ties and zero gradients too
+                    gradient = rng.Uniform(10) / 4.0;
+                }
+                gradients[0] = 1.0;
+                TVector<double> reorderedGradients = gradients;
+                const double sampleSize = sampleRate * objectCount;
+                const double threshold = CalcMvsThreshold(sampleSize, &reorderedGradients);
+                UNIT_ASSERT(threshold > 0);
+
+                double expectedSampleSize = 0;
+                for (double gradient : gradients) {
+                    expectedSampleSize += Min(1.0, gradient / threshold);
+                }
+                const size_t nonZeroCount = CountIf(gradients, [] (double gradient) { return gradient > 0; });
+                UNIT_ASSERT_DOUBLES_EQUAL(expectedSampleSize, Min<double>(sampleSize, nonZeroCount), 1e-6);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(MvsThresholdIsZeroForZeroGradients) {
+        TVector<double> gradients(100, 0.0);
+        UNIT_ASSERT_VALUES_EQUAL(CalcMvsThreshold(50, &gradients), 0.0);
+    }
+
+    Y_UNIT_TEST(GossTopObjectsAreLargest) {
+        TRestorableFastRng64 rand(0);
+        TVector<double> gradients = {0.5, 3.0, 1.0, 2.0, 0.0, 2.5};
+        TVector<ui32> topObjects = SelectGossTopObjects(gradients, 3, &rand);
+        Sort(topObjects);
+        UNIT_ASSERT_VALUES_EQUAL(topObjects, TVector<ui32>({1, 3, 5}));
+    }
+
+    Y_UNIT_TEST(GossTopObjectsCountWithTies) {
+        TRestorableFastRng64 rand(0);
+        const size_t objectCount = 1000;
+        TVector<double> gradients(objectCount, 1.0);
+        for (auto i : xrange<size_t>(0, objectCount, 10)) {
+            gradients[i] = 2.0;
+        }
+        TVector<size_t> topCounts(objectCount, 0);
+        const int topCount = 300;
+        const size_t iterationCount = 20;
+        for (auto iteration : xrange(iterationCount)) {
+            Y_UNUSED(iteration);
+            const TVector<ui32> topObjects = SelectGossTopObjects(gradients, topCount, &rand);
+            UNIT_ASSERT_VALUES_EQUAL(topObjects.ysize(), topCount);
+            for (ui32 objectIdx : topObjects) {
+                ++topCounts[objectIdx];
+            }
+        }
+        // objects with larger gradients are always on top, the rest of top is taken from ties at random
+        size_t tiedObjectsOnTop = 0;
+        for (auto i : xrange(objectCount)) {
+            if (gradients[i] == 2.0) {
+                UNIT_ASSERT_VALUES_EQUAL(topCounts[i], iterationCount);
+            } else {
+                UNIT_ASSERT(topCounts[i] < iterationCount);
+                tiedObjectsOnTop += topCounts[i] > 0;
+            }
+        }
+        UNIT_ASSERT(tiedObjectsOnTop > size_t(topCount - objectCount / 10));
+    }
+}
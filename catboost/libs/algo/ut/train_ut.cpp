@@ -8,6 +8,7 @@
 #include <util/random/fast.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
+#include <util/string/cast.h>
 
 
 using namespace NCB;
@@ -122,7 +123,293 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             *(dataProviders.Learn->ObjectsData)
         );
         for (size_t j = 0; j < FactorCount; ++j) {
-            UNIT_ASSERT( Equal<float>(features[j], (**rawObjectsData.GetFloatFeature(j)).GetArrayData()) );
+            UNIT_ASSERT( Equal<float>(features[j], dynamic_cast<const TFloatValuesHolder&>(**rawObjectsData.GetFloatFeature(j)).GetArrayData()) );
+        }
+    }
+
+    Y_UNIT_TEST(TestStreamingOnlineCtrsGiveSameModel) {
+        const size_t TestDocCount = 1000;
+        const ui32 FloatFactorCount = 2;
+        const TVector<ui32> CatFactorValueCounts = {3, 10, 50};
+        const ui32 FactorCount = FloatFactorCount + CatFactorValueCounts.size();
+
+        TReallyFastRng32 rng(123);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> floatFeatures(FloatFactorCount); // [featureIdx][objectIdx]
+        TVector<TVector<TString>> catFeatures(CatFactorValueCounts.size()); // [featureIdx][objectIdx]
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            float targetValue = rng.GenRandReal2();
+            for (auto j : xrange(FloatFactorCount)) {
+                floatFeatures[j].push_back(rng.GenRandReal2());
+                targetValue += floatFeatures[j].back();
+            }
+            for (auto j : xrange(CatFactorValueCounts.size())) {
+                const ui32 value = rng.Uniform(CatFactorValueCounts[j]);
+                catFeatures[j].push_back(ToString(value));
+                targetValue += (value % 3) * 0.5f;
+            }
+            target[i] = targetValue;
+        }
+
+        const TVector<ui32> catFeatureIndices = xrange(FloatFactorCount, FactorCount);
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateDataProvider(
+            [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                TDataMetaInfo metaInfo;
+                metaInfo.HasTarget = true;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    FactorCount,
+                    catFeatureIndices,
+                    TVector<TString>{}
+                );
+
+                visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+
+                for (auto factorId : xrange(FloatFactorCount)) {
+                    visitor->AddFloatFeature(
+                        factorId,
+                        TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>(floatFeatures[factorId]))
+                    );
+                }
+                for (auto catFactorId : xrange(catFeatures.size())) {
+                    visitor->AddCatFeature(
+                        FloatFactorCount + catFactorId,
+                        TConstArrayRef<TString>(catFeatures[catFactorId])
+                    );
+                }
+                visitor->AddTarget(target);
+
+                visitor->Finish();
+            }
+        );
+
+        const auto trainModel = [&] (bool streamingOnlineCtrs) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 20);
+            plainFitParams.InsertValue("depth", 4);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 1);
+            plainFitParams.InsertValue("streaming_online_ctrs", streamingOnlineCtrs);
+            if (streamingOnlineCtrs) {
+                // small enough for ctrs to be evicted and calculated again
+                plainFitParams.InsertValue("online_ctr_cache_size", "16kb");
+            }
+            TEvalResult testApprox;
+            TFullModel model;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                "",
+                &model,
+                {&testApprox}
+            );
+            return model;
+        };
+
+        const TFullModel model = trainModel(/*streamingOnlineCtrs*/ false);
+        UNIT_ASSERT(!model.ObliviousTrees.CtrFeatures.empty());
+        UNIT_ASSERT_EQUAL(model, trainModel(/*streamingOnlineCtrs*/ true));
+    }
+
+    Y_UNIT_TEST(TestDepthwiseModelAppliesAsTrained) {
+        const size_t TestDocCount = 1000;
+        const ui32 FactorCount = 5;
+
+        TReallyFastRng32 rng(123);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> features(FactorCount); // [featureIdx][objectIdx]
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            float targetValue = 0;
+            for (auto j : xrange(FactorCount)) {
+                features[j].push_back(rng.GenRandReal2());
+                targetValue += (j + 1) * features[j].back() * features[(j + 1) % FactorCount].back();
+            }
+            target[i] = targetValue + 0.1 * rng.GenRandReal2();
+        }
+
+        const auto createDataProvider = [&] (const TDataMetaInfo& metaInfo) {
+            return CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+                    for (auto factorId : xrange(FactorCount)) {
+                        visitor->AddFloatFeature(
+                            factorId,
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>(features[factorId]))
+                        );
+                    }
+                    visitor->AddTarget(target);
+                    visitor->Finish();
+                }
+            );
+        };
+        TDataMetaInfo metaInfo;
+        metaInfo.HasTarget = true;
+        metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(FactorCount, TVector<ui32>{}, TVector<TString>{});
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = createDataProvider(metaInfo);
+        dataProviders.Test.push_back(createDataProvider(metaInfo));
+
+        NJson::TJsonValue plainFitParams;
+        plainFitParams.InsertValue("random_seed", 5);
+        plainFitParams.InsertValue("iterations", 20);
+        plainFitParams.InsertValue("depth", 5);
+        plainFitParams.InsertValue("grow_policy", "Depthwise");
+        plainFitParams.InsertValue("train_dir", ".");
+        plainFitParams.InsertValue("thread_count", 1);
+        TEvalResult testApprox;
+        TFullModel model;
+        TrainModel(
+            plainFitParams,
+            nullptr,
+            Nothing(),
+            Nothing(),
+            dataProviders,
+            "",
+            &model,
+            {&testApprox}
+        );
+        UNIT_ASSERT(!model.ObliviousTrees.NonSymmetricStepNodes.empty());
+
+        // trees built from splits of leaves give the same approx as calculated on test data while training
+        TVector<TVector<float>> docFeatures(TestDocCount, TVector<float>(FactorCount));
+        TVector<TConstArrayRef<float>> docFeatureRefs;
+        for (auto i : xrange(TestDocCount)) {
+            for (auto j : xrange(FactorCount)) {
+                docFeatures[i][j] = features[j][i];
+            }
+            docFeatureRefs.push_back(docFeatures[i]);
+        }
+        TVector<double> modelApprox(TestDocCount);
+        model.CalcFlat(docFeatureRefs, modelApprox);
+        const auto& trainingApprox = testApprox.GetRawValuesConstRef()[0][0];
+        UNIT_ASSERT_VALUES_EQUAL(trainingApprox.size(), TestDocCount);
+        for (auto i : xrange(TestDocCount)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(modelApprox[i], trainingApprox[i], 1e-6);
+        }
+    }
+
+    Y_UNIT_TEST(TestSparseFeaturesGiveSameModel) {
+        const size_t TestDocCount = 2000;
+        const ui32 FactorCount = 6;
+        const size_t GroupSize = 10;
+
+        TReallyFastRng32 rng(123);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> features(FactorCount); // [featureIdx][objectIdx]
+        for (auto& feature : features) {
+            feature.resize(TestDocCount, 0.0f);
+        }
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            float targetValue = 0;
+            for (auto j : xrange(FactorCount)) {
+                // most of values are default
+                if (rng.GenRandReal2() < 0.1) {
+                    features[j][i] = rng.GenRandReal2() + (j % 2 ? 0.0f : -1.0f);
+                }
+                targetValue += (j + 1) * features[j][i];
+            }
+            target[i] = targetValue + 0.1 * rng.GenRandReal2();
+        }
+        TVector<TPair> pairs;
+        for (size_t i = 0; i + 1 < TestDocCount; ++i) {
+            if ((i + 1) % GroupSize != 0) {
+                pairs.emplace_back(target[i] > target[i + 1] ? i : i + 1, target[i] > target[i + 1] ? i + 1 : i, 1.0f);
+            }
+        }
+
+        const auto createDataProvider = [&] (bool isSparse, bool hasPairs) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.HasGroupId = hasPairs;
+            metaInfo.HasPairs = hasPairs;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(FactorCount, TVector<ui32>{}, TVector<TString>{});
+            return CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+                    if (hasPairs) {
+                        for (auto i : xrange(TestDocCount)) {
+                            visitor->AddGroupId(i, i / GroupSize);
+                        }
+                    }
+                    for (auto factorId : xrange(FactorCount)) {
+                        if (isSparse) {
+                            visitor->AddFloatFeature(factorId, TSparseArray<float, ui32>::FromDense(features[factorId]));
+                        } else {
+                            visitor->AddFloatFeature(
+                                factorId,
+                                TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>(features[factorId]))
+                            );
+                        }
+                    }
+                    visitor->AddTarget(target);
+                    if (hasPairs) {
+                        visitor->SetPairs(pairs);
+                    }
+                    visitor->Finish();
+                }
+            );
+        };
+
+        TVector<TVector<float>> docFeatures(TestDocCount, TVector<float>(FactorCount));
+        TVector<TConstArrayRef<float>> docFeatureRefs;
+        for (auto i : xrange(TestDocCount)) {
+            for (auto j : xrange(FactorCount)) {
+                docFeatures[i][j] = features[j][i];
+            }
+            docFeatureRefs.push_back(docFeatures[i]);
+        }
+
+        // stats of sparse features are accumulated only over non-default values, see CalcSparseStatsKernel
+        const auto trainAndApply = [&] (bool isSparse, const TString& lossFunction, const TString& boostingType) {
+            const bool hasPairs = lossFunction == "PairLogitPairwise";
+            TDataProviders dataProviders;
+            dataProviders.Learn = createDataProvider(isSparse, hasPairs);
+            dataProviders.Test.push_back(createDataProvider(isSparse, hasPairs));
+
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("loss_function", lossFunction);
+            plainFitParams.InsertValue("boosting_type", boostingType);
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 10);
+            plainFitParams.InsertValue("depth", 4);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 4);
+            TEvalResult testApprox;
+            TFullModel model;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                "",
+                &model,
+                {&testApprox}
+            );
+            TVector<double> modelApprox(TestDocCount);
+            model.CalcFlat(docFeatureRefs, modelApprox);
+            return modelApprox;
+        };
+
+        for (const auto& [lossFunction, boostingType] : TVector<std::pair<TString, TString>>{
+            {"RMSE", "Plain"},
+            {"RMSE", "Ordered"},
+            {"PairLogitPairwise", "Plain"}
+        }) {
+            const auto denseApprox = trainAndApply(/*isSparse*/ false, lossFunction, boostingType);
+            const auto sparseApprox = trainAndApply(/*isSparse*/ true, lossFunction, boostingType);
+            for (auto i : xrange(TestDocCount)) {
+                UNIT_ASSERT_DOUBLES_EQUAL(denseApprox[i], sparseApprox[i], 1e-6);
+            }
         }
     }
 }
@@ -29,7 +29,8 @@ inline void ReadAndProceedPoolInBlocks(const NCB::TAnalyticalModeCommonParams& p
                 /*ignoredFeatures*/ {},
                 NCB::EObjectsOrder::Undefined,
                 blockSize,
-                localExecutor
+                localExecutor,
+                /*featuresLayout*/ nullptr
             }
         }
     );
@@ -0,0 +1,146 @@
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_util/line_data_reader.h>
+#include <catboost/libs/data_util/path_with_scheme.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/getopt/small/last_getopt.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/stream/format.h>
+#include <util/stream/output.h>
+#include <util/system/fstat.h>
+#include <util/system/hp_timer.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+/**
+ * Loading throughput benchmark of CatBoost dsv pools.
+ * Narrow, wide and categorical-heavy pools with the same total count of values are generated with
+ * fixed seed into temporary files, then each pool is loaded several times and the best time is reported.
+ */
+
+using namespace NCB;
+
+struct TPoolLayout {
+    TString Name;
+    int FloatFeatureCount = 0;
+    int CatFeatureCount = 0;
+};
+
+struct TBenchmarkParams {
+    ui64 ValueCount = 0;
+    int Repetitions = 0;
+    int ThreadCount = 0;
+    ui64 Seed = 0;
+    TString TmpDir;
+};
+
+static TVector<TColumn> GenerateColumnsDescription(const TPoolLayout& layout) {
+    TVector<TColumn> columns;
+    columns.push_back(TColumn{EColumn::Label, TString()});
+    for (auto i : xrange(layout.FloatFeatureCount)) {
+        Y_UNUSED(i);
+        columns.push_back(TColumn{EColumn::Num, TString()});
+    }
+    for (auto i : xrange(layout.CatFeatureCount)) {
+        Y_UNUSED(i);
+        columns.push_back(TColumn{EColumn::Categ, TString()});
+    }
+    return columns;
+}
+
+static void GeneratePool(const TPoolLayout& layout, ui64 rowCount, const TString& path, TFastRng64* rng) {
+    TOFStream out(path);
+    for (auto rowIdx : xrange(rowCount)) {
+        Y_UNUSED(rowIdx);
+        out << rng->Uniform(2);
+        for (auto i : xrange(layout.FloatFeatureCount)) {
+            Y_UNUSED(i);
+            out << '\t' << Prec(rng->GenRandReal1() * 100.0, PREC_POINT_DIGITS, 4);
+        }
+        for (auto i : xrange(layout.CatFeatureCount)) {
+            out << '\t' << "c" << i << "_" << rng->Uniform(1000);
+        }
+        out << '\n';
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace NLastGetopt;
+
+    TBenchmarkParams params;
+    TOpts opts = NLastGetopt::TOpts::Default();
+    opts.AddLongOption("values").RequiredArgument("INT")
+        .Help("Count of feature values in each generated pool")
+        .DefaultValue(20000000)
+        .StoreResult(&params.ValueCount);
+    opts.AddLongOption("repetitions").RequiredArgument("INT")
+        .DefaultValue(3)
+        .StoreResult(&params.Repetitions);
+    opts.AddLongOption('T', "thread-count").RequiredArgument("INT")
+        .DefaultValue(8)
+        .StoreResult(&params.ThreadCount);
+    opts.AddLongOption("seed").RequiredArgument("INT")
+        .DefaultValue(0)
+        .StoreResult(&params.Seed);
+    opts.AddLongOption("tmp-dir").RequiredArgument("PATH")
+        .Help("Directory for generated pools")
+        .DefaultValue(".")
+        .StoreResult(&params.TmpDir);
+    opts.SetFreeArgsNum(0);
+    TOptsParseResult args(&opts, argc, argv);
+
+    CB_ENSURE(params.ValueCount > 0, "Pools should be nonempty");
+    CB_ENSURE(params.Repetitions > 0, "At least one repetition is required");
+
+    const TVector<TPoolLayout> layouts = {
+        {"narrow", 10, 0},
+        {"wide", 400, 0},
+        {"categorical", 10, 40}
+    };
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(params.ThreadCount - 1);
+
+    TFastRng64 rng(params.Seed);
+
+    Cout << "pool\trows\tcolumns\tmegabytes\tseconds\tmegabytes_per_second" << Endl;
+    for (const auto& layout : layouts) {
+        const TVector<TColumn> columnsDescription = GenerateColumnsDescription(layout);
+        const ui64 rowCount = Max<ui64>(params.ValueCount / (columnsDescription.size() - 1), 1);
+
+        TTempFile poolFile(MakeTempName(params.TmpDir.c_str(), "dsv_loading_benchmark"));
+        GeneratePool(layout, rowCount, poolFile.Name(), &rng);
+        const double megabytes = (double)GetFileLength(poolFile.Name()) / (1 << 20);
+
+        double bestSeconds = Max<double>();
+        for (auto repetition : xrange(params.Repetitions)) {
+            Y_UNUSED(repetition);
+            THPTimer timer;
+            TDataProviderPtr dataProvider = ReadDataset(
+                GetLineDataReader(TPathWithScheme(poolFile.Name(), "dsv")),
+                /*pairsFilePath*/ TPathWithScheme(),
+                /*groupWeightsFilePath*/ TPathWithScheme(),
+                TDsvFormatOptions(),
+                columnsDescription,
+                /*ignoredFeatures*/ {},
+                EObjectsOrder::Undefined,
+                &localExecutor
+            );
+            bestSeconds = Min(bestSeconds, timer.Passed());
+            CB_ENSURE(dataProvider->GetObjectCount() == rowCount, "Unexpected object count");
+        }
+
+        Cout << layout.Name << '\t'
+            << rowCount << '\t'
+            << columnsDescription.size() << '\t'
+            << Prec(megabytes, PREC_POINT_DIGITS, 1) << '\t'
+            << Prec(bestSeconds, PREC_POINT_DIGITS, 3) << '\t'
+            << Prec(megabytes / bestSeconds, PREC_POINT_DIGITS, 1) << Endl;
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "cb_dsv_loader.h"
+#include "dsv_parser.h"
 
 #include <catboost/libs/column_description/cd_parser.h>
 #include <catboost/libs/data_util/exists_checker.h>
@@ -13,14 +14,24 @@
 #include <util/string/iterator.h>
 #include <util/string/split.h>
 #include <util/system/types.h>
+#include <util/thread/singleton.h>
 
 
 namespace NCB {
 
+    namespace {
+        // reused between lines processed in the same thread to avoid allocations for each line
+        struct TDsvLineParseBuffers {
+            TVector<TStringBuf> Tokens;
+            TVector<float> FloatFeatures;
+            TVector<ui32> CatFeatures;
+        };
+    }
+
     TCBDsvDataLoader::TCBDsvDataLoader(TDatasetLoaderPullArgs&& args)
         : TCBDsvDataLoader(
             TLineDataLoaderPushArgs {
-                GetLineDataReader(args.PoolPath, args.CommonArgs.PoolFormat),
+                GetLineDataReader(args.PoolPath, args.CommonArgs.PoolFormat, args.CommonArgs.LocalExecutor),
                 std::move(args.CommonArgs)
             }
         )
@@ -88,14 +99,17 @@ namespace NCB {
             ui32 featureId = 0;
             ui32 baselineIdx = 0;
 
-            TVector<float> floatFeatures;
+            auto& buffers = *FastTlsSingleton<TDsvLineParseBuffers>();
+
+            TVector<float>& floatFeatures = buffers.FloatFeatures;
             floatFeatures.yresize(featuresLayout.GetFloatFeatureCount());
 
-            TVector<ui32> catFeatures;
+            TVector<ui32>& catFeatures = buffers.CatFeatures;
             catFeatures.yresize(featuresLayout.GetCatFeatureCount());
 
             size_t tokenCount = 0;
-            TVector<TStringBuf> tokens = StringSplitter(line).Split(FieldDelimiter);
+            TVector<TStringBuf>& tokens = buffers.Tokens;
+            SplitDsvLine(line, FieldDelimiter, &tokens);
             try {
                 for (const auto& token : tokens) {
                     try {
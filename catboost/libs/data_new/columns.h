@@ -5,6 +5,7 @@
 #include <catboost/libs/helpers/array_subset.h>
 #include <catboost/libs/helpers/compression.h>
 #include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/sparse_array.h>
 
 #include <library/threading/local_executor/local_executor.h>
 
@@ -100,21 +101,58 @@ namespace NCB {
      * Raw data
      */
 
+    /* interface instead of concrete TArrayValuesHolder because there is
+     * an alternative sparse implementation TSparseArrayValuesHolder
+     */
+    template <class T, EFeatureValuesType TType>
+    class ITypedFeatureValuesHolder: public IFeatureValuesHolder {
+    public:
+        using TValueType = T;
+    public:
+        ITypedFeatureValuesHolder(ui32 featureId,
+                                  ui32 size)
+            : IFeatureValuesHolder(TType,
+                                   featureId,
+                                   size)
+        {}
+
+        /* note: subsetIndexing is already a composition - this is an optimization to call compose once per
+         * all features data and not for each feature
+         */
+        virtual THolder<ITypedFeatureValuesHolder> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const = 0;
+
+        // dense values in subset order
+        virtual TMaybeOwningArrayHolder<T> ExtractValues(NPar::TLocalExecutor* localExecutor) const = 0;
+    };
+
+
     template <class T, EFeatureValuesType TType>
-    class TArrayValuesHolder: public IFeatureValuesHolder {
+    class TArrayValuesHolder: public ITypedFeatureValuesHolder<T, TType> {
     public:
         TArrayValuesHolder(ui32 featureId,
                            TMaybeOwningConstArrayHolder<T> srcData,
                            const TFeaturesArraySubsetIndexing* subsetIndexing)
-            : IFeatureValuesHolder(TType,
-                                   featureId,
-                                   subsetIndexing->Size())
+            : ITypedFeatureValuesHolder<T, TType>(featureId, subsetIndexing->Size())
             , SrcData(std::move(srcData))
             , SubsetIndexing(subsetIndexing)
         {
             CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
         }
 
+        THolder<ITypedFeatureValuesHolder<T, TType>> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const override {
+            return MakeHolder<TArrayValuesHolder>(this->GetId(), SrcData, subsetIndexing);
+        }
+
+        TMaybeOwningArrayHolder<T> ExtractValues(NPar::TLocalExecutor* localExecutor) const override {
+            return TMaybeOwningArrayHolder<T>::CreateOwning(
+                ::NCB::GetSubset<T>(*SrcData, *SubsetIndexing, localExecutor)
+            );
+        }
+
         const TMaybeOwningConstArraySubset<T, ui32> GetArrayData() const {
             return {&SrcData, SubsetIndexing};
         }
@@ -124,8 +162,55 @@ namespace NCB {
         const TFeaturesArraySubsetIndexing* SubsetIndexing;
     };
 
+
+    /* Values with most of the elements equal to some default value (usually 0)
+     * are stored as TSparseArray, only non-default values take memory
+     */
+    template <class T, EFeatureValuesType TType>
+    class TSparseArrayValuesHolder: public ITypedFeatureValuesHolder<T, TType> {
+    public:
+        TSparseArrayValuesHolder(ui32 featureId,
+                                 TSparseArray<T, ui32> srcData,
+                                 const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : ITypedFeatureValuesHolder<T, TType>(featureId, subsetIndexing->Size())
+            , SrcData(std::move(srcData))
+            , SubsetIndexing(subsetIndexing)
+        {
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+        }
+
+        THolder<ITypedFeatureValuesHolder<T, TType>> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const override {
+            return MakeHolder<TSparseArrayValuesHolder>(this->GetId(), SrcData, subsetIndexing);
+        }
+
+        TMaybeOwningArrayHolder<T> ExtractValues(NPar::TLocalExecutor* /*localExecutor*/) const override {
+            return TMaybeOwningArrayHolder<T>::CreateOwning(GetSubsetData().ExtractValues());
+        }
+
+        // data without subset indexing
+        const TSparseArray<T, ui32>& GetSrcData() const {
+            return SrcData;
+        }
+
+        // data in subset order
+        TSparseArray<T, ui32> GetSubsetData() const {
+            return SrcData.GetSubset(*SubsetIndexing);
+        }
+
+    private:
+        TSparseArray<T, ui32> SrcData;
+        const TFeaturesArraySubsetIndexing* SubsetIndexing;
+    };
+
+
+    using IFloatValuesHolder = ITypedFeatureValuesHolder<float, EFeatureValuesType::Float>;
+
     using TFloatValuesHolder = TArrayValuesHolder<float, EFeatureValuesType::Float>;
 
+    using TSparseFloatValuesHolder = TSparseArrayValuesHolder<float, EFeatureValuesType::Float>;
+
     using THashedCatValuesHolder = TArrayValuesHolder<ui32, EFeatureValuesType::HashedCategorical>;
 
 
@@ -220,6 +305,118 @@ namespace NCB {
     using TQuantizedFloatValuesHolder = TCompressedValuesHolderImpl<IQuantizedFloatValuesHolder>;
 
 
+    // bins of up to 8 binary features for one object, one bit per feature
+    using TBinaryFeaturesPack = ui8;
+
+    // accessor to bins of a binary feature in raw array of packs (without subset indexing)
+    struct TPackedBinaryBins {
+        const TBinaryFeaturesPack* Packs = nullptr;
+        ui8 BitIdx = 0;
+
+        ui8 operator[](size_t idx) const {
+            return (Packs[idx] >> BitIdx) & 1;
+        }
+    };
+
+    /* Quantized float feature with at most 2 bins, stored as a bit in an array of TBinaryFeaturesPack
+     * shared with other binary features.
+     * Uses 8 times less memory and bandwidth than TQuantizedFloatValuesHolder.
+     */
+    class TQuantizedFloatPackedBinaryValuesHolder : public IQuantizedFloatValuesHolder {
+    public:
+        TQuantizedFloatPackedBinaryValuesHolder(ui32 featureId,
+                                                TCompressedArray packs,
+                                                ui8 bitIdx,
+                                                const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : IQuantizedFloatValuesHolder(featureId, subsetIndexing->Size())
+            , Packs(std::move(packs))
+            , BitIdx(bitIdx)
+            , SubsetIndexing(subsetIndexing)
+        {
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+            CB_ENSURE_INTERNAL(
+                BitIdx < sizeof(TBinaryFeaturesPack) * CHAR_BIT,
+                "bitIdx " << (ui32)BitIdx << " is out of binary features pack"
+            );
+            Packs.CheckIfCanBeInterpretedAsRawArray<TBinaryFeaturesPack>();
+        }
+
+        THolder<IQuantizedFloatValuesHolder> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const override {
+            return MakeHolder<TQuantizedFloatPackedBinaryValuesHolder>(GetId(), Packs, BitIdx, subsetIndexing);
+        }
+
+        TMaybeOwningArrayHolder<ui8> ExtractValues(NPar::TLocalExecutor* localExecutor) const override {
+            TVector<ui8> values = ::NCB::GetSubset<TBinaryFeaturesPack>(Packs, *SubsetIndexing, localExecutor);
+            for (auto& value : values) {
+                value = (value >> BitIdx) & 1;
+            }
+            return TMaybeOwningArrayHolder<ui8>::CreateOwning(std::move(values));
+        }
+
+        // packs without subset indexing, shared with other features
+        const TCompressedArray& GetPacks() const {
+            return Packs;
+        }
+
+        ui8 GetBitIdx() const {
+            return BitIdx;
+        }
+
+        // low-level function, data is without subset indexing, apply external subset indexing!
+        TPackedBinaryBins GetRawBins() const {
+            return {reinterpret_cast<const TBinaryFeaturesPack*>(Packs.GetRawPtr()), BitIdx};
+        }
+
+    private:
+        TCompressedArray Packs;
+        ui8 BitIdx;
+        const TFeaturesArraySubsetIndexing* SubsetIndexing;
+    };
+
+
+    /* Quantized float feature with most of the objects in one bin (usually the bin of 0.0f),
+     * bins are stored as TSparseArray. Created from TSparseFloatValuesHolder.
+     */
+    class TQuantizedFloatSparseValuesHolder : public IQuantizedFloatValuesHolder {
+    public:
+        TQuantizedFloatSparseValuesHolder(ui32 featureId,
+                                          TSparseArray<ui8, ui32> srcData,
+                                          const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : IQuantizedFloatValuesHolder(featureId, subsetIndexing->Size())
+            , SrcData(std::move(srcData))
+            , SubsetIndexing(subsetIndexing)
+        {
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+        }
+
+        THolder<IQuantizedFloatValuesHolder> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const override {
+            return MakeHolder<TQuantizedFloatSparseValuesHolder>(GetId(), SrcData, subsetIndexing);
+        }
+
+        TMaybeOwningArrayHolder<ui8> ExtractValues(NPar::TLocalExecutor* /*localExecutor*/) const override {
+            return TMaybeOwningArrayHolder<ui8>::CreateOwning(GetSubsetData().ExtractValues());
+        }
+
+        // low-level function, data is without subset indexing, apply external subset indexing!
+        const TSparseArray<ui8, ui32>& GetSrcData() const {
+            return SrcData;
+        }
+
+        // data in subset order
+        TSparseArray<ui8, ui32> GetSubsetData() const {
+            return SrcData.GetSubset(*SubsetIndexing);
+        }
+
+    private:
+        TSparseArray<ui8, ui32> SrcData;
+        const TFeaturesArraySubsetIndexing* SubsetIndexing;
+    };
+
+
     /* interface instead of concrete TQuantizedFloatValuesHolder because there is
      * an alternative implementation TExternalFloatValuesHolder for GPU
      */
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <array>
+#include <climits>
 
 
 namespace NCB {
@@ -271,13 +272,13 @@ namespace NCB {
                 TFullSubset<ui32>(ObjectCount)
             );
 
-            FloatFeaturesStorage.GetResult(
+            FloatFeaturesStorage.GetResult<EFeatureValuesType::Float>(
                 *Data.MetaInfo.FeaturesLayout,
                 Data.CommonObjectsData.SubsetIndexing.Get(),
                 &Data.ObjectsData.FloatFeatures
             );
 
-            CatFeaturesStorage.GetResult(
+            CatFeaturesStorage.GetResult<EFeatureValuesType::HashedCategorical>(
                 *Data.MetaInfo.FeaturesLayout,
                 Data.CommonObjectsData.SubsetIndexing.Get(),
                 &Data.ObjectsData.CatFeatures
@@ -457,11 +458,12 @@ namespace NCB {
                 }
             }
 
-            template <EFeatureValuesType ColumnType>
+            // IColumnType is TArrayValuesHolder<T, ColumnType> or its interface
+            template <EFeatureValuesType ColumnType, class IColumnType>
             void GetResult(
                 const TFeaturesLayout& featuresLayout,
                 const TFeaturesArraySubsetIndexing* subsetIndexing,
-                TVector<THolder<TArrayValuesHolder<T, ColumnType>>>* result
+                TVector<THolder<IColumnType>>* result
             ) {
                 CB_ENSURE_INTERNAL(Storage.size() == DstView.size(), "Storage is inconsistent with DstView");
 
@@ -599,6 +601,20 @@ namespace NCB {
             );
         }
 
+        void AddFloatFeature(ui32 flatFeatureIdx, TSparseArray<float, ui32> features) override {
+            auto floatFeatureIdx = GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+            CB_ENSURE_INTERNAL(
+                features.GetSize() == ObjectCount,
+                "Sparse float feature #" << flatFeatureIdx << " size (" << features.GetSize()
+                << ") is not equal to object count (" << ObjectCount << ')'
+            );
+            Data.ObjectsData.FloatFeatures[*floatFeatureIdx] = MakeHolder<TSparseFloatValuesHolder>(
+                flatFeatureIdx,
+                std::move(features),
+                Data.CommonObjectsData.SubsetIndexing.Get()
+            );
+        }
+
         void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TString> feature) override {
             AddCatFeatureImpl(flatFeatureIdx, feature);
         }
@@ -834,7 +850,7 @@ namespace NCB {
             FloatFeaturesStorage.Set(
                 GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx),
                 objectOffset,
-                *featuresPart
+                std::move(featuresPart)
             );
         }
 
@@ -1008,6 +1024,13 @@ namespace NCB {
 
             TVector<TIndexHelper<ui64>> IndexHelpers; // [perTypeFeatureIdx]
 
+            /* if not nullptr, DstView points to data passed to Set as a whole and it is owned by this holder
+             * instead of Storage
+             */
+            TVector<TIntrusivePtr<IResourceHolder>> ExternalStorage; // [perTypeFeatureIdx]
+
+            ui32 ObjectCount = 0;
+
         public:
             void PrepareForInitialization(
                 const TFeaturesLayout& featuresLayout,
@@ -1015,7 +1038,9 @@ namespace NCB {
                 const TPoolQuantizationSchema& quantizationSchema
             ) {
                 const size_t perTypeFeatureCount = (size_t)featuresLayout.GetFeatureCount(FeatureType);
+                ObjectCount = objectCount;
                 Storage.resize(perTypeFeatureCount);
+                ExternalStorage.assign(perTypeFeatureCount, nullptr);
                 DstView.resize(perTypeFeatureCount);
                 IsAvailable.resize(perTypeFeatureCount, false); // filled from quantization Schema, then checked
                 IndexHelpers.resize(perTypeFeatureCount, TIndexHelper<ui64>(8));
@@ -1073,17 +1098,52 @@ namespace NCB {
             void Set(
                 TFeatureIdx<FeatureType> perTypeFeatureIdx,
                 ui32 objectOffset,
-                TConstArrayRef<ui8> featuresPart
+                TMaybeOwningConstArrayHolder<ui8> featuresPartHolder
             ) {
                 if (IsAvailable[*perTypeFeatureIdx]) {
+                    const TConstArrayRef<ui8> featuresPart = *featuresPartHolder;
+                    if (CanUseInPlace(perTypeFeatureIdx, objectOffset, featuresPartHolder)) {
+                        // data is only read, so it can be shared with the source (memory mapped file for example)
+                        DstView[*perTypeFeatureIdx] = TArrayRef<ui64>(
+                            (ui64*)const_cast<ui8*>(featuresPart.data()),
+                            IndexHelpers[*perTypeFeatureIdx].CompressedSize(ObjectCount)
+                        );
+                        ExternalStorage[*perTypeFeatureIdx] = featuresPartHolder.GetResourceHolder();
+                        Storage[*perTypeFeatureIdx] = nullptr;
+                        return;
+                    }
+                    CB_ENSURE_INTERNAL(
+                        !ExternalStorage[*perTypeFeatureIdx],
+                        "Feature data has already been set as a whole"
+                    );
+                    // featuresPart can have padding after objects' data
+                    const size_t dstSize = DstView[*perTypeFeatureIdx].size() * sizeof(ui64);
+                    CB_ENSURE_INTERNAL(objectOffset <= dstSize, "Feature data part is out of range");
                     memcpy(
                         ((ui8*)DstView[*perTypeFeatureIdx].data()) + objectOffset,
                         featuresPart.data(),
-                        featuresPart.size()
+                        Min(featuresPart.size(), dstSize - objectOffset)
                     );
                 }
             }
 
+            /* parts that contain all objects' data of the feature with the same layout as in Storage
+             * (including padding up to the end of the last ui64 word, as TCompressedArray reads whole words)
+             * are used in place if their memory is owned by featuresPartHolder
+             */
+            bool CanUseInPlace(
+                TFeatureIdx<FeatureType> perTypeFeatureIdx,
+                ui32 objectOffset,
+                const TMaybeOwningConstArrayHolder<ui8>& featuresPartHolder
+            ) const {
+                const TConstArrayRef<ui8> featuresPart = *featuresPartHolder;
+                return featuresPartHolder.GetResourceHolder()
+                    && (objectOffset == 0)
+                    && (IndexHelpers[*perTypeFeatureIdx].GetBitsPerKey() == CHAR_BIT)
+                    && (featuresPart.size() >= IndexHelpers[*perTypeFeatureIdx].CompressedSize(ObjectCount) * sizeof(ui64))
+                    && (reinterpret_cast<uintptr_t>(featuresPart.data()) % alignof(ui64) == 0);
+            }
+
             template <class IColumnType>
             void GetResult(
                 ui32 objectCount,
@@ -1114,7 +1174,9 @@ namespace NCB {
                                     IndexHelpers[perTypeFeatureIdx].GetBitsPerKey(),
                                     TMaybeOwningArrayHolder<ui64>::CreateOwning(
                                         DstView[perTypeFeatureIdx],
-                                        Storage[perTypeFeatureIdx]
+                                        ExternalStorage[perTypeFeatureIdx]
+                                            ? ExternalStorage[perTypeFeatureIdx]
+                                            : TIntrusivePtr<IResourceHolder>(Storage[perTypeFeatureIdx])
                                     )
                                 ),
                                 subsetIndexing
@@ -0,0 +1,124 @@
+#include "dsv_parser.h"
+
+#include <util/generic/bitops.h>
+#include <util/generic/ymath.h>
+#include <util/string/ascii.h>
+#include <util/system/types.h>
+
+#ifdef _sse2_
+#include <emmintrin.h>
+#endif
+
+
+namespace NCB {
+
+    void SplitDsvLine(TStringBuf line, char delimiter, TVector<TStringBuf>* tokens) {
+        tokens->clear();
+
+        const char* const begin = line.data();
+        const char* const end = begin + line.size();
+        const char* tokenBegin = begin;
+        const char* ptr = begin;
+
+#ifdef _sse2_
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        for (; ptr + 16 <= end; ptr += 16) {
+            const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            ui32 mask = (ui32)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, delimiters));
+            while (mask) {
+                const char* delimiterPtr = ptr + CountTrailingZeroBits(mask);
+                tokens->emplace_back(tokenBegin, delimiterPtr);
+                tokenBegin = delimiterPtr + 1;
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        for (; ptr != end; ++ptr) {
+            if (*ptr == delimiter) {
+                tokens->emplace_back(tokenBegin, ptr);
+                tokenBegin = ptr + 1;
+            }
+        }
+        tokens->emplace_back(tokenBegin, end);
+    }
+
+    bool TryParseSimpleFloat(TStringBuf value, float* result) {
+        // exact powers of 10 representable in double
+        static constexpr double POWERS_OF_TEN[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        constexpr ui64 MAX_EXACT_MANTISSA = ui64(1) << 53;
+        constexpr int MAX_EXACT_EXPONENT = 22;
+
+        const char* ptr = value.data();
+        const char* const end = ptr + value.size();
+
+        const bool negative = (ptr != end) && (*ptr == '-');
+        if (negative) {
+            ++ptr;
+        }
+
+        ui64 mantissa = 0;
+        int exponent = 0;
+
+        const char* digitsBegin = ptr;
+        for (; (ptr != end) && IsAsciiDigit(*ptr); ++ptr) {
+            mantissa = mantissa * 10 + (*ptr - '0');
+            if (mantissa > MAX_EXACT_MANTISSA) {
+                return false;
+            }
+        }
+        if (ptr == digitsBegin) {
+            return false;
+        }
+        if ((ptr != end) && (*ptr == '.')) {
+            ++ptr;
+            digitsBegin = ptr;
+            for (; (ptr != end) && IsAsciiDigit(*ptr); ++ptr) {
+                mantissa = mantissa * 10 + (*ptr - '0');
+                if (mantissa > MAX_EXACT_MANTISSA) {
+                    return false;
+                }
+                --exponent;
+            }
+            if (ptr == digitsBegin) {
+                return false;
+            }
+        }
+        if ((ptr != end) && ((*ptr == 'e') || (*ptr == 'E'))) {
+            ++ptr;
+            const bool negativeExponent = (ptr != end) && (*ptr == '-');
+            if ((ptr != end) && ((*ptr == '-') || (*ptr == '+'))) {
+                ++ptr;
+            }
+            digitsBegin = ptr;
+            int explicitExponent = 0;
+            for (; (ptr != end) && IsAsciiDigit(*ptr); ++ptr) {
+                explicitExponent = explicitExponent * 10 + (*ptr - '0');
+                if (explicitExponent > 2 * MAX_EXACT_EXPONENT) {
+                    return false;
+                }
+            }
+            if (ptr == digitsBegin) {
+                return false;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+        if ((ptr != end) || (Abs(exponent) > MAX_EXACT_EXPONENT)) {
+            return false;
+        }
+
+        // both operands are exact, so the result is correctly rounded like in StrToD
+        double doubleValue = (double)mantissa;
+        if (exponent < 0) {
+            doubleValue /= POWERS_OF_TEN[-exponent];
+        } else {
+            doubleValue *= POWERS_OF_TEN[exponent];
+        }
+        *result = (float)(negative ? -doubleValue : doubleValue);
+        return true;
+    }
+
+}
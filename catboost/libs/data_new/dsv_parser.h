@@ -0,0 +1,22 @@
+#pragma once
+
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+
+
+namespace NCB {
+
+    /* Split line by delimiter into tokens referring to line data.
+     * Gives the same tokens as StringSplitter(line).Split(delimiter), but scans 16 bytes at once
+     * and reuses tokens' storage, so no memory is allocated when it is called for a lot of lines.
+     */
+    void SplitDsvLine(TStringBuf line, char delimiter, TVector<TStringBuf>* tokens);
+
+    /* Fast path for float values written as [-]digits[.digits][(e|E)[+|-]digits] which
+     * can be converted exactly (see Clinger's algorithm), the result is the same as for
+     * FromString<float>.
+     * @return false if the value has some other format, then nothing is known about it
+     */
+    bool TryParseSimpleFloat(TStringBuf value, float* result);
+
+}
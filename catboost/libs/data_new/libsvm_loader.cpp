@@ -0,0 +1,207 @@
+#include "libsvm_loader.h"
+
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_util/exists_checker.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/sparse_array.h>
+
+#include <library/object_factory/object_factory.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/string.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/string/cast.h>
+#include <util/string/iterator.h>
+#include <util/string/split.h>
+#include <util/string/strip.h>
+
+
+namespace NCB {
+
+    TLibSvmDataLoader::TLibSvmDataLoader(TDatasetLoaderPullArgs&& args)
+        : TLibSvmDataLoader(
+            TLineDataLoaderPushArgs {
+                GetLineDataReader(args.PoolPath),
+                std::move(args.CommonArgs)
+            }
+        )
+    {
+    }
+
+    TLibSvmDataLoader::TLibSvmDataLoader(TLineDataLoaderPushArgs&& args)
+        : Args(std::move(args.CommonArgs))
+        , LineDataReader(std::move(args.Reader))
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TLibSvmDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TLibSvmDataLoader:GroupWeightsFilePath does not exist");
+
+        // feature count is known only after all data is read
+        TString line;
+        // lines are counted in file, with empty and comment lines, to be reported in errors
+        for (ui64 lineIdx = 0; LineDataReader->ReadLine(&line); ++lineIdx) {
+            try {
+                ProcessLine(line);
+            } catch (yexception& e) {
+                throw TCatBoostException() << "Error in libsvm data. Line " << lineIdx + 1 << ": "
+                    << e.what();
+            }
+        }
+        CB_ENSURE(ObjectCount, "TLibSvmDataLoader: no data rows in pool");
+
+        // features that are not specified in this data at all still have to be present in it
+        // if they are in learn data, otherwise features layouts are different
+        if (Args.FeaturesLayout) {
+            const ui32 featureCount = Args.FeaturesLayout->GetExternalFeatureCount();
+            CB_ENSURE(
+                FeatureIndices.size() <= featureCount,
+                "TLibSvmDataLoader: data contains feature " << FeatureIndices.size()
+                << ", but there are only " << featureCount << " features in learn data"
+            );
+            CB_ENSURE(
+                Args.FeaturesLayout->GetCatFeatureCount() == 0,
+                "TLibSvmDataLoader: learn data with categorical features is incompatible with libsvm data"
+            );
+            FeatureIndices.resize(featureCount);
+            FeatureValues.resize(featureCount);
+        }
+
+        TVector<TColumn> columns;
+        columns.push_back(TColumn{EColumn::Label, TString()});
+        if (!GroupIds.empty()) {
+            columns.push_back(TColumn{EColumn::GroupId, TString()});
+        }
+        for (auto i : xrange(FeatureIndices.size())) {
+            Y_UNUSED(i);
+            columns.push_back(TColumn{EColumn::Num, TString()});
+        }
+
+        DataMetaInfo = TDataMetaInfo(
+            TDataColumnsMetaInfo{std::move(columns)},
+            Args.GroupWeightsFilePath.Inited(),
+            Args.PairsFilePath.Inited()
+        );
+
+        ProcessIgnoredFeaturesList(Args.IgnoredFeatures, &DataMetaInfo, &FeatureIgnored);
+    }
+
+    void TLibSvmDataLoader::ProcessLine(TStringBuf line) {
+        line = StripString(line.Before('#'));
+        if (line.empty()) {
+            return;
+        }
+
+        CB_ENSURE(
+            ObjectCount < Max<ui32>(),
+            "CatBoost does not support datasets with more than " << Max<ui32>() << " objects"
+        );
+        const ui32 objectIdx = ObjectCount;
+
+        TVector<TStringBuf> tokens = StringSplitter(line).Split(' ');
+        bool targetParsed = false;
+        bool hasGroupId = false;
+        TMaybe<ui32> prevFeatureIdx;
+        for (const auto& token : tokens) {
+            if (token.empty()) {
+                continue;
+            }
+            if (!targetParsed) {
+                float target = 0.0f;
+                CB_ENSURE(TryFromString(token, target), "Target \"" << token << "\" cannot be parsed as float");
+                Target.push_back(target);
+                targetParsed = true;
+                continue;
+            }
+
+            TStringBuf key;
+            TStringBuf value;
+            CB_ENSURE(token.TrySplit(':', key, value), "Expected <index>:<value>, got \"" << token << '"');
+
+            if (key == "qid") {
+                CB_ENSURE(!hasGroupId, "qid is specified several times");
+                CB_ENSURE(
+                    (objectIdx == 0) || (GroupIds.size() == objectIdx),
+                    "qid must be specified either for all objects or for none of them"
+                );
+                GroupIds.push_back(CalcGroupIdFor(value));
+                hasGroupId = true;
+                continue;
+            }
+
+            ui32 featureIdx = 0;
+            CB_ENSURE(
+                TryFromString(key, featureIdx) && (featureIdx > 0),
+                "Feature index \"" << key << "\" is not a positive integer"
+            );
+            --featureIdx; // libsvm indices are 1-based
+
+            float featureValue = 0.0f;
+            CB_ENSURE(
+                TryParseFloatFeatureValue(value, &featureValue),
+                "Factor " << featureIdx << " cannot be parsed as float"
+            );
+
+            // checked for zero values too, though they are not stored
+            CB_ENSURE(
+                !prevFeatureIdx || (featureIdx != *prevFeatureIdx),
+                "Feature " << featureIdx + 1 << " is specified several times"
+            );
+            CB_ENSURE(
+                !prevFeatureIdx || (featureIdx > *prevFeatureIdx),
+                "Feature indices must be in ascending order, got " << featureIdx + 1
+                << " after " << *prevFeatureIdx + 1
+            );
+            prevFeatureIdx = featureIdx;
+
+            if (featureIdx >= FeatureIndices.size()) {
+                FeatureIndices.resize(featureIdx + 1);
+                FeatureValues.resize(featureIdx + 1);
+            }
+            if (featureValue != 0.0f) {
+                FeatureIndices[featureIdx].push_back(objectIdx);
+                FeatureValues[featureIdx].push_back(featureValue);
+            }
+        }
+        CB_ENSURE(targetParsed, "Target is missing");
+        CB_ENSURE(
+            hasGroupId == !GroupIds.empty(),
+            "qid must be specified either for all objects or for none of them"
+        );
+
+        ++ObjectCount;
+    }
+
+    void TLibSvmDataLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        visitor->Start(DataMetaInfo, ObjectCount, Args.ObjectsOrder, {});
+
+        for (auto objectIdx : xrange(GroupIds.size())) {
+            visitor->AddGroupId(objectIdx, GroupIds[objectIdx]);
+        }
+
+        for (auto flatFeatureIdx : xrange(FeatureIndices.size())) {
+            if (FeatureIgnored[flatFeatureIdx]) {
+                continue;
+            }
+            visitor->AddFloatFeature(
+                flatFeatureIdx,
+                TSparseArray<float, ui32>(
+                    ObjectCount,
+                    TMaybeOwningConstArrayHolder<ui32>::CreateOwning(std::move(FeatureIndices[flatFeatureIdx])),
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(FeatureValues[flatFeatureIdx]))
+                )
+            );
+        }
+
+        visitor->AddTarget(Target);
+
+        SetGroupWeights(Args.GroupWeightsFilePath, ObjectCount, visitor);
+        SetPairs(Args.PairsFilePath, ObjectCount, visitor);
+        visitor->Finish();
+    }
+
+    namespace {
+        TDatasetLoaderFactory::TRegistrator<TLibSvmDataLoader> LibSvmDataLoaderReg("libsvm");
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "loader.h"
+
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/data_util/line_data_reader.h>
+
+#include <util/generic/ptr.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Reads datasets in libsvm format:
+     *   <target> [qid:<groupId>] <featureIdx>:<value> <featureIdx>:<value> ...
+     *
+     * featureIdx are 1-based, features not specified for an object are equal to 0.
+     * Float features are passed to visitor as sparse arrays, so memory usage is proportional
+     * to the number of specified values.
+     * Features count is the maximal featureIdx in data or, if features layout of learn data is
+     * passed in args (for test data), the features count of learn data.
+     */
+    class TLibSvmDataLoader : public IRawFeaturesOrderDatasetLoader {
+    public:
+        explicit TLibSvmDataLoader(TDatasetLoaderPullArgs&& args);
+
+        explicit TLibSvmDataLoader(TLineDataLoaderPushArgs&& args);
+
+        void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+    private:
+        void ProcessLine(TStringBuf line);
+
+    private:
+        TDatasetLoaderCommonArgs Args;
+        THolder<NCB::ILineDataReader> LineDataReader;
+
+        ui32 ObjectCount = 0;
+        TVector<float> Target; // [objectIdx]
+        TVector<TGroupId> GroupIds; // [objectIdx], empty if there's no qid in data
+
+        // non-zero values of features
+        TVector<TVector<ui32>> FeatureIndices; // [flatFeatureIdx][nonZeroIdx]
+        TVector<TVector<float>> FeatureValues; // [flatFeatureIdx][nonZeroIdx]
+
+        TVector<bool> FeatureIgnored; // [flatFeatureIdx]
+        TDataMetaInfo DataMetaInfo;
+    };
+
+}
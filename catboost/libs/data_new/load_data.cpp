@@ -20,7 +20,8 @@ namespace NCB {
         const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
         const TVector<ui32>& ignoredFeatures,
         EObjectsOrder objectsOrder,
-        NPar::TLocalExecutor* localExecutor
+        NPar::TLocalExecutor* localExecutor,
+        TFeaturesLayoutPtr featuresLayout
     ) {
         auto datasetLoader = GetProcessor<IDatasetLoader>(
             poolPath, // for choosing processor
@@ -37,7 +38,8 @@ namespace NCB {
                     ignoredFeatures,
                     objectsOrder,
                     10000, // TODO: make it a named constant
-                    localExecutor
+                    localExecutor,
+                    std::move(featuresLayout)
                 }
             }
         );
@@ -118,7 +120,8 @@ namespace NCB {
                     ignoredFeatures,
                     objectsOrder,
                     10000, // TODO: make it a named constant
-                    localExecutor
+                    localExecutor,
+                    /*featuresLayout*/ nullptr
                 }
             }
         );
@@ -175,7 +178,8 @@ namespace NCB {
                     loadOptions.DsvPoolFormatParams,
                     loadOptions.IgnoredFeatures,
                     objectsOrder,
-                    &localExecutor
+                    &localExecutor,
+                    dataProviders.Learn ? dataProviders.Learn->MetaInfo.FeaturesLayout : TFeaturesLayoutPtr()
                 );
                 dataProviders.Test.push_back(std::move(testDataProvider));
                 if (profile.Defined() && (testIdx + 1 == loadOptions.TestSetPaths.ysize())) {
@@ -26,7 +26,11 @@ namespace NCB {
         const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
         const TVector<ui32>& ignoredFeatures,
         EObjectsOrder objectsOrder,
-        NPar::TLocalExecutor* localExecutor
+        NPar::TLocalExecutor* localExecutor,
+
+        // if specified, features count of data that does not define all features (e.g. libsvm) is
+        // taken from it, pass features layout of learn data here when reading test data
+        TFeaturesLayoutPtr featuresLayout = nullptr
     );
 
     // for use from context where there's no localExecutor and proper logging handling is unimplemented
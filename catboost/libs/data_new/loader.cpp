@@ -1,5 +1,7 @@
 #include "loader.h"
 
+#include "dsv_parser.h"
+
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
 
@@ -168,7 +170,7 @@ namespace NCB {
     }
 
     bool TryParseFloatFeatureValue(TStringBuf stringValue, float* value) {
-        if (!TryFromString<float>(stringValue, *value)) {
+        if (!TryParseSimpleFloat(stringValue, value) && !TryFromString<float>(stringValue, *value)) {
             if (IsNanValue(stringValue)) {
                 *value = std::numeric_limits<float>::quiet_NaN();
             } else if (stringValue.length() == 0) {
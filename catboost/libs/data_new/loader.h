@@ -29,6 +29,10 @@ namespace NCB {
         EObjectsOrder ObjectsOrder;
         ui32 BlockSize;
         NPar::TLocalExecutor* LocalExecutor;
+
+        // can be nullptr, features layout of learn data for loaders of test data that can't get
+        // all features from data itself (e.g. libsvm with sparse features)
+        TFeaturesLayoutPtr FeaturesLayout;
     };
 
     // pass this struct to to IDatasetLoader ctor
@@ -78,7 +82,13 @@ namespace NCB {
 
     struct IRawFeaturesOrderDatasetLoader : public IDatasetLoader {
         virtual EDatasetVisitorType GetVisitorType() const override {
-            return EDatasetVisitorType::RawObjectsOrder;
+            return EDatasetVisitorType::RawFeaturesOrder;
+        }
+
+        void DoIfCompatible(IDatasetVisitor* visitor) override {
+            auto compatibleVisitor = dynamic_cast<IRawFeaturesOrderDataVisitor*>(visitor);
+            CB_ENSURE_INTERNAL(compatibleVisitor, "visitor is incompatible with dataset loader");
+            Do(compatibleVisitor);
         }
 
         // Process all data
@@ -304,10 +304,11 @@ static bool AreFeaturesValuesEqual(
     return Equal<T>(lhsData, rhs.GetArrayData());
 }
 
-template <class IQuantizedValuesHolder>
+// for interfaces with ExtractValues (dense or sparse implementations)
+template <class IValuesHolder>
 static bool AreFeaturesValuesEqual(
-    const IQuantizedValuesHolder& lhs,
-    const IQuantizedValuesHolder& rhs
+    const IValuesHolder& lhs,
+    const IValuesHolder& rhs
 ) {
     return *(lhs.ExtractValues(&NPar::LocalExecutor())) == *(rhs.ExtractValues(&NPar::LocalExecutor()));
 }
@@ -453,6 +454,25 @@ void NCB::TRawObjectsData::Check(
 }
 
 
+template <class T>
+static void CreateSubsetFeatures(
+    const TVector<THolder<T>>& src, // not TConstArrayRef to allow template parameter deduction
+    const TFeaturesArraySubsetIndexing* subsetIndexing,
+    TVector<THolder<T>>* dst
+) {
+    dst->clear();
+    dst->reserve(src.size());
+    for (const auto& feature : src) {
+        auto* srcDataPtr = feature.Get();
+        if (srcDataPtr) {
+            dst->emplace_back(srcDataPtr->CloneWithNewSubsetIndexing(subsetIndexing));
+        } else {
+            dst->push_back(nullptr);
+        }
+    }
+}
+
+
 template <class T, EFeatureValuesType TType>
 static void CreateSubsetFeatures(
     TConstArrayRef<THolder<TArrayValuesHolder<T, TType>>> src,
@@ -489,7 +509,7 @@ TObjectsDataProviderPtr NCB::TRawObjectsDataProvider::GetSubset(
 
     TRawObjectsData subsetData;
     CreateSubsetFeatures(
-        (TConstArrayRef<THolder<TFloatValuesHolder>>)Data.FloatFeatures,
+        Data.FloatFeatures,
         subsetCommonData.SubsetIndexing.Get(),
         &subsetData.FloatFeatures
     );
@@ -557,7 +577,8 @@ TVector<float> NCB::TRawObjectsDataProvider::GetFeatureDataOldFormat(ui32 flatFe
 
     if (featureMetaInfo.Type == EFeatureType::Float) {
         const auto& feature = **GetFloatFeature(featuresLayout.GetInternalFeatureIdx(flatFeatureIdx));
-        feature.GetArrayData().ForEach([&result](ui32 idx, float value) { result[idx] = value; });
+        const auto values = feature.ExtractValues(&NPar::LocalExecutor());
+        Copy((*values).begin(), (*values).end(), result.begin());
     } else {
         const auto& feature = **GetCatFeature(featuresLayout.GetInternalFeatureIdx(flatFeatureIdx));
         feature.GetArrayData().ForEach(
@@ -621,24 +642,6 @@ void NCB::TQuantizedObjectsData::Check(
 }
 
 
-template <class T>
-static void CreateSubsetFeatures(
-    const TVector<THolder<T>>& src, // not TConstArrayRef to allow template parameter deduction
-    const TFeaturesArraySubsetIndexing* subsetIndexing,
-    TVector<THolder<T>>* dst
-) {
-    dst->clear();
-    dst->reserve(src.size());
-    for (const auto& feature : src) {
-        auto* srcDataPtr = feature.Get();
-        if (srcDataPtr) {
-            dst->emplace_back(srcDataPtr->CloneWithNewSubsetIndexing(subsetIndexing));
-        } else {
-            dst->push_back(nullptr);
-        }
-    }
-}
-
 TQuantizedObjectsData NCB::TQuantizedObjectsData::GetSubset(
     const TArraySubsetIndexing<ui32>* subsetComposition
 ) const {
@@ -860,6 +863,105 @@ NCB::TQuantizedForCPUObjectsDataProvider::TQuantizedForCPUObjectsDataProvider(
         CatFeatureUniqueValuesCounts[catFeatureIdx] =
             Data.QuantizedFeaturesInfo->GetUniqueValuesCounts(TCatFeatureIdx(catFeatureIdx));
     }
+
+    PackBinaryFloatFeatures();
+    UpdateFloatFeaturesSparseBins();
+}
+
+
+static bool IsBinaryFloatFeature(
+    const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+    TFloatFeatureIdx floatFeatureIdx
+) {
+    return quantizedFeaturesInfo.HasBorders(floatFeatureIdx) &&
+        (quantizedFeaturesInfo.GetBorders(floatFeatureIdx).size() == 1);
+}
+
+void NCB::TQuantizedForCPUObjectsDataProvider::PackBinaryFloatFeatures() {
+    constexpr ui32 bitsPerPack = sizeof(TBinaryFeaturesPack) * CHAR_BIT;
+
+    TVector<ui32> featuresToPack; // [floatFeatureIdx]
+    for (auto floatFeatureIdx : xrange(Data.FloatFeatures.size())) {
+        const auto* featureData = dynamic_cast<const TQuantizedFloatValuesHolder*>(
+            Data.FloatFeatures[floatFeatureIdx].Get()
+        );
+        if (featureData &&
+            (featureData->GetBitsPerKey() == CHAR_BIT) &&
+            IsBinaryFloatFeature(*Data.QuantizedFeaturesInfo, TFloatFeatureIdx(floatFeatureIdx)))
+        {
+            featuresToPack.push_back(floatFeatureIdx);
+        }
+    }
+
+    for (ui32 packBegin = 0; packBegin < featuresToPack.size(); packBegin += bitsPerPack) {
+        const auto packFeatures = TConstArrayRef<ui32>(featuresToPack).Slice(
+            packBegin,
+            Min<size_t>(bitsPerPack, featuresToPack.size() - packBegin)
+        );
+
+        const ui64 srcSize = static_cast<const TQuantizedFloatValuesHolder&>(*Data.FloatFeatures[packFeatures[0]])
+            .GetCompressedData().GetSrc()->GetSize();
+        TIndexHelper<ui64> indexHelper(bitsPerPack);
+        TVector<ui64> storage(indexHelper.CompressedSize(srcSize), 0);
+        auto* packsData = reinterpret_cast<TBinaryFeaturesPack*>(storage.data());
+
+        for (auto bitIdx : xrange(packFeatures.size())) {
+            const auto& srcData = *static_cast<const TQuantizedFloatValuesHolder&>(
+                *Data.FloatFeatures[packFeatures[bitIdx]]
+            ).GetCompressedData().GetSrc();
+            CB_ENSURE_INTERNAL(
+                srcData.GetSize() == srcSize,
+                "Binary features packed together have different source data sizes"
+            );
+            const ui8* bins = reinterpret_cast<const ui8*>(srcData.GetRawPtr());
+            for (auto i : xrange(srcSize)) {
+                Y_ASSERT(bins[i] <= 1);
+                packsData[i] |= TBinaryFeaturesPack(bins[i] != 0) << bitIdx;
+            }
+        }
+
+        const TCompressedArray packs(
+            srcSize,
+            bitsPerPack,
+            TMaybeOwningArrayHolder<ui64>::CreateOwning(std::move(storage))
+        );
+        for (auto bitIdx : xrange(packFeatures.size())) {
+            auto& featureData = Data.FloatFeatures[packFeatures[bitIdx]];
+            featureData = MakeHolder<TQuantizedFloatPackedBinaryValuesHolder>(
+                featureData->GetId(),
+                packs,
+                (ui8)bitIdx,
+                CommonData.SubsetIndexing.Get()
+            );
+        }
+    }
+
+    UpdateFloatFeaturesPackedBinaryBins();
+}
+
+void NCB::TQuantizedForCPUObjectsDataProvider::UpdateFloatFeaturesPackedBinaryBins() {
+    FloatFeaturesPackedBinaryBins.clear();
+    FloatFeaturesPackedBinaryBins.resize(Data.FloatFeatures.size());
+    for (auto floatFeatureIdx : xrange(Data.FloatFeatures.size())) {
+        const auto* packedFeatureData = dynamic_cast<const TQuantizedFloatPackedBinaryValuesHolder*>(
+            Data.FloatFeatures[floatFeatureIdx].Get()
+        );
+        if (packedFeatureData) {
+            FloatFeaturesPackedBinaryBins[floatFeatureIdx] = packedFeatureData->GetRawBins();
+        }
+    }
+}
+
+void NCB::TQuantizedForCPUObjectsDataProvider::UpdateFloatFeaturesSparseBins() {
+    FloatFeaturesSparseBins.assign(Data.FloatFeatures.size(), nullptr);
+    for (auto floatFeatureIdx : xrange(Data.FloatFeatures.size())) {
+        const auto* sparseFeatureData = dynamic_cast<const TQuantizedFloatSparseValuesHolder*>(
+            Data.FloatFeatures[floatFeatureIdx].Get()
+        );
+        if (sparseFeatureData) {
+            FloatFeaturesSparseBins[floatFeatureIdx] = &sparseFeatureData->GetSrcData();
+        }
+    }
 }
 
 
@@ -888,6 +990,11 @@ static void MakeConsecutiveArrayFeatures(
 
     featuresLayout.IterateOverAvailableFeatures<FeatureType>(
         [&] (TFeatureIdx<FeatureType> featureIdx) {
+            if (!dynamic_cast<const TCompressedValuesHolderImpl<IColumnType>*>(src[*featureIdx].Get())) {
+                // packed binary features are made consecutive separately
+                Y_ASSERT(&src == dst);
+                return;
+            }
             tasks.emplace_back(
                 [&, featureIdx]() {
                     auto& srcCompressedValuesHolder = dynamic_cast<TCompressedValuesHolderImpl<IColumnType>&>(
@@ -922,6 +1029,75 @@ static void MakeConsecutiveArrayFeatures(
     ExecuteTasksInParallel(&tasks, localExecutor);
 }
 
+static void MakeConsecutivePackedBinaryFeatures(
+    const NCB::TFeaturesArraySubsetIndexing& srcSubsetIndexing,
+    const NCB::TFeaturesArraySubsetIndexing* newSubsetIndexing,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<THolder<IQuantizedFloatValuesHolder>>* features
+) {
+    constexpr ui32 bitsPerPack = sizeof(TBinaryFeaturesPack) * CHAR_BIT;
+
+    // packs are shared by features, so map them by source data
+    THashMap<const char*, TCompressedArray> consecutivePacks;
+    for (auto& featureData : *features) {
+        const auto* packedFeatureData = dynamic_cast<const TQuantizedFloatPackedBinaryValuesHolder*>(
+            featureData.Get()
+        );
+        if (!packedFeatureData) {
+            continue;
+        }
+        const auto& srcPacks = packedFeatureData->GetPacks();
+        auto packsIt = consecutivePacks.find(srcPacks.GetRawPtr());
+        if (packsIt == consecutivePacks.end()) {
+            const auto objectCount = newSubsetIndexing->Size();
+            TIndexHelper<ui64> indexHelper(bitsPerPack);
+            TVector<ui64> storage;
+            storage.yresize(indexHelper.CompressedSize(objectCount));
+            auto* dstBuffer = reinterpret_cast<TBinaryFeaturesPack*>(storage.data());
+            TConstCompressedArraySubset(&srcPacks, &srcSubsetIndexing).ParallelForEach(
+                [&] (ui32 idx, TBinaryFeaturesPack pack) {
+                    dstBuffer[idx] = pack;
+                },
+                localExecutor
+            );
+            packsIt = consecutivePacks.emplace(
+                srcPacks.GetRawPtr(),
+                TCompressedArray(
+                    objectCount,
+                    bitsPerPack,
+                    TMaybeOwningArrayHolder<ui64>::CreateOwning(std::move(storage))
+                )
+            ).first;
+        }
+        featureData = MakeHolder<TQuantizedFloatPackedBinaryValuesHolder>(
+            packedFeatureData->GetId(),
+            packsIt->second,
+            packedFeatureData->GetBitIdx(),
+            newSubsetIndexing
+        );
+    }
+}
+
+static void MakeConsecutiveSparseFeatures(
+    const NCB::TFeaturesArraySubsetIndexing* newSubsetIndexing,
+    TVector<THolder<IQuantizedFloatValuesHolder>>* features
+) {
+    for (auto& featureData : *features) {
+        const auto* sparseFeatureData = dynamic_cast<const TQuantizedFloatSparseValuesHolder*>(
+            featureData.Get()
+        );
+        if (!sparseFeatureData) {
+            continue;
+        }
+        // only non-default values are remapped
+        featureData = MakeHolder<TQuantizedFloatSparseValuesHolder>(
+            sparseFeatureData->GetId(),
+            sparseFeatureData->GetSubsetData(),
+            newSubsetIndexing
+        );
+    }
+}
+
 void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
     NPar::TLocalExecutor* localExecutor
 ) {
@@ -933,6 +1109,13 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
         TFullSubset<ui32>(GetObjectCount())
     );
 
+    MakeConsecutivePackedBinaryFeatures(
+        GetFeaturesArraySubsetIndexing(),
+        newSubsetIndexing.Get(),
+        localExecutor,
+        &Data.FloatFeatures
+    );
+    MakeConsecutiveSparseFeatures(newSubsetIndexing.Get(), &Data.FloatFeatures);
     MakeConsecutiveArrayFeatures<EFeatureType::Float>(
         *GetFeaturesLayout(),
         GetObjectCount(),
@@ -951,6 +1134,9 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
     );
 
     CommonData.SubsetIndexing = std::move(newSubsetIndexing);
+
+    UpdateFloatFeaturesPackedBinaryBins();
+    UpdateFloatFeaturesSparseBins();
 }
 
 
@@ -966,6 +1152,14 @@ static void CheckIsRequiredType(
         if (!dataPtr) {
             continue;
         }
+        if (dynamic_cast<const TQuantizedFloatPackedBinaryValuesHolder*>(dataPtr)) {
+            // binary float features packed by TQuantizedForCPUObjectsDataProvider itself
+            continue;
+        }
+        if (dynamic_cast<const TQuantizedFloatSparseValuesHolder*>(dataPtr)) {
+            // sparse float features are accessed separately by CPU training code
+            continue;
+        }
 
         auto requiredTypePtr = dynamic_cast<TRequiredFeatureColumn*>(dataPtr);
         CB_ENSURE_INTERNAL(
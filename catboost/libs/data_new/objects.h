@@ -183,7 +183,7 @@ namespace NCB {
         /* some feature holders can contain nullptr
          *  (ignored or this data provider contains only subset of features)
          */
-        TVector<THolder<TFloatValuesHolder>> FloatFeatures; // [floatFeatureIdx]
+        TVector<THolder<IFloatValuesHolder>> FloatFeatures; // [floatFeatureIdx]
         TVector<THolder<THashedCatValuesHolder>> CatFeatures; // [catFeatureIdx]
 
     public:
@@ -252,8 +252,8 @@ namespace NCB {
         /* can return nullptr if this feature is unavailable
          * (ignored or this data provider contains only subset of features)
          */
-        TMaybeData<const TFloatValuesHolder*> GetFloatFeature(ui32 floatFeatureIdx) const {
-            return MakeMaybeData<const TFloatValuesHolder>(Data.FloatFeatures[floatFeatureIdx]);
+        TMaybeData<const IFloatValuesHolder*> GetFloatFeature(ui32 floatFeatureIdx) const {
+            return MakeMaybeData<const IFloatValuesHolder>(Data.FloatFeatures[floatFeatureIdx]);
         }
 
         /* can return nullptr if this feature is unavailable
@@ -455,11 +455,21 @@ namespace NCB {
 
         /* overrides base class implementation with more restricted type
          * (more efficient for CPU score calculation)
-         * features guaranteed to be stored as an array of ui8
+         * features guaranteed to be stored as an array of ui8 unless they are packed binary features
+         * (use GetFloatFeaturePackedBinaryBins for them) or sparse features
+         * (use GetFloatFeatureSparseBins for them)
          */
         TMaybeData<const TQuantizedFloatValuesHolder*> GetFloatFeature(ui32 floatFeatureIdx) const {
+            CB_ENSURE_INTERNAL(
+                !FloatFeaturesPackedBinaryBins[floatFeatureIdx],
+                "Float feature " << floatFeatureIdx << " is packed binary, it has no dense holder"
+            );
+            CB_ENSURE_INTERNAL(
+                !FloatFeaturesSparseBins[floatFeatureIdx],
+                "Float feature " << floatFeatureIdx << " is sparse, it has no dense holder"
+            );
             return MakeMaybeData(
-                // already checked in ctor that this cast is safe
+                // other types are checked above and in ctor
                 static_cast<const TQuantizedFloatValuesHolder*>(
                     Data.FloatFeatures[floatFeatureIdx].Get()
                 )
@@ -471,6 +481,23 @@ namespace NCB {
             return *((*GetFloatFeature(floatFeatureIdx))->GetArrayData().GetSrc());
         }
 
+        /* Float features with at most 2 bins are packed by bits into arrays of TBinaryFeaturesPack
+         * (8 features per byte), this function returns accessor to bins for such features
+         * and Nothing() for other features.
+         * low-level function, data is without subset indexing, apply external subset indexing!
+         */
+        TMaybe<TPackedBinaryBins> GetFloatFeaturePackedBinaryBins(ui32 floatFeatureIdx) const {
+            return FloatFeaturesPackedBinaryBins[floatFeatureIdx];
+        }
+
+        /* Float features stored as TQuantizedFloatSparseValuesHolder keep only bins different from
+         * the default bin, this function returns them for such features and nullptr for other features.
+         * low-level function, data is without subset indexing, apply external subset indexing!
+         */
+        const TSparseArray<ui8, ui32>* GetFloatFeatureSparseBins(ui32 floatFeatureIdx) const {
+            return FloatFeaturesSparseBins[floatFeatureIdx];
+        }
+
         /* overrides base class implementation with more restricted type
          * (more efficient for CPU score calculation)
          * features guaranteed to be stored as an array of ui32
@@ -497,9 +524,20 @@ namespace NCB {
         // check that additional CPU-specific constraints are respected
         void Check() const;
 
+        // replace holders of float features with at most 2 bins by TQuantizedFloatPackedBinaryValuesHolder
+        void PackBinaryFloatFeatures();
+
+        void UpdateFloatFeaturesPackedBinaryBins();
+
+        void UpdateFloatFeaturesSparseBins();
+
     private:
         // store directly instead of looking up in Data.QuantizedFeaturesInfo for runtime efficiency
         TVector<TCatFeatureUniqueValuesCounts> CatFeatureUniqueValuesCounts; // [catFeatureIdx]
+
+        TVector<TMaybe<TPackedBinaryBins>> FloatFeaturesPackedBinaryBins; // [floatFeatureIdx]
+
+        TVector<const TSparseArray<ui8, ui32>*> FloatFeaturesSparseBins; // [floatFeatureIdx]
     };
 
 
@@ -124,7 +124,7 @@ namespace NCB {
 
 
     static void CalcBordersAndNanMode(
-        const TFloatValuesHolder& srcFeature,
+        const IFloatValuesHolder& srcFeature,
         const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         ENanMode* nanMode,
@@ -134,28 +134,42 @@ namespace NCB {
 
         Y_VERIFY(binarizationOptions.BorderCount > 0);
 
-        TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
-
-        TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
-            srcFeatureData.GetSrc(),
-            subsetForBuildBorders
-        );
-
         // does not contain nans
         TVector<float> srcFeatureValuesForBuildBorders;
-        srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+        srcFeatureValuesForBuildBorders.reserve(subsetForBuildBorders->Size());
 
         bool hasNans = false;
 
-        srcDataForBuildBorders.ForEach(
-            [&] (ui32 /*idx*/, float value) {
-                if (IsNan(value)) {
-                    hasNans = true;
-                } else {
-                    srcFeatureValuesForBuildBorders.push_back(value);
-                }
+        auto addValue = [&] (float value) {
+            if (IsNan(value)) {
+                hasNans = true;
+            } else {
+                srcFeatureValuesForBuildBorders.push_back(value);
             }
-        );
+        };
+
+        if (const auto* denseFeature = dynamic_cast<const TFloatValuesHolder*>(&srcFeature)) {
+            TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
+                denseFeature->GetArrayData().GetSrc(),
+                subsetForBuildBorders
+            );
+            srcDataForBuildBorders.ForEach([&] (ui32 /*idx*/, float value) { addValue(value); });
+        } else {
+            const auto& sparseFeature = dynamic_cast<const TSparseFloatValuesHolder&>(srcFeature);
+
+            // BestSplit needs all values, default values are added as is
+            const TSparseArray<float, ui32> srcDataForBuildBorders
+                = sparseFeature.GetSrcData().GetSubset(*subsetForBuildBorders);
+            for (float value : srcDataForBuildBorders.GetValues()) {
+                addValue(value);
+            }
+            const ui32 defaultValuesCount
+                = srcDataForBuildBorders.GetSize() - srcDataForBuildBorders.GetNonDefaultSize();
+            for (auto i : xrange(defaultValuesCount)) {
+                Y_UNUSED(i);
+                addValue(srcDataForBuildBorders.GetDefaultValue());
+            }
+        }
 
         CB_ENSURE(
             (binarizationOptions.NanMode != ENanMode::Forbidden) ||
@@ -200,9 +214,49 @@ namespace NCB {
     }
 
 
+    static TSparseArray<ui8, ui32> QuantizeSparse(
+        const TSparseArray<float, ui32>& srcFeatureData,
+        bool allowNans,
+        ENanMode nanMode,
+        ui32 featureIdx, // for error message
+        TConstArrayRef<float> borders
+    ) {
+        auto quantizeValue = [&] (float srcValue) -> ui8 {
+            CB_ENSURE(
+                allowNans || !IsNan(srcValue),
+                "There are NaNs in test dataset (feature number "
+                << featureIdx << ") but there were no NaNs in learn dataset"
+            );
+            return Binarize<ui8>(nanMode, borders, srcValue);
+        };
+
+        const ui8 defaultBin = quantizeValue(srcFeatureData.GetDefaultValue());
+
+        // values that fall into the default bin are not stored
+        TVector<ui32> indices;
+        TVector<ui8> bins;
+        srcFeatureData.ForEachNonDefault(
+            [&] (ui32 idx, float srcValue) {
+                const ui8 bin = quantizeValue(srcValue);
+                if (bin != defaultBin) {
+                    indices.push_back(idx);
+                    bins.push_back(bin);
+                }
+            }
+        );
+
+        return TSparseArray<ui8, ui32>(
+            srcFeatureData.GetSize(),
+            TMaybeOwningConstArrayHolder<ui32>::CreateOwning(std::move(indices)),
+            TMaybeOwningConstArrayHolder<ui8>::CreateOwning(std::move(bins)),
+            defaultBin
+        );
+    }
+
+
     static void ProcessFloatFeature(
         TFloatFeatureIdx floatFeatureIdx,
-        const TFloatValuesHolder& srcFeature,
+        const IFloatValuesHolder& srcFeature,
         const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
         const TQuantizationOptions& options,
         bool clearSrcData,
@@ -252,8 +306,21 @@ namespace NCB {
             borders = calculatedBorders;
         }
 
-        if (!calcBordersAndNanModeOnly && !borders.Empty()) {
-            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
+        // it's ok even if it is learn data, for learn nans are checked at CalcBordersAndNanMode stage
+        const bool allowNans = (nanMode != ENanMode::Forbidden) ||
+            quantizedFeaturesInfo->GetFloatFeaturesAllowNansInTestOnly();
+
+        const auto* sparseFeature = dynamic_cast<const TSparseFloatValuesHolder*>(&srcFeature);
+
+        if (!calcBordersAndNanModeOnly && !borders.Empty() && sparseFeature) {
+            *dstQuantizedFeature = MakeHolder<TQuantizedFloatSparseValuesHolder>(
+                srcFeature.GetId(),
+                QuantizeSparse(sparseFeature->GetSubsetData(), allowNans, nanMode, srcFeature.GetId(), borders),
+                dstSubsetIndexing
+            );
+        } else if (!calcBordersAndNanModeOnly && !borders.Empty()) {
+            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData
+                = dynamic_cast<const TFloatValuesHolder&>(srcFeature).GetArrayData();
 
             if (!options.CpuCompatibleFormat && !clearSrcData) {
                 // use GPU-only external columns
@@ -275,10 +342,6 @@ namespace NCB {
                     srcFeatureData.Size()
                 );
 
-                // it's ok even if it is learn data, for learn nans are checked at CalcBordersAndNanMode stage
-                bool allowNans = (nanMode != ENanMode::Forbidden) ||
-                    quantizedFeaturesInfo->GetFloatFeaturesAllowNansInTestOnly();
-
                 Quantize(
                     srcFeatureData,
                     allowNans,
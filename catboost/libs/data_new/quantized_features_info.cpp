@@ -9,6 +9,7 @@
 
 #include <library/dbg_output/dump.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/xrange.h>
@@ -70,20 +71,31 @@ namespace NCB {
             (CatFeaturesPerfectHash == rhs.CatFeaturesPerfectHash);
     }
 
-    ENanMode TQuantizedFeaturesInfo::ComputeNanMode(const TFloatValuesHolder& feature) const {
+    ENanMode TQuantizedFeaturesInfo::ComputeNanMode(const IFloatValuesHolder& feature) const {
         if (FloatFeaturesBinarization.NanMode == ENanMode::Forbidden) {
             return ENanMode::Forbidden;
         }
-        TMaybeOwningConstArraySubset<float, ui32> arrayData = feature.GetArrayData();
-
-        bool hasNans = arrayData.Find([] (size_t /*idx*/, float value) { return IsNan(value); });
+        bool hasNans = false;
+        if (const auto* denseFeature = dynamic_cast<const TFloatValuesHolder*>(&feature)) {
+            TMaybeOwningConstArraySubset<float, ui32> arrayData = denseFeature->GetArrayData();
+            hasNans = arrayData.Find([] (size_t /*idx*/, float value) { return IsNan(value); });
+        } else {
+            const auto& sparseFeature = dynamic_cast<const TSparseFloatValuesHolder&>(feature);
+            const TSparseArray<float, ui32> sparseData = sparseFeature.GetSubsetData();
+            hasNans = (sparseData.GetNonDefaultSize() != sparseData.GetSize())
+                && IsNan(sparseData.GetDefaultValue());
+            hasNans = hasNans || AnyOf(
+                sparseData.GetValues(),
+                [] (float value) { return IsNan(value); }
+            );
+        }
         if (hasNans) {
             return FloatFeaturesBinarization.NanMode;
         }
         return ENanMode::Forbidden;
     }
 
-    ENanMode TQuantizedFeaturesInfo::GetOrComputeNanMode(const TFloatValuesHolder& feature)  {
+    ENanMode TQuantizedFeaturesInfo::GetOrComputeNanMode(const IFloatValuesHolder& feature)  {
         const auto floatFeatureIdx = GetPerTypeFeatureIdx<EFeatureType::Float>(feature);
         if (!NanModes.contains(*floatFeatureIdx)) {
             NanModes[*floatFeatureIdx] = ComputeNanMode(feature);
@@ -88,7 +88,7 @@ namespace NCB {
             NanModes[*floatFeatureIdx] = nanMode;
         }
 
-        ENanMode GetOrComputeNanMode(const TFloatValuesHolder& feature);
+        ENanMode GetOrComputeNanMode(const IFloatValuesHolder& feature);
 
         ENanMode GetNanMode(const TFloatFeatureIdx floatFeatureIdx) const;
 
@@ -179,7 +179,7 @@ namespace NCB {
         friend class TCatFeaturesPerfectHashHelper;
         friend class TObjectsSerialization;
 
-        inline ENanMode ComputeNanMode(const TFloatValuesHolder& feature) const;
+        inline ENanMode ComputeNanMode(const IFloatValuesHolder& feature) const;
 
     private:
         // use for shared mutable access
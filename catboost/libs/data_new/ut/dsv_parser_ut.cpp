@@ -0,0 +1,65 @@
+#include <catboost/libs/data_new/dsv_parser.h>
+
+#include <util/generic/string.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
+
+#include <cstring>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(DsvParser) {
+    Y_UNIT_TEST(SplitDsvLine) {
+        TFastRng64 rng(0);
+        TVector<TStringBuf> tokens;
+        for (auto lineLength : {0, 1, 5, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+            for (auto iteration : xrange(20)) {
+                Y_UNUSED(iteration);
+                TString line;
+                for (auto i : xrange(lineLength)) {
+                    Y_UNUSED(i);
+                    line.push_back("\tab,"[rng.Uniform(4)]);
+                }
+                SplitDsvLine(line, '\t', &tokens);
+                const TVector<TStringBuf> expectedTokens = StringSplitter(line).Split('\t');
+                UNIT_ASSERT_VALUES_EQUAL(tokens, expectedTokens);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TryParseSimpleFloat) {
+        // values not in simple format are allowed to be left for the general parser
+        auto checkParsed = [] (TStringBuf value, bool mustBeParsed) {
+            float parsedValue = 0.0f;
+            if (!TryParseSimpleFloat(value, &parsedValue)) {
+                UNIT_ASSERT_C(!mustBeParsed, value);
+                return;
+            }
+            const float expectedValue = FromString<float>(value);
+            UNIT_ASSERT_C(memcmp(&parsedValue, &expectedValue, sizeof(float)) == 0, value);
+        };
+        for (TStringBuf value : {"0", "-0", "1", "-12", "0.5", "3.1415926", "1e10", "2.5E-3", "7e+22", "16777217"}) {
+            checkParsed(value, true);
+        }
+
+        TFastRng64 rng(0);
+        for (auto i : xrange(100000)) {
+            Y_UNUSED(i);
+            const double value = (rng.GenRandReal1() - 0.5) * Pow(10.0, (double)rng.Uniform(7));
+            checkParsed(ToString(value), false);
+            checkParsed(FloatToString(value, PREC_POINT_DIGITS, rng.Uniform(10)), true);
+        }
+
+        for (TStringBuf value : {"", "-", "nan", "inf", "+1", ".5", "1.", "1e", "1e-", "0x10", "1,5", "1e23", "12345678901234567890"}) {
+            float parsedValue = 0.0f;
+            UNIT_ASSERT_C(!TryParseSimpleFloat(value, &parsedValue), value);
+        }
+    }
+}
@@ -4,6 +4,8 @@
 #include <catboost/libs/data_new/util.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/array_ref.h>
 #include <util/generic/string.h>
 #include <util/generic/xrange.h>
@@ -98,7 +100,7 @@ namespace NCB {
         CompareSubgroupIds(objectsData.GetSubgroupIds(), expectedData.Objects.SubgroupIds);
         Compare(objectsData.GetTimestamp(), expectedData.Objects.Timestamp);
 
-        CompareFeatures<EFeatureType::Float, float, TFloatValuesHolder>(
+        CompareFeatures<EFeatureType::Float, float, IFloatValuesHolder>(
             *objectsData.GetFeaturesLayout(),
             /*getFeatureFunc*/ [&] (ui32 floatFeatureIdx) {
                 return objectsData.GetFloatFeature(floatFeatureIdx);
@@ -107,8 +109,10 @@ namespace NCB {
                 UNIT_ASSERT(floatFeatureIdx < expectedData.Objects.FloatFeatures.size());
                 return expectedData.Objects.FloatFeatures[floatFeatureIdx];
             },
-            /*areEqualFunc*/ [&](const TVector<float>& lhs, const TFloatValuesHolder& rhs) {
-                return Equal<float>(lhs, rhs.GetArrayData());
+            /*areEqualFunc*/ [&](const TVector<float>& lhs, const IFloatValuesHolder& rhs) {
+                // features can be stored both densely and sparsely
+                NPar::TLocalExecutor localExecutor;
+                return Equal<float>(*rhs.ExtractValues(&localExecutor), lhs);
             }
         );
 
@@ -35,11 +35,29 @@ namespace NCB {
     }
 
     template <class T, EFeatureValuesType TType>
+    void InitFeatures(
+        const TVector<TVector<T>>& src,
+        const TArraySubsetIndexing<ui32>& indexing,
+        TConstArrayRef<ui32> featureIds,
+        TVector<THolder<ITypedFeatureValuesHolder<T, TType>>>* dst
+    ) {
+        for (auto i : xrange(src.size())) {
+            dst->emplace_back(
+                MakeHolder<TArrayValuesHolder<T, TType>>(
+                    featureIds[i],
+                    TMaybeOwningConstArrayHolder<T>::CreateOwning( TVector<T>(src[i]) ),
+                    &indexing
+                )
+            );
+        }
+    }
+
+    template <class T, class TColumn>
     void InitFeatures(
         const TVector<TVector<T>>& src,
         const TArraySubsetIndexing<ui32>& indexing,
         ui32* featureId,
-        TVector<THolder<TArrayValuesHolder<T, TType>>>* dst
+        TVector<THolder<TColumn>>* dst
     ) {
         TVector<ui32> featureIds(src.size());
         std::iota(featureIds.begin(), featureIds.end(), *featureId);
@@ -0,0 +1,253 @@
+#include <catboost/libs/data_new/ut/lib/for_data_provider.h>
+#include <catboost/libs/data_new/ut/lib/for_loader.h>
+
+#include <catboost/libs/data_new/load_data.h>
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/objects_grouping.h>
+
+#include <util/generic/fwd.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/xrange.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+Y_UNIT_TEST_SUITE(LoadDataFromLibSvm) {
+    struct TTestCase {
+        TStringBuf SrcData;
+        TVector<ui32> IgnoredFeatures;
+        TExpectedRawData ExpectedData;
+    };
+
+    void Test(const TTestCase& testCase) {
+        // TODO(akhropov): temporarily use THolder until TTempFile move semantic are fixed
+        TVector<THolder<TTempFile>> srcDataFiles;
+
+        TPathWithScheme poolPath;
+        SaveDataToTempFile(testCase.SrcData, &poolPath, &srcDataFiles);
+        poolPath.Scheme = "libsvm";
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDataProviderPtr dataProvider = ReadDataset(
+            poolPath,
+            TPathWithScheme(),
+            TPathWithScheme(),
+            NCatboostOptions::TDsvPoolFormatParams(),
+            testCase.IgnoredFeatures,
+            EObjectsOrder::Undefined,
+            &localExecutor
+        );
+
+        Compare<TRawObjectsDataProvider>(std::move(dataProvider), testCase.ExpectedData);
+    }
+
+
+    void TestReadError(TStringBuf srcData, TStringBuf expectedMessage) {
+        // TODO(akhropov): temporarily use THolder until TTempFile move semantic are fixed
+        TVector<THolder<TTempFile>> srcDataFiles;
+
+        TPathWithScheme poolPath;
+        SaveDataToTempFile(srcData, &poolPath, &srcDataFiles);
+        poolPath.Scheme = "libsvm";
+
+        NPar::TLocalExecutor localExecutor;
+        UNIT_ASSERT_EXCEPTION_CONTAINS(
+            ReadDataset(
+                poolPath,
+                TPathWithScheme(),
+                TPathWithScheme(),
+                NCatboostOptions::TDsvPoolFormatParams(),
+                {},
+                EObjectsOrder::Undefined,
+                &localExecutor
+            ),
+            TCatBoostException,
+            expectedMessage
+        );
+    }
+
+
+    Y_UNIT_TEST(ReadDataset) {
+        TVector<TTestCase> testCases;
+
+        {
+            TTestCase simpleTestCase;
+            simpleTestCase.SrcData = AsStringBuf(
+                "0 1:0.1 3:0.2\n"
+                "# comment line\n"
+                "1 2:0.97 # trailing comment\n"
+                "0.5 1:0.13 2:0 3:0.22\n"
+            );
+
+            TExpectedRawData expectedData;
+
+            TDataColumnsMetaInfo dataColumnsMetaInfo;
+            dataColumnsMetaInfo.Columns = {
+                {EColumn::Label, ""},
+                {EColumn::Num, ""},
+                {EColumn::Num, ""},
+                {EColumn::Num, ""}
+            };
+
+            expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), false, false);
+            expectedData.Objects.FloatFeatures = {
+                TVector<float>{0.1f, 0.0f, 0.13f},
+                TVector<float>{0.0f, 0.97f, 0.0f},
+                TVector<float>{0.2f, 0.0f, 0.22f}
+            };
+
+            expectedData.ObjectsGrouping = TObjectsGrouping(3);
+            expectedData.Target.Target = TVector<TString>{"0", "1", "0.5"};
+            expectedData.Target.Weights = TWeights<float>(3);
+            expectedData.Target.GroupWeights = TWeights<float>(3);
+
+            simpleTestCase.ExpectedData = std::move(expectedData);
+
+            testCases.push_back(std::move(simpleTestCase));
+        }
+
+        {
+            TTestCase groupDataTestCase;
+            groupDataTestCase.SrcData = AsStringBuf(
+                "1 qid:query0 1:0.1 2:0.2\n"
+                "0 qid:query0 2:0.82\n"
+                "0 qid:query1 1:0.13\n"
+            );
+            groupDataTestCase.IgnoredFeatures = {1};
+
+            TExpectedRawData expectedData;
+
+            TDataColumnsMetaInfo dataColumnsMetaInfo;
+            dataColumnsMetaInfo.Columns = {
+                {EColumn::Label, ""},
+                {EColumn::GroupId, ""},
+                {EColumn::Num, ""},
+                {EColumn::Num, ""}
+            };
+
+            expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), false, false);
+            expectedData.MetaInfo.FeaturesLayout->IgnoreExternalFeature(1);
+            expectedData.Objects.GroupIds = TVector<TStringBuf>{"query0", "query0", "query1"};
+            expectedData.Objects.FloatFeatures = {
+                TVector<float>{0.1f, 0.0f, 0.13f},
+                Nothing()
+            };
+
+            expectedData.ObjectsGrouping = TObjectsGrouping(TVector<TGroupBounds>{{0, 2}, {2, 3}});
+            expectedData.Target.Target = TVector<TString>{"1", "0", "0"};
+            expectedData.Target.Weights = TWeights<float>(3);
+            expectedData.Target.GroupWeights = TWeights<float>(3);
+
+            groupDataTestCase.ExpectedData = std::move(expectedData);
+
+            testCases.push_back(std::move(groupDataTestCase));
+        }
+
+        for (const auto& testCase : testCases) {
+            Test(testCase);
+        }
+    }
+
+    Y_UNIT_TEST(ReadTestDatasetWithFeaturesCountOfLearn) {
+        // TODO(akhropov): temporarily use THolder until TTempFile move semantic are fixed
+        TVector<THolder<TTempFile>> srcDataFiles;
+
+        NCatboostOptions::TPoolLoadParams loadOptions;
+        SaveDataToTempFile(
+            AsStringBuf(
+                "0 1:0.1 4:0.2\n"
+                "1 2:0.97\n"
+            ),
+            &loadOptions.LearnSetPath,
+            &srcDataFiles
+        );
+        loadOptions.LearnSetPath.Scheme = "libsvm";
+
+        // the largest feature index in test data is less than in learn data
+        loadOptions.TestSetPaths.resize(1);
+        SaveDataToTempFile(
+            AsStringBuf(
+                "1 2:0.5\n"
+                "0 1:0.3 2:0.4\n"
+                "0.5 3:0.7\n"
+            ),
+            &loadOptions.TestSetPaths[0],
+            &srcDataFiles
+        );
+        loadOptions.TestSetPaths[0].Scheme = "libsvm";
+
+        TDataProviders dataProviders = ReadTrainDatasets(
+            loadOptions,
+            EObjectsOrder::Undefined,
+            /*readTestData*/ true,
+            /*threadCount*/ 4,
+            /*profile*/ Nothing()
+        );
+        UNIT_ASSERT_VALUES_EQUAL(dataProviders.Test.size(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(dataProviders.Learn->MetaInfo.GetFeatureCount(), 4);
+
+        TExpectedRawData expectedData;
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {{EColumn::Label, ""}};
+        for (auto i : xrange(4)) {
+            Y_UNUSED(i);
+            dataColumnsMetaInfo.Columns.push_back({EColumn::Num, ""});
+        }
+
+        expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), false, false);
+        expectedData.Objects.FloatFeatures = {
+            TVector<float>{0.0f, 0.3f, 0.0f},
+            TVector<float>{0.5f, 0.4f, 0.0f},
+            TVector<float>{0.0f, 0.0f, 0.7f},
+            TVector<float>{0.0f, 0.0f, 0.0f}
+        };
+
+        expectedData.ObjectsGrouping = TObjectsGrouping(3);
+        expectedData.Target.Target = TVector<TString>{"1", "0", "0.5"};
+        expectedData.Target.Weights = TWeights<float>(3);
+        expectedData.Target.GroupWeights = TWeights<float>(3);
+
+        Compare<TRawObjectsDataProvider>(std::move(dataProviders.Test[0]), expectedData);
+    }
+
+    Y_UNIT_TEST(ReadTestDatasetWithMoreFeaturesThanLearn) {
+        // TODO(akhropov): temporarily use THolder until TTempFile move semantic are fixed
+        TVector<THolder<TTempFile>> srcDataFiles;
+
+        NCatboostOptions::TPoolLoadParams loadOptions;
+        SaveDataToTempFile(AsStringBuf("0 1:0.1\n1 2:0.97\n"), &loadOptions.LearnSetPath, &srcDataFiles);
+        loadOptions.LearnSetPath.Scheme = "libsvm";
+
+        loadOptions.TestSetPaths.resize(1);
+        SaveDataToTempFile(AsStringBuf("1 3:0.5\n"), &loadOptions.TestSetPaths[0], &srcDataFiles);
+        loadOptions.TestSetPaths[0].Scheme = "libsvm";
+
+        UNIT_ASSERT_EXCEPTION(
+            ReadTrainDatasets(
+                loadOptions,
+                EObjectsOrder::Undefined,
+                /*readTestData*/ true,
+                /*threadCount*/ 4,
+                /*profile*/ Nothing()
+            ),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(ReadDatasetWithErrors) {
+        // line numbers count empty and comment lines
+        TestReadError(AsStringBuf("0 1:0.1\n\n# comment\n1 2:x\n"), "Line 4:");
+        // zero values are not stored, but their indices are checked
+        TestReadError(AsStringBuf("0 1:0 1:5\n"), "Feature 1 is specified several times");
+        TestReadError(AsStringBuf("0 1:0.1 1:0\n"), "Feature 1 is specified several times");
+        TestReadError(AsStringBuf("0 3:0 2:0.5\n"), "ascending order");
+    }
+}
@@ -312,7 +312,8 @@ Y_UNIT_TEST_SUITE(TRawObjectsData) {
                     UNIT_ASSERT(
                         Equal<float>(
                             subsetFloatFeatures[i],
-                            (*objectsDataProvider.GetFloatFeature(i))->GetArrayData()
+                            dynamic_cast<const TFloatValuesHolder*>(*objectsDataProvider.GetFloatFeature(i))
+                                ->GetArrayData()
                         )
                     );
                 }
@@ -1139,4 +1140,101 @@ Y_UNIT_TEST_SUITE(TQuantizedObjectsData) {
         );
 
     }
+
+    Y_UNIT_TEST(PackedBinaryFloatFeatures) {
+        // features 0 and 2 are binary, feature 1 is not
+        TVector<TVector<float>> borders = {{0.5f}, {0.1f, 0.2f, 0.3f}, {1.0f}};
+        TVector<TVector<ui8>> srcFloatFeatures = {
+            {0, 1, 1, 0, 1},
+            {0, 3, 2, 1, 0},
+            {1, 0, 0, 1, 1}
+        };
+
+        TFeaturesLayout featuresLayout((ui32)srcFloatFeatures.size(), {}, {});
+
+        TCommonObjectsData commonData;
+        commonData.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(featuresLayout);
+        commonData.SubsetIndexing = MakeAtomicShared<TArraySubsetIndexing<ui32>>(
+            TFullSubset<ui32>(srcFloatFeatures[0].size())
+        );
+        commonData.Order = EObjectsOrder::Undefined;
+
+        TQuantizedObjectsData data;
+        data.QuantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            featuresLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions()
+        );
+        for (auto floatFeatureIdx : xrange(borders.size())) {
+            data.QuantizedFeaturesInfo->SetBorders(
+                TFloatFeatureIdx(floatFeatureIdx),
+                TVector<float>(borders[floatFeatureIdx])
+            );
+        }
+        TVector<ui32> featureIds = {0, 1, 2};
+        NCB::NDataNewUT::InitQuantizedFeatures(
+            srcFloatFeatures,
+            commonData.SubsetIndexing.Get(),
+            featureIds,
+            &data.FloatFeatures
+        );
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+
+        auto checkFeatures = [&] (
+            const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+            const TVector<ui32>& objectIndices
+        ) {
+            for (auto floatFeatureIdx : xrange(srcFloatFeatures.size())) {
+                const auto& srcFeature = srcFloatFeatures[floatFeatureIdx];
+                TVector<ui8> expectedValues;
+                for (auto objectIdx : objectIndices) {
+                    expectedValues.push_back(srcFeature[objectIdx]);
+                }
+                UNIT_ASSERT_EQUAL(
+                    (TConstArrayRef<ui8>)expectedValues,
+                    *((*objectsDataProvider.TQuantizedObjectsDataProvider::GetFloatFeature(
+                        floatFeatureIdx
+                    ))->ExtractValues(&localExecutor))
+                );
+
+                const auto packedBinaryBins = objectsDataProvider.GetFloatFeaturePackedBinaryBins(
+                    floatFeatureIdx
+                );
+                UNIT_ASSERT_VALUES_EQUAL(packedBinaryBins.Defined(), floatFeatureIdx != 1);
+                if (packedBinaryBins) {
+                    // packed features have no dense holder
+                    UNIT_ASSERT_EXCEPTION(objectsDataProvider.GetFloatFeature(floatFeatureIdx), TCatBoostException);
+                    objectsDataProvider.GetFeaturesArraySubsetIndexing().ForEach(
+                        [&] (ui32 idx, ui32 srcIdx) {
+                            UNIT_ASSERT_VALUES_EQUAL((*packedBinaryBins)[srcIdx], expectedValues[idx]);
+                        }
+                    );
+                }
+            }
+        };
+
+        TQuantizedForCPUObjectsDataProvider objectsDataProvider(
+            Nothing(),
+            std::move(commonData),
+            std::move(data),
+            false,
+            &localExecutor
+        );
+        checkFeatures(objectsDataProvider, {0, 1, 2, 3, 4});
+
+        TVector<ui32> subsetIndices = {4, 1, 3};
+        auto subsetDataProvider = GetMaybeSubsetDataProvider(
+            std::move(objectsDataProvider),
+            TArraySubsetIndexing<ui32>(TIndexedSubset<ui32>(subsetIndices)),
+            EObjectsOrder::Undefined,
+            &localExecutor
+        );
+        checkFeatures(subsetDataProvider, subsetIndices);
+
+        subsetDataProvider.EnsureConsecutiveFeaturesData(&localExecutor);
+        UNIT_ASSERT(subsetDataProvider.GetFeaturesArraySubsetIndexing().IsConsecutive());
+        checkFeatures(subsetDataProvider, subsetIndices);
+    }
 }
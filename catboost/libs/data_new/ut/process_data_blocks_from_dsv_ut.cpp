@@ -40,7 +40,8 @@ inline void ReadAndProceedPoolInBlocks(
                 /*ignoredFeatures*/ {},
                 EObjectsOrder::Undefined,
                 blockSize,
-                localExecutor
+                localExecutor,
+                /*featuresLayout*/ nullptr
             }
         }
     );
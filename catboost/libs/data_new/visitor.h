@@ -10,6 +10,7 @@
 #include <catboost/libs/data_types/pair.h>
 #include <catboost/libs/helpers/maybe_owning_array_holder.h>
 #include <catboost/libs/helpers/resource_holder.h>
+#include <catboost/libs/helpers/sparse_array.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/quantization_schema/schema.h>
 
@@ -139,6 +140,9 @@ namespace NCB {
         // shared ownership is passed to IRawFeaturesOrderDataVisitor
         virtual void AddFloatFeature(ui32 flatFeatureIdx, TMaybeOwningConstArrayHolder<float> features) = 0;
 
+        // for features with most of the values equal to some default value (usually 0)
+        virtual void AddFloatFeature(ui32 flatFeatureIdx, TSparseArray<float, ui32> features) = 0;
+
         virtual void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TString> feature) = 0;
         virtual void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TStringBuf> feature) = 0;
 
@@ -192,6 +196,7 @@ namespace NCB {
 
         /* shared ownership is passed to Start in resourceHolders to avoid creating resource holder
          * for each such call
+         * featuresPart can include padding after objects' data up to the end of the last ui64 word
          */
         virtual void AddFloatFeaturePart(
             ui32 flatFeatureIdx,
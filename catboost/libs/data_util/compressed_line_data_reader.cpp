@@ -0,0 +1,477 @@
+#include "compressed_line_data_reader.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/blockcodecs/codecs.h>
+#include <library/blockcodecs/stream.h>
+#include <library/streams/brotli/brotli.h>
+#include <library/streams/lz/lz.h>
+#include <library/threading/future/future.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/digest/murmur.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/buffer.h>
+#include <util/generic/cast.h>
+#include <util/generic/deque.h>
+#include <util/generic/hash.h>
+#include <util/generic/maybe.h>
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/stream/buffered.h>
+#include <util/stream/file.h>
+#include <util/stream/mem.h>
+#include <util/stream/zlib.h>
+#include <util/system/atomic.h>
+#include <util/system/file.h>
+#include <util/ysaveload.h>
+
+#include <exception>
+
+
+namespace NCB {
+
+    namespace {
+
+    enum class ECompression {
+        GZip,
+        Lz,
+        Brotli,
+        BlockCodecs
+    };
+
+    // NBlockCodecs::TCodedOutput block header is codec id followed by compressed block size
+    constexpr size_t BLOCK_HEADER_SIZE = sizeof(ui16) + sizeof(ui64);
+    // the same limit as in NBlockCodecs::TDecodedInput
+    constexpr ui64 MAX_COMPRESSED_BLOCK_SIZE = 1 << 30;
+
+    struct TBlockHeader {
+        ui16 CodecId = 0;
+        ui64 Size = 0;
+    };
+
+    // codec ids are computed in the same way as in library/blockcodecs/stream.cpp
+    class TBlockCodecsById {
+    public:
+        TBlockCodecsById() {
+            for (const auto& name : NBlockCodecs::ListAllCodecs()) {
+                const NBlockCodecs::ICodec* codec = NBlockCodecs::Codec(name);
+                const TStringBuf codecName = codec->Name();
+                const ui32 hash = MurmurHash<ui32>(codecName.data(), codecName.size());
+                CodecById[(ui16)(hash >> 16) ^ (ui16)hash] = codec;
+            }
+        }
+
+        const NBlockCodecs::ICodec* Find(ui16 codecId) const {
+            const auto* codec = CodecById.FindPtr(codecId);
+            return codec ? *codec : nullptr;
+        }
+
+    private:
+        THashMap<ui16, const NBlockCodecs::ICodec*> CodecById;
+    };
+
+    bool TryReadBlockHeader(const TFile& file, ui64 offset, TBlockHeader* header) {
+        char buffer[BLOCK_HEADER_SIZE];
+        if (file.Pread(buffer, BLOCK_HEADER_SIZE, offset) != BLOCK_HEADER_SIZE) {
+            return false;
+        }
+        TMemoryInput in(buffer, BLOCK_HEADER_SIZE);
+        ::Load(&in, header->CodecId);
+        ::Load(&in, header->Size);
+        return true;
+    }
+
+    bool IsLzCompressed(const TString& path) {
+        try {
+            TIFStream in(path);
+            return TryOpenLzDecompressor(&in).Get() != nullptr;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    TMaybe<ECompression> DetectCompression(const TString& path) {
+        TFile file(path, OpenExisting | RdOnly);
+        const ui64 fileSize = (ui64)file.GetLength();
+
+        ui8 signature[2];
+        if ((file.Pread(signature, sizeof(signature), 0) == sizeof(signature))
+            && (signature[0] == 0x1f) && (signature[1] == 0x8b))
+        {
+            return ECompression::GZip;
+        }
+
+        // text has no zero bytes, so valid block size in the first block header is a reliable signature
+        TBlockHeader header;
+        if (TryReadBlockHeader(file, 0, &header)
+            && (header.Size ? (header.Size <= fileSize - BLOCK_HEADER_SIZE) : (fileSize == BLOCK_HEADER_SIZE))
+            && Singleton<TBlockCodecsById>()->Find(header.CodecId))
+        {
+            return ECompression::BlockCodecs;
+        }
+
+        if (IsLzCompressed(path)) {
+            return ECompression::Lz;
+        }
+        if (path.EndsWith(".br")) {
+            return ECompression::Brotli;
+        }
+        return Nothing();
+    }
+
+
+    // decompressed file contents for sequential reading
+    class TDecompressedFileInput {
+    public:
+        TDecompressedFileInput(const TString& path, ECompression compression)
+            : File(path)
+        {
+            switch (compression) {
+                case ECompression::GZip:
+                    Decompressor = MakeHolder<TZLibDecompress>(&File);
+                    break;
+                case ECompression::Lz:
+                    Decompressor.Reset(OpenLzDecompressor(&File).Release());
+                    break;
+                case ECompression::Brotli:
+                    Decompressor = MakeHolder<TBrotliDecompress>(&File);
+                    break;
+                case ECompression::BlockCodecs:
+                    Decompressor = MakeHolder<NBlockCodecs::TDecodedInput>(&File);
+                    break;
+            }
+            // decompressors are not buffered, and reading lines from them reads them by single chars
+            BufferedInput = MakeHolder<TBufferedInput>(Decompressor.Get(), 1 << 16);
+        }
+
+        IInputStream* Get() {
+            return BufferedInput.Get();
+        }
+
+    private:
+        TIFStream File;
+        THolder<IInputStream> Decompressor;
+        THolder<TBufferedInput> BufferedInput;
+    };
+
+
+    class TDecompressingLineDataReaderBase : public ILineDataReader {
+    public:
+        TDecompressingLineDataReaderBase(const TLineDataReaderArgs& args, ECompression compression)
+            : Args(args)
+            , Compression(compression)
+            , HeaderProcessed(!Args.Format.HasHeader)
+        {}
+
+        ui64 GetDataLineCount() override {
+            TDecompressedFileInput input(Args.PathWithScheme.Path, Compression);
+
+            ui64 lineCount = 0;
+            TVector<char> buffer(1 << 16);
+            char lastChar = '\n';
+            while (const size_t readSize = input.Get()->Read(buffer.data(), buffer.size())) {
+                lineCount += Count(buffer.begin(), buffer.begin() + readSize, '\n');
+                lastChar = buffer[readSize - 1];
+            }
+            if (lastChar != '\n') {
+                ++lineCount; // last line without line end
+            }
+            if (Args.Format.HasHeader && lineCount) {
+                --lineCount;
+            }
+            return lineCount;
+        }
+
+        TMaybe<TString> GetHeader() override {
+            if (Args.Format.HasHeader) {
+                CB_ENSURE(!HeaderProcessed, "TDecompressingLineDataReader: multiple calls to GetHeader");
+                TString header;
+                CB_ENSURE(ReadDecompressedLine(&header), "TDecompressingLineDataReader: no header in file");
+                HeaderProcessed = true;
+                return header;
+            }
+
+            return {};
+        }
+
+        bool ReadLine(TString* line) override {
+            // skip header if it hasn't been read
+            if (!HeaderProcessed) {
+                GetHeader();
+            }
+            return ReadDecompressedLine(line);
+        }
+
+    protected:
+        virtual bool ReadDecompressedLine(TString* line) = 0;
+
+    protected:
+        TLineDataReaderArgs Args;
+        ECompression Compression;
+
+    private:
+        bool HeaderProcessed;
+    };
+
+
+    class TSequentialDecompressingLineDataReader final : public TDecompressingLineDataReaderBase {
+    public:
+        TSequentialDecompressingLineDataReader(const TLineDataReaderArgs& args, ECompression compression)
+            : TDecompressingLineDataReaderBase(args, compression)
+            , Input(Args.PathWithScheme.Path, compression)
+        {}
+
+    private:
+        bool ReadDecompressedLine(TString* line) override {
+            return Input.Get()->ReadLine(*line) != 0;
+        }
+
+    private:
+        TDecompressedFileInput Input;
+    };
+
+
+    /* Blocks of NBlockCodecs streams can be decompressed independently, so their headers are scanned
+     * ahead and the blocks are read and decompressed concurrently on executor threads,
+     * while lines are assembled from the decompressed blocks in order.
+     */
+    class TBlockCodecsLineDataReader final : public TDecompressingLineDataReaderBase {
+    public:
+        explicit TBlockCodecsLineDataReader(const TLineDataReaderArgs& args)
+            : TDecompressingLineDataReaderBase(args, ECompression::BlockCodecs)
+            , File(Args.PathWithScheme.Path, OpenExisting | RdOnly | Seq)
+            , FileSize((ui64)File.GetLength())
+            , MaxBlocksInFlight(1)
+        {
+            if (Args.LocalExecutor && (Args.LocalExecutor->GetThreadCount() > 0)) {
+                MaxBlocksInFlight = 2 * (Args.LocalExecutor->GetThreadCount() + 1);
+            }
+        }
+
+    private:
+        struct TBlock : public TThrRefBase {
+            ui64 Offset = 0; // of compressed data in file
+            TBlockHeader Header;
+            TAtomic Claimed = 0;
+            NThreading::TPromise<void> Ready = NThreading::NewPromise();
+            TBuffer Data; // decompressed
+        };
+
+        using TBlockPtr = TIntrusivePtr<TBlock>;
+
+        static void DecompressBlock(const TFile& file, TBlock* block) {
+            if (!AtomicCas(&block->Claimed, 1, 0)) {
+                return; // already processed or being processed in another thread
+            }
+            try {
+                const NBlockCodecs::ICodec* codec = Singleton<TBlockCodecsById>()->Find(block->Header.CodecId);
+                CB_ENSURE(codec, "can not find block codec by id " << block->Header.CodecId);
+
+                TBuffer compressedData;
+                compressedData.Resize(block->Header.Size);
+                file.Pload(compressedData.Data(), compressedData.Size(), block->Offset);
+                codec->Decode(compressedData, block->Data);
+                block->Ready.SetValue();
+            } catch (...) {
+                block->Ready.SetException(std::current_exception());
+            }
+        }
+
+        // @return false if there're no more blocks starting at offset
+        bool ReadNextBlockHeader(ui64 offset, TBlockHeader* header) const {
+            if (offset == FileSize) {
+                return false;
+            }
+            CB_ENSURE(
+                TryReadBlockHeader(File, offset, header),
+                "compressed file '" << Args.PathWithScheme.Path << "' is truncated"
+            );
+            if (!header->Size) { // end of stream marker
+                return false;
+            }
+            CB_ENSURE(
+                header->Size <= MAX_COMPRESSED_BLOCK_SIZE,
+                "compressed file '" << Args.PathWithScheme.Path << "': block size exceeds 1 GiB"
+            );
+            return true;
+        }
+
+        void ScheduleBlocks() {
+            const bool useExecutor = MaxBlocksInFlight > 1;
+            while (!StreamFinished && (Blocks.size() < MaxBlocksInFlight)) {
+                TBlockHeader header;
+                if (!ReadNextBlockHeader(NextBlockOffset, &header)) {
+                    StreamFinished = true;
+                    break;
+                }
+
+                TBlockPtr block = MakeIntrusive<TBlock>();
+                block->Offset = NextBlockOffset + BLOCK_HEADER_SIZE;
+                block->Header = header;
+                NextBlockOffset = block->Offset + header.Size;
+                Blocks.push_back(block);
+
+                if (useExecutor) {
+                    // tasks own everything they use, so the reader can be destroyed before they finish
+                    Args.LocalExecutor->Exec(
+                        [file = File, block] (int) {
+                            DecompressBlock(file, block.Get());
+                        },
+                        0,
+                        NPar::TLocalExecutor::HIGH_PRIORITY
+                    );
+                }
+            }
+        }
+
+        // @return nullptr if there're no more blocks
+        TBlock* GetFrontBlock() {
+            if (Blocks.empty()) {
+                ScheduleBlocks();
+                if (Blocks.empty()) {
+                    return nullptr;
+                }
+            }
+            TBlock* block = Blocks.front().Get();
+            if (!FrontBlockReady) {
+                // decompress the block here if no thread has started it yet, so there is no waiting
+                // for executor threads that can be busy with the caller's own tasks
+                DecompressBlock(File, block);
+                block->Ready.GetFuture().GetValueSync(); // will rethrow if there was an exception
+                FrontBlockReady = true;
+            }
+            if (block->Data.Empty()) {
+                // NBlockCodecs::TCodedOutput finishes stream with an empty block
+                Blocks.clear();
+                FrontBlockReady = false;
+                StreamFinished = true;
+                return nullptr;
+            }
+            return block;
+        }
+
+        struct TBlockLineStats {
+            ui64 LineEndCount = 0;
+            bool IsEmpty = true;
+            bool EndsWithLineEnd = false;
+        };
+
+        // blocks are decompressed concurrently just to count line ends, only headers are scanned serially
+        ui64 GetDataLineCount() override {
+            TVector<ui64> blockOffsets;
+            TVector<TBlockHeader> blockHeaders;
+            for (ui64 offset = 0;;) {
+                TBlockHeader header;
+                if (!ReadNextBlockHeader(offset, &header)) {
+                    break;
+                }
+                blockOffsets.push_back(offset + BLOCK_HEADER_SIZE);
+                blockHeaders.push_back(header);
+                offset = blockOffsets.back() + header.Size;
+            }
+
+            TVector<TBlockLineStats> blockStats(blockHeaders.size());
+            const auto countLineEnds = [&] (int blockIdx) {
+                const TBlockHeader& header = blockHeaders[blockIdx];
+                const NBlockCodecs::ICodec* codec = Singleton<TBlockCodecsById>()->Find(header.CodecId);
+                CB_ENSURE(codec, "can not find block codec by id " << header.CodecId);
+
+                TBuffer compressedData;
+                compressedData.Resize(header.Size);
+                File.Pload(compressedData.Data(), compressedData.Size(), blockOffsets[blockIdx]);
+                TBuffer data;
+                codec->Decode(compressedData, data);
+
+                TBlockLineStats& stats = blockStats[blockIdx];
+                stats.LineEndCount = Count(data.Data(), data.Data() + data.Size(), '\n');
+                stats.IsEmpty = data.Empty();
+                stats.EndsWithLineEnd = !data.Empty() && (data.Data()[data.Size() - 1] == '\n');
+            };
+            const int blockCount = SafeIntegerCast<int>(blockHeaders.size());
+            if (Args.LocalExecutor && (Args.LocalExecutor->GetThreadCount() > 0)) {
+                Args.LocalExecutor->ExecRangeWithThrow(
+                    countLineEnds,
+                    0,
+                    blockCount,
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+            } else {
+                for (int blockIdx : xrange(blockCount)) {
+                    countLineEnds(blockIdx);
+                }
+            }
+
+            ui64 lineCount = 0;
+            bool endsWithLineEnd = true;
+            for (const auto& stats : blockStats) {
+                if (stats.IsEmpty) {
+                    break; // NBlockCodecs::TCodedOutput finishes stream with an empty block
+                }
+                lineCount += stats.LineEndCount;
+                endsWithLineEnd = stats.EndsWithLineEnd;
+            }
+            if (!endsWithLineEnd) {
+                ++lineCount; // last line without line end
+            }
+            if (Args.Format.HasHeader && lineCount) {
+                --lineCount;
+            }
+            return lineCount;
+        }
+
+        bool ReadDecompressedLine(TString* line) override {
+            line->clear();
+            bool lineStarted = false;
+            while (TBlock* block = GetFrontBlock()) {
+                const char* begin = block->Data.Data() + FrontBlockPos;
+                const char* end = block->Data.Data() + block->Data.Size();
+                const char* lineEnd = Find(begin, end, '\n');
+                line->append(begin, lineEnd - begin);
+                lineStarted = lineStarted || (begin != end);
+                if (lineEnd != end) {
+                    FrontBlockPos = (lineEnd + 1) - block->Data.Data();
+                    break;
+                }
+                Blocks.pop_front();
+                FrontBlockReady = false;
+                FrontBlockPos = 0;
+                ScheduleBlocks();
+            }
+            if (!lineStarted) {
+                return false;
+            }
+            if (!line->empty() && (line->back() == '\r')) {
+                line->pop_back();
+            }
+            return true;
+        }
+
+    private:
+        TFile File;
+        ui64 FileSize;
+        size_t MaxBlocksInFlight;
+
+        ui64 NextBlockOffset = 0;
+        bool StreamFinished = false;
+        TDeque<TBlockPtr> Blocks; // scheduled blocks in file order
+        bool FrontBlockReady = false;
+        size_t FrontBlockPos = 0;
+    };
+
+    }
+
+
+    THolder<ILineDataReader> TryGetCompressedLineDataReader(const TLineDataReaderArgs& args) {
+        const TMaybe<ECompression> compression = DetectCompression(args.PathWithScheme.Path);
+        if (!compression) {
+            return nullptr;
+        }
+        if (*compression == ECompression::BlockCodecs) {
+            return MakeHolder<TBlockCodecsLineDataReader>(args);
+        }
+        return MakeHolder<TSequentialDecompressingLineDataReader>(args, *compression);
+    }
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "line_data_reader.h"
+
+#include <util/generic/ptr.h>
+
+
+namespace NCB {
+
+    /* Returns reader of decompressed lines if the file in args.PathWithScheme is compressed.
+     * Supported formats:
+     *  - streams written by NBlockCodecs::TCodedOutput (zstd, lz4 and other block codecs),
+     *    their blocks are decompressed in parallel on args.LocalExecutor threads
+     *  - gzip
+     *  - library/streams/lz formats (lz4, snappy, fastlz, quicklz, minilzo)
+     *  - brotli, detected by ".br" extension because brotli streams have no signature
+     * Formats other than block codecs streams are decompressed sequentially.
+     * @return nullptr if the file is not compressed
+     */
+    THolder<ILineDataReader> TryGetCompressedLineDataReader(const TLineDataReaderArgs& args);
+
+}
@@ -9,10 +9,11 @@
 namespace NCB {
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
-                                               const TDsvFormatOptions& format)
+                                               const TDsvFormatOptions& format,
+                                               NPar::TLocalExecutor* localExecutor)
     {
         return GetProcessor<ILineDataReader, TLineDataReaderArgs>(
-            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format}
+            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format, localExecutor}
         );
     }
 
@@ -74,9 +75,9 @@ namespace NCB {
     };
 
 
-    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DefLineDataReaderReg("");
+    // "" and "dsv" schemes are read by TParallelFileLineDataReader
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> FileLineDataReaderReg("file");
-    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLineDataReaderReg("dsv");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> LibSvmLineDataReaderReg("libsvm");
 
     }
 }
@@ -0,0 +1,223 @@
+#include "parallel_line_data_reader.h"
+#include "compressed_line_data_reader.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/system/fs.h>
+#include <util/system/fstat.h>
+
+#include <exception>
+
+
+namespace NCB {
+
+    static constexpr size_t LINE_END_SEARCH_STEP = 64 << 10;
+
+    // append data from offset up to and including the next '\n' (or up to the end of file)
+    static void ReadUntilLineEnd(const TFile& file, ui64 offset, ui64 fileSize, TString* data) {
+        while (offset < fileSize) {
+            const size_t prevSize = data->size();
+            const size_t stepSize = (size_t)Min<ui64>(LINE_END_SEARCH_STEP, fileSize - offset);
+            data->resize(prevSize + stepSize);
+            const size_t readSize = file.Pread(data->begin() + prevSize, stepSize, offset);
+            data->resize(prevSize + readSize);
+            if (readSize == 0) {
+                return;
+            }
+            const size_t lineEnd = data->find('\n', prevSize);
+            if (lineEnd != TString::npos) {
+                data->resize(lineEnd + 1);
+                return;
+            }
+            offset += readSize;
+        }
+    }
+
+    static TString MakeLine(const TString& data, size_t begin, size_t end) {
+        if ((end > begin) && (data[end - 1] == '\r')) {
+            --end;
+        }
+        return data.substr(begin, end - begin);
+    }
+
+
+    TParallelFileLineDataReader::TParallelFileLineDataReader(const TLineDataReaderArgs& args, ui64 chunkSize)
+        : Args(args)
+        , ChunkSize(chunkSize)
+        , MaxChunksInFlight(1)
+    {
+        CB_ENSURE(ChunkSize > 0, "TParallelFileLineDataReader: chunkSize == 0");
+        CB_ENSURE(
+            NFs::Exists(Args.PathWithScheme.Path),
+            "pool file '" << Args.PathWithScheme.Path << "' is not found"
+        );
+        if (!TFileStat(Args.PathWithScheme.Path).IsFile()) {
+            DelegateReader.Reset(TLineDataReaderFactory::Construct("file", Args));
+            return;
+        }
+        DelegateReader = TryGetCompressedLineDataReader(Args);
+        if (DelegateReader) {
+            return;
+        }
+        if (Args.LocalExecutor && (Args.LocalExecutor->GetThreadCount() > 0)) {
+            MaxChunksInFlight = 2 * (Args.LocalExecutor->GetThreadCount() + 1);
+        }
+        File = TFile(Args.PathWithScheme.Path, OpenExisting | RdOnly | Seq);
+        FileSize = (ui64)File.GetLength();
+        HeaderProcessed = !Args.Format.HasHeader;
+        if (Args.Format.HasHeader) {
+            ReadHeader();
+        }
+        NextChunkBegin = DataBegin;
+    }
+
+    void TParallelFileLineDataReader::ReadHeader() {
+        TString data;
+        ReadUntilLineEnd(File, 0, FileSize, &data);
+        DataBegin = data.size();
+        if (!data.empty()) {
+            Header = MakeLine(data, 0, data.back() == '\n' ? data.size() - 1 : data.size());
+        }
+    }
+
+    ui64 TParallelFileLineDataReader::GetDataLineCount() {
+        if (DelegateReader) {
+            return DelegateReader->GetDataLineCount();
+        }
+
+        ui64 lineCount = 0;
+        TString buffer;
+        buffer.resize(LINE_END_SEARCH_STEP);
+        char lastChar = '\n';
+        for (ui64 offset = 0; offset < FileSize; ) {
+            const size_t readSize = File.Pread(buffer.begin(), buffer.size(), offset);
+            if (readSize == 0) {
+                break;
+            }
+            lineCount += Count(buffer.begin(), buffer.begin() + readSize, '\n');
+            lastChar = buffer[readSize - 1];
+            offset += readSize;
+        }
+        if (lastChar != '\n') {
+            ++lineCount; // last line without line end
+        }
+        if (Args.Format.HasHeader && lineCount) {
+            --lineCount;
+        }
+        return lineCount;
+    }
+
+    TMaybe<TString> TParallelFileLineDataReader::GetHeader() {
+        if (DelegateReader) {
+            return DelegateReader->GetHeader();
+        }
+        if (Args.Format.HasHeader) {
+            CB_ENSURE(!HeaderProcessed, "TParallelFileLineDataReader: multiple calls to GetHeader");
+            CB_ENSURE(Header, "TParallelFileLineDataReader: no header in file");
+            HeaderProcessed = true;
+            return Header;
+        }
+
+        return {};
+    }
+
+    void TParallelFileLineDataReader::ProcessChunk(const TFile& file, ui64 dataBegin, ui64 fileSize, TChunk* chunk) {
+        if (!AtomicCas(&chunk->Claimed, 1, 0)) {
+            return; // already processed or being processed in another thread
+        }
+        try {
+            // read one byte before the chunk to know if the chunk begins with a line start
+            const ui64 readBegin = (chunk->Begin > dataBegin) ? (chunk->Begin - 1) : chunk->Begin;
+            TString data;
+            data.resize(chunk->End - readBegin);
+            data.resize(file.Pread(data.begin(), data.size(), readBegin));
+
+            size_t lineBegin = 0;
+            if (readBegin != chunk->Begin) {
+                // the line containing the byte before chunk belongs to the previous chunk
+                lineBegin = data.find('\n');
+                if (lineBegin == TString::npos) {
+                    lineBegin = data.size();
+                } else {
+                    ++lineBegin;
+                }
+            }
+            if ((lineBegin < data.size()) && (data.back() != '\n')) {
+                // the last line in chunk continues after it
+                ReadUntilLineEnd(file, readBegin + data.size(), fileSize, &data);
+            }
+
+            while (lineBegin < data.size()) {
+                size_t lineEnd = data.find('\n', lineBegin);
+                if (lineEnd == TString::npos) {
+                    lineEnd = data.size();
+                }
+                chunk->Lines.push_back(MakeLine(data, lineBegin, lineEnd));
+                lineBegin = lineEnd + 1;
+            }
+            chunk->Ready.SetValue();
+        } catch (...) {
+            chunk->Ready.SetException(std::current_exception());
+        }
+    }
+
+    void TParallelFileLineDataReader::ScheduleChunks() {
+        const bool useExecutor = MaxChunksInFlight > 1;
+        while ((Chunks.size() < MaxChunksInFlight) && (NextChunkBegin < FileSize)) {
+            TChunkPtr chunk = MakeIntrusive<TChunk>();
+            chunk->Begin = NextChunkBegin;
+            chunk->End = Min(NextChunkBegin + ChunkSize, FileSize);
+            NextChunkBegin = chunk->End;
+            Chunks.push_back(chunk);
+
+            if (useExecutor) {
+                // tasks own everything they use, so the reader can be destroyed before they finish
+                Args.LocalExecutor->Exec(
+                    [file = File, dataBegin = DataBegin, fileSize = FileSize, chunk] (int) {
+                        ProcessChunk(file, dataBegin, fileSize, chunk.Get());
+                    },
+                    0,
+                    NPar::TLocalExecutor::HIGH_PRIORITY
+                );
+            }
+        }
+    }
+
+    bool TParallelFileLineDataReader::ReadLine(TString* line) {
+        if (DelegateReader) {
+            return DelegateReader->ReadLine(line);
+        }
+        while (true) {
+            if (Chunks.empty()) {
+                ScheduleChunks();
+                if (Chunks.empty()) {
+                    return false;
+                }
+            }
+            TChunk& chunk = *Chunks.front();
+            if (!FrontChunkReady) {
+                // process the chunk here if no thread has started it yet, so there is no waiting
+                // for executor threads that can be busy with the caller's own tasks
+                ProcessChunk(File, DataBegin, FileSize, &chunk);
+                chunk.Ready.GetFuture().GetValueSync(); // will rethrow if there was an exception during read
+                FrontChunkReady = true;
+            }
+            if (FrontChunkLineIdx < chunk.Lines.size()) {
+                *line = std::move(chunk.Lines[FrontChunkLineIdx]);
+                ++FrontChunkLineIdx;
+                return true;
+            }
+            Chunks.pop_front();
+            FrontChunkReady = false;
+            FrontChunkLineIdx = 0;
+            ScheduleChunks();
+        }
+    }
+
+    namespace {
+        TLineDataReaderFactory::TRegistrator<TParallelFileLineDataReader> DefLineDataReaderReg("");
+        TLineDataReaderFactory::TRegistrator<TParallelFileLineDataReader> DsvLineDataReaderReg("dsv");
+    }
+}
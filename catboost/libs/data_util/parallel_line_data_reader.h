@@ -0,0 +1,75 @@
+#pragma once
+
+#include "line_data_reader.h"
+
+#include <library/threading/future/future.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/deque.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/atomic.h>
+#include <util/system/file.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Reads a regular file by chunks of bytes that are read and split to lines concurrently
+     * on args.LocalExecutor threads (or in the calling thread if there are no additional threads).
+     * Each line belongs to the chunk where it starts, so chunks can be processed independently
+     * and lines are returned in the file order.
+     * Compressed files are read by TryGetCompressedLineDataReader result,
+     * files that do not support positional reads (pipes etc.) are read by "file" scheme reader.
+     */
+    class TParallelFileLineDataReader : public ILineDataReader {
+    public:
+        static constexpr ui64 DEFAULT_CHUNK_SIZE = 4 << 20;
+
+    public:
+        explicit TParallelFileLineDataReader(const TLineDataReaderArgs& args, ui64 chunkSize = DEFAULT_CHUNK_SIZE);
+
+        ui64 GetDataLineCount() override;
+
+        TMaybe<TString> GetHeader() override;
+
+        bool ReadLine(TString* line) override;
+
+    private:
+        struct TChunk : public TThrRefBase {
+            ui64 Begin = 0;
+            ui64 End = 0;
+            TAtomic Claimed = 0;
+            NThreading::TPromise<void> Ready = NThreading::NewPromise();
+            TVector<TString> Lines;
+        };
+
+        using TChunkPtr = TIntrusivePtr<TChunk>;
+
+        static void ProcessChunk(const TFile& file, ui64 dataBegin, ui64 fileSize, TChunk* chunk);
+
+        void ReadHeader();
+        void ScheduleChunks();
+
+    private:
+        TLineDataReaderArgs Args;
+        ui64 ChunkSize;
+        size_t MaxChunksInFlight;
+
+        THolder<ILineDataReader> DelegateReader; // for compressed files and files without positional reads
+
+        TFile File;
+        ui64 FileSize = 0;
+        ui64 DataBegin = 0;
+        TMaybe<TString> Header;
+        bool HeaderProcessed = false;
+
+        ui64 NextChunkBegin = 0;
+        TDeque<TChunkPtr> Chunks; // scheduled chunks in file order
+        bool FrontChunkReady = false;
+        size_t FrontChunkLineIdx = 0;
+    };
+
+}
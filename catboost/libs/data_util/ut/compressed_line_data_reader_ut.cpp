@@ -0,0 +1,130 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/data_util/line_data_reader.h>
+
+#include <library/blockcodecs/codecs.h>
+#include <library/blockcodecs/stream.h>
+#include <library/streams/brotli/brotli.h>
+#include <library/streams/lz/lz.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/stream/zlib.h>
+#include <util/system/tempfile.h>
+
+#include <functional>
+
+
+using namespace NCB;
+
+
+static TVector<TString> ReadAllLines(ILineDataReader* reader) {
+    TVector<TString> lines;
+    TString line;
+    while (reader->ReadLine(&line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static TString GenerateData(TFastRng64* rng) {
+    TString data;
+    const size_t lineCount = rng->Uniform(1000);
+    for (auto lineIdx : xrange(lineCount)) {
+        Y_UNUSED(lineIdx);
+        const size_t lineLength = rng->Uniform(2) ? rng->Uniform(5) : rng->Uniform(300);
+        for (auto i : xrange(lineLength)) {
+            Y_UNUSED(i);
+            data.push_back("ab\t"[rng->Uniform(3)]);
+        }
+        if (rng->Uniform(5) == 0) {
+            data.push_back('\r');
+        }
+        data.push_back('\n');
+    }
+    if (rng->Uniform(2)) {
+        data += "last";
+    }
+    return data;
+}
+
+Y_UNIT_TEST_SUITE(CompressedLineDataReader) {
+    Y_UNIT_TEST(SameLinesAsUncompressed) {
+        using TCompress = std::function<void(const TString&, IOutputStream*)>;
+        const TVector<std::pair<TString, TCompress>> compressions = {
+            {
+                "gz",
+                [] (const TString& data, IOutputStream* out) {
+                    TZLibCompress compressor(out, ZLib::GZip);
+                    compressor.Write(data);
+                    compressor.Finish();
+                }
+            },
+            {
+                "lz4",
+                [] (const TString& data, IOutputStream* out) {
+                    TLz4Compress compressor(out);
+                    compressor.Write(data);
+                    compressor.Finish();
+                }
+            },
+            {
+                "br",
+                [] (const TString& data, IOutputStream* out) {
+                    TBrotliCompress compressor(out);
+                    compressor.Write(data);
+                    compressor.Finish();
+                }
+            },
+            {
+                "zstd",
+                [] (const TString& data, IOutputStream* out) {
+                    // small blocks to have lines split between them
+                    NBlockCodecs::TCodedOutput compressor(out, NBlockCodecs::Codec("zstd_1"), 100);
+                    compressor.Write(data);
+                    compressor.Finish();
+                }
+            }
+        };
+
+        TFastRng64 rng(0);
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (auto iteration : xrange(10)) {
+            Y_UNUSED(iteration);
+            const TString data = GenerateData(&rng);
+
+            TTempFile plainFile("compressed_line_data_reader_ut.tsv");
+            TOFStream(plainFile.Name()).Write(data);
+
+            for (const auto& [extension, compress] : compressions) {
+                TTempFile compressedFile("compressed_line_data_reader_ut.tsv." + extension);
+                {
+                    TOFStream out(compressedFile.Name());
+                    compress(data, &out);
+                }
+
+                for (bool hasHeader : {false, true}) {
+                    if (hasHeader && data.empty()) {
+                        continue;
+                    }
+                    const TDsvFormatOptions format{hasHeader, '\t'};
+                    auto plainReader = GetLineDataReader(TPathWithScheme(plainFile.Name(), "file"), format);
+                    const TMaybe<TString> expectedHeader = plainReader->GetHeader();
+                    const ui64 expectedLineCount = plainReader->GetDataLineCount();
+                    const TVector<TString> expectedLines = ReadAllLines(plainReader.Get());
+
+                    for (auto* executor : {(NPar::TLocalExecutor*)nullptr, &localExecutor}) {
+                        auto reader = GetLineDataReader(TPathWithScheme(compressedFile.Name(), "dsv"), format, executor);
+                        UNIT_ASSERT_VALUES_EQUAL(reader->GetHeader(), expectedHeader);
+                        UNIT_ASSERT_VALUES_EQUAL(reader->GetDataLineCount(), expectedLineCount);
+                        UNIT_ASSERT_VALUES_EQUAL(ReadAllLines(reader.Get()), expectedLines);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/data_util/parallel_line_data_reader.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/system/tempfile.h>
+
+
+using namespace NCB;
+
+
+static TVector<TString> ReadAllLines(ILineDataReader* reader) {
+    TVector<TString> lines;
+    TString line;
+    while (reader->ReadLine(&line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+Y_UNIT_TEST_SUITE(ParallelFileLineDataReader) {
+    Y_UNIT_TEST(SameLinesAsFileReader) {
+        TFastRng64 rng(0);
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (auto iteration : xrange(30)) {
+            Y_UNUSED(iteration);
+            // lines of very different lengths, sometimes with \r and without final line end
+            TString data;
+            const size_t lineCount = rng.Uniform(100);
+            for (auto lineIdx : xrange(lineCount)) {
+                Y_UNUSED(lineIdx);
+                const size_t lineLength = rng.Uniform(2) ? rng.Uniform(5) : rng.Uniform(100);
+                for (auto i : xrange(lineLength)) {
+                    Y_UNUSED(i);
+                    data.push_back("ab\t"[rng.Uniform(3)]);
+                }
+                if (rng.Uniform(5) == 0) {
+                    data.push_back('\r');
+                }
+                data.push_back('\n');
+            }
+            if (rng.Uniform(2)) {
+                data += "last";
+            }
+
+            TTempFile tempFile("parallel_line_data_reader_ut.tsv");
+            TOFStream(tempFile.Name()).Write(data);
+
+            for (bool hasHeader : {false, true}) {
+                TLineDataReaderArgs args{TPathWithScheme(tempFile.Name(), "dsv"), TDsvFormatOptions{hasHeader, '\t'}};
+                THolder<ILineDataReader> fileReader = GetLineDataReader(TPathWithScheme(tempFile.Name(), "file"), args.Format);
+                if (hasHeader && data.empty()) {
+                    continue;
+                }
+                const TMaybe<TString> expectedHeader = fileReader->GetHeader();
+                const ui64 expectedLineCount = fileReader->GetDataLineCount();
+                const TVector<TString> expectedLines = ReadAllLines(fileReader.Get());
+                UNIT_ASSERT_VALUES_EQUAL(expectedLines.size(), expectedLineCount);
+
+                for (auto* executor : {(NPar::TLocalExecutor*)nullptr, &localExecutor}) {
+                    args.LocalExecutor = executor;
+                    for (ui64 chunkSize : {1, 7, 64, 1000, 100000}) {
+                        TParallelFileLineDataReader reader(args, chunkSize);
+                        UNIT_ASSERT_VALUES_EQUAL(reader.GetHeader(), expectedHeader);
+                        UNIT_ASSERT_VALUES_EQUAL(reader.GetDataLineCount(), expectedLineCount);
+                        UNIT_ASSERT_VALUES_EQUAL(ReadAllLines(&reader), expectedLines);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -60,7 +60,8 @@ void TPlainFoldBuilder::DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unu
                 *(trainData->TrainData->ObjectsData->GetQuantizedFeaturesInfo()),
                 localData.Params.CatFeatureParams->OneHotMaxSize.Get()
             ),
-            localData.Params.ObliviousTreeOptions->MaxDepth);
+            localData.Params.ObliviousTreeOptions->MaxDepth,
+            GetTreeLevelCacheSizeLimit(localData.Params));
     }
     localData.Indices.yresize(plainFold.GetLearnSampleCount());
     localData.AllDocCount = trainData->AllDocCount;
@@ -53,6 +53,7 @@ public:
         , DocCount(processedData.GetObjectCount())
         , LocalExecutor(std::move(localExecutor))
     {
+        CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Document importances are not supported for models with non-symmetric trees");
         NJson::TJsonValue paramsJson = ReadTJsonValue(model.ModelInfo.at("params"));
         LossFunction = FromString<ELossFunction>(paramsJson["loss_function"]["type"].GetString());
         LeafEstimationMethod = FromString<ELeavesEstimation>(paramsJson["tree_learner_options"]["leaf_estimation_method"].GetString());
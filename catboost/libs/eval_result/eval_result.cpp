@@ -273,11 +273,10 @@ namespace NCB {
                         )
                     );
                 } else {
-                    const auto arrayData = (*rawObjectsData->GetFloatFeature(it->second.Index))->GetArrayData();
-                    TVector<float> floatFeaturesArray = GetSubset<float>(
-                        *arrayData.GetSrc(),
-                        *arrayData.GetSubsetIndexing()
+                    const auto values = (*rawObjectsData->GetFloatFeature(it->second.Index))->ExtractValues(
+                        &NPar::LocalExecutor()
                     );
+                    TVector<float> floatFeaturesArray((*values).begin(), (*values).end());
 
                     columnPrinter.push_back(
                         MakeHolder<TArrayPrinter<float>>(
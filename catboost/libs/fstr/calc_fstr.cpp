@@ -49,6 +49,7 @@ static TVector<TMxTree> BuildTrees(
     const THashMap<TFeature, int, TFeatureHash>& featureToIdx,
     const TFullModel& model)
 {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Feature importance is not supported for models with non-symmetric trees");
     TVector<TMxTree> trees(model.ObliviousTrees.GetTreeCount());
     auto& binFeatures = model.ObliviousTrees.GetBinFeatures();
     for (int treeIdx = 0; treeIdx < trees.ysize(); ++treeIdx) {
@@ -503,6 +503,7 @@ static TShapPreparedTrees PrepareTrees(
     int logPeriod,
     NPar::TLocalExecutor* localExecutor
 ) {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "SHAP values are not supported for models with non-symmetric trees");
     WarnForComplexCtrs(model.ObliviousTrees);
 
     const size_t treeCount = model.GetTreeCount();
@@ -16,6 +16,7 @@ TVector<TVector<double>> CollectLeavesStatistics(
     const TFullModel& model,
     NPar::TLocalExecutor* localExecutor) {
 
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Leaves statistics are not supported for models with non-symmetric trees");
     const auto* rawObjectsData = dynamic_cast<const TRawObjectsDataProvider*>(dataset.ObjectsData.Get());
     CB_ENSURE(rawObjectsData, "Quantized datasets are not supported yet");
 
@@ -3,6 +3,7 @@
 #include <util/digest/numeric.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/algorithm.h>
+#include <util/system/compiler.h>
 
 namespace NCatboost {
 
@@ -44,6 +45,24 @@ namespace NCatboost {
             return NotFoundIndex;
         }
 
+        /**
+         * Batched GetIndex. Buckets of hashes PrefetchDistance positions ahead are prefetched,
+         * so cache misses of different hashes overlap instead of being paid one after another.
+         */
+        void GetIndexes(TConstArrayRef<ui64> hashes, TArrayRef<ui32> result) const {
+            Y_ASSERT(hashes.size() == result.size());
+            const size_t count = hashes.size();
+            for (size_t i = 0; i < Min(PrefetchDistance, count); ++i) {
+                PrefetchBucket(hashes[i]);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (i + PrefetchDistance < count) {
+                    PrefetchBucket(hashes[i + PrefetchDistance]);
+                }
+                result[i] = GetIndex(hashes[i]);
+            }
+        }
+
         size_t CountNonEmptyBuckets() const {
             return CountIf(Buckets, [](const TBucket& bucket) { return bucket.Hash != TBucket::InvalidHashValue; });
         }
@@ -51,6 +70,16 @@ namespace NCatboost {
         const TConstArrayRef<TBucket> GetBuckets() const {
             return Buckets;
         }
+    private:
+        static constexpr size_t PrefetchDistance = 16;
+
+        void PrefetchBucket(ui64 hash) const {
+            // packed 12 byte bucket may cross cache line boundary
+            const char* bucketPtr = reinterpret_cast<const char*>(Buckets.data() + (hash & HashMask));
+            Y_PREFETCH_READ(bucketPtr, 3);
+            Y_PREFETCH_READ(bucketPtr + sizeof(TBucket) - 1, 3);
+        }
+
     private:
         ui64 HashMask = 0;
         TConstArrayRef<TBucket> Buckets;
@@ -44,6 +44,11 @@ namespace NCB {
             return ArrayRef[idx];
         }
 
+        // nullptr for non-owning holders
+        TIntrusivePtr<IResourceHolder> GetResourceHolder() const {
+            return ResourceHolder;
+        }
+
     private:
         TMaybeOwningArrayHolder(
             TArrayRef<T> arrayRef,
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "array_subset.h"
+#include "exception.h"
+#include "maybe_owning_array_holder.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/system/types.h>
+#include <util/system/yassert.h>
+
+
+namespace NCB {
+
+    /* Array where most of the elements are equal to DefaultValue.
+     * Only indices (in increasing order) and values of other elements are stored.
+     */
+    template <class TValue, class TSize = ui32>
+    class TSparseArray {
+    public:
+        TSparseArray(
+            TSize size,
+            TMaybeOwningConstArrayHolder<TSize> indices,
+            TMaybeOwningConstArrayHolder<TValue> values,
+            TValue defaultValue = TValue()
+        )
+            : Size(size)
+            , Indices(std::move(indices))
+            , Values(std::move(values))
+            , DefaultValue(defaultValue)
+        {
+            CB_ENSURE_INTERNAL(
+                (*Indices).size() == (*Values).size(),
+                "TSparseArray: indices and values have different sizes"
+            );
+            for (auto i : xrange((*Indices).size())) {
+                CB_ENSURE_INTERNAL(Indices[i] < Size, "TSparseArray: index " << Indices[i] << " >= size " << Size);
+                CB_ENSURE_INTERNAL(
+                    !i || (Indices[i - 1] < Indices[i]),
+                    "TSparseArray: indices are not strictly increasing"
+                );
+            }
+        }
+
+        // elements equal to defaultValue are not stored
+        static TSparseArray FromDense(TConstArrayRef<TValue> values, TValue defaultValue = TValue()) {
+            TVector<TSize> nonDefaultIndices;
+            TVector<TValue> nonDefaultValues;
+            for (auto i : xrange(values.size())) {
+                if (values[i] != defaultValue) {
+                    nonDefaultIndices.push_back((TSize)i);
+                    nonDefaultValues.push_back(values[i]);
+                }
+            }
+            return TSparseArray(
+                (TSize)values.size(),
+                TMaybeOwningConstArrayHolder<TSize>::CreateOwning(std::move(nonDefaultIndices)),
+                TMaybeOwningConstArrayHolder<TValue>::CreateOwning(std::move(nonDefaultValues)),
+                defaultValue
+            );
+        }
+
+        bool operator==(const TSparseArray& rhs) const {
+            return (Size == rhs.Size) && (DefaultValue == rhs.DefaultValue) &&
+                (*Indices == *rhs.Indices) && (*Values == *rhs.Values);
+        }
+
+        TSize GetSize() const {
+            return Size;
+        }
+
+        TSize GetNonDefaultSize() const {
+            return (TSize)(*Indices).size();
+        }
+
+        const TValue& GetDefaultValue() const {
+            return DefaultValue;
+        }
+
+        TConstArrayRef<TSize> GetIndices() const {
+            return *Indices;
+        }
+
+        TConstArrayRef<TValue> GetValues() const {
+            return *Values;
+        }
+
+        // f is called as f(index, value) in increasing order of indices
+        template <class F>
+        void ForEachNonDefault(F&& f) const {
+            for (auto i : xrange((*Indices).size())) {
+                f(Indices[i], Values[i]);
+            }
+        }
+
+        // dense representation
+        template <class TDst = TValue>
+        TVector<TDst> ExtractValues() const {
+            TVector<TDst> result(Size, DefaultValue);
+            ForEachNonDefault([&result] (TSize idx, TValue value) { result[idx] = value; });
+            return result;
+        }
+
+        /* result[i] = (*this)[src index of i in subsetIndexing]
+         * touches only non-default elements for full and ranges subsets,
+         * for indexed subsets each element of the subset is looked up by binary search
+         */
+        TSparseArray GetSubset(const TArraySubsetIndexing<TSize>& subsetIndexing) const {
+            using TVariantType = typename TArraySubsetIndexing<TSize>::TBase;
+
+            const TConstArrayRef<TSize> indices = *Indices;
+
+            TVector<TSize> subsetIndices;
+            TVector<TValue> subsetValues;
+
+            switch (subsetIndexing.index()) {
+                case TVariantType::template TagOf<TFullSubset<TSize>>():
+                    Y_ASSERT(subsetIndexing.Size() == Size);
+                    return *this;
+                case TVariantType::template TagOf<TRangesSubset<TSize>>():
+                    for (const auto& block : subsetIndexing.template Get<TRangesSubset<TSize>>().Blocks) {
+                        auto i = LowerBound(indices.begin(), indices.end(), block.SrcBegin) - indices.begin();
+                        for (; (i < (ptrdiff_t)indices.size()) && (indices[i] < block.SrcEnd); ++i) {
+                            subsetIndices.push_back(block.DstBegin + (indices[i] - block.SrcBegin));
+                            subsetValues.push_back(Values[i]);
+                        }
+                    }
+                    break;
+                case TVariantType::template TagOf<TIndexedSubset<TSize>>():
+                    if (!indices.empty()) {
+                        subsetIndexing.ForEach(
+                            [&] (TSize idx, TSize srcIdx) {
+                                auto it = LowerBound(indices.begin(), indices.end(), srcIdx);
+                                if ((it != indices.end()) && (*it == srcIdx)) {
+                                    subsetIndices.push_back(idx);
+                                    subsetValues.push_back(Values[it - indices.begin()]);
+                                }
+                            }
+                        );
+                    }
+                    break;
+            }
+
+            return TSparseArray(
+                subsetIndexing.Size(),
+                TMaybeOwningConstArrayHolder<TSize>::CreateOwning(std::move(subsetIndices)),
+                TMaybeOwningConstArrayHolder<TValue>::CreateOwning(std::move(subsetValues)),
+                DefaultValue
+            );
+        }
+
+    private:
+        TSize Size;
+        TMaybeOwningConstArrayHolder<TSize> Indices;
+        TMaybeOwningConstArrayHolder<TValue> Values;
+        TValue DefaultValue;
+    };
+
+}
@@ -0,0 +1,45 @@
+#include <catboost/libs/helpers/dense_hash_view.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCatboost;
+
+
+Y_UNIT_TEST_SUITE(TDenseIndexHashView) {
+    Y_UNIT_TEST(TestGetIndexes) {
+        TFastRng64 rng(0);
+        const size_t uniqueCount = 1000;
+        TVector<TBucket> buckets(TDenseIndexHashBuilder::GetProperBucketsCount(uniqueCount));
+        TDenseIndexHashBuilder builder(buckets);
+        TVector<ui64> hashes;
+        for (auto i : xrange(uniqueCount)) {
+            Y_UNUSED(i);
+            hashes.push_back(rng.GenRand());
+            builder.AddIndex(hashes.back());
+        }
+        for (auto i : xrange(uniqueCount)) {
+            Y_UNUSED(i);
+            hashes.push_back(rng.GenRand());
+        }
+
+        const TDenseIndexHashView view(buckets);
+        for (size_t count : {0, 1, 15, 17, 2000}) {
+            const auto batch = MakeArrayRef(hashes).Slice(hashes.size() - count);
+            TVector<ui32> indexes(count);
+            view.GetIndexes(batch, indexes);
+            for (auto i : xrange(count)) {
+                UNIT_ASSERT_VALUES_EQUAL(indexes[i], view.GetIndex(batch[i]));
+            }
+        }
+        TVector<ui32> indexes(uniqueCount);
+        view.GetIndexes(MakeArrayRef(hashes).Slice(0, uniqueCount), indexes);
+        for (auto i : xrange(uniqueCount)) {
+            UNIT_ASSERT_VALUES_EQUAL(indexes[i], i);
+        }
+    }
+}
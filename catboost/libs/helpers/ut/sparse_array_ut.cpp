@@ -0,0 +1,71 @@
+#include <catboost/libs/helpers/sparse_array.h>
+
+#include <util/generic/vector.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TSparseArray) {
+    Y_UNIT_TEST(TestFromDense) {
+        TVector<float> dense = {0.0f, 1.0f, 0.0f, 0.0f, 2.5f, 0.0f};
+
+        auto sparseArray = TSparseArray<float, ui32>::FromDense(dense);
+
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray.GetSize(), 6);
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray.GetNonDefaultSize(), 2);
+        UNIT_ASSERT_EQUAL(sparseArray.GetIndices(), TConstArrayRef<ui32>({1, 4}));
+        UNIT_ASSERT_EQUAL(sparseArray.GetValues(), TConstArrayRef<float>({1.0f, 2.5f}));
+        UNIT_ASSERT_EQUAL(sparseArray.ExtractValues(), dense);
+    }
+
+    Y_UNIT_TEST(TestBadIndices) {
+        UNIT_ASSERT_EXCEPTION(
+            ([]{
+                TSparseArray<ui8, ui32>(
+                    3,
+                    TMaybeOwningConstArrayHolder<ui32>::CreateOwning(TVector<ui32>{2, 1}),
+                    TMaybeOwningConstArrayHolder<ui8>::CreateOwning(TVector<ui8>{1, 1})
+                );
+            }()),
+            TCatBoostException
+        );
+        UNIT_ASSERT_EXCEPTION(
+            ([]{
+                TSparseArray<ui8, ui32>(
+                    3,
+                    TMaybeOwningConstArrayHolder<ui32>::CreateOwning(TVector<ui32>{1, 3}),
+                    TMaybeOwningConstArrayHolder<ui8>::CreateOwning(TVector<ui8>{1, 1})
+                );
+            }()),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(TestGetSubset) {
+        TVector<ui8> dense = {0, 3, 0, 1, 0, 0, 2, 7};
+        auto sparseArray = TSparseArray<ui8, ui32>::FromDense(dense, /*defaultValue*/ 0);
+
+        TVector<TArraySubsetIndexing<ui32>> subsets;
+        subsets.emplace_back(TFullSubset<ui32>(dense.size()));
+        {
+            TVector<TSubsetBlock<ui32>> blocks = {
+                TSubsetBlock<ui32>({5, 8}, 0),
+                TSubsetBlock<ui32>({0, 2}, 3)
+            };
+            subsets.emplace_back(TRangesSubset<ui32>(5, std::move(blocks)));
+        }
+        subsets.emplace_back(TIndexedSubset<ui32>{7, 2, 3, 3, 0, 6});
+
+        for (const auto& subset : subsets) {
+            TVector<ui8> expectedValues = GetSubset<ui8>(dense, subset);
+            auto subsetSparseArray = sparseArray.GetSubset(subset);
+
+            UNIT_ASSERT_VALUES_EQUAL(subsetSparseArray.GetSize(), expectedValues.size());
+            UNIT_ASSERT_EQUAL(subsetSparseArray.ExtractValues(), expectedValues);
+            UNIT_ASSERT((subsetSparseArray == TSparseArray<ui8, ui32>::FromDense(expectedValues, 0)));
+        }
+    }
+}
@@ -0,0 +1,300 @@
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/model/evaluation_context.h>
+#include <catboost/libs/model/formula_evaluator.h>
+#include <catboost/libs/model/hash.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/model/static_ctr_provider.h>
+
+#include <library/getopt/small/last_getopt.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/format.h>
+#include <util/stream/output.h>
+#include <util/system/hp_timer.h>
+
+/**
+ * Microbenchmarks of model evaluation on synthetic models.
+ * For each combination of tree depth, tree count, ctr count and batch size a model is generated
+ * with fixed seed, so results of different builds are comparable.
+ * Each ctr is built on its own categorical feature, categorical features are used only via ctrs.
+ */
+
+struct TBenchmarkParams {
+    int FloatFeatureCount = 0;
+    int BordersPerFeature = 0;
+    int CtrValueCount = 0;
+    double MinTime = 0;
+    ui64 Seed = 0;
+};
+
+struct TModelParams {
+    int Depth = 0;
+    int TreeCount = 0;
+    int CtrCount = 0;
+};
+
+struct TBenchmarkData {
+    //! Flat documents: float features followed by categorical feature hashes casted to float
+    TVector<TVector<float>> FlatFeatures;
+    TVector<TVector<float>> FloatFeatures;
+    TVector<TVector<int>> CatFeatures;
+};
+
+static TModelCtr MakeBordersCtr(int catFeatureIdx) {
+    TModelCtr ctr;
+    ctr.Base.Projection.CatFeatures = {catFeatureIdx};
+    ctr.Base.CtrType = ECtrType::Borders;
+    ctr.PriorNum = 0.5f;
+    ctr.PriorDenom = 1.0f;
+    return ctr;
+}
+
+// Known values of categorical feature are [0, ctrValueCount), data has twice more values to have ctr table misses
+static TCtrValueTable MakeCtrValueTable(const TModelCtr& ctr, int ctrValueCount, TFastRng64* rng) {
+    TCtrValueTable table;
+    table.ModelCtrBase = ctr.Base;
+    table.TargetClassesCount = 2;
+    auto hashBuilder = table.GetIndexHashBuilder(ctrValueCount);
+    auto counters = table.AllocateBlobAndGetArrayRef<int>(ctrValueCount * 2);
+    for (auto value : xrange(ctrValueCount)) {
+        const auto index = hashBuilder.AddIndex(CalcHash(0, (ui64)value));
+        counters[index * 2] = rng->Uniform(100);
+        counters[index * 2 + 1] = rng->Uniform(100);
+    }
+    return table;
+}
+
+static TFullModel MakeModel(const TBenchmarkParams& params, const TModelParams& modelParams, TFastRng64* rng) {
+    TVector<TFloatFeature> floatFeatures;
+    for (auto featureIdx : xrange(params.FloatFeatureCount)) {
+        floatFeatures.emplace_back(false, featureIdx, featureIdx, TVector<float>());
+    }
+    TVector<TCatFeature> catFeatures;
+    TVector<TModelCtr> ctrs;
+    for (auto featureIdx : xrange(modelParams.CtrCount)) {
+        auto& catFeature = catFeatures.emplace_back();
+        catFeature.FeatureIndex = featureIdx;
+        catFeature.FlatFeatureIndex = params.FloatFeatureCount + featureIdx;
+        ctrs.push_back(MakeBordersCtr(featureIdx));
+    }
+    TObliviousTreeBuilder builder(floatFeatures, catFeatures, 1);
+    for (auto treeIdx : xrange(modelParams.TreeCount)) {
+        Y_UNUSED(treeIdx);
+        TVector<TModelSplit> splits;
+        for (auto depthIdx : xrange(modelParams.Depth)) {
+            Y_UNUSED(depthIdx);
+            const auto splitIdx = rng->Uniform(params.FloatFeatureCount + modelParams.CtrCount);
+            if (splitIdx < (ui64)params.FloatFeatureCount) {
+                const float border = (1 + rng->Uniform(params.BordersPerFeature)) / (params.BordersPerFeature + 1.0f);
+                splits.emplace_back(TFloatSplit(splitIdx, border));
+            } else {
+                const float border = (1 + rng->Uniform(15)) / 16.0f;
+                splits.emplace_back(TModelCtrSplit(ctrs[splitIdx - params.FloatFeatureCount], border));
+            }
+        }
+        TVector<double> leafValues(1 << modelParams.Depth);
+        for (auto& value : leafValues) {
+            value = rng->GenRandReal1() - 0.5;
+        }
+        builder.AddTree(splits, leafValues, {});
+    }
+    TFullModel model;
+    model.ObliviousTrees = builder.Build();
+    if (!model.ObliviousTrees.GetUsedModelCtrs().empty()) {
+        model.CtrProvider = new TStaticCtrProvider;
+        for (const auto& ctr : model.ObliviousTrees.GetUsedModelCtrs()) {
+            model.CtrProvider->AddCtrCalcerData(MakeCtrValueTable(ctr, params.CtrValueCount, rng));
+        }
+    }
+    model.UpdateDynamicData();
+    return model;
+}
+
+static TBenchmarkData MakeData(const TBenchmarkParams& params, int ctrCount, size_t docCount, TFastRng64* rng) {
+    TBenchmarkData data;
+    data.FlatFeatures.resize(docCount);
+    data.FloatFeatures.resize(docCount);
+    data.CatFeatures.resize(docCount);
+    for (auto docId : xrange(docCount)) {
+        for (auto featureIdx : xrange(params.FloatFeatureCount)) {
+            Y_UNUSED(featureIdx);
+            data.FloatFeatures[docId].push_back(rng->GenRandReal1());
+        }
+        for (auto featureIdx : xrange(ctrCount)) {
+            Y_UNUSED(featureIdx);
+            data.CatFeatures[docId].push_back(rng->Uniform(params.CtrValueCount * 2));
+        }
+        data.FlatFeatures[docId] = data.FloatFeatures[docId];
+        for (int hash : data.CatFeatures[docId]) {
+            data.FlatFeatures[docId].push_back(ConvertCatFeatureHashToFloat(hash));
+        }
+    }
+    return data;
+}
+
+// Run func until minTime passes, return average seconds per call
+template <class TFunc>
+static double MeasureSecondsPerCall(double minTime, TFunc&& func) {
+    func(); // warmup
+    size_t callCount = 0;
+    THPTimer timer;
+    double passed = 0;
+    do {
+        func();
+        ++callCount;
+        passed = timer.Passed();
+    } while (passed < minTime);
+    return passed / callCount;
+}
+
+static void ReportResult(
+    TStringBuf benchmarkName,
+    const TModelParams& modelParams,
+    size_t batchSize,
+    size_t treeCount,
+    double secondsPerBatch
+) {
+    const double docsPerSecond = batchSize / secondsPerBatch;
+    Cout << benchmarkName
+        << '\t' << modelParams.Depth
+        << '\t' << modelParams.TreeCount
+        << '\t' << modelParams.CtrCount
+        << '\t' << batchSize
+        << '\t' << Prec(docsPerSecond, PREC_POINT_DIGITS, 1)
+        << '\t' << Prec(1e9 / docsPerSecond, PREC_POINT_DIGITS, 2);
+    if (treeCount) {
+        Cout << '\t' << Prec(1e9 / docsPerSecond / treeCount, PREC_POINT_DIGITS, 3);
+    } else {
+        Cout << "\t-";
+    }
+    Cout << Endl;
+}
+
+static void RunModelBenchmarks(const TBenchmarkParams& params, const TModelParams& modelParams, size_t batchSize) {
+    TFastRng64 rng(params.Seed);
+    const TFullModel model = MakeModel(params, modelParams, &rng);
+    const TBenchmarkData data = MakeData(params, modelParams.CtrCount, batchSize, &rng);
+    const size_t treeCount = model.GetTreeCount();
+    TVector<double> results(batchSize);
+
+    TVector<TConstArrayRef<float>> flatFeatures(data.FlatFeatures.begin(), data.FlatFeatures.end());
+    TVector<TConstArrayRef<float>> floatFeatures(data.FloatFeatures.begin(), data.FloatFeatures.end());
+    TVector<TConstArrayRef<int>> catFeatures(data.CatFeatures.begin(), data.CatFeatures.end());
+
+    ReportResult("CalcFlat", modelParams, batchSize, treeCount, MeasureSecondsPerCall(params.MinTime, [&] {
+        model.CalcFlat(flatFeatures, results);
+    }));
+    ReportResult("CalcFlatSingle", modelParams, batchSize, treeCount, MeasureSecondsPerCall(params.MinTime, [&] {
+        for (auto docId : xrange(batchSize)) {
+            model.CalcFlatSingle(flatFeatures[docId], MakeArrayRef(&results[docId], 1));
+        }
+    }));
+    if (modelParams.CtrCount) {
+        ReportResult("CalcHashedCat", modelParams, batchSize, treeCount, MeasureSecondsPerCall(params.MinTime, [&] {
+            model.Calc(floatFeatures, catFeatures, results);
+        }));
+    }
+
+    TModelEvaluationContext context(model);
+    const auto floatAccessor = [&](const TFloatFeature& floatFeature, size_t index) -> float {
+        return flatFeatures[index][floatFeature.FlatFeatureIndex];
+    };
+    const auto catAccessor = [&](const TCatFeature& catFeature, size_t index) -> int {
+        return catFeatures[index][catFeature.FeatureIndex];
+    };
+    const auto binarizeBlocks = [&] {
+        for (size_t blockStart = 0; blockStart < batchSize; blockStart += FORMULA_EVALUATION_BLOCK_SIZE) {
+            const auto blockEnd = Min(batchSize, blockStart + FORMULA_EVALUATION_BLOCK_SIZE);
+            BinarizeFeatures(
+                model,
+                floatAccessor,
+                catAccessor,
+                blockStart,
+                blockEnd,
+                context.BinFeatures,
+                context.TransposedHash,
+                context.Ctrs);
+        }
+    };
+    ReportResult("BinarizeFeatures", modelParams, batchSize, 0, MeasureSecondsPerCall(params.MinTime, binarizeBlocks));
+
+    if (modelParams.CtrCount) {
+        // ctr calculation on already binarized blocks, only the last block is recalculated to keep inputs in cache
+        const auto blockSize = Min<size_t>(batchSize, FORMULA_EVALUATION_BLOCK_SIZE);
+        BinarizeFeatures(model, floatAccessor, catAccessor, 0, blockSize, context.BinFeatures, context.TransposedHash, context.Ctrs);
+        const double secondsPerBlock = MeasureSecondsPerCall(params.MinTime, [&] {
+            model.CtrProvider->CalcCtrs(
+                model.ObliviousTrees.GetUsedModelCtrs(),
+                context.BinFeatures,
+                context.TransposedHash,
+                blockSize,
+                context.Ctrs);
+        });
+        ReportResult("CalcCtrs", modelParams, blockSize, 0, secondsPerBlock);
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace NLastGetopt;
+    TBenchmarkParams params;
+    TVector<int> depths;
+    TVector<int> treeCounts;
+    TVector<int> ctrCounts;
+    TVector<size_t> batchSizes;
+    TOpts opts = NLastGetopt::TOpts::Default();
+    opts.AddLongOption("depth").RequiredArgument("LIST")
+        .Help("Comma separated tree depths")
+        .DefaultValue("4,6,8")
+        .SplitHandler(&depths, ',');
+    opts.AddLongOption("trees").RequiredArgument("LIST")
+        .Help("Comma separated tree counts")
+        .DefaultValue("100,1000")
+        .SplitHandler(&treeCounts, ',');
+    opts.AddLongOption("ctrs").RequiredArgument("LIST")
+        .Help("Comma separated ctr counts, each ctr uses its own categorical feature")
+        .DefaultValue("0,8")
+        .SplitHandler(&ctrCounts, ',');
+    opts.AddLongOption("batch").RequiredArgument("LIST")
+        .Help("Comma separated batch sizes")
+        .DefaultValue("1,128,10000")
+        .SplitHandler(&batchSizes, ',');
+    opts.AddLongOption("float-features").RequiredArgument("INT")
+        .DefaultValue(50)
+        .StoreResult(&params.FloatFeatureCount);
+    opts.AddLongOption("borders").RequiredArgument("INT")
+        .Help("Borders per float feature")
+        .DefaultValue(32)
+        .StoreResult(&params.BordersPerFeature);
+    opts.AddLongOption("ctr-values").RequiredArgument("INT")
+        .Help("Categorical feature values known by each ctr table")
+        .DefaultValue(10000)
+        .StoreResult(&params.CtrValueCount);
+    opts.AddLongOption("min-time").RequiredArgument("SECONDS")
+        .Help("Minimal measurement time of each benchmark")
+        .DefaultValue(0.5)
+        .StoreResult(&params.MinTime);
+    opts.AddLongOption("seed").RequiredArgument("INT")
+        .DefaultValue(0)
+        .StoreResult(&params.Seed);
+    opts.SetFreeArgsNum(0);
+    TOptsParseResult args(&opts, argc, argv);
+
+    CB_ENSURE(params.FloatFeatureCount > 0, "At least one float feature is required");
+    CB_ENSURE(params.BordersPerFeature > 0 && params.BordersPerFeature <= 254, "Borders count should be in [1, 254]");
+    CB_ENSURE(params.CtrValueCount > 0, "Ctr values count should be positive");
+    Cout << "benchmark\tdepth\ttrees\tctrs\tbatch\tdocs/sec\tns/doc\tns/tree" << Endl;
+    for (int depth : depths) {
+        CB_ENSURE(depth >= 0 && depth <= 16, "Tree depth should be in [0, 16]");
+        for (int treeCount : treeCounts) {
+            for (int ctrCount : ctrCounts) {
+                for (size_t batchSize : batchSizes) {
+                    CB_ENSURE(batchSize > 0, "Batch size should be positive");
+                    RunModelBenchmarks(params, TModelParams{depth, treeCount, ctrCount}, batchSize);
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,468 @@
+#include "compiled_model.h"
+
+#include "formula_evaluator.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/ymath.h>
+#include <util/stream/labeled.h>
+
+#include <cmath>
+#include <type_traits>
+
+
+TCompiledModel::TCompiledModel(const TFullModel& model, ECompiledLeafType leafType)
+    : Model(model)
+    , LeafType(leafType)
+    , NeedXorMask(!model.ObliviousTrees.OneHotFeatures.empty())
+{
+    Compile();
+}
+
+TCompiledModel::TCompiledModel(TFullModel&& model, ECompiledLeafType leafType)
+    : OwnedModel(MakeHolder<TFullModel>(std::move(model)))
+    , Model(*OwnedModel)
+    , LeafType(leafType)
+    , NeedXorMask(!OwnedModel->ObliviousTrees.OneHotFeatures.empty())
+{
+    Compile();
+    if (leafType != ECompiledLeafType::Double) {
+        TVector<double>().swap(OwnedModel->ObliviousTrees.LeafValues);
+    }
+}
+
+static void QuantizeLeafValues(
+    TConstArrayRef<double> leafValues,
+    TVector<i16>* quantizedLeafValues,
+    double* scale,
+    double* maxError
+) {
+    constexpr double maxQuantizedValue = Max<i16>();
+    double maxAbsValue = 0;
+    for (double value : leafValues) {
+        maxAbsValue = Max(maxAbsValue, Abs(value));
+    }
+    *scale = maxAbsValue > 0 ? maxAbsValue / maxQuantizedValue : 1.0;
+    *maxError = 0;
+    for (double value : leafValues) {
+        const i16 quantizedValue = static_cast<i16>(ClampVal(std::round(value / *scale), -maxQuantizedValue, maxQuantizedValue));
+        quantizedLeafValues->push_back(quantizedValue);
+        *maxError = Max(*maxError, Abs(value - quantizedValue * *scale));
+    }
+}
+
+void TCompiledModel::Compile() {
+    const auto& trees = Model.ObliviousTrees;
+    CB_ENSURE(trees.IsOblivious(), "Compilation of models with non-symmetric trees is not supported");
+    const auto& repackedBins = trees.GetRepackedBins();
+    const auto& firstLeafOffsets = trees.GetFirstLeafOffsets();
+    TVector<TVector<size_t>> treesByDepth(COMPILED_MODEL_MAX_TREE_DEPTH + 1);
+    for (size_t treeId = 0; treeId < trees.TreeSizes.size(); ++treeId) {
+        const int depth = trees.TreeSizes[treeId];
+        CB_ENSURE(
+            depth <= COMPILED_MODEL_MAX_TREE_DEPTH,
+            "Compiled model supports trees with depth up to " << COMPILED_MODEL_MAX_TREE_DEPTH << ", got " << depth);
+        treesByDepth[depth].push_back(treeId);
+    }
+    MaxErrorBound = 0;
+    for (int depth = 0; depth <= COMPILED_MODEL_MAX_TREE_DEPTH; ++depth) {
+        const auto& treeIds = treesByDepth[depth];
+        if (treeIds.empty()) {
+            continue;
+        }
+        auto& group = DepthGroups.emplace_back();
+        group.Depth = depth;
+        group.TreeCount = treeIds.size();
+        const size_t leafCount = (size_t(1) << depth) * trees.ApproxDimension;
+        group.Splits.reserve(treeIds.size() * depth);
+        switch (LeafType) {
+            case ECompiledLeafType::Double:
+                group.DoubleLeafValues.reserve(treeIds.size() * leafCount);
+                break;
+            case ECompiledLeafType::Float:
+                group.FloatLeafValues.reserve(treeIds.size() * leafCount);
+                break;
+            case ECompiledLeafType::Int16:
+                group.Int16LeafValues.reserve(treeIds.size() * leafCount);
+                group.LeafScales.reserve(treeIds.size());
+                break;
+        }
+        for (size_t treeId : treeIds) {
+            const auto splitsBegin = repackedBins.begin() + trees.TreeStartOffsets[treeId];
+            group.Splits.insert(group.Splits.end(), splitsBegin, splitsBegin + depth);
+            const TConstArrayRef<double> treeLeafValues(trees.LeafValues.data() + firstLeafOffsets[treeId], leafCount);
+            double treeMaxError = 0;
+            switch (LeafType) {
+                case ECompiledLeafType::Double:
+                    group.DoubleLeafValues.insert(group.DoubleLeafValues.end(), treeLeafValues.begin(), treeLeafValues.end());
+                    break;
+                case ECompiledLeafType::Float:
+                    for (double value : treeLeafValues) {
+                        group.FloatLeafValues.push_back(static_cast<float>(value));
+                        treeMaxError = Max(treeMaxError, Abs(value - group.FloatLeafValues.back()));
+                    }
+                    break;
+                case ECompiledLeafType::Int16:
+                    QuantizeLeafValues(treeLeafValues, &group.Int16LeafValues, &group.LeafScales.emplace_back(), &treeMaxError);
+                    break;
+            }
+            MaxErrorBound += treeMaxError;
+        }
+    }
+}
+
+size_t TCompiledModel::GetLeafValuesByteSize() const {
+    size_t byteSize = 0;
+    for (const auto& group : DepthGroups) {
+        byteSize += group.DoubleLeafValues.size() * sizeof(double);
+        byteSize += group.FloatLeafValues.size() * sizeof(float);
+        byteSize += group.Int16LeafValues.size() * sizeof(i16);
+        byteSize += group.LeafScales.size() * sizeof(double);
+    }
+    return byteSize;
+}
+
+template <int Depth, bool NeedXorMask, typename TIndex>
+static Y_FORCE_INLINE void CalcTreeIndexes(
+    const ui8* __restrict binFeatures,
+    size_t docCount,
+    const TRepackedBin* __restrict splits,
+    TIndex* __restrict indexes
+) {
+    if (Depth == 0) {
+        std::fill(indexes, indexes + docCount, 0);
+        return;
+    }
+    for (int depth = 0; depth < Depth; ++depth) {
+        const ui8* __restrict binFeaturePtr = binFeatures + splits[depth].FeatureIndex * docCount;
+        const ui8 borderVal = splits[depth].SplitIdx;
+        const ui8 xorMask = splits[depth].XorMask;
+        if (depth == 0) {
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                const ui8 bin = NeedXorMask ? binFeaturePtr[docId] ^ xorMask : binFeaturePtr[docId];
+                indexes[docId] = (TIndex)(bin >= borderVal);
+            }
+        } else {
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                const ui8 bin = NeedXorMask ? binFeaturePtr[docId] ^ xorMask : binFeaturePtr[docId];
+                indexes[docId] |= (TIndex)((bin >= borderVal) << depth);
+            }
+        }
+    }
+}
+
+template <int Depth, bool NeedXorMask, bool IsSingleClassModel, typename TLeaf>
+static void CalcDepthGroup(
+    const TCompiledModel::TDepthGroup& group,
+    const TLeaf* __restrict leafValues,
+    int approxDimension,
+    const ui8* __restrict binFeatures,
+    size_t docCount,
+    ui32* __restrict indexesScratch,
+    double* __restrict results
+) {
+    // leaf indexes of trees up to depth 8 fit in bytes, this quarters index traffic
+    using TIndex = std::conditional_t<(Depth <= 8), ui8, ui32>;
+    TIndex* __restrict indexes = reinterpret_cast<TIndex*>(indexesScratch);
+    // quantized leaf values are scaled per tree
+    constexpr bool isQuantized = std::is_same<TLeaf, i16>::value;
+    const TRepackedBin* splits = group.Splits.data();
+    const size_t treeLeafCount = (size_t(1) << Depth) * approxDimension;
+    for (size_t treeId = 0; treeId < group.TreeCount; ++treeId) {
+        CalcTreeIndexes<Depth, NeedXorMask>(binFeatures, docCount, splits, indexes);
+        const double scale = isQuantized ? group.LeafScales[treeId] : 1.0;
+        if (IsSingleClassModel) {
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                if (isQuantized) {
+                    results[docId] += scale * leafValues[indexes[docId]];
+                } else {
+                    results[docId] += leafValues[indexes[docId]];
+                }
+            }
+        } else {
+            double* __restrict writePtr = results;
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                const TLeaf* leafValuePtr = leafValues + indexes[docId] * approxDimension;
+                for (int classId = 0; classId < approxDimension; ++classId) {
+                    if (isQuantized) {
+                        writePtr[classId] += scale * leafValuePtr[classId];
+                    } else {
+                        writePtr[classId] += leafValuePtr[classId];
+                    }
+                }
+                writePtr += approxDimension;
+            }
+        }
+        splits += Depth;
+        leafValues += treeLeafCount;
+    }
+}
+
+template <bool NeedXorMask, bool IsSingleClassModel, typename TLeaf>
+static void CalcTreesImpl(
+    const TVector<TCompiledModel::TDepthGroup>& depthGroups,
+    int approxDimension,
+    const ui8* binFeatures,
+    size_t docCount,
+    ui32* indexesScratch,
+    double* results
+) {
+    for (const auto& group : depthGroups) {
+        const TLeaf* leafValues = nullptr;
+        if constexpr (std::is_same<TLeaf, double>::value) {
+            leafValues = group.DoubleLeafValues.data();
+        } else if constexpr (std::is_same<TLeaf, float>::value) {
+            leafValues = group.FloatLeafValues.data();
+        } else {
+            leafValues = group.Int16LeafValues.data();
+        }
+#define CALC_DEPTH_GROUP(depth) \
+        case depth: \
+            CalcDepthGroup<depth, NeedXorMask, IsSingleClassModel>(group, leafValues, approxDimension, binFeatures, docCount, indexesScratch, results); \
+            break;
+
+        switch (group.Depth) {
+            CALC_DEPTH_GROUP(0)
+            CALC_DEPTH_GROUP(1)
+            CALC_DEPTH_GROUP(2)
+            CALC_DEPTH_GROUP(3)
+            CALC_DEPTH_GROUP(4)
+            CALC_DEPTH_GROUP(5)
+            CALC_DEPTH_GROUP(6)
+            CALC_DEPTH_GROUP(7)
+            CALC_DEPTH_GROUP(8)
+            CALC_DEPTH_GROUP(9)
+            CALC_DEPTH_GROUP(10)
+            CALC_DEPTH_GROUP(11)
+            CALC_DEPTH_GROUP(12)
+            CALC_DEPTH_GROUP(13)
+            CALC_DEPTH_GROUP(14)
+            CALC_DEPTH_GROUP(15)
+            CALC_DEPTH_GROUP(16)
+            default:
+                Y_UNREACHABLE();
+        }
+#undef CALC_DEPTH_GROUP
+    }
+}
+
+template <typename TLeaf>
+static void CalcTreesWithLeafType(
+    const TVector<TCompiledModel::TDepthGroup>& depthGroups,
+    bool needXorMask,
+    int approxDimension,
+    const ui8* binFeatures,
+    size_t docCount,
+    ui32* indexesScratch,
+    double* results
+) {
+    if (approxDimension == 1) {
+        if (needXorMask) {
+            CalcTreesImpl<true, true, TLeaf>(depthGroups, approxDimension, binFeatures, docCount, indexesScratch, results);
+        } else {
+            CalcTreesImpl<false, true, TLeaf>(depthGroups, approxDimension, binFeatures, docCount, indexesScratch, results);
+        }
+    } else {
+        if (needXorMask) {
+            CalcTreesImpl<true, false, TLeaf>(depthGroups, approxDimension, binFeatures, docCount, indexesScratch, results);
+        } else {
+            CalcTreesImpl<false, false, TLeaf>(depthGroups, approxDimension, binFeatures, docCount, indexesScratch, results);
+        }
+    }
+}
+
+void TCompiledModel::CalcTrees(
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui32* indexesScratch,
+    double* results
+) const {
+    const int approxDimension = Model.ObliviousTrees.ApproxDimension;
+    switch (LeafType) {
+        case ECompiledLeafType::Double:
+            CalcTreesWithLeafType<double>(DepthGroups, NeedXorMask, approxDimension, binFeatures, docCountInBlock, indexesScratch, results);
+            break;
+        case ECompiledLeafType::Float:
+            CalcTreesWithLeafType<float>(DepthGroups, NeedXorMask, approxDimension, binFeatures, docCountInBlock, indexesScratch, results);
+            break;
+        case ECompiledLeafType::Int16:
+            CalcTreesWithLeafType<i16>(DepthGroups, NeedXorMask, approxDimension, binFeatures, docCountInBlock, indexesScratch, results);
+            break;
+    }
+}
+
+template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+static void CalcCompiledGeneric(
+    const TCompiledModel& compiledModel,
+    TFloatFeatureAccessor floatFeatureAccessor,
+    TCatFeatureAccessor catFeaturesAccessor,
+    size_t docCount,
+    TArrayRef<double> results,
+    TModelEvaluationContext& context
+) {
+    const auto& model = compiledModel.GetModel();
+    const size_t approxDimension = model.ObliviousTrees.ApproxDimension;
+    CB_ENSURE(
+        results.size() == docCount * approxDimension,
+        "`results` size is insufficient: "
+        LabeledOutput(results.size(), docCount * approxDimension));
+    std::fill(results.begin(), results.end(), 0.0);
+    const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+    context.Prepare(model, blockSize);
+    for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
+        const auto docCountInBlock = Min(blockSize, docCount - blockStart);
+        BinarizeFeatures(
+            model,
+            floatFeatureAccessor,
+            catFeaturesAccessor,
+            blockStart,
+            blockStart + docCountInBlock,
+            context.BinFeatures,
+            context.TransposedHash,
+            context.Ctrs
+        );
+        compiledModel.CalcTrees(
+            context.BinFeatures.data(),
+            docCountInBlock,
+            context.IndexesVec.data(),
+            results.data() + blockStart * approxDimension
+        );
+    }
+}
+
+static void CheckFloatAndCatFeatures(const TFullModel& model, size_t floatFeaturesDocCount, size_t catFeaturesDocCount) {
+    if (floatFeaturesDocCount != 0 && catFeaturesDocCount != 0) {
+        CB_ENSURE(catFeaturesDocCount == floatFeaturesDocCount);
+    }
+    CB_ENSURE(model.ObliviousTrees.GetUsedFloatFeaturesCount() == 0 || floatFeaturesDocCount != 0, "Model has float features but no float features provided");
+    CB_ENSURE(model.ObliviousTrees.GetUsedCatFeaturesCount() == 0 || catFeaturesDocCount != 0, "Model has categorical features but no categorical features provided");
+}
+
+void TCompiledModel::CalcFlat(
+    TConstArrayRef<TConstArrayRef<float>> features,
+    TArrayRef<double> results,
+    TModelEvaluationContext& context
+) const {
+    const auto expectedFlatVecSize = Model.ObliviousTrees.GetFlatFeatureVectorExpectedSize();
+    for (const auto& flatFeaturesVec : features) {
+        CB_ENSURE(flatFeaturesVec.size() >= expectedFlatVecSize,
+                  "insufficient flat features vector size: " << flatFeaturesVec.size()
+                                                             << " expected: " << expectedFlatVecSize);
+    }
+    CalcCompiledGeneric(
+        *this,
+        [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+            return features[index][floatFeature.FlatFeatureIndex];
+        },
+        [&features](const TCatFeature& catFeature, size_t index) -> int {
+            return ConvertFloatCatFeatureToIntHash(features[index][catFeature.FlatFeatureIndex]);
+        },
+        features.size(),
+        results,
+        context
+    );
+}
+
+void TCompiledModel::CalcFlat(TConstArrayRef<TConstArrayRef<float>> features, TArrayRef<double> results) const {
+    TModelEvaluationContext context;
+    CalcFlat(features, results, context);
+}
+
+void TCompiledModel::CalcFlatSingle(
+    TConstArrayRef<float> features,
+    TArrayRef<double> results,
+    TModelEvaluationContext& context
+) const {
+    const TConstArrayRef<float> featuresArray[] = {features};
+    CalcFlat(featuresArray, results, context);
+}
+
+void TCompiledModel::Calc(
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TConstArrayRef<int>> catFeatures,
+    TArrayRef<double> results
+) const {
+    CheckFloatAndCatFeatures(Model, floatFeatures.size(), catFeatures.size());
+    for (const auto& floatFeaturesVec : floatFeatures) {
+        CB_ENSURE(floatFeaturesVec.size() >= Model.ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize(),
+                  "insufficient float features vector size: " << floatFeaturesVec.size()
+                                                              << " expected: " << Model.ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize());
+    }
+    for (const auto& catFeaturesVec : catFeatures) {
+        CB_ENSURE(catFeaturesVec.size() >= Model.ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize(),
+                  "insufficient cat features vector size: " << catFeaturesVec.size()
+                                                            << " expected: " << Model.ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize());
+    }
+    TModelEvaluationContext context;
+    CalcCompiledGeneric(
+        *this,
+        [&floatFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
+            return floatFeatures[index][floatFeature.FeatureIndex];
+        },
+        [&catFeatures](const TCatFeature& catFeature, size_t index) -> int {
+            return catFeatures[index][catFeature.FeatureIndex];
+        },
+        Max(floatFeatures.size(), catFeatures.size()),
+        results,
+        context
+    );
+}
+
+void TCompiledModel::Calc(
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TVector<TStringBuf>> catFeatures,
+    TArrayRef<double> results
+) const {
+    CheckFloatAndCatFeatures(Model, floatFeatures.size(), catFeatures.size());
+    for (const auto& floatFeaturesVec : floatFeatures) {
+        CB_ENSURE(floatFeaturesVec.size() >= Model.ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize(),
+                  "insufficient float features vector size: " << floatFeaturesVec.size()
+                                                              << " expected: " << Model.ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize());
+    }
+    for (const auto& catFeaturesVec : catFeatures) {
+        CB_ENSURE(catFeaturesVec.size() >= Model.ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize(),
+                  "insufficient cat features vector size: " << catFeaturesVec.size()
+                                                            << " expected: " << Model.ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize());
+    }
+    TModelEvaluationContext context;
+    CalcCompiledGeneric(
+        *this,
+        [&floatFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
+            return floatFeatures[index][floatFeature.FeatureIndex];
+        },
+        [&catFeatures](const TCatFeature& catFeature, size_t index) -> int {
+            return CalcCatFeatureHash(catFeatures[index][catFeature.FeatureIndex]);
+        },
+        Max(floatFeatures.size(), catFeatures.size()),
+        results,
+        context
+    );
+}
+
+TCompiledModelAccuracyReport CalcCompiledModelAccuracyReport(
+    const TFullModel& model,
+    const TCompiledModel& compiledModel,
+    TConstArrayRef<TConstArrayRef<float>> features
+) {
+    const size_t resultSize = features.size() * model.ObliviousTrees.ApproxDimension;
+    TVector<double> canonResults(resultSize);
+    model.CalcFlat(features, canonResults);
+    TVector<double> results(resultSize);
+    compiledModel.CalcFlat(features, results);
+
+    TCompiledModelAccuracyReport report;
+    report.ObjectCount = features.size();
+    report.MaxErrorBound = compiledModel.GetMaxErrorBound();
+    double absErrorSum = 0;
+    for (size_t i = 0; i < resultSize; ++i) {
+        const double absError = Abs(results[i] - canonResults[i]);
+        absErrorSum += absError;
+        report.MaxAbsError = Max(report.MaxAbsError, absError);
+        if (canonResults[i] != 0) {
+            report.MaxRelativeError = Max(report.MaxRelativeError, absError / Abs(canonResults[i]));
+        }
+    }
+    report.MeanAbsError = resultSize ? absErrorSum / resultSize : 0;
+    return report;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "evaluation_context.h"
+#include "model.h"
+
+#include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+
+enum class ECompiledLeafType {
+    Double,
+    Float,
+    //! Leaf values are quantized to int16 with per tree scale, accumulation is still done in double
+    Int16
+};
+
+constexpr int COMPILED_MODEL_MAX_TREE_DEPTH = 16;
+
+/**
+ * Evaluation oriented representation of oblivious trees model.
+ * Trees are grouped by depth and each group is evaluated by kernel specialized for that depth,
+ * so there is no per tree branching on tree size. Splits and leaf values are stored in group order,
+ * leaf values can be stored as float or scaled int16 to cut memory size and traffic of large models.
+ *
+ * Trees are summed in group order, so results can differ from TFullModel::Calc in last bits
+ * (and by rounding of leaf values for reduced precision leaf types, see GetMaxErrorBound).
+ * Compiled model references features, borders and ctr data of source model: source model must outlive it
+ * and must not be modified. Constructor taking model by rvalue reference keeps source model inside.
+ */
+class TCompiledModel {
+public:
+    struct TDepthGroup {
+        int Depth = 0;
+        size_t TreeCount = 0;
+        //! Depth splits for each tree of the group
+        TVector<TRepackedBin> Splits;
+        //! (1 << Depth) * ApproxDimension leaf values for each tree of the group, only one of vectors is filled
+        TVector<double> DoubleLeafValues;
+        TVector<float> FloatLeafValues;
+        TVector<i16> Int16LeafValues;
+        //! Leaf value is Int16LeafValues[i] * LeafScales[treeIdx], filled only for ECompiledLeafType::Int16
+        TVector<double> LeafScales;
+    };
+
+public:
+    explicit TCompiledModel(const TFullModel& model, ECompiledLeafType leafType = ECompiledLeafType::Double);
+
+    /**
+     * Take ownership of model. If leaf type is not Double, double leaf values of the owned model are released
+     * to reduce memory footprint, so GetModel() result can't be evaluated by itself.
+     */
+    explicit TCompiledModel(TFullModel&& model, ECompiledLeafType leafType);
+
+    /**
+     * Evaluate all model trees on flat feature vectors, see TFullModel::CalcFlat
+     * @param[in] features vector of flat features array reference. First dimension is object index, second dimension is feature index.
+     * @param[out] results Flat double vector with indexation [objectIndex * ApproxDimension + classId].
+     */
+    void CalcFlat(TConstArrayRef<TConstArrayRef<float>> features, TArrayRef<double> results) const;
+
+    /**
+     * Same as CalcFlat, but all scratch buffers are taken from context
+     */
+    void CalcFlat(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        TArrayRef<double> results,
+        TModelEvaluationContext& context) const;
+
+    /**
+     * Evaluate all model trees on one flat feature vector
+     */
+    void CalcFlatSingle(TConstArrayRef<float> features, TArrayRef<double> results, TModelEvaluationContext& context) const;
+
+    /**
+     * Evaluate all model trees on float features and hashed categorical features, see TFullModel::Calc
+     */
+    void Calc(
+        TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+        TConstArrayRef<TConstArrayRef<int>> catFeatures,
+        TArrayRef<double> results) const;
+
+    /**
+     * Evaluate all model trees on float features and categorical features strings, see TFullModel::Calc
+     */
+    void Calc(
+        TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+        TConstArrayRef<TVector<TStringBuf>> catFeatures,
+        TArrayRef<double> results) const;
+
+    /**
+     * Evaluate trees on already binarized features block, features layout is the same as in BinarizeFeatures.
+     * @param[in] binFeatures binarized features of docCountInBlock documents
+     * @param[in] docCountInBlock document count, should not exceed FORMULA_EVALUATION_BLOCK_SIZE
+     * @param[in] indexesScratch scratch buffer for docCountInBlock leaf indexes
+     * @param[out] results leaf values are added to results with indexation [objectIndex * ApproxDimension + classId]
+     */
+    void CalcTrees(
+        const ui8* binFeatures,
+        size_t docCountInBlock,
+        ui32* indexesScratch,
+        double* results) const;
+
+    const TFullModel& GetModel() const {
+        return Model;
+    }
+
+    ECompiledLeafType GetLeafType() const {
+        return LeafType;
+    }
+
+    const TVector<TDepthGroup>& GetDepthGroups() const {
+        return DepthGroups;
+    }
+
+    /**
+     * Upper bound of absolute difference between predictions of compiled and source models caused by leaf values
+     * rounding: sum of per tree maximal leaf rounding errors. Zero for Double leaf type.
+     */
+    double GetMaxErrorBound() const {
+        return MaxErrorBound;
+    }
+
+    //! Memory used by leaf values and leaf scales
+    size_t GetLeafValuesByteSize() const;
+
+private:
+    void Compile();
+
+private:
+    THolder<TFullModel> OwnedModel;
+    const TFullModel& Model;
+    ECompiledLeafType LeafType;
+    bool NeedXorMask = false;
+    TVector<TDepthGroup> DepthGroups;
+    double MaxErrorBound = 0;
+};
+
+struct TCompiledModelAccuracyReport {
+    size_t ObjectCount = 0;
+    double MaxAbsError = 0;
+    double MeanAbsError = 0;
+    //! Maximum of absolute error divided by absolute value of source model prediction, zero predictions are skipped
+    double MaxRelativeError = 0;
+    double MaxErrorBound = 0;
+};
+
+/**
+ * Measure prediction difference between compiled model and source model (with double leaf values) on flat feature vectors
+ */
+TCompiledModelAccuracyReport CalcCompiledModelAccuracyReport(
+    const TFullModel& model,
+    const TCompiledModel& compiledModel,
+    TConstArrayRef<TConstArrayRef<float>> features);
@@ -28,3 +28,18 @@ void TCtrData::Load(IInputStream* s) {
         LearnCtrs[ctrBase] = std::move(table);
     }
 }
+
+void TCtrData::LoadNonOwning(TMemoryInput* in) {
+    const size_t cnt = ::LoadSize(in);
+    LearnCtrs.reserve(cnt);
+
+    for (size_t i = 0; i != cnt; ++i) {
+        const size_t tableSize = ::LoadSize(in);
+        CB_ENSURE(tableSize <= in->Avail(), "Ctr value table data is truncated");
+        TCtrValueTable table;
+        table.LoadThin(MakeArrayRef(reinterpret_cast<const ui8*>(in->Buf()), tableSize));
+        in->Skip(tableSize);
+        TModelCtrBase ctrBase = table.ModelCtrBase;
+        LearnCtrs[ctrBase] = std::move(table);
+    }
+}
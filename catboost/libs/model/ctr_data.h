@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ctr_value_table.h"
+#include <util/stream/mem.h>
 #include <util/system/mutex.h>
 #include <util/system/guard.h>
 
@@ -18,6 +19,12 @@ struct TCtrData {
     void Save(IOutputStream* s) const;
 
     void Load(IInputStream* s);
+
+    /**
+     * Load tables serialized in memory without copying their data, see TCtrValueTable::LoadThin.
+     * Memory of the stream must outlive loaded tables.
+     */
+    void LoadNonOwning(TMemoryInput* in);
 };
 
 struct TCtrDataStreamWriter {
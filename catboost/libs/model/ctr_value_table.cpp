@@ -1,9 +1,28 @@
 #include "ctr_value_table.h"
 #include "flatbuffers_serializer_helper.h"
+
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/flatbuffers/model.fbs.h>
 #include <util/stream/input.h>
 #include <util/ysaveload.h>
 
+static_assert(CTR_VALUE_TABLE_ALIGNMENT >= alignof(ui64), "");
+
+/**
+ * Tables are saved one after another with 4-byte size prefix, so trailing padding of table buffer
+ * to 4 modulo CTR_VALUE_TABLE_ALIGNMENT keeps next table buffer aligned once the first one is.
+ * Flatbuffers verification and loading ignore these trailing bytes.
+ */
+static void SaveWithAlignmentPadding(const flatbuffers::FlatBufferBuilder& builder, IOutputStream* s) {
+    const size_t size = builder.GetSize();
+    const size_t sizePrefix = sizeof(ui32);
+    const size_t padding = (CTR_VALUE_TABLE_ALIGNMENT - (size + sizePrefix) % CTR_VALUE_TABLE_ALIGNMENT) % CTR_VALUE_TABLE_ALIGNMENT;
+    SaveSize(s, size + padding);
+    s->Write(builder.GetBufferPointer(), size);
+    for (size_t i = 0; i < padding; ++i) {
+        s->Write('\0');
+    }
+}
 
 void TCtrValueTable::Save(IOutputStream* s) const {
     using namespace flatbuffers;
@@ -11,9 +30,12 @@ void TCtrValueTable::Save(IOutputStream* s) const {
     TModelPartsCachingSerializer serializer;
     if (HoldsAlternative<TSolidTable>(Impl)) {
         auto& solid = Get<TSolidTable>(Impl);
+        serializer.FlatbufBuilder.ForceVectorAlignment(solid.CTRBlob.size(), sizeof(ui8), CTR_VALUE_TABLE_ALIGNMENT);
+        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(solid.CTRBlob);
+        serializer.FlatbufBuilder.ForceVectorAlignment(
+            sizeof(NCatboost::TBucket) * solid.IndexBuckets.size(), sizeof(ui8), CTR_VALUE_TABLE_ALIGNMENT);
         auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) solid.IndexBuckets.data(),
                                                 sizeof(NCatboost::TBucket) * solid.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(solid.CTRBlob);
         auto ctrValueTable = CreateTCtrValueTable(
             serializer.FlatbufBuilder,
             serializer.GetOffset(ModelCtrBase),
@@ -24,9 +46,12 @@ void TCtrValueTable::Save(IOutputStream* s) const {
         serializer.FlatbufBuilder.Finish(ctrValueTable);
     } else {
         auto& thin = Get<TThinTable>(Impl);
+        serializer.FlatbufBuilder.ForceVectorAlignment(thin.CTRBlob.size(), sizeof(ui8), CTR_VALUE_TABLE_ALIGNMENT);
+        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(thin.CTRBlob.data(), thin.CTRBlob.size());
+        serializer.FlatbufBuilder.ForceVectorAlignment(
+            sizeof(NCatboost::TBucket) * thin.IndexBuckets.size(), sizeof(ui8), CTR_VALUE_TABLE_ALIGNMENT);
         auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) thin.IndexBuckets.data(),
                                                 sizeof(NCatboost::TBucket) * thin.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(thin.CTRBlob.data(), thin.CTRBlob.size());
         auto ctrValueTable = CreateTCtrValueTable(
             serializer.FlatbufBuilder,
             serializer.GetOffset(ModelCtrBase),
@@ -36,8 +61,7 @@ void TCtrValueTable::Save(IOutputStream* s) const {
             TargetClassesCount);
         serializer.FlatbufBuilder.Finish(ctrValueTable);
     }
-    SaveSize(s, serializer.FlatbufBuilder.GetSize());
-    s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
+    SaveWithAlignmentPadding(serializer.FlatbufBuilder, s);
 }
 
 void TCtrValueTable::Load(IInputStream* s) {
@@ -62,3 +86,31 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     solid.CTRBlob.assign(ctrValueTable->CTRBlob()->data(),
                          ctrValueTable->CTRBlob()->data() + ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::LoadThin(TConstArrayRef<ui8> buf) {
+    using namespace flatbuffers;
+    {
+        flatbuffers::Verifier verifier(buf.data(), buf.size());
+        CB_ENSURE(NCatBoostFbs::VerifyTCtrValueTableBuffer(verifier), "Flatbuffers ctr value table verification failed");
+    }
+    auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(buf.data());
+    const ui8* indexHashData = ctrValueTable->IndexHashRaw()->data();
+    const ui8* ctrBlobData = ctrValueTable->CTRBlob()->data();
+    // blob holds TCtrMeanHistory or int counters
+    if (reinterpret_cast<uintptr_t>(indexHashData) % CTR_VALUE_TABLE_ALIGNMENT != 0 ||
+        reinterpret_cast<uintptr_t>(ctrBlobData) % CTR_VALUE_TABLE_ALIGNMENT != 0)
+    {
+        LoadSolid(const_cast<ui8*>(buf.data()), buf.size());
+        return;
+    }
+    ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
+    CounterDenominator = ctrValueTable->CounterDenominator();
+    TargetClassesCount = ctrValueTable->TargetClassesCount();
+    TThinTable thin;
+    thin.IndexBuckets = MakeArrayRef(
+        reinterpret_cast<const NCatboost::TBucket*>(indexHashData),
+        ctrValueTable->IndexHashRaw()->size() / sizeof(NCatboost::TBucket)
+    );
+    thin.CTRBlob = MakeArrayRef(ctrBlobData, ctrValueTable->CTRBlob()->size());
+    Impl = thin;
+}
@@ -4,12 +4,20 @@
 #include <catboost/libs/model/flatbuffers/ctr_data.fbs.h>
 
 #include <catboost/libs/helpers/dense_hash_view.h>
+#include <util/generic/utility.h>
 #include <util/generic/vector.h>
 #include <util/generic/variant.h>
 #include <tuple>
 #include <util/stream/input.h>
 #include <util/stream/output.h>
 
+/**
+ * Alignment of index buckets and ctr blob in serialized tables, that makes them usable in place
+ * when model is mapped into memory, see TCtrValueTable::Save and TFullModel::Save.
+ * TBucket is packed, so its alignment is 1, the constant is taken from its ui64 hash and blob values.
+ */
+constexpr size_t CTR_VALUE_TABLE_ALIGNMENT = Max(alignof(NCatboost::TBucket::THashType), alignof(TCtrMeanHistory));
+
 class TCtrValueTable {
     struct TSolidTable {
         TVector<NCatboost::TBucket> IndexBuckets;
@@ -88,6 +96,18 @@ public:
 
     void LoadSolid(void* buf, size_t length);
 
+    /**
+     * Deserialize table without copying: index buckets and ctr blob reference serialized data in buf,
+     * so buf must outlive the table. If serialized arrays are not aligned for in place access
+     * the table is loaded as solid copy.
+     */
+    void LoadThin(TConstArrayRef<ui8> buf);
+
+    //! Whether table references external memory instead of owning its data
+    bool IsThin() const {
+        return HoldsAlternative<TThinTable>(Impl);
+    }
+
     bool operator==(const TCtrValueTable& other) const {
         return std::tie(CounterDenominator, TargetClassesCount, Impl) ==
                std::tie(other.CounterDenominator, other.TargetClassesCount, other.Impl);
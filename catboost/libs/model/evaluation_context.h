@@ -0,0 +1,37 @@
+#pragma once
+
+#include "model.h"
+
+#include <util/generic/vector.h>
+
+constexpr size_t FORMULA_EVALUATION_BLOCK_SIZE = 128;
+
+/**
+ * Reusable scratch buffers for model evaluation.
+ * Buffers grow to fit the largest model and block evaluated with context, after that evaluation
+ * doesn't allocate memory (except ctr provider internals for models with ctr features).
+ * Context is not thread safe, use one context per thread.
+ */
+class TModelEvaluationContext {
+public:
+    TModelEvaluationContext() = default;
+
+    //! Preallocate buffers for full evaluation block of model
+    explicit TModelEvaluationContext(const TFullModel& model) {
+        Prepare(model, FORMULA_EVALUATION_BLOCK_SIZE);
+    }
+
+    //! Resize buffers to fit blockSize documents of model
+    void Prepare(const TFullModel& model, size_t blockSize) {
+        BinFeatures.resize(blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount());
+        IndexesVec.resize(blockSize);
+        TransposedHash.resize(blockSize * model.GetUsedCatFeaturesCount());
+        Ctrs.resize(blockSize * model.ObliviousTrees.GetUsedModelCtrs().size());
+    }
+
+public:
+    TVector<ui8> BinFeatures;
+    TVector<ui32> IndexesVec;
+    TVector<ui32> TransposedHash;
+    TVector<float> Ctrs;
+};
@@ -177,6 +177,21 @@ static void CalcIndexesSse(
     }
 }
 
+template <bool NeedXorMask, size_t SSEBlockCount>
+Y_FORCE_INLINE void CalcIndexesShallow(
+    const TEvaluationKernels& kernels,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    const int curTreeSize) {
+    if (kernels.CalcIndexes && docCountInBlock >= kernels.DocsPerStep) {
+        kernels.CalcIndexes(NeedXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    } else {
+        CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
 #endif
 
 template <typename TIndexType>
@@ -299,6 +314,7 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
     const auto treeLeafPtr = model.ObliviousTrees.LeafValues.data();
     auto firstLeafOffsetsPtr = model.ObliviousTrees.GetFirstLeafOffsets().data();
 #ifdef _sse2_
+    const auto& kernels = GetEvaluationKernels();
     bool allTreesAreShallow = AllOf(
             model.ObliviousTrees.TreeSizes.begin() + treeStart,
             model.ObliviousTrees.TreeSizes.begin() + treeEnd,
@@ -320,13 +336,13 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
         auto treeEnd4 = treeStart + (((treeEnd - treeStart) | 0x3) ^ 0x3);
         for (size_t treeId = treeStart; treeId < treeEnd4; treeId += 4) {
             memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(kernels, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 1]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(kernels, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 1]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 1];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 2]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(kernels, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 2]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 2];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 3]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(kernels, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 3]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 3];
 
             CalculateLeafValues4<SSEBlockCount>(
@@ -353,7 +369,7 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
         memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
 #ifdef _sse2_
         if (curTreeSize <= 8) {
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(kernels, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
             if (IsSingleClassModel) { // single class model
                 CalculateLeafValues(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVec, resultsPtr);
             } else { // mutliclass model
@@ -460,8 +476,135 @@ inline void CalcTreesSingleDocImpl(
     }
 }
 
+/* Objects of the block are moved through tree node array level by level in passes over the whole block,
+ * so feature bins are read sequentially for every node level and there are no data dependent branches.
+ * Objects that have reached their leaf node stay there (their step is zero).
+ */
+template <bool IsSingleClassModel, bool NeedXorMask>
+inline void CalcNonSymmetricTreesBlocked(
+    const TFullModel& model,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    TCalcerIndexType* __restrict indexesVec,
+    size_t treeStart,
+    size_t treeEnd,
+    double* __restrict resultsPtr)
+{
+    const auto& trees = model.ObliviousTrees;
+    const TRepackedBin* __restrict repackedBins = trees.GetRepackedBins().data();
+    const TNonSymmetricTreeStepNode* __restrict stepNodes = trees.NonSymmetricStepNodes.data();
+    const ui32* __restrict nodeIdToLeafId = trees.NonSymmetricNodeIdToLeafId.data();
+    const double* __restrict leafValues = trees.LeafValues.data();
+    const int approxDimension = trees.ApproxDimension;
+    for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+        const ui32 rootNodeIdx = trees.TreeStartOffsets[treeId];
+        if (trees.TreeSizes[treeId] == 1) {
+            const double* leafPtr = leafValues + nodeIdToLeafId[rootNodeIdx];
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                for (int classId = 0; classId < approxDimension; ++classId) {
+                    resultsPtr[docId * approxDimension + classId] += leafPtr[classId];
+                }
+            }
+            continue;
+        }
+        Fill(indexesVec, indexesVec + docCountInBlock, rootNodeIdx);
+        bool someDocMoved = true;
+        while (someDocMoved) {
+            someDocMoved = false;
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                const ui32 nodeIdx = indexesVec[docId];
+                const TRepackedBin split = repackedBins[nodeIdx];
+                ui8 featureValue = binFeatures[split.FeatureIndex * docCountInBlock + docId];
+                if (NeedXorMask) {
+                    featureValue ^= split.XorMask;
+                }
+                const TNonSymmetricTreeStepNode stepNode = stepNodes[nodeIdx];
+                const ui16 diff = (featureValue >= split.SplitIdx) ? stepNode.RightSubtreeDiff : stepNode.LeftSubtreeDiff;
+                indexesVec[docId] = nodeIdx + diff;
+                someDocMoved |= (diff != 0);
+            }
+        }
+        if (IsSingleClassModel) {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                resultsPtr[docId] += leafValues[nodeIdToLeafId[indexesVec[docId]]];
+            }
+        } else {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                const double* leafPtr = leafValues + nodeIdToLeafId[indexesVec[docId]];
+                for (int classId = 0; classId < approxDimension; ++classId) {
+                    resultsPtr[docId * approxDimension + classId] += leafPtr[classId];
+                }
+            }
+        }
+    }
+}
+
+template <bool IsSingleClassModel, bool NeedXorMask>
+inline void CalcNonSymmetricTreesSingleDoc(
+    const TFullModel& model,
+    const ui8* __restrict binFeatures,
+    size_t,
+    TCalcerIndexType* __restrict,
+    size_t treeStart,
+    size_t treeEnd,
+    double* __restrict results)
+{
+    const auto& trees = model.ObliviousTrees;
+    const TRepackedBin* repackedBins = trees.GetRepackedBins().data();
+    const TNonSymmetricTreeStepNode* stepNodes = trees.NonSymmetricStepNodes.data();
+    double result = 0.0;
+    for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+        ui32 nodeIdx = trees.TreeStartOffsets[treeId];
+        while (!stepNodes[nodeIdx].IsTerminal()) {
+            const TRepackedBin split = repackedBins[nodeIdx];
+            ui8 featureValue = binFeatures[split.FeatureIndex];
+            if (NeedXorMask) {
+                featureValue ^= split.XorMask;
+            }
+            const ui16 diff = (featureValue >= split.SplitIdx)
+                ? stepNodes[nodeIdx].RightSubtreeDiff
+                : stepNodes[nodeIdx].LeftSubtreeDiff;
+            if (diff == 0) {
+                break;
+            }
+            nodeIdx += diff;
+        }
+        const double* leafPtr = trees.LeafValues.data() + trees.NonSymmetricNodeIdToLeafId[nodeIdx];
+        if (IsSingleClassModel) { // single class model
+            result += *leafPtr;
+        } else { // mutliclass model
+            for (int classId = 0; classId < trees.ApproxDimension; ++classId) {
+                results[classId] += leafPtr[classId];
+            }
+        }
+    }
+    if (IsSingleClassModel) {
+        results[0] = result;
+    }
+}
+
+template <bool IsSingleClassModel, bool NeedXorMask>
+static TTreeCalcFunction GetCalcNonSymmetricTreesFunction(size_t docCountInBlock) {
+    if (docCountInBlock == 1) {
+        return CalcNonSymmetricTreesSingleDoc<IsSingleClassModel, NeedXorMask>;
+    } else {
+        return CalcNonSymmetricTreesBlocked<IsSingleClassModel, NeedXorMask>;
+    }
+}
+
 TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountInBlock) {
     const bool hasOneHots = !model.ObliviousTrees.OneHotFeatures.empty();
+    if (!model.ObliviousTrees.IsOblivious()) {
+        if (model.ObliviousTrees.ApproxDimension == 1) {
+            return hasOneHots
+                ? GetCalcNonSymmetricTreesFunction<true, true>(docCountInBlock)
+                : GetCalcNonSymmetricTreesFunction<true, false>(docCountInBlock);
+        } else {
+            return hasOneHots
+                ? GetCalcNonSymmetricTreesFunction<false, true>(docCountInBlock)
+                : GetCalcNonSymmetricTreesFunction<false, false>(docCountInBlock);
+        }
+    }
     if (model.ObliviousTrees.ApproxDimension == 1) {
         if (docCountInBlock == 1) {
             if (hasOneHots) {
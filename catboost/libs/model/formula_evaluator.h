@@ -1,5 +1,7 @@
 #pragma once
 
+#include "evaluation_context.h"
+#include "formula_evaluator_kernels.h"
 #include "model.h"
 
 #include <catboost/libs/helpers/exception.h>
@@ -9,16 +11,9 @@
 
 #include <util/system/platform.h>
 
-#ifdef _sse2_
-#include <emmintrin.h>
-#endif
-
-constexpr size_t FORMULA_EVALUATION_BLOCK_SIZE = 128;
-constexpr ui32 MAX_VALUES_PER_BIN = 254;
-
 inline void OneHotBinsFromTransposedCatFeatures(
     const TVector<TOneHotFeature>& OneHotFeatures,
-    const THashMap<int, int> catFeaturePackedIndex,
+    const THashMap<int, int>& catFeaturePackedIndex,
     const size_t docCount,
     ui8*& result,
     TVector<ui32>& transposedHash) {
@@ -40,81 +35,12 @@ inline void OneHotBinsFromTransposedCatFeatures(
     }
 }
 
-template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
-Y_FORCE_INLINE void BinarizeFloatsNonSse(
-        const size_t docCount,
-        TFloatFeatureAccessor floatAccessor,
-        const TConstArrayRef<float> borders,
-        size_t start,
-        ui8*& result,
-        float nanSubstitutionValue=0.0f
-) {
-    const auto docCount8 = (docCount | 0x7) ^ 0x7;
-    for (size_t docId = 0; docId < docCount8; docId += 8) {
-        float val[8] = {
-            floatAccessor(start + docId + 0),
-            floatAccessor(start + docId + 1),
-            floatAccessor(start + docId + 2),
-            floatAccessor(start + docId + 3),
-            floatAccessor(start + docId + 4),
-            floatAccessor(start + docId + 5),
-            floatAccessor(start + docId + 6),
-            floatAccessor(start + docId + 7)
-        };
-        if (UseNanSubstitution) {
-            for (size_t i = 0; i < 8; ++i) {
-                if (IsNan(val[i])) {
-                    val[i] = nanSubstitutionValue;
-                }
-            }
-        }
-        ui32* writePtr = (ui32*)(result + docId);
-        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
-            const size_t blockEnd = Min(blockStart + MAX_VALUES_PER_BIN, borders.size());
-            for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
-                const auto border = borders[borderId];
-                writePtr[0] += (val[0] > border) + ((val[1] > border) << 8) + ((val[2] > border) << 16) + ((val[3] > border) << 24);
-                writePtr[1] += (val[4] > border) + ((val[5] > border) << 8) + ((val[6] > border) << 16) + ((val[7] > border) << 24);
-            }
-            writePtr = (ui32*)((ui8*)writePtr + docCount);
-        }
-    }
-    for (size_t docId = docCount8; docId < docCount; ++docId) {
-        float val = floatAccessor(start + docId);
-        if (UseNanSubstitution) {
-            if (IsNan(val)) {
-                val = nanSubstitutionValue;
-            }
-        }
-
-        ui8* writePtr = result + docId;
-        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
-            const size_t blockEnd = Min(blockStart + MAX_VALUES_PER_BIN, borders.size());
-            for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
-                *writePtr += (ui8) (val > borders[borderId]);
-            }
-            writePtr += docCount;
-        }
-    }
-    result += docCount * ((borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN);
-}
-
-#ifndef _sse2_
-
-template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
-Y_FORCE_INLINE void BinarizeFloats(
-    const size_t docCount,
-    TFloatFeatureAccessor floatAccessor,
-    const TConstArrayRef<float> borders,
-    size_t start,
-    ui8*& result,
-    const float nanSubstitutionValue = 0.0f
-) {
-    BinarizeFloatsNonSse<UseNanSubstitution, TFloatFeatureAccessor>(docCount, floatAccessor, borders, start, result, nanSubstitutionValue);
-};
-
-#else
+constexpr size_t BINARIZATION_CHUNK_SIZE = 64;
 
+/**
+ * Gathers float values through accessor in small chunks and binarizes them with the widest kernel supported by CPU.
+ * Features with many sorted borders are binarized with binary search instead of linear scan over borders.
+ */
 template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
 Y_FORCE_INLINE void BinarizeFloats(
     const size_t docCount,
@@ -122,91 +48,26 @@ Y_FORCE_INLINE void BinarizeFloats(
     const TConstArrayRef<float> borders,
     size_t start,
     ui8*& result,
+    bool bordersAreSorted,
     const float nanSubstitutionValue = 0.0f
 ) {
-    const __m128 substitutionValVec = _mm_set1_ps(nanSubstitutionValue);
-    const auto docCount16 = (docCount | 0xf) ^ 0xf;
-    for (size_t docId = 0; docId < docCount16; docId += 16) {
-        const float val[16] = {
-            floatAccessor(start + docId + 0),
-            floatAccessor(start + docId + 1),
-            floatAccessor(start + docId + 2),
-            floatAccessor(start + docId + 3),
-            floatAccessor(start + docId + 4),
-            floatAccessor(start + docId + 5),
-            floatAccessor(start + docId + 6),
-            floatAccessor(start + docId + 7),
-            floatAccessor(start + docId + 8),
-            floatAccessor(start + docId + 9),
-            floatAccessor(start + docId + 10),
-            floatAccessor(start + docId + 11),
-            floatAccessor(start + docId + 12),
-            floatAccessor(start + docId + 13),
-            floatAccessor(start + docId + 14),
-            floatAccessor(start + docId + 15)
-        };
-        const __m128i mask = _mm_set1_epi8(1);
-        __m128 floats0 = _mm_load_ps(val);
-        __m128 floats1 = _mm_load_ps(val + 4);
-        __m128 floats2 = _mm_load_ps(val + 8);
-        __m128 floats3 = _mm_load_ps(val + 12);
-
-        if (UseNanSubstitution) {
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats0, floats0);
-                floats0 = _mm_or_ps(_mm_andnot_ps(masks, floats0), _mm_and_ps(masks, substitutionValVec));
-            }
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats1, floats1);
-                floats1 = _mm_or_ps(_mm_andnot_ps(masks, floats1), _mm_and_ps(masks, substitutionValVec));
-            }
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats2, floats2);
-                floats2 = _mm_or_ps(_mm_andnot_ps(masks, floats2), _mm_and_ps(masks, substitutionValVec));
-            }
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats3, floats3);
-                floats3 = _mm_or_ps(_mm_andnot_ps(masks, floats3), _mm_and_ps(masks, substitutionValVec));
-            }
-        }
-        ui8* writePtr = result + docId;
-        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
-            __m128i resultVec = _mm_setzero_si128();
-            const size_t blockEnd = Min(blockStart + MAX_VALUES_PER_BIN, borders.size());
-            for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
-                const __m128 borderVec = _mm_set1_ps(borders[borderId]);
-                const __m128i r0 = _mm_castps_si128(_mm_cmpgt_ps(floats0, borderVec));
-                const __m128i r1 = _mm_castps_si128(_mm_cmpgt_ps(floats1, borderVec));
-                const __m128i r2 = _mm_castps_si128(_mm_cmpgt_ps(floats2, borderVec));
-                const __m128i r3 = _mm_castps_si128(_mm_cmpgt_ps(floats3, borderVec));
-                const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
-                resultVec = _mm_add_epi8(resultVec, _mm_and_si128(packed, mask));
-            }
-            _mm_storeu_si128((__m128i *)writePtr, resultVec);
-            writePtr += docCount;
-        }
-    }
-    for (size_t docId = docCount16; docId < docCount; ++docId) {
-        float val = floatAccessor(start + docId);
-        if (UseNanSubstitution) {
-            if (IsNan(val)) {
-                val = nanSubstitutionValue;
-            }
-        }
-        ui8* writePtr = result + docId;
-        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
-            const size_t blockEnd = Min(blockStart + MAX_VALUES_PER_BIN, borders.size());
-            for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
-                *writePtr += (ui8)(val > borders[borderId]);
+    const auto binarizeKernel = GetBinarizeFloatsKernel(GetEvaluationKernels(), borders.size(), bordersAreSorted);
+    float values[BINARIZATION_CHUNK_SIZE];
+    for (size_t chunkStart = 0; chunkStart < docCount; chunkStart += BINARIZATION_CHUNK_SIZE) {
+        const size_t chunkSize = Min(BINARIZATION_CHUNK_SIZE, docCount - chunkStart);
+        for (size_t i = 0; i < chunkSize; ++i) {
+            values[i] = floatAccessor(start + chunkStart + i);
+            if (UseNanSubstitution) {
+                if (IsNan(values[i])) {
+                    values[i] = nanSubstitutionValue;
+                }
             }
-            writePtr += docCount;
         }
+        binarizeKernel(values, chunkSize, borders, docCount, result + chunkStart);
     }
     result += docCount * ((borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN);
 }
 
-#endif
-
 /**
 * This function binarizes
 */
@@ -222,6 +83,7 @@ inline void BinarizeFeatures(
     TVector<float>& ctrs
 ) {
     const auto docCount = end - start;
+    const bool bordersAreSorted = model.ObliviousTrees.AreAllBordersSorted();
     ui8* resultPtr = result.data();
     std::fill(result.begin(), result.end(), 0);
     for (const auto& floatFeature : model.ObliviousTrees.FloatFeatures) {
@@ -234,7 +96,8 @@ inline void BinarizeFeatures(
                 [&floatFeature, floatAccessor](size_t index) { return floatAccessor(floatFeature, index); },
                 floatFeature.Borders,
                 start,
-                resultPtr);
+                resultPtr,
+                bordersAreSorted);
         } else {
             const float infinity = std::numeric_limits<float>::infinity();
             if (floatFeature.NanValueTreatment == NCatBoostFbs::ENanValueTreatment_AsFalse) {
@@ -244,6 +107,7 @@ inline void BinarizeFeatures(
                     floatFeature.Borders,
                     start,
                     resultPtr,
+                    bordersAreSorted,
                     -infinity);
             } else {
                 Y_ASSERT(floatFeature.NanValueTreatment == NCatBoostFbs::ENanValueTreatment_AsTrue);
@@ -253,18 +117,18 @@ inline void BinarizeFeatures(
                     floatFeature.Borders,
                     start,
                     resultPtr,
+                    bordersAreSorted,
                     infinity);
             }
         }
     }
     if (model.HasCategoricalFeatures()) {
-        THashMap<int, int> catFeaturePackedIndexes;
+        const auto& catFeaturePackedIndexes = model.ObliviousTrees.GetUsedCatFeaturesPackedIndexes();
         int usedFeatureIdx = 0;
         for (const auto& catFeature : model.ObliviousTrees.CatFeatures) {
             if (!catFeature.UsedInModel) {
                 continue;
             }
-            catFeaturePackedIndexes[catFeature.FeatureIndex] = usedFeatureIdx;
             for (size_t docId = 0, writeIdx = usedFeatureIdx * docCount; docId < docCount; ++docId, ++writeIdx) {
                 transposedHash[writeIdx] = catFeatureAccessor(catFeature, start + docId);
             }
@@ -289,7 +153,8 @@ inline void BinarizeFeatures(
                 [ctrFloatsPtr](size_t index) { return ctrFloatsPtr[index]; },
                 ctr.Borders,
                 0,
-                resultPtr);
+                resultPtr,
+                bordersAreSorted);
         }
     }
 }
@@ -322,33 +187,29 @@ inline X* GetAligned(X* val) {
     return val;
 }
 
+/**
+ * Evaluate trees [treeStart, treeEnd) on docCount documents using caller provided scratch buffers.
+ * indexesVec is not used for single document evaluation and may be empty in that case.
+ */
 template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
-inline void CalcGeneric(
+inline void CalcGenericWithBuffers(
     const TFullModel& model,
     TFloatFeatureAccessor floatFeatureAccessor,
     TCatFeatureAccessor catFeaturesAccessor,
     size_t docCount,
     size_t treeStart,
     size_t treeEnd,
-    TArrayRef<double> results)
+    TArrayRef<double> results,
+    TArrayRef<ui8> binFeatures,
+    TArrayRef<TCalcerIndexType> indexesVec,
+    TVector<ui32>& transposedHash,
+    TVector<float>& ctrs)
 {
-    size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
-    blockSize = Min(blockSize, docCount);
-    const size_t binSlots = blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount();
-    TArrayRef<ui8> binFeatures;
-    TVector<ui8> binFeaturesHolder;
-    if (binSlots < 65536) { // 65KB of stack maximum
-        binFeatures = MakeArrayRef(GetAligned((ui8*)(alloca(binSlots + 0x20))), binSlots);
-    } else {
-        binFeaturesHolder.yresize(blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount());
-        binFeatures = binFeaturesHolder;
-    }
+    const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
     auto calcTrees = GetCalcTreesFunction(model, blockSize);
     if (docCount == 1) {
         CB_ENSURE((int)results.size() == model.ObliviousTrees.ApproxDimension);
         std::fill(results.begin(), results.end(), 0.0);
-        TVector<ui32> transposedHash(model.GetUsedCatFeaturesCount());
-        TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size());
         BinarizeFeatures(
             model,
             floatFeatureAccessor,
@@ -376,9 +237,6 @@ inline void CalcGeneric(
         "`results` size is insufficient: "
         LabeledOutput(results.size(), docCount * model.ObliviousTrees.ApproxDimension));
     std::fill(results.begin(), results.end(), 0.0);
-    TVector<TCalcerIndexType> indexesVec(blockSize);
-    TVector<ui32> transposedHash(blockSize * model.GetUsedCatFeaturesCount());
-    TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * blockSize);
     for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
         const auto docCountInBlock = Min(blockSize, docCount - blockStart);
         BinarizeFeatures(
@@ -403,6 +261,75 @@ inline void CalcGeneric(
     }
 }
 
+template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+inline void CalcGeneric(
+    const TFullModel& model,
+    TFloatFeatureAccessor floatFeatureAccessor,
+    TCatFeatureAccessor catFeaturesAccessor,
+    size_t docCount,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> results)
+{
+    size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
+    blockSize = Min(blockSize, docCount);
+    const size_t binSlots = blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount();
+    TArrayRef<ui8> binFeatures;
+    TVector<ui8> binFeaturesHolder;
+    if (binSlots < 65536) { // 65KB of stack maximum
+        binFeatures = MakeArrayRef(GetAligned((ui8*)(alloca(binSlots + 0x20))), binSlots);
+    } else {
+        binFeaturesHolder.yresize(blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount());
+        binFeatures = binFeaturesHolder;
+    }
+    TVector<TCalcerIndexType> indexesVec(docCount == 1 ? 0 : blockSize);
+    TVector<ui32> transposedHash(blockSize * model.GetUsedCatFeaturesCount());
+    TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * blockSize);
+    CalcGenericWithBuffers(
+        model,
+        floatFeatureAccessor,
+        catFeaturesAccessor,
+        docCount,
+        treeStart,
+        treeEnd,
+        results,
+        binFeatures,
+        indexesVec,
+        transposedHash,
+        ctrs
+    );
+}
+
+/**
+ * Same as CalcGeneric, but takes all scratch buffers from context
+ */
+template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+inline void CalcGeneric(
+    const TFullModel& model,
+    TFloatFeatureAccessor floatFeatureAccessor,
+    TCatFeatureAccessor catFeaturesAccessor,
+    size_t docCount,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> results,
+    TModelEvaluationContext& context)
+{
+    context.Prepare(model, Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount));
+    CalcGenericWithBuffers(
+        model,
+        floatFeatureAccessor,
+        catFeaturesAccessor,
+        docCount,
+        treeStart,
+        treeEnd,
+        results,
+        context.BinFeatures,
+        context.IndexesVec,
+        context.TransposedHash,
+        context.Ctrs
+    );
+}
+
 
 /**
  * Warning: use aggressive caching. Stores all binarized features in RAM
@@ -0,0 +1,203 @@
+#include "formula_evaluator_kernels.h"
+
+#ifdef AVX2_STUB
+
+bool GetAvx2EvaluationKernels(TEvaluationKernels*) {
+    return false;
+}
+
+#else
+
+#include "model.h"
+
+#include <util/generic/utility.h>
+
+#include <immintrin.h>
+
+constexpr size_t AVX2_BLOCK_SIZE = 32;
+
+static void BinarizeFloatsAvx2(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result
+) {
+    // _mm256_packs_* work inside 128-bit lanes, so after packing dwords of 4 vectors
+    // lane 0 holds docs [0..3, 8..11, 16..19, 24..27] and lane 1 holds docs [4..7, 12..15, 20..23, 28..31]
+    const __m256i unpackLanesPermutation = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const auto docCount32 = valueCount - valueCount % AVX2_BLOCK_SIZE;
+    for (size_t docId = 0; docId < docCount32; docId += AVX2_BLOCK_SIZE) {
+        const __m256 floats0 = _mm256_loadu_ps(values + docId);
+        const __m256 floats1 = _mm256_loadu_ps(values + docId + 8);
+        const __m256 floats2 = _mm256_loadu_ps(values + docId + 16);
+        const __m256 floats3 = _mm256_loadu_ps(values + docId + 24);
+        ui8* writePtr = result + docId;
+        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+            __m256i resultVec = _mm256_setzero_si256();
+            const size_t blockEnd = Min<size_t>(blockStart + MAX_VALUES_PER_BIN, borders.size());
+            for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
+                const __m256 borderVec = _mm256_set1_ps(borders[borderId]);
+                const __m256i r0 = _mm256_castps_si256(_mm256_cmp_ps(floats0, borderVec, _CMP_GT_OQ));
+                const __m256i r1 = _mm256_castps_si256(_mm256_cmp_ps(floats1, borderVec, _CMP_GT_OQ));
+                const __m256i r2 = _mm256_castps_si256(_mm256_cmp_ps(floats2, borderVec, _CMP_GT_OQ));
+                const __m256i r3 = _mm256_castps_si256(_mm256_cmp_ps(floats3, borderVec, _CMP_GT_OQ));
+                const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(r0, r1), _mm256_packs_epi32(r2, r3));
+                // packed bytes are 0xff for values greater than border
+                resultVec = _mm256_sub_epi8(resultVec, packed);
+            }
+            resultVec = _mm256_permutevar8x32_epi32(resultVec, unpackLanesPermutation);
+            _mm256_storeu_si256((__m256i*)writePtr, resultVec);
+            writePtr += resultStride;
+        }
+    }
+    for (size_t docId = docCount32; docId < valueCount; ++docId) {
+        BinarizeFloatLinear(values[docId], borders, resultStride, result + docId);
+    }
+}
+
+// Branchless lower bound for 8 values at once, all lanes make the same number of steps
+static Y_FORCE_INLINE __m256i CountBordersLessThanAvx2(__m256 vals, TConstArrayRef<float> borders) {
+    const float* bordersPtr = borders.data();
+    __m256i base = _mm256_setzero_si256();
+    size_t size = borders.size();
+    while (size > 1) {
+        const size_t half = size / 2;
+        const __m256i halfVec = _mm256_set1_epi32(half);
+        const __m256 middle = _mm256_i32gather_ps(bordersPtr, _mm256_add_epi32(base, halfVec), sizeof(float));
+        const __m256i isLess = _mm256_castps_si256(_mm256_cmp_ps(middle, vals, _CMP_LT_OQ));
+        base = _mm256_add_epi32(base, _mm256_and_si256(isLess, halfVec));
+        size -= half;
+    }
+    const __m256 lastBorder = _mm256_i32gather_ps(bordersPtr, base, sizeof(float));
+    // comparison mask is -1 for borders less than value
+    return _mm256_sub_epi32(base, _mm256_castps_si256(_mm256_cmp_ps(lastBorder, vals, _CMP_LT_OQ)));
+}
+
+static void BinarizeFloatsBinarySearchAvx2(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result
+) {
+    constexpr size_t docsPerStep = 16;
+    alignas(32) ui32 counts[docsPerStep];
+    const auto docCount16 = valueCount - valueCount % docsPerStep;
+    for (size_t docId = 0; docId < docCount16; docId += docsPerStep) {
+        // two independent searches to hide gather latency
+        const __m256i counts0 = CountBordersLessThanAvx2(_mm256_loadu_ps(values + docId), borders);
+        const __m256i counts1 = CountBordersLessThanAvx2(_mm256_loadu_ps(values + docId + 8), borders);
+        _mm256_store_si256((__m256i*)counts, counts0);
+        _mm256_store_si256((__m256i*)(counts + 8), counts1);
+        for (size_t i = 0; i < docsPerStep; ++i) {
+            WriteBinarizedBuckets(counts[i], borders.size(), resultStride, result + docId + i);
+        }
+    }
+    for (size_t docId = docCount16; docId < valueCount; ++docId) {
+        WriteBinarizedBuckets(CountBordersLessThan(values[docId], borders), borders.size(), resultStride, result + docId);
+    }
+}
+
+template <bool NeedXorMask, int CurTreeSize>
+static void CalcIndexesAvx2Depthed(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr
+) {
+    const auto docCount32 = docCountInBlock - docCountInBlock % AVX2_BLOCK_SIZE;
+    for (size_t docId = 0; docId < docCount32; docId += AVX2_BLOCK_SIZE) {
+        __m256i indexes = _mm256_setzero_si256();
+        for (int depth = 0; depth < CurTreeSize; ++depth) {
+            const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            const __m256i borderValVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+            __m256i val = _mm256_loadu_si256((const __m256i*)binFeaturePtr);
+            if (NeedXorMask) {
+                val = _mm256_xor_si256(val, _mm256_set1_epi8(treeSplitsCurPtr[depth].XorMask));
+            }
+            const __m256i isGreaterOrEqual = _mm256_cmpeq_epi8(_mm256_max_epu8(val, borderValVec), val);
+            indexes = _mm256_or_si256(indexes, _mm256_and_si256(isGreaterOrEqual, _mm256_set1_epi8(1 << depth)));
+        }
+        _mm256_storeu_si256((__m256i*)(indexesVec + docId), indexes);
+    }
+    for (int depth = 0; depth < CurTreeSize; ++depth) {
+        const ui8 borderVal = treeSplitsCurPtr[depth].SplitIdx;
+        const ui8 xorMask = treeSplitsCurPtr[depth].XorMask;
+        const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock;
+        for (size_t docId = docCount32; docId < docCountInBlock; ++docId) {
+            if (NeedXorMask) {
+                indexesVec[docId] |= ((binFeaturePtr[docId] ^ xorMask) >= borderVal) << depth;
+            } else {
+                indexesVec[docId] |= (binFeaturePtr[docId] >= borderVal) << depth;
+            }
+        }
+    }
+}
+
+template <bool NeedXorMask>
+static void CalcIndexesAvx2Impl(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize
+) {
+    switch (curTreeSize) {
+    case 1:
+        CalcIndexesAvx2Depthed<NeedXorMask, 1>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 2:
+        CalcIndexesAvx2Depthed<NeedXorMask, 2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 3:
+        CalcIndexesAvx2Depthed<NeedXorMask, 3>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 4:
+        CalcIndexesAvx2Depthed<NeedXorMask, 4>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 5:
+        CalcIndexesAvx2Depthed<NeedXorMask, 5>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 6:
+        CalcIndexesAvx2Depthed<NeedXorMask, 6>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 7:
+        CalcIndexesAvx2Depthed<NeedXorMask, 7>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 8:
+        CalcIndexesAvx2Depthed<NeedXorMask, 8>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    default:
+        break;
+    }
+}
+
+static void CalcIndexesAvx2(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize
+) {
+    if (needXorMask) {
+        CalcIndexesAvx2Impl<true>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    } else {
+        CalcIndexesAvx2Impl<false>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
+bool GetAvx2EvaluationKernels(TEvaluationKernels* kernels) {
+    *kernels = TEvaluationKernels{
+        EEvaluationIsa::Avx2,
+        AVX2_BLOCK_SIZE,
+        BinarizeFloatsAvx2,
+        BinarizeFloatsBinarySearchAvx2,
+        256,
+        CalcIndexesAvx2
+    };
+    return true;
+}
+
+#endif
@@ -0,0 +1,199 @@
+#include "formula_evaluator_kernels.h"
+
+#ifdef AVX512_STUB
+
+bool GetAvx512EvaluationKernels(TEvaluationKernels*) {
+    return false;
+}
+
+#else
+
+#include "model.h"
+
+#include <util/generic/utility.h>
+
+#include <immintrin.h>
+
+constexpr size_t AVX512_BLOCK_SIZE = 64;
+
+static void BinarizeFloatsAvx512(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result
+) {
+    const __m512i ones = _mm512_set1_epi8(1);
+    const auto docCount64 = valueCount - valueCount % AVX512_BLOCK_SIZE;
+    for (size_t docId = 0; docId < docCount64; docId += AVX512_BLOCK_SIZE) {
+        const __m512 floats0 = _mm512_loadu_ps(values + docId);
+        const __m512 floats1 = _mm512_loadu_ps(values + docId + 16);
+        const __m512 floats2 = _mm512_loadu_ps(values + docId + 32);
+        const __m512 floats3 = _mm512_loadu_ps(values + docId + 48);
+        ui8* writePtr = result + docId;
+        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+            __m512i resultVec = _mm512_setzero_si512();
+            const size_t blockEnd = Min<size_t>(blockStart + MAX_VALUES_PER_BIN, borders.size());
+            for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
+                const __m512 borderVec = _mm512_set1_ps(borders[borderId]);
+                const ui64 mask0 = _mm512_cmp_ps_mask(floats0, borderVec, _CMP_GT_OQ);
+                const ui64 mask1 = _mm512_cmp_ps_mask(floats1, borderVec, _CMP_GT_OQ);
+                const ui64 mask2 = _mm512_cmp_ps_mask(floats2, borderVec, _CMP_GT_OQ);
+                const ui64 mask3 = _mm512_cmp_ps_mask(floats3, borderVec, _CMP_GT_OQ);
+                const __mmask64 isGreater = mask0 | (mask1 << 16) | (mask2 << 32) | (mask3 << 48);
+                resultVec = _mm512_mask_add_epi8(resultVec, isGreater, resultVec, ones);
+            }
+            _mm512_storeu_si512((__m512i*)writePtr, resultVec);
+            writePtr += resultStride;
+        }
+    }
+    for (size_t docId = docCount64; docId < valueCount; ++docId) {
+        BinarizeFloatLinear(values[docId], borders, resultStride, result + docId);
+    }
+}
+
+// Branchless lower bound for 16 values at once, all lanes make the same number of steps
+static Y_FORCE_INLINE __m512i CountBordersLessThanAvx512(__m512 vals, TConstArrayRef<float> borders) {
+    const float* bordersPtr = borders.data();
+    __m512i base = _mm512_setzero_si512();
+    size_t size = borders.size();
+    while (size > 1) {
+        const size_t half = size / 2;
+        const __m512i halfVec = _mm512_set1_epi32(half);
+        const __m512 middle = _mm512_i32gather_ps(_mm512_add_epi32(base, halfVec), bordersPtr, sizeof(float));
+        const __mmask16 isLess = _mm512_cmp_ps_mask(middle, vals, _CMP_LT_OQ);
+        base = _mm512_mask_add_epi32(base, isLess, base, halfVec);
+        size -= half;
+    }
+    const __m512 lastBorder = _mm512_i32gather_ps(base, bordersPtr, sizeof(float));
+    const __mmask16 isLess = _mm512_cmp_ps_mask(lastBorder, vals, _CMP_LT_OQ);
+    return _mm512_mask_add_epi32(base, isLess, base, _mm512_set1_epi32(1));
+}
+
+static void BinarizeFloatsBinarySearchAvx512(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result
+) {
+    constexpr size_t docsPerStep = 32;
+    alignas(64) ui32 counts[docsPerStep];
+    const auto docCount32 = valueCount - valueCount % docsPerStep;
+    for (size_t docId = 0; docId < docCount32; docId += docsPerStep) {
+        // two independent searches to hide gather latency
+        const __m512i counts0 = CountBordersLessThanAvx512(_mm512_loadu_ps(values + docId), borders);
+        const __m512i counts1 = CountBordersLessThanAvx512(_mm512_loadu_ps(values + docId + 16), borders);
+        _mm512_store_si512((__m512i*)counts, counts0);
+        _mm512_store_si512((__m512i*)(counts + 16), counts1);
+        for (size_t i = 0; i < docsPerStep; ++i) {
+            WriteBinarizedBuckets(counts[i], borders.size(), resultStride, result + docId + i);
+        }
+    }
+    for (size_t docId = docCount32; docId < valueCount; ++docId) {
+        WriteBinarizedBuckets(CountBordersLessThan(values[docId], borders), borders.size(), resultStride, result + docId);
+    }
+}
+
+template <bool NeedXorMask, int CurTreeSize>
+static void CalcIndexesAvx512Depthed(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr
+) {
+    const auto docCount64 = docCountInBlock - docCountInBlock % AVX512_BLOCK_SIZE;
+    for (size_t docId = 0; docId < docCount64; docId += AVX512_BLOCK_SIZE) {
+        __m512i indexes = _mm512_setzero_si512();
+        for (int depth = 0; depth < CurTreeSize; ++depth) {
+            const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            const __m512i borderValVec = _mm512_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+            __m512i val = _mm512_loadu_si512((const __m512i*)binFeaturePtr);
+            if (NeedXorMask) {
+                val = _mm512_xor_si512(val, _mm512_set1_epi8(treeSplitsCurPtr[depth].XorMask));
+            }
+            const __mmask64 isGreaterOrEqual = _mm512_cmpge_epu8_mask(val, borderValVec);
+            indexes = _mm512_or_si512(indexes, _mm512_maskz_mov_epi8(isGreaterOrEqual, _mm512_set1_epi8(1 << depth)));
+        }
+        _mm512_storeu_si512((__m512i*)(indexesVec + docId), indexes);
+    }
+    for (int depth = 0; depth < CurTreeSize; ++depth) {
+        const ui8 borderVal = treeSplitsCurPtr[depth].SplitIdx;
+        const ui8 xorMask = treeSplitsCurPtr[depth].XorMask;
+        const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock;
+        for (size_t docId = docCount64; docId < docCountInBlock; ++docId) {
+            if (NeedXorMask) {
+                indexesVec[docId] |= ((binFeaturePtr[docId] ^ xorMask) >= borderVal) << depth;
+            } else {
+                indexesVec[docId] |= (binFeaturePtr[docId] >= borderVal) << depth;
+            }
+        }
+    }
+}
+
+template <bool NeedXorMask>
+static void CalcIndexesAvx512Impl(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize
+) {
+    switch (curTreeSize) {
+    case 1:
+        CalcIndexesAvx512Depthed<NeedXorMask, 1>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 2:
+        CalcIndexesAvx512Depthed<NeedXorMask, 2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 3:
+        CalcIndexesAvx512Depthed<NeedXorMask, 3>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 4:
+        CalcIndexesAvx512Depthed<NeedXorMask, 4>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 5:
+        CalcIndexesAvx512Depthed<NeedXorMask, 5>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 6:
+        CalcIndexesAvx512Depthed<NeedXorMask, 6>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 7:
+        CalcIndexesAvx512Depthed<NeedXorMask, 7>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    case 8:
+        CalcIndexesAvx512Depthed<NeedXorMask, 8>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+        break;
+    default:
+        break;
+    }
+}
+
+static void CalcIndexesAvx512(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize
+) {
+    if (needXorMask) {
+        CalcIndexesAvx512Impl<true>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    } else {
+        CalcIndexesAvx512Impl<false>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
+bool GetAvx512EvaluationKernels(TEvaluationKernels* kernels) {
+    *kernels = TEvaluationKernels{
+        EEvaluationIsa::Avx512,
+        AVX512_BLOCK_SIZE,
+        BinarizeFloatsAvx512,
+        BinarizeFloatsBinarySearchAvx512,
+        192,
+        CalcIndexesAvx512
+    };
+    return true;
+}
+
+#endif
@@ -0,0 +1,149 @@
+#include "formula_evaluator_kernels.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/singleton.h>
+#include <util/generic/utility.h>
+#include <util/system/cpu_id.h>
+#include <util/system/platform.h>
+
+#ifdef _sse2_
+#include <emmintrin.h>
+#endif
+
+
+static void BinarizeFloatsGeneric(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result
+) {
+    for (size_t docId = 0; docId < valueCount; ++docId) {
+        BinarizeFloatLinear(values[docId], borders, resultStride, result + docId);
+    }
+}
+
+static void BinarizeFloatsBinarySearchGeneric(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result
+) {
+    for (size_t docId = 0; docId < valueCount; ++docId) {
+        WriteBinarizedBuckets(CountBordersLessThan(values[docId], borders), borders.size(), resultStride, result + docId);
+    }
+}
+
+#ifdef _sse2_
+
+static void BinarizeFloatsSse2(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result
+) {
+    const auto docCount16 = (valueCount | 0xf) ^ 0xf;
+    const __m128i mask = _mm_set1_epi8(1);
+    for (size_t docId = 0; docId < docCount16; docId += 16) {
+        const __m128 floats0 = _mm_loadu_ps(values + docId);
+        const __m128 floats1 = _mm_loadu_ps(values + docId + 4);
+        const __m128 floats2 = _mm_loadu_ps(values + docId + 8);
+        const __m128 floats3 = _mm_loadu_ps(values + docId + 12);
+        ui8* writePtr = result + docId;
+        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+            __m128i resultVec = _mm_setzero_si128();
+            const size_t blockEnd = Min<size_t>(blockStart + MAX_VALUES_PER_BIN, borders.size());
+            for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
+                const __m128 borderVec = _mm_set1_ps(borders[borderId]);
+                const __m128i r0 = _mm_castps_si128(_mm_cmpgt_ps(floats0, borderVec));
+                const __m128i r1 = _mm_castps_si128(_mm_cmpgt_ps(floats1, borderVec));
+                const __m128i r2 = _mm_castps_si128(_mm_cmpgt_ps(floats2, borderVec));
+                const __m128i r3 = _mm_castps_si128(_mm_cmpgt_ps(floats3, borderVec));
+                const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
+                resultVec = _mm_add_epi8(resultVec, _mm_and_si128(packed, mask));
+            }
+            _mm_storeu_si128((__m128i *)writePtr, resultVec);
+            writePtr += resultStride;
+        }
+    }
+    BinarizeFloatsGeneric(values + docCount16, valueCount - docCount16, borders, resultStride, result + docCount16);
+}
+
+#endif
+
+namespace {
+    struct TEvaluationKernelsRegistry {
+        TMaybe<TEvaluationKernels> Generic;
+        TMaybe<TEvaluationKernels> Sse2;
+        TMaybe<TEvaluationKernels> Avx2;
+        TMaybe<TEvaluationKernels> Avx512;
+        const TEvaluationKernels* Best = nullptr;
+
+        TEvaluationKernelsRegistry() {
+            Generic = TEvaluationKernels{
+                EEvaluationIsa::Generic,
+                1,
+                BinarizeFloatsGeneric,
+                BinarizeFloatsBinarySearchGeneric,
+                16,
+                nullptr
+            };
+            Best = Generic.Get();
+#ifdef _sse2_
+            Sse2 = TEvaluationKernels{
+                EEvaluationIsa::Sse2,
+                16,
+                BinarizeFloatsSse2,
+                BinarizeFloatsBinarySearchGeneric,
+                128,
+                nullptr
+            };
+            Best = Sse2.Get();
+#endif
+#ifdef _x86_64_
+            TEvaluationKernels kernels;
+            if (NX86::CachedHaveAVX() && NX86::CachedHaveAVX2() && GetAvx2EvaluationKernels(&kernels)) {
+                Avx2 = kernels;
+                Best = Avx2.Get();
+            }
+            if (NX86::CachedHaveAVX512F() && NX86::CachedHaveAVX512BW() && GetAvx512EvaluationKernels(&kernels)) {
+                Avx512 = kernels;
+                Best = Avx512.Get();
+            }
+#endif
+        }
+
+        const TMaybe<TEvaluationKernels>& Get(EEvaluationIsa isa) const {
+            switch (isa) {
+                case EEvaluationIsa::Generic:
+                    return Generic;
+                case EEvaluationIsa::Sse2:
+                    return Sse2;
+                case EEvaluationIsa::Avx2:
+                    return Avx2;
+                case EEvaluationIsa::Avx512:
+                    return Avx512;
+            }
+            Y_UNREACHABLE();
+        }
+    };
+}
+
+bool IsEvaluationIsaSupported(EEvaluationIsa isa) {
+    return Singleton<TEvaluationKernelsRegistry>()->Get(isa).Defined();
+}
+
+const TEvaluationKernels& GetEvaluationKernels(EEvaluationIsa isa) {
+    const auto& kernels = Singleton<TEvaluationKernelsRegistry>()->Get(isa);
+    CB_ENSURE(kernels.Defined(), "Evaluation kernels for " << isa << " are not supported on this CPU");
+    return *kernels;
+}
+
+const TEvaluationKernels& GetEvaluationKernels() {
+    static const TEvaluationKernels* best = Singleton<TEvaluationKernelsRegistry>()->Best;
+    return *best;
+}
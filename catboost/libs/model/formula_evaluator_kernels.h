@@ -0,0 +1,128 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/generic/utility.h>
+#include <util/system/compiler.h>
+#include <util/system/types.h>
+
+struct TRepackedBin;
+
+constexpr ui32 MAX_VALUES_PER_BIN = 254;
+
+/**
+ * Instruction sets we have vectorized model evaluation kernels for.
+ */
+enum class EEvaluationIsa {
+    Generic,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+/**
+ * Binarize `valueCount` float values against `borders`.
+ * Each MAX_VALUES_PER_BIN borders form one bucket, bucket `b` value for object `i` is written to result[b * resultStride + i].
+ * NaN substitution must be done by caller, NaN values are treated as less than any border.
+ */
+using TBinarizeFloatsKernel = void (*)(
+    const float* __restrict values,
+    size_t valueCount,
+    TConstArrayRef<float> borders,
+    size_t resultStride,
+    ui8* __restrict result);
+
+/**
+ * Calculate ui8 leaf indexes of one tree with depth <= 8 for all documents in block.
+ */
+using TCalcIndexesKernel = void (*)(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize);
+
+struct TEvaluationKernels {
+    EEvaluationIsa Isa = EEvaluationIsa::Generic;
+    //! Documents processed by one vector step, blocks with less documents are processed by SSE2 code
+    size_t DocsPerStep = 1;
+    TBinarizeFloatsKernel BinarizeFloats = nullptr;
+    //! Branchless binary search over borders instead of linear scan, requires borders sorted in ascending order
+    TBinarizeFloatsKernel BinarizeFloatsBinarySearch = nullptr;
+    //! Rough break-even point between linear scan and binary search over borders
+    size_t BinarySearchMinBorderCount = 0;
+    //! Empty for Generic and Sse2 kernels, CalcTreesBlocked uses inlined SSE2 implementation in that case
+    TCalcIndexesKernel CalcIndexes = nullptr;
+};
+
+/**
+ * Scalar linear scan binarization of one value, used for tails of vectorized kernels
+ */
+static Y_FORCE_INLINE void BinarizeFloatLinear(float val, TConstArrayRef<float> borders, size_t resultStride, ui8* writePtr) {
+    for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+        const size_t blockEnd = Min<size_t>(blockStart + MAX_VALUES_PER_BIN, borders.size());
+        ui8 binIdx = 0;
+        for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
+            binIdx += (ui8)(val > borders[borderId]);
+        }
+        *writePtr = binIdx;
+        writePtr += resultStride;
+    }
+}
+
+/**
+ * Split count of borders less than value into MAX_VALUES_PER_BIN sized buckets
+ */
+static Y_FORCE_INLINE void WriteBinarizedBuckets(ui32 bordersLessCount, size_t borderCount, size_t resultStride, ui8* writePtr) {
+    for (size_t blockStart = 0; blockStart < borderCount; blockStart += MAX_VALUES_PER_BIN) {
+        *writePtr = (ui8)ClampVal<i64>((i64)bordersLessCount - (i64)blockStart, 0, MAX_VALUES_PER_BIN);
+        writePtr += resultStride;
+    }
+}
+
+/**
+ * Branchless lower bound: count of borders less than value. NaN values are greater than no border.
+ */
+static Y_FORCE_INLINE ui32 CountBordersLessThan(float val, TConstArrayRef<float> borders) {
+    const float* base = borders.data();
+    size_t size = borders.size();
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = (base[half] < val) ? base + half : base;
+        size -= half;
+    }
+    return (base - borders.data()) + (*base < val);
+}
+
+/**
+ * Check if kernels for instruction set are compiled in and supported by current CPU
+ */
+bool IsEvaluationIsaSupported(EEvaluationIsa isa);
+
+/**
+ * Kernels for specific instruction set, throws if instruction set is not supported
+ */
+const TEvaluationKernels& GetEvaluationKernels(EEvaluationIsa isa);
+
+/**
+ * Kernels for the widest instruction set supported by current CPU. Detection is done once per process.
+ */
+const TEvaluationKernels& GetEvaluationKernels();
+
+/**
+ * Choose linear or binary search binarization kernel for feature with borderCount borders
+ */
+inline TBinarizeFloatsKernel GetBinarizeFloatsKernel(
+    const TEvaluationKernels& kernels,
+    size_t borderCount,
+    bool bordersAreSorted
+) {
+    if (bordersAreSorted && borderCount >= kernels.BinarySearchMinBorderCount) {
+        return kernels.BinarizeFloatsBinarySearch;
+    }
+    return kernels.BinarizeFloats;
+}
+
+// Implemented in ISA specific translation units, return false if kernels are not compiled in
+bool GetAvx2EvaluationKernels(TEvaluationKernels* kernels);
+bool GetAvx512EvaluationKernels(TEvaluationKernels* kernels);
@@ -1,6 +1,7 @@
 #include "model.h"
 
 #include "coreml_helpers.h"
+#include "evaluation_context.h"
 #include "flatbuffers_serializer_helper.h"
 #include "formula_evaluator.h"
 #include "json_model_helpers.h"
@@ -19,10 +20,13 @@
 
 #include <library/json/json_reader.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 #include <util/string/builder.h>
 #include <util/stream/buffer.h>
 #include <util/stream/file.h>
+#include <util/stream/mem.h>
 #include <util/system/fs.h>
 #include <util/stream/str.h>
 
@@ -101,6 +105,19 @@ TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelTy
     return ReadModel(&bs, format);
 }
 
+TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize) {
+    TFullModel model;
+    model.InitNonOwning(TBlob::NoCopy(binaryBuffer, binaryBufferSize));
+    return model;
+}
+
+TFullModel LoadFullModelMapped(const TString& modelFile) {
+    CB_ENSURE(NFs::Exists(modelFile), "Model file doesn't exist: " << modelFile);
+    TFullModel model;
+    model.InitNonOwning(TBlob::FromFile(modelFile));
+    return model;
+}
+
 void OutputModelCoreML(const TFullModel& model, const TString& modelFile, const NJson::TJsonValue& userParameters) {
     CoreML::Specification::Model outModel;
     outModel.set_specificationversion(1);
@@ -129,6 +146,10 @@ void ExportModel(
         const TVector<TString>* featureId,
         const THashMap<ui32, TString>* catFeaturesHashToString
 ) {
+    CB_ENSURE(
+        model.ObliviousTrees.IsOblivious() || format == EModelType::CatboostBinary,
+        "Export of models with non-symmetric trees to " << format << " format is not supported"
+    );
     const auto modelFileName = NCatboostOptions::AddExtension(format, modelFile, addFileFormatExtension);
     switch (format) {
         case EModelType::CatboostBinary:
@@ -178,20 +199,76 @@ TFullModel DeserializeModel(const TString& serializedModel) {
     return DeserializeModel(TMemoryInput{serializedModel.Data(), serializedModel.Size()});
 }
 
+TVector<size_t> TObliviousTrees::CalcTreeLeafCounts() const {
+    TVector<size_t> treeLeafCounts(TreeSizes.size());
+    for (size_t treeIdx = 0; treeIdx < TreeSizes.size(); ++treeIdx) {
+        if (IsOblivious()) {
+            treeLeafCounts[treeIdx] = (1uLL << TreeSizes[treeIdx]);
+            continue;
+        }
+        for (int nodeIdx = TreeStartOffsets[treeIdx]; nodeIdx < TreeStartOffsets[treeIdx] + TreeSizes[treeIdx]; ++nodeIdx) {
+            treeLeafCounts[treeIdx] += (NonSymmetricNodeIdToLeafId[nodeIdx] != Max<ui32>());
+        }
+    }
+    return treeLeafCounts;
+}
+
+static void AddTreeToBuilder(
+    const TObliviousTrees& trees,
+    size_t treeIdx,
+    double leafMultiplier,
+    TObliviousTreeBuilder* builder
+) {
+    const auto& binFeatures = trees.GetBinFeatures();
+    const size_t firstLeafOffset = trees.GetFirstLeafOffsets()[treeIdx];
+    const size_t treeStart = trees.TreeStartOffsets[treeIdx];
+    const size_t treeEnd = treeStart + trees.TreeSizes[treeIdx];
+    TVector<TModelSplit> modelSplits;
+    for (size_t splitIdx = treeStart; splitIdx < treeEnd; ++splitIdx) {
+        // leaf-only nodes of non-symmetric trees have placeholder split index 0
+        modelSplits.push_back(binFeatures.empty() ? TModelSplit() : binFeatures[trees.TreeSplits[splitIdx]]);
+    }
+    const size_t leafCount = trees.IsOblivious()
+        ? (1uLL << trees.TreeSizes[treeIdx])
+        : CountIf(
+            trees.NonSymmetricNodeIdToLeafId.begin() + treeStart,
+            trees.NonSymmetricNodeIdToLeafId.begin() + treeEnd,
+            [] (ui32 leafOffset) { return leafOffset != Max<ui32>(); });
+    TVector<double> leafValues(
+        trees.LeafValues.begin() + firstLeafOffset,
+        trees.LeafValues.begin() + firstLeafOffset + trees.ApproxDimension * leafCount);
+    if (leafMultiplier != 1.0) {
+        for (auto& leafValue : leafValues) {
+            leafValue *= leafMultiplier;
+        }
+    }
+    const TConstArrayRef<double> leafWeights = trees.LeafWeights.empty()
+        ? TConstArrayRef<double>()
+        : TConstArrayRef<double>(trees.LeafWeights[treeIdx]);
+    if (trees.IsOblivious()) {
+        builder->AddTree(modelSplits, leafValues, leafWeights);
+        return;
+    }
+    TVector<TNonSymmetricTreeStepNode> stepNodes(
+        trees.NonSymmetricStepNodes.begin() + treeStart,
+        trees.NonSymmetricStepNodes.begin() + treeEnd);
+    TVector<ui32> nodeIdToLeafId(
+        trees.NonSymmetricNodeIdToLeafId.begin() + treeStart,
+        trees.NonSymmetricNodeIdToLeafId.begin() + treeEnd);
+    for (auto& leafId : nodeIdToLeafId) {
+        if (leafId != Max<ui32>()) {
+            leafId = (leafId - firstLeafOffset) / trees.ApproxDimension;
+        }
+    }
+    builder->AddNonSymmetricTree(modelSplits, stepNodes, nodeIdToLeafId, leafValues, leafWeights);
+}
+
 void TObliviousTrees::TruncateTrees(size_t begin, size_t end) {
     CB_ENSURE(begin <= end, "begin tree index should be not greater than end tree index.");
     CB_ENSURE(end <= TreeSplits.size(), "end tree index should be not greater than tree count.");
     TObliviousTreeBuilder builder(FloatFeatures, CatFeatures, ApproxDimension);
-    const auto& leafOffsets = MetaData->TreeFirstLeafOffsets;
     for (size_t treeIdx = begin; treeIdx < end; ++treeIdx) {
-        TVector<TModelSplit> modelSplits;
-        for (int splitIdx = TreeStartOffsets[treeIdx]; splitIdx < TreeStartOffsets[treeIdx] + TreeSizes[treeIdx]; ++splitIdx) {
-            modelSplits.push_back(MetaData->BinFeatures[TreeSplits[splitIdx]]);
-        }
-        TArrayRef<double> leafValuesRef(
-            LeafValues.begin() + leafOffsets[treeIdx],
-            LeafValues.begin() + leafOffsets[treeIdx] + ApproxDimension * (1u << TreeSizes[treeIdx]));
-        builder.AddTree(modelSplits, leafValuesRef, LeafWeights[treeIdx]);
+        AddTreeToBuilder(*this, treeIdx, /*leafMultiplier*/ 1.0, &builder);
     }
     *this = builder.Build();
 }
@@ -222,6 +299,10 @@ TObliviousTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
                 oneTreeLeafWeights.end()
         );
     }
+    std::vector<NCatBoostFbs::TNonSymmetricTreeStepNode> fbsStepNodes;
+    for (const auto& stepNode : NonSymmetricStepNodes) {
+        fbsStepNodes.emplace_back(stepNode.LeftSubtreeDiff, stepNode.RightSubtreeDiff);
+    }
     return NCatBoostFbs::CreateTObliviousTreesDirect(
         serializer.FlatbufBuilder,
         ApproxDimension,
@@ -233,7 +314,9 @@ TObliviousTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
         &oneHotFeaturesOffsets,
         &ctrFeaturesOffsets,
         &LeafValues,
-        &flatLeafWeights
+        &flatLeafWeights,
+        IsOblivious() ? nullptr : &fbsStepNodes,
+        IsOblivious() ? nullptr : &NonSymmetricNodeIdToLeafId
     );
 }
 
@@ -247,10 +330,11 @@ void TObliviousTrees::UpdateMetadata() const {
     auto& ref = MetaData.GetRef();
 
     ref.TreeFirstLeafOffsets.resize(TreeSizes.size());
+    const auto treeLeafCounts = CalcTreeLeafCounts();
     size_t currentOffset = 0;
     for (size_t i = 0; i < TreeSizes.size(); ++i) {
         ref.TreeFirstLeafOffsets[i] = currentOffset;
-        currentOffset += (1 << TreeSizes[i]) * ApproxDimension;
+        currentOffset += treeLeafCounts[i] * ApproxDimension;
     }
 
     for (const auto& ctrFeature : CtrFeatures) {
@@ -280,6 +364,7 @@ void TObliviousTrees::UpdateMetadata() const {
         if (!feature.UsedInModel) {
             continue;
         }
+        ref.UsedCatFeaturesPackedIndexes[feature.FeatureIndex] = ref.UsedCatFeaturesCount;
         ++ref.UsedCatFeaturesCount;
         ref.MinimalSufficientCatFeaturesVectorSize = static_cast<size_t>(feature.FeatureIndex) + 1;
     }
@@ -307,7 +392,12 @@ void TObliviousTrees::UpdateMetadata() const {
         }
         ref.EffectiveBinFeaturesBucketCount += (feature.Borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
     }
-    for (const auto& binSplit : TreeSplits) {
+    for (size_t nodeIdx = 0; nodeIdx < TreeSplits.size(); ++nodeIdx) {
+        if (!IsOblivious() && NonSymmetricStepNodes[nodeIdx].IsTerminal()) {
+            ref.RepackedBins.push_back(TRepackedBin());
+            continue;
+        }
+        const auto binSplit = TreeSplits[nodeIdx];
         const auto& feature = ref.BinFeatures[binSplit];
         const auto& featureIndex = splitIds[binSplit];
         Y_ENSURE(featureIndex.FeatureIdx <= 0xffff, "To many features in model, ask catboost team for support");
@@ -323,12 +413,95 @@ void TObliviousTrees::UpdateMetadata() const {
     }
 }
 
+void TObliviousTrees::UpdateBordersSortedness() {
+    const auto isSorted = [](const auto& feature) {
+        return IsSorted(feature.Borders.begin(), feature.Borders.end());
+    };
+    AllBordersAreSorted = AllOf(FloatFeatures, isSorted) && AllOf(CtrFeatures, isSorted);
+}
+
 void TObliviousTrees::DropUnusedFeatures() {
     EraseIf(FloatFeatures, [](const TFloatFeature& feature) { return !feature.UsedInModel();});
     EraseIf(CatFeatures, [](const TCatFeature& feature) { return !feature.UsedInModel; });
+    UpdateBordersSortedness();
     UpdateMetadata();
 }
 
+/**
+ * Split [0, docCount) x [treeStart, treeEnd) evaluation into executor tasks.
+ * Documents are split into parts of whole evaluation blocks first, if there are less document parts than
+ * threads, tree range is split too and partial sums of tree parts are accumulated into results.
+ * calcRange(docBegin, docEnd, treeBegin, treeEnd, results) must overwrite results of its range.
+ */
+template <class TCalcRange>
+static void CalcParallel(
+    size_t docCount,
+    size_t treeStart,
+    size_t treeEnd,
+    size_t approxDimension,
+    NPar::TLocalExecutor* executor,
+    TArrayRef<double> results,
+    const TCalcRange& calcRange
+) {
+    const int threadCount = executor ? executor->GetThreadCount() + 1 : 1;
+    const size_t blockCount = CeilDiv(docCount, FORMULA_EVALUATION_BLOCK_SIZE);
+    if (threadCount == 1 || docCount == 0 || treeStart >= treeEnd || (blockCount == 1 && treeEnd - treeStart == 1)) {
+        calcRange(0, docCount, treeStart, treeEnd, results);
+        return;
+    }
+    const size_t docPartCount = Min<size_t>(threadCount, blockCount);
+    const size_t docPartSize = CeilDiv(blockCount, docPartCount) * FORMULA_EVALUATION_BLOCK_SIZE;
+    const size_t treeCount = treeEnd - treeStart;
+    const size_t treePartSize = CeilDiv(treeCount, Max<size_t>(1, Min<size_t>(treeCount, threadCount / docPartCount)));
+    // recalculated to avoid empty tree parts
+    const size_t treePartCount = CeilDiv(treeCount, treePartSize);
+    const size_t realDocPartCount = CeilDiv(docCount, docPartSize);
+
+    // first tree part is written directly to results
+    TVector<TVector<double>> partialResults(treePartCount - 1);
+    for (auto& partialResult : partialResults) {
+        partialResult.yresize(docCount * approxDimension);
+    }
+    executor->ExecRangeWithThrow(
+        [&](int taskId) {
+            const size_t docPartId = taskId % realDocPartCount;
+            const size_t treePartId = taskId / realDocPartCount;
+            const size_t docBegin = docPartId * docPartSize;
+            const size_t docEnd = Min(docCount, docBegin + docPartSize);
+            const size_t treeBegin = treeStart + treePartId * treePartSize;
+            const size_t treePartEnd = Min(treeEnd, treeBegin + treePartSize);
+            TArrayRef<double> target = treePartId == 0 ? results : TArrayRef<double>(partialResults[treePartId - 1]);
+            calcRange(
+                docBegin,
+                docEnd,
+                treeBegin,
+                treePartEnd,
+                target.Slice(docBegin * approxDimension, (docEnd - docBegin) * approxDimension)
+            );
+        },
+        0,
+        realDocPartCount * treePartCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+    if (partialResults.empty()) {
+        return;
+    }
+    executor->ExecRangeWithThrow(
+        [&](int docPartId) {
+            const size_t begin = docPartId * docPartSize * approxDimension;
+            const size_t end = Min(docCount, (docPartId + 1) * docPartSize) * approxDimension;
+            for (const auto& partialResult : partialResults) {
+                for (size_t i = begin; i < end; ++i) {
+                    results[i] += partialResult[i];
+                }
+            }
+        },
+        0,
+        realDocPartCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
+
 void TFullModel::CalcFlat(TConstArrayRef<TConstArrayRef<float>> features,
                           size_t treeStart,
                           size_t treeEnd,
@@ -354,6 +527,55 @@ void TFullModel::CalcFlat(TConstArrayRef<TConstArrayRef<float>> features,
     );
 }
 
+void TFullModel::CalcFlat(TConstArrayRef<TConstArrayRef<float>> features,
+                          size_t treeStart,
+                          size_t treeEnd,
+                          TArrayRef<double> results,
+                          TModelEvaluationContext& context) const {
+    const auto expectedFlatVecSize = ObliviousTrees.GetFlatFeatureVectorExpectedSize();
+    for (const auto& flatFeaturesVec : features) {
+        CB_ENSURE(flatFeaturesVec.size() >= expectedFlatVecSize,
+                  "insufficient flat features vector size: " << flatFeaturesVec.size()
+                                                             << " expected: " << expectedFlatVecSize);
+    }
+    CalcGeneric(
+        *this,
+        [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+            return features[index][floatFeature.FlatFeatureIndex];
+        },
+        [&features](const TCatFeature& catFeature, size_t index) -> int {
+            return ConvertFloatCatFeatureToIntHash(features[index][catFeature.FlatFeatureIndex]);
+        },
+        features.size(),
+        treeStart,
+        treeEnd,
+        results,
+        context
+    );
+}
+
+void TFullModel::CalcFlat(TConstArrayRef<TConstArrayRef<float>> features,
+                          size_t treeStart,
+                          size_t treeEnd,
+                          TArrayRef<double> results,
+                          NPar::TLocalExecutor* executor) const {
+    CB_ENSURE(
+        results.size() == features.size() * ObliviousTrees.ApproxDimension,
+        "`results` size is insufficient: "
+        LabeledOutput(results.size(), features.size() * ObliviousTrees.ApproxDimension));
+    CalcParallel(
+        features.size(),
+        treeStart,
+        treeEnd,
+        ObliviousTrees.ApproxDimension,
+        executor,
+        results,
+        [&](size_t docBegin, size_t docEnd, size_t treeBegin, size_t treePartEnd, TArrayRef<double> partResults) {
+            CalcFlat(features.Slice(docBegin, docEnd - docBegin), treeBegin, treePartEnd, partResults);
+        }
+    );
+}
+
 void TFullModel::CalcFlatSingle(TConstArrayRef<float> features, size_t treeStart, size_t treeEnd, TArrayRef<double> results) const {
     CB_ENSURE(ObliviousTrees.GetFlatFeatureVectorExpectedSize() <= features.size(), "Not enough features provided");
     CalcGeneric(
@@ -371,6 +593,29 @@ void TFullModel::CalcFlatSingle(TConstArrayRef<float> features, size_t treeStart
     );
 }
 
+void TFullModel::CalcFlatSingle(
+    TConstArrayRef<float> features,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> results,
+    TModelEvaluationContext& context) const {
+    CB_ENSURE(ObliviousTrees.GetFlatFeatureVectorExpectedSize() <= features.size(), "Not enough features provided");
+    CalcGeneric(
+        *this,
+        [&features](const TFloatFeature& floatFeature, size_t ) -> float {
+            return features[floatFeature.FlatFeatureIndex];
+        },
+        [&features](const TCatFeature& catFeature, size_t ) -> int {
+            return ConvertFloatCatFeatureToIntHash(features[catFeature.FlatFeatureIndex]);
+        },
+        1,
+        treeStart,
+        treeEnd,
+        results,
+        context
+    );
+}
+
 void TFullModel::CalcFlatTransposed(TConstArrayRef<TConstArrayRef<float>> transposedFeatures,
                                     size_t treeStart,
                                     size_t treeEnd,
@@ -427,6 +672,44 @@ void TFullModel::Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
     );
 }
 
+void TFullModel::Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                      TConstArrayRef<TConstArrayRef<int>> catFeatures,
+                      size_t treeStart,
+                      size_t treeEnd,
+                      TArrayRef<double> results,
+                      TModelEvaluationContext& context) const {
+    if (!floatFeatures.empty() && !catFeatures.empty()) {
+        CB_ENSURE(catFeatures.size() == floatFeatures.size());
+    }
+    const size_t docCount = Max(catFeatures.size(), floatFeatures.size());
+    CB_ENSURE(ObliviousTrees.GetUsedFloatFeaturesCount() == 0 || !floatFeatures.Empty(), "Model has float features but no float features provided");
+    CB_ENSURE(ObliviousTrees.GetUsedCatFeaturesCount() == 0 || !catFeatures.Empty(), "Model has categorical features but no categorical features provided");
+    for (const auto& floatFeaturesVec : floatFeatures) {
+        CB_ENSURE(floatFeaturesVec.size() >= ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize(),
+                  "insufficient float features vector size: " << floatFeaturesVec.size()
+                                                              << " expected: " << ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize());
+    }
+    for (const auto& catFeaturesVec : catFeatures) {
+        CB_ENSURE(catFeaturesVec.size() >= ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize(),
+                  "insufficient cat features vector size: " << catFeaturesVec.size()
+                                                            << " expected: " << ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize());
+    }
+    CalcGeneric(
+        *this,
+        [&floatFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
+            return floatFeatures[index][floatFeature.FeatureIndex];
+        },
+        [&catFeatures](const TCatFeature& catFeature, size_t index) -> int {
+            return catFeatures[index][catFeature.FeatureIndex];
+        },
+        docCount,
+        treeStart,
+        treeEnd,
+        results,
+        context
+    );
+}
+
 void TFullModel::Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
                       TConstArrayRef<TVector<TStringBuf>> catFeatures, size_t treeStart, size_t treeEnd,
                       TArrayRef<double> results) const {
@@ -461,6 +744,98 @@ void TFullModel::Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
     );
 }
 
+void TFullModel::Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                      TConstArrayRef<TConstArrayRef<int>> catFeatures,
+                      size_t treeStart,
+                      size_t treeEnd,
+                      TArrayRef<double> results,
+                      NPar::TLocalExecutor* executor) const {
+    if (!floatFeatures.empty() && !catFeatures.empty()) {
+        CB_ENSURE(catFeatures.size() == floatFeatures.size());
+    }
+    const size_t docCount = Max(catFeatures.size(), floatFeatures.size());
+    CB_ENSURE(
+        results.size() == docCount * ObliviousTrees.ApproxDimension,
+        "`results` size is insufficient: "
+        LabeledOutput(results.size(), docCount * ObliviousTrees.ApproxDimension));
+    CalcParallel(
+        docCount,
+        treeStart,
+        treeEnd,
+        ObliviousTrees.ApproxDimension,
+        executor,
+        results,
+        [&](size_t docBegin, size_t docEnd, size_t treeBegin, size_t treePartEnd, TArrayRef<double> partResults) {
+            Calc(
+                floatFeatures.empty() ? floatFeatures : floatFeatures.Slice(docBegin, docEnd - docBegin),
+                catFeatures.empty() ? catFeatures : catFeatures.Slice(docBegin, docEnd - docBegin),
+                treeBegin,
+                treePartEnd,
+                partResults
+            );
+        }
+    );
+}
+
+void TFullModel::Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                      TConstArrayRef<TVector<TStringBuf>> catFeatures,
+                      size_t treeStart,
+                      size_t treeEnd,
+                      TArrayRef<double> results,
+                      NPar::TLocalExecutor* executor) const {
+    if (!floatFeatures.empty() && !catFeatures.empty()) {
+        CB_ENSURE(catFeatures.size() == floatFeatures.size());
+    }
+    const size_t docCount = Max(catFeatures.size(), floatFeatures.size());
+    CB_ENSURE(
+        results.size() == docCount * ObliviousTrees.ApproxDimension,
+        "`results` size is insufficient: "
+        LabeledOutput(results.size(), docCount * ObliviousTrees.ApproxDimension));
+    CalcParallel(
+        docCount,
+        treeStart,
+        treeEnd,
+        ObliviousTrees.ApproxDimension,
+        executor,
+        results,
+        [&](size_t docBegin, size_t docEnd, size_t treeBegin, size_t treePartEnd, TArrayRef<double> partResults) {
+            Calc(
+                floatFeatures.empty() ? floatFeatures : floatFeatures.Slice(docBegin, docEnd - docBegin),
+                catFeatures.empty() ? catFeatures : catFeatures.Slice(docBegin, docEnd - docBegin),
+                treeBegin,
+                treePartEnd,
+                partResults
+            );
+        }
+    );
+}
+
+void TFullModel::Calc(TConstArrayRef<float> floatFeatures,
+                      TConstArrayRef<TStringBuf> catFeatures,
+                      TArrayRef<double> result,
+                      TModelEvaluationContext& context) const {
+    CB_ENSURE(floatFeatures.size() >= ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize(),
+              "insufficient float features vector size: " << floatFeatures.size()
+                                                          << " expected: " << ObliviousTrees.GetMinimalSufficientFloatFeaturesVectorSize());
+    CB_ENSURE(catFeatures.size() >= ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize(),
+              "insufficient cat features vector size: " << catFeatures.size()
+                                                        << " expected: " << ObliviousTrees.GetMinimalSufficientCatFeaturesVectorSize());
+    CalcGeneric(
+        *this,
+        [&floatFeatures](const TFloatFeature& floatFeature, size_t ) -> float {
+            return floatFeatures[floatFeature.FeatureIndex];
+        },
+        [&catFeatures](const TCatFeature& catFeature, size_t ) -> int {
+            return CalcCatFeatureHash(catFeatures[catFeature.FeatureIndex]);
+        },
+        1,
+        0,
+        ObliviousTrees.TreeSizes.size(),
+        result,
+        context
+    );
+}
+
 TVector<TVector<double>> TFullModel::CalcTreeIntervals(
     TConstArrayRef<TConstArrayRef<float>> floatFeatures,
     TConstArrayRef<TConstArrayRef<int>> catFeatures,
@@ -546,39 +921,41 @@ void TFullModel::Save(IOutputStream* s) const {
         modelPartIds.empty() ? nullptr : &modelPartIds
     );
     serializer.FlatbufBuilder.Finish(coreOffset);
-    SaveSize(s, serializer.FlatbufBuilder.GetSize());
-    s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
+    // core is padded so that ctr data (4-byte table count and tables with 4-byte size prefixes)
+    // starts at offset aligned by CTR_VALUE_TABLE_ALIGNMENT and its tables can be used in place
+    // when model is mapped into memory, see TCtrValueTable::Save
+    const size_t coreSize = serializer.FlatbufBuilder.GetSize();
+    const size_t headerSize = sizeof(ui32) * 2; // format descriptor and core size
+    const size_t corePadding = (CTR_VALUE_TABLE_ALIGNMENT - (headerSize + coreSize) % CTR_VALUE_TABLE_ALIGNMENT) % CTR_VALUE_TABLE_ALIGNMENT;
+    SaveSize(s, coreSize + corePadding);
+    s->Write(serializer.FlatbufBuilder.GetBufferPointer(), coreSize);
+    for (size_t i = 0; i < corePadding; ++i) {
+        s->Write('\0');
+    }
     if (!!CtrProvider && CtrProvider->IsSerializable()) {
         CtrProvider->Save(s);
     }
 }
 
-void TFullModel::Load(IInputStream* s) {
+static TVector<TString> DeserializeModelCore(const ui8* coreData, size_t coreSize, TFullModel* model) {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
-    ui32 fileDescriptor;
-    ::Load(s, fileDescriptor);
-    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
-    auto coreSize = ::LoadSize(s);
-    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
-    s->LoadOrFail(arrayHolder.Get(), coreSize);
-
     {
-        flatbuffers::Verifier verifier(arrayHolder.Get(), coreSize);
+        flatbuffers::Verifier verifier(coreData, coreSize);
         CB_ENSURE(VerifyTModelCoreBuffer(verifier), "Flatbuffers model verification failed");
     }
-    auto fbModelCore = GetTModelCore(arrayHolder.Get());
+    auto fbModelCore = GetTModelCore(coreData);
     CB_ENSURE(
         fbModelCore->FormatVersion() && fbModelCore->FormatVersion()->str() == CURRENT_CORE_FORMAT_STRING,
         "Unsupported model format: " << fbModelCore->FormatVersion()->str()
     );
     if (fbModelCore->ObliviousTrees()) {
-        ObliviousTrees.FBDeserialize(fbModelCore->ObliviousTrees());
+        model->ObliviousTrees.FBDeserialize(fbModelCore->ObliviousTrees());
     }
-    ModelInfo.clear();
+    model->ModelInfo.clear();
     if (fbModelCore->InfoMap()) {
         for (auto keyVal : *fbModelCore->InfoMap()) {
-            ModelInfo[keyVal->Key()->str()] = keyVal->Value()->str();
+            model->ModelInfo[keyVal->Key()->str()] = keyVal->Value()->str();
         }
     }
     TVector<TString> modelParts;
@@ -589,13 +966,46 @@ void TFullModel::Load(IInputStream* s) {
     }
     if (!modelParts.empty()) {
         CB_ENSURE(modelParts.size() == 1, "only single part model supported now");
+        CB_ENSURE(modelParts[0] == TStaticCtrProvider().ModelPartIdentifier(), "only static ctr models supported");
+    }
+    return modelParts;
+}
+
+void TFullModel::Load(IInputStream* s) {
+    ui32 fileDescriptor;
+    ::Load(s, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(s);
+    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
+    s->LoadOrFail(arrayHolder.Get(), coreSize);
+
+    const auto modelParts = DeserializeModelCore(arrayHolder.Get(), coreSize, this);
+    if (!modelParts.empty()) {
         CtrProvider = new TStaticCtrProvider;
-        CB_ENSURE(modelParts[0] == CtrProvider->ModelPartIdentifier(), "only static ctr models supported");
         CtrProvider->Load(s);
     }
     UpdateDynamicData();
 }
 
+void TFullModel::InitNonOwning(const TBlob& modelBlob) {
+    TMemoryInput in(modelBlob.Data(), modelBlob.Size());
+    ui32 fileDescriptor;
+    ::Load(&in, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(&in);
+    CB_ENSURE(coreSize <= in.Avail(), "Model data is truncated");
+    const ui8* coreData = reinterpret_cast<const ui8*>(in.Buf());
+    in.Skip(coreSize);
+
+    const auto modelParts = DeserializeModelCore(coreData, coreSize, this);
+    if (!modelParts.empty()) {
+        TIntrusivePtr<TStaticCtrProvider> ctrProvider = new TStaticCtrProvider;
+        ctrProvider->LoadNonOwning(&in, modelBlob);
+        CtrProvider = ctrProvider;
+    }
+    UpdateDynamicData();
+}
+
 TVector<TString> GetModelUsedFeaturesNames(const TFullModel& model) {
     TVector<int> featuresIdxs;
     TVector<TString> featuresNames;
@@ -708,27 +1118,8 @@ namespace {
 }
 
 static void StreamModelTreesToBuilder(const TObliviousTrees& trees, double leafMultiplier, TObliviousTreeBuilder* builder) {
-    const auto& binFeatures = trees.GetBinFeatures();
-    const auto& leafOffsets = trees.GetFirstLeafOffsets();
     for (size_t treeIdx = 0; treeIdx < trees.TreeSizes.size(); ++treeIdx) {
-        TVector<TModelSplit> modelSplits;
-        for (int splitIdx = trees.TreeStartOffsets[treeIdx]; splitIdx < trees.TreeStartOffsets[treeIdx] + trees.TreeSizes[treeIdx]; ++splitIdx) {
-            modelSplits.push_back(binFeatures[trees.TreeSplits[splitIdx]]);
-        }
-        if (leafMultiplier == 1.0) {
-            TConstArrayRef<double> leafValuesRef(
-                    trees.LeafValues.begin() + leafOffsets[treeIdx],
-                    trees.LeafValues.begin() + leafOffsets[treeIdx] + trees.ApproxDimension * (1u << trees.TreeSizes[treeIdx]));
-            builder->AddTree(modelSplits, leafValuesRef, trees.LeafWeights[treeIdx]);
-        } else {
-            TVector<double> leafValues(
-                    trees.LeafValues.begin() + leafOffsets[treeIdx],
-                    trees.LeafValues.begin() + leafOffsets[treeIdx] + trees.ApproxDimension * (1u << trees.TreeSizes[treeIdx]));
-            for (auto& leafValue: leafValues) {
-                leafValue *= leafMultiplier;
-            }
-            builder->AddTree(modelSplits, leafValues, trees.LeafWeights[treeIdx]);
-        }
+        AddTreeToBuilder(trees, treeIdx, leafMultiplier, builder);
     }
 }
 
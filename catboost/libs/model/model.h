@@ -11,11 +11,15 @@
 #include <catboost/libs/options/output_file_options.h>
 
 #include <library/json/json_reader.h>
+#include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/hash.h>
+#include <util/memory/blob.h>
 #include <util/stream/file.h>
 #include <util/system/mutex.h>
 
 class TModelPartsCachingSerializer;
+class TModelEvaluationContext;
 
 /*!
     \brief Oblivious tree model structure
@@ -38,6 +42,13 @@ class TModelPartsCachingSerializer;
     - TreeSplits - holds all binary feature indexes from all the trees.
     - TreeSizes - holds tree depth.
     - TreeStartOffsets - holds offset of first tree split in TreeSplits vector
+
+    Model can also contain non-symmetric trees (see IsOblivious()), then every tree is stored as an array of nodes:
+    - TreeSplits - holds binary feature index of every node (0 for nodes without split)
+    - TreeSizes - holds node count
+    - TreeStartOffsets - holds offset of tree root node
+    - NonSymmetricStepNodes - holds steps from a node to its children in node array
+    - NonSymmetricNodeIdToLeafId - holds offset in LeafValues of the leaf where a zero step ends
 */
 struct TRepackedBin {
     ui16 FeatureIndex = 0;
@@ -45,6 +56,23 @@ struct TRepackedBin {
     ui8 SplitIdx = 0;
 };
 
+/**
+ * Steps from a non-symmetric tree node to its children in node array,
+ * zero step means that objects going in that direction end in the leaf of this node.
+ */
+struct TNonSymmetricTreeStepNode {
+    ui16 LeftSubtreeDiff = 0;
+    ui16 RightSubtreeDiff = 0;
+
+    bool operator==(const TNonSymmetricTreeStepNode& other) const {
+        return std::tie(LeftSubtreeDiff, RightSubtreeDiff) == std::tie(other.LeftSubtreeDiff, other.RightSubtreeDiff);
+    }
+
+    bool IsTerminal() const {
+        return !LeftSubtreeDiff && !RightSubtreeDiff;
+    }
+};
+
 struct TObliviousTrees {
 
     /**
@@ -80,6 +108,9 @@ struct TObliviousTrees {
 
         ui32 EffectiveBinFeaturesBucketCount = 0;
 
+        //! Categorical feature index -> index among used categorical features (row in transposed hashes)
+        THashMap<int, int> UsedCatFeaturesPackedIndexes;
+
         //! Offset of first tree leaf in flat tree leafs array
         TVector<size_t> TreeFirstLeafOffsets;
     };
@@ -109,6 +140,12 @@ struct TObliviousTrees {
      */
     TVector<TVector<double>> LeafWeights;
 
+    //! Non-symmetric trees only, layout: [nodeIndex]
+    TVector<TNonSymmetricTreeStepNode> NonSymmetricStepNodes;
+
+    //! Non-symmetric trees only, offset of node leaf in LeafValues or Max<ui32>() if both node steps are not zero
+    TVector<ui32> NonSymmetricNodeIdToLeafId;
+
     //! Categorical features, used in model in OneHot conditions or/and in CTR feature combinations
     TVector<TCatFeature> CatFeatures;
 
@@ -149,11 +186,26 @@ struct TObliviousTrees {
         if (fbObj->LeafValues()) {
             LeafValues.assign(fbObj->LeafValues()->begin(), fbObj->LeafValues()->end());
         }
+        if (fbObj->NonSymmetricStepNodes()) {
+            NonSymmetricStepNodes.resize(fbObj->NonSymmetricStepNodes()->size());
+            for (size_t nodeIdx = 0; nodeIdx < NonSymmetricStepNodes.size(); ++nodeIdx) {
+                const auto* fbNode = fbObj->NonSymmetricStepNodes()->Get(nodeIdx);
+                NonSymmetricStepNodes[nodeIdx].LeftSubtreeDiff = fbNode->LeftSubtreeDiff();
+                NonSymmetricStepNodes[nodeIdx].RightSubtreeDiff = fbNode->RightSubtreeDiff();
+            }
+        }
+        if (fbObj->NonSymmetricNodeIdToLeafId()) {
+            NonSymmetricNodeIdToLeafId.assign(
+                fbObj->NonSymmetricNodeIdToLeafId()->begin(),
+                fbObj->NonSymmetricNodeIdToLeafId()->end()
+            );
+        }
         if (fbObj->LeafWeights()) {
+            const auto treeLeafCounts = CalcTreeLeafCounts();
             LeafWeights.resize(TreeSizes.size());
             auto leafValIter = fbObj->LeafWeights()->begin();
             for (size_t treeId = 0; treeId < TreeSizes.size(); ++treeId) {
-                const auto treeLeafCout = (1 << TreeSizes[treeId]);
+                const auto treeLeafCout = treeLeafCounts[treeId];
                 LeafWeights[treeId].assign(leafValIter, leafValIter + treeLeafCout);
                 leafValIter += treeLeafCout;
             }
@@ -193,6 +245,8 @@ struct TObliviousTrees {
                         TreeSizes,
                         TreeStartOffsets,
                         LeafValues,
+                        NonSymmetricStepNodes,
+                        NonSymmetricNodeIdToLeafId,
                         CatFeatures,
                         FloatFeatures,
                         OneHotFeatures,
@@ -202,6 +256,8 @@ struct TObliviousTrees {
                        other.TreeSizes,
                        other.TreeStartOffsets,
                        other.LeafValues,
+                       other.NonSymmetricStepNodes,
+                       other.NonSymmetricNodeIdToLeafId,
                        other.CatFeatures,
                        other.FloatFeatures,
                        other.OneHotFeatures,
@@ -213,6 +269,14 @@ struct TObliviousTrees {
     size_t GetTreeCount() const {
         return TreeSizes.size();
     }
+
+    //! False if trees are stored as node arrays
+    bool IsOblivious() const {
+        return NonSymmetricStepNodes.empty();
+    }
+
+    //! Number of leaves in each tree (leaf values count is multiplied by ApproxDimension)
+    TVector<size_t> CalcTreeLeafCounts() const;
     /**
      * Truncate oblivous trees to contain only trees from [begin; end) interval.
      * @param begin
@@ -314,6 +378,21 @@ struct TObliviousTrees {
         return GetBinFeatures().size();
     }
 
+    bool AreAllBordersSorted() const {
+        return AllBordersAreSorted;
+    }
+
+    /**
+     * Internal usage only. Checks borders of all float and CTR features once per model, so that
+     * evaluation only reads the result. Should be called after any modifications of borders.
+     */
+    void UpdateBordersSortedness();
+
+    const THashMap<int, int>& GetUsedCatFeaturesPackedIndexes() const {
+        CB_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        return MetaData->UsedCatFeaturesPackedIndexes;
+    }
+
     ui32 GetEffectiveBinaryFeaturesBucketsCount() const {
         CB_ENSURE(MetaData.Defined(), "metadata should be initialized");
         return MetaData->EffectiveBinFeaturesBucketCount;
@@ -327,6 +406,9 @@ struct TObliviousTrees {
     }
 private:
     mutable TMaybe<TMetaData> MetaData;
+
+    //! All float and CTR feature borders are sorted, so binarization can use binary search
+    bool AllBordersAreSorted = true;
 };
 
 /*!
@@ -434,6 +516,14 @@ struct TFullModel {
      */
     void Load(IInputStream* s);
 
+    /**
+     * Deserialize model from binary model data without copying ctr tables: ctr value tables reference
+     * modelBlob memory and blob is kept alive by ctr provider. Trees, borders and leaf values are copied
+     * to model vectors, they are small compared to ctr tables of models with categorical features.
+     * @param modelBlob blob with model saved in CatboostBinary format
+     */
+    void InitNonOwning(const TBlob& modelBlob);
+
     //! Check if TFullModel instance has valid CTR provider.
     // If no ctr features present it will return true
     bool HasValidCtrProvider() const {
@@ -474,6 +564,29 @@ struct TFullModel {
         CalcFlat(features, 0, ObliviousTrees.TreeSizes.size(), results);
     }
 
+    /**
+     * Parallel version of CalcFlat. Documents are split between executor threads and the calling thread,
+     * if there are too few documents to occupy all threads tree range is split too.
+     * @param[in] features vector of flat features array reference. First dimension is object index, second dimension is feature index.
+     * @param[in] treeStart Index of first tree in model to start evaluation
+     * @param[in] treeEnd Index of tree after the last tree in model to evaluate
+     * @param[out] results Flat double vector with indexation [objectIndex * ApproxDimension + classId].
+     * @param[in] executor executor to run evaluation tasks on, nullptr means single threaded evaluation
+     */
+    void CalcFlat(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor) const;
+
+    /**
+     * Parallel CalcFlat on all model trees
+     */
+    void CalcFlat(TConstArrayRef<TConstArrayRef<float>> features, TArrayRef<double> results, NPar::TLocalExecutor* executor) const {
+        CalcFlat(features, 0, ObliviousTrees.TreeSizes.size(), results, executor);
+    }
+
     /**
      * Same as CalcFlat method but for one object
      * @param[in] features flat features array reference. First dimension is object index, second dimension is feature index.
@@ -494,6 +607,34 @@ struct TFullModel {
         CalcFlatSingle(features, 0, ObliviousTrees.TreeSizes.size(), results);
     }
 
+    /**
+     * Same as CalcFlat, but all scratch buffers are taken from context, see evaluation_context.h
+     */
+    void CalcFlat(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        TModelEvaluationContext& context) const;
+
+    /**
+     * Same as CalcFlatSingle, but all scratch buffers are taken from context.
+     * Doesn't allocate memory if context was already used with this model.
+     */
+    void CalcFlatSingle(
+        TConstArrayRef<float> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        TModelEvaluationContext& context) const;
+
+    /**
+     * CalcFlatSingle with context on all trees in the model
+     */
+    void CalcFlatSingle(TConstArrayRef<float> features, TArrayRef<double> results, TModelEvaluationContext& context) const {
+        CalcFlatSingle(features, 0, ObliviousTrees.TreeSizes.size(), results, context);
+    }
+
     /**
      * Shortcut for CalcFlatSingle
      */
@@ -550,6 +691,16 @@ struct TFullModel {
         Calc(floatFeatures, catFeatures, 0, ObliviousTrees.TreeSizes.size(), results);
     }
 
+    /**
+     * Parallel version of Calc with hashed categorical features, see parallel CalcFlat for details
+     */
+    void Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+              TConstArrayRef<TConstArrayRef<int>> catFeatures,
+              size_t treeStart,
+              size_t treeEnd,
+              TArrayRef<double> results,
+              NPar::TLocalExecutor* executor) const;
+
     /**
      * Evaluate raw formula prediction for one object. Uses all model trees
      * @param floatFeatures
@@ -564,6 +715,45 @@ struct TFullModel {
         Calc(floatFeaturesArray, catFeaturesArray, result);
     }
 
+    /**
+     * Same as Calc with hashed categorical features, but all scratch buffers are taken from context
+     */
+    void Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+              TConstArrayRef<TConstArrayRef<int>> catFeatures,
+              size_t treeStart,
+              size_t treeEnd,
+              TArrayRef<double> results,
+              TModelEvaluationContext& context) const;
+
+    /**
+     * Evaluate raw formula prediction for one object using scratch buffers from context. Uses all model trees
+     * @param floatFeatures
+     * @param catFeatures hashed cat feature values
+     * @param result indexation is [classId]
+     * @param context
+     */
+    void Calc(TConstArrayRef<float> floatFeatures,
+              TConstArrayRef<int> catFeatures,
+              TArrayRef<double> result,
+              TModelEvaluationContext& context) const {
+        const TConstArrayRef<float> floatFeaturesArray[] = {floatFeatures};
+        const TConstArrayRef<int> catFeaturesArray[] = {catFeatures};
+        Calc(floatFeaturesArray, catFeaturesArray, 0, ObliviousTrees.TreeSizes.size(), result, context);
+    }
+
+    /**
+     * Evaluate raw formula prediction for one object with string categorical features using scratch buffers from context.
+     * Uses all model trees
+     * @param floatFeatures
+     * @param catFeatures categorical features strings
+     * @param result indexation is [classId]
+     * @param context
+     */
+    void Calc(TConstArrayRef<float> floatFeatures,
+              TConstArrayRef<TStringBuf> catFeatures,
+              TArrayRef<double> result,
+              TModelEvaluationContext& context) const;
+
     /**
      * Evaluate raw formula predictions for objects. Uses model trees for interval [treeStart, treeEnd)
      * @param floatFeatures
@@ -578,6 +768,16 @@ struct TFullModel {
               size_t treeEnd,
               TArrayRef<double> results) const;
 
+    /**
+     * Parallel version of Calc with string categorical features, see parallel CalcFlat for details
+     */
+    void Calc(TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+              TConstArrayRef<TVector<TStringBuf>> catFeatures,
+              size_t treeStart,
+              size_t treeEnd,
+              TArrayRef<double> results,
+              NPar::TLocalExecutor* executor) const;
+
     /**
      * Evaluate raw formula predictions for objects. Uses all model trees.
      * @param floatFeatures
@@ -610,6 +810,7 @@ struct TFullModel {
      * Updates indexes in CTR provider and recalculates metadata in Oblivious trees after model modifications.
      */
     void UpdateDynamicData() {
+        ObliviousTrees.UpdateBordersSortedness();
         ObliviousTrees.UpdateMetadata();
         if (CtrProvider) {
             CtrProvider->SetupBinFeatureIndexes(
@@ -625,6 +826,19 @@ void OutputModel(const TFullModel& model, IOutputStream* out);
 TFullModel ReadModel(const TString& modelFile, EModelType format = EModelType::CatboostBinary);
 TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelType format = EModelType::CatboostBinary);
 
+/**
+ * Read model in CatboostBinary format from memory buffer, ctr tables reference buffer memory,
+ * so buffer must outlive the model and all its copies.
+ */
+TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize);
+
+/**
+ * Memory map model file in CatboostBinary format and read model with ctr tables referencing mapped memory.
+ * Mapping is released when the model and all its copies are destroyed, so processes loading the same
+ * model share page cache instead of holding private copies of ctr tables.
+ */
+TFullModel LoadFullModelMapped(const TString& modelFile);
+
 /**
  * Export model in our binary or protobuf CoreML format
  * @param model
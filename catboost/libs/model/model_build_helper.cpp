@@ -55,6 +55,7 @@ void TObliviousTreeBuilder::AddTree(const TVector<TModelSplit>& modelSplits,
                                     TConstArrayRef<double> treeLeafValues,
                                     TConstArrayRef<double> treeLeafWeights
 ) {
+    CB_ENSURE(NonSymmetricStepNodes.empty(), "Oblivious and non-symmetric trees can't be mixed in one model");
     CB_ENSURE((1u << modelSplits.size()) * ApproxDimension == treeLeafValues.size());
     LeafValues.insert(LeafValues.end(), treeLeafValues.begin(), treeLeafValues.end());
     if (!treeLeafWeights.empty()) {
@@ -63,10 +64,51 @@ void TObliviousTreeBuilder::AddTree(const TVector<TModelSplit>& modelSplits,
     Trees.emplace_back(modelSplits);
 }
 
+void TObliviousTreeBuilder::AddNonSymmetricTree(const TVector<TModelSplit>& nodeSplits,
+                                                const TVector<TNonSymmetricTreeStepNode>& stepNodes,
+                                                const TVector<ui32>& nodeIdToLeafId,
+                                                TConstArrayRef<double> treeLeafValues,
+                                                TConstArrayRef<double> treeLeafWeights
+) {
+    CB_ENSURE(Trees.empty() || !NonSymmetricStepNodes.empty(), "Oblivious and non-symmetric trees can't be mixed in one model");
+    CB_ENSURE(!nodeSplits.empty(), "Non-symmetric tree should have at least one node");
+    CB_ENSURE(nodeSplits.size() == stepNodes.size() && nodeSplits.size() == nodeIdToLeafId.size());
+    CB_ENSURE(treeLeafValues.size() % ApproxDimension == 0);
+    const ui32 leafCount = treeLeafValues.size() / ApproxDimension;
+    CB_ENSURE(treeLeafWeights.empty() || treeLeafWeights.size() == leafCount);
+    for (auto nodeIdx : xrange(stepNodes.size())) {
+        const auto& stepNode = stepNodes[nodeIdx];
+        CB_ENSURE(nodeIdx + stepNode.LeftSubtreeDiff < stepNodes.size() && nodeIdx + stepNode.RightSubtreeDiff < stepNodes.size(),
+            "Step from node " << nodeIdx << " is out of tree");
+        const bool hasLeaf = !stepNode.LeftSubtreeDiff || !stepNode.RightSubtreeDiff;
+        CB_ENSURE(hasLeaf == (nodeIdToLeafId[nodeIdx] != Max<ui32>()), "Node " << nodeIdx << " leaf mismatches its steps");
+        if (hasLeaf) {
+            CB_ENSURE(nodeIdToLeafId[nodeIdx] < leafCount, "Leaf index of node " << nodeIdx << " is out of range");
+            NonSymmetricNodeIdToLeafId.push_back(LeafValues.size() + nodeIdToLeafId[nodeIdx] * ApproxDimension);
+        } else {
+            NonSymmetricNodeIdToLeafId.push_back(Max<ui32>());
+        }
+    }
+    NonSymmetricStepNodes.insert(NonSymmetricStepNodes.end(), stepNodes.begin(), stepNodes.end());
+    LeafValues.insert(LeafValues.end(), treeLeafValues.begin(), treeLeafValues.end());
+    if (!treeLeafWeights.empty()) {
+        LeafWeights.push_back(TVector<double>(treeLeafWeights.begin(), treeLeafWeights.end()));
+    }
+    Trees.emplace_back(nodeSplits);
+}
+
 TObliviousTrees TObliviousTreeBuilder::Build() {
+    // splits of non-symmetric tree nodes without children are placeholders
+    const auto isSplitUsed = [this] (size_t nodeIdx) {
+        return NonSymmetricStepNodes.empty() || !NonSymmetricStepNodes[nodeIdx].IsTerminal();
+    };
     TSet<TModelSplit> modelSplitSet;
+    size_t nodeIdx = 0;
     for (const auto& tree : Trees) {
         for (const auto& split : tree) {
+            if (!isSplitUsed(nodeIdx++)) {
+                continue;
+            }
             modelSplitSet.insert(split);
             if (split.Type == ESplitType::OnlineCtr) {
                 auto& proj = split.OnlineCtr.Ctr.Base.Projection;
@@ -92,6 +134,8 @@ TObliviousTrees TObliviousTreeBuilder::Build() {
     result.ApproxDimension = ApproxDimension;
     result.LeafValues = LeafValues;
     result.LeafWeights = LeafWeights;
+    result.NonSymmetricStepNodes = NonSymmetricStepNodes;
+    result.NonSymmetricNodeIdToLeafId = NonSymmetricNodeIdToLeafId;
     result.CatFeatures = CatFeatures;
     result.FloatFeatures = FloatFeatures;
     for (auto& feature : result.FloatFeatures) {
@@ -100,9 +144,10 @@ TObliviousTrees TObliviousTreeBuilder::Build() {
     for (auto& feature : result.CatFeatures) {
         feature.UsedInModel = false;
     }
+    nodeIdx = 0;
     for (const auto& treeStruct : Trees) {
         for (const auto& split : treeStruct) {
-            result.TreeSplits.push_back(binFeatureIndexes.at(split));
+            result.TreeSplits.push_back(isSplitUsed(nodeIdx++) ? binFeatureIndexes.at(split) : 0);
         }
         if (result.TreeStartOffsets.empty()) {
             result.TreeStartOffsets.push_back(0);
@@ -136,6 +181,7 @@ TObliviousTrees TObliviousTreeBuilder::Build() {
     for (auto usedCatFeatureIdx : usedCatFeatureIndexes) {
         result.CatFeatures[CatFeaturesInternalIndexesMap.at(usedCatFeatureIdx)].UsedInModel = true;
     }
+    result.UpdateBordersSortedness();
     result.UpdateMetadata();
     return result;
 }
@@ -22,12 +22,25 @@ public:
             const TVector<TVector<double>>& treeLeafValues) {
         AddTree(modelSplits, treeLeafValues, TVector<double>());
     }
+    /* Non-symmetric tree given as node array (see TObliviousTrees), splits of nodes with both zero steps
+     * are ignored. nodeIdToLeafId holds leaf index in treeLeafValues ([leafId * ApproxDimension + dimension])
+     * for nodes with zero steps and Max<ui32>() for other nodes.
+     * Non-symmetric and oblivious trees can't be mixed in one model.
+     */
+    void AddNonSymmetricTree(
+            const TVector<TModelSplit>& nodeSplits,
+            const TVector<TNonSymmetricTreeStepNode>& stepNodes,
+            const TVector<ui32>& nodeIdToLeafId,
+            TConstArrayRef<double> treeLeafValues,
+            TConstArrayRef<double> treeLeafWeights);
     TObliviousTrees Build();
 private:
     int ApproxDimension = 1;
     TVector<TVector<TModelSplit>> Trees;
     TVector<double> LeafValues;
     TVector<TVector<double>> LeafWeights;
+    TVector<TNonSymmetricTreeStepNode> NonSymmetricStepNodes;
+    TVector<ui32> NonSymmetricNodeIdToLeafId;
     TVector<TFloatFeature> FloatFeatures;
     TVector<size_t> FloatFeaturesInternalIndexesMap;
     TVector<TCatFeature> CatFeatures;
@@ -0,0 +1,188 @@
+#include "multi_model_evaluator.h"
+
+#include "evaluation_context.h"
+#include "formula_evaluator.h"
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/map.h>
+#include <util/generic/set.h>
+#include <util/generic/xrange.h>
+
+// nan value treatment doesn't matter for features without nans in learn data
+static bool AreNanValueTreatmentsCompatible(const TFloatFeature& lhs, const TFloatFeature& rhs) {
+    return !lhs.HasNans || !rhs.HasNans || (lhs.NanValueTreatment == rhs.NanValueTreatment);
+}
+
+TMultiModelEvaluator::TMultiModelEvaluator(TConstArrayRef<TFullModel> models)
+    : Models(models.begin(), models.end())
+    , UsesSharedBinarization(models.size(), false)
+{
+    TMap<int, TFloatFeature> floatFeatures;
+    TMap<int, TCatFeature> catFeatures;
+    TMap<int, TSet<int>> oneHotValues;
+    for (auto modelIdx : xrange(Models.size())) {
+        const auto& trees = Models[modelIdx].ObliviousTrees;
+        if (!trees.CtrFeatures.empty()) {
+            continue;
+        }
+        UsesSharedBinarization[modelIdx] = true;
+        for (const auto& feature : trees.FloatFeatures) {
+            if (!feature.UsedInModel()) {
+                continue;
+            }
+            auto iter = floatFeatures.find(feature.FeatureIndex);
+            if (iter == floatFeatures.end()) {
+                floatFeatures.emplace(feature.FeatureIndex, feature);
+                continue;
+            }
+            auto& unionFeature = iter->second;
+            CB_ENSURE(
+                unionFeature.FlatFeatureIndex == feature.FlatFeatureIndex,
+                "Models should be trained on the same feature set, float feature " << feature.FeatureIndex
+                << " has different flat indexes in models");
+            CB_ENSURE(
+                AreNanValueTreatmentsCompatible(unionFeature, feature),
+                "Float feature " << feature.FeatureIndex << " has different nan value treatment in models");
+            if (feature.HasNans && !unionFeature.HasNans) {
+                unionFeature.HasNans = true;
+                unionFeature.NanValueTreatment = feature.NanValueTreatment;
+            }
+            unionFeature.Borders.insert(unionFeature.Borders.end(), feature.Borders.begin(), feature.Borders.end());
+        }
+        for (const auto& feature : trees.CatFeatures) {
+            if (!feature.UsedInModel) {
+                continue;
+            }
+            auto iter = catFeatures.find(feature.FeatureIndex);
+            if (iter == catFeatures.end()) {
+                catFeatures.emplace(feature.FeatureIndex, feature);
+            } else {
+                CB_ENSURE(
+                    iter->second.FlatFeatureIndex == feature.FlatFeatureIndex,
+                    "Models should be trained on the same feature set, categorical feature " << feature.FeatureIndex
+                    << " has different flat indexes in models");
+            }
+        }
+        for (const auto& feature : trees.OneHotFeatures) {
+            oneHotValues[feature.CatFeatureIndex].insert(feature.Values.begin(), feature.Values.end());
+        }
+    }
+
+    auto& unionTrees = BinarizationModel.ObliviousTrees;
+    for (auto& indexAndFeature : floatFeatures) {
+        auto& feature = indexAndFeature.second;
+        SortUnique(feature.Borders);
+        unionTrees.FloatFeatures.push_back(feature);
+    }
+    for (const auto& indexAndFeature : catFeatures) {
+        unionTrees.CatFeatures.push_back(indexAndFeature.second);
+    }
+    for (const auto& indexAndValues : oneHotValues) {
+        auto& feature = unionTrees.OneHotFeatures.emplace_back();
+        feature.CatFeatureIndex = indexAndValues.first;
+        feature.Values.assign(indexAndValues.second.begin(), indexAndValues.second.end());
+    }
+    BinarizationModel.UpdateDynamicData();
+
+    THashMap<TModelSplit, int> unionBinFeatureIndexes;
+    const auto& unionBinFeatures = unionTrees.GetBinFeatures();
+    for (auto binFeatureIdx : xrange(unionBinFeatures.size())) {
+        unionBinFeatureIndexes[unionBinFeatures[binFeatureIdx]] = binFeatureIdx;
+    }
+    for (auto modelIdx : xrange(Models.size())) {
+        if (!UsesSharedBinarization[modelIdx]) {
+            continue;
+        }
+        auto& model = Models[modelIdx];
+        model.ObliviousTrees.UpdateMetadata();
+        const auto& binFeatures = model.ObliviousTrees.GetBinFeatures();
+        for (auto& split : model.ObliviousTrees.TreeSplits) {
+            split = unionBinFeatureIndexes.at(binFeatures[split]);
+        }
+        model.ObliviousTrees.FloatFeatures = unionTrees.FloatFeatures;
+        model.ObliviousTrees.CatFeatures = unionTrees.CatFeatures;
+        model.ObliviousTrees.OneHotFeatures = unionTrees.OneHotFeatures;
+        model.UpdateDynamicData();
+    }
+}
+
+size_t TMultiModelEvaluator::GetSharedBinarizationModelCount() const {
+    return Count(UsesSharedBinarization, true);
+}
+
+void TMultiModelEvaluator::CalcFlat(
+    TConstArrayRef<TConstArrayRef<float>> features,
+    TArrayRef<TArrayRef<double>> results
+) const {
+    CB_ENSURE(results.size() == Models.size(), "Results count should be equal to models count");
+    const size_t docCount = features.size();
+    for (auto modelIdx : xrange(Models.size())) {
+        const auto& model = Models[modelIdx];
+        CB_ENSURE(
+            results[modelIdx].size() == docCount * model.ObliviousTrees.ApproxDimension,
+            "`results` size is insufficient: "
+            LabeledOutput(modelIdx, results[modelIdx].size(), docCount * model.ObliviousTrees.ApproxDimension));
+        if (UsesSharedBinarization[modelIdx]) {
+            Fill(results[modelIdx].begin(), results[modelIdx].end(), 0.0);
+        } else {
+            model.CalcFlat(features, results[modelIdx]);
+        }
+    }
+    if (docCount == 0 || GetSharedBinarizationModelCount() == 0) {
+        return;
+    }
+
+    const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+    TVector<TTreeCalcFunction> calcTreesFunctions(Models.size());
+    for (auto modelIdx : xrange(Models.size())) {
+        if (UsesSharedBinarization[modelIdx]) {
+            calcTreesFunctions[modelIdx] = GetCalcTreesFunction(Models[modelIdx], blockSize);
+        }
+    }
+    TModelEvaluationContext context;
+    context.Prepare(BinarizationModel, blockSize);
+    for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
+        const auto docCountInBlock = Min(blockSize, docCount - blockStart);
+        BinarizeFeatures(
+            BinarizationModel,
+            [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+                return features[index][floatFeature.FlatFeatureIndex];
+            },
+            [&features](const TCatFeature& catFeature, size_t index) -> int {
+                return ConvertFloatCatFeatureToIntHash(features[index][catFeature.FlatFeatureIndex]);
+            },
+            blockStart,
+            blockStart + docCountInBlock,
+            context.BinFeatures,
+            context.TransposedHash,
+            context.Ctrs);
+        for (auto modelIdx : xrange(Models.size())) {
+            if (!UsesSharedBinarization[modelIdx]) {
+                continue;
+            }
+            const auto& model = Models[modelIdx];
+            calcTreesFunctions[modelIdx](
+                model,
+                context.BinFeatures.data(),
+                docCountInBlock,
+                context.IndexesVec.data(),
+                0,
+                model.GetTreeCount(),
+                results[modelIdx].data() + blockStart * model.ObliviousTrees.ApproxDimension);
+        }
+    }
+}
+
+TVector<TVector<double>> TMultiModelEvaluator::CalcFlat(TConstArrayRef<TConstArrayRef<float>> features) const {
+    TVector<TVector<double>> results(Models.size());
+    TVector<TArrayRef<double>> resultRefs;
+    for (auto modelIdx : xrange(Models.size())) {
+        results[modelIdx].resize(features.size() * Models[modelIdx].ObliviousTrees.ApproxDimension);
+        resultRefs.push_back(results[modelIdx]);
+    }
+    CalcFlat(features, resultRefs);
+    return results;
+}
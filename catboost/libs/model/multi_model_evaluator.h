@@ -0,0 +1,44 @@
+#pragma once
+
+#include "model.h"
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+
+/**
+ * Evaluation of several models trained on the same feature set with shared binarization.
+ * Float feature borders and one hot values of all models are merged into one binarization layout,
+ * trees of each model are remapped to that layout, so every block of documents is binarized once
+ * and then trees of all models are applied to the same binarized block.
+ *
+ * Ctr tables are model specific, so models with ctr features are evaluated with their own binarization.
+ * Models are copied into evaluator (ctr providers are shared with source models).
+ */
+class TMultiModelEvaluator {
+public:
+    explicit TMultiModelEvaluator(TConstArrayRef<TFullModel> models);
+
+    size_t GetModelCount() const {
+        return Models.size();
+    }
+
+    //! Number of models that use shared binarization
+    size_t GetSharedBinarizationModelCount() const;
+
+    /**
+     * Evaluate all models on flat feature vectors
+     * @param[in] features vector of flat features array reference. First dimension is object index, second dimension is feature index.
+     * @param[out] results results of model i are written to results[i] with indexation [objectIndex * ApproxDimension + classId]
+     */
+    void CalcFlat(TConstArrayRef<TConstArrayRef<float>> features, TArrayRef<TArrayRef<double>> results) const;
+
+    //! Same as CalcFlat with results allocation, result[i] holds predictions of model i
+    TVector<TVector<double>> CalcFlat(TConstArrayRef<TConstArrayRef<float>> features) const;
+
+private:
+    //! Model without trees which features are union of features of models with shared binarization
+    TFullModel BinarizationModel;
+    //! Source models, models with shared binarization are remapped to BinarizationModel features
+    TVector<TFullModel> Models;
+    TVector<bool> UsesSharedBinarization;
+};
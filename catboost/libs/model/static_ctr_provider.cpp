@@ -78,7 +78,7 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
     auto compressedModelCtrs = NCatboostModelExportHelpers::CompressModelCtrs(neededCtrs);
     size_t samplesCount = docCount;
     TVector<ui64> ctrHashes(samplesCount);
-    TVector<ui64> buckets(samplesCount);
+    TVector<ui32> buckets(samplesCount);
     size_t resultIdx = 0;
     float* resultPtr = result.data();
     TVector<int> transposedCatFeatureIndexes;
@@ -101,10 +101,8 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
             auto& learnCtr = CtrData.LearnCtrs.at(ctr->Base);
             auto hashIndexResolver = learnCtr.GetIndexHashViewer();
             const ECtrType ctrType = ctr->Base.CtrType;
+            hashIndexResolver.GetIndexes(ctrHashes, buckets);
             auto ptrBuckets = buckets.data();
-            for (size_t docId = 0; docId < samplesCount; ++docId) {
-                ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
-            }
             if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
                 const auto emptyVal = ctr->Calc(0.f, 0.f);
                 auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
@@ -228,6 +226,7 @@ void TStaticCtrProvider::SetupBinFeatureIndexes(const TVector<TFloatFeature>& fl
 TIntrusivePtr<ICtrProvider> TStaticCtrProvider::Clone() const {
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
     result->CtrData = CtrData;
+    result->DataHolder = DataHolder;
     return result;
 }
 
@@ -8,6 +8,8 @@
 #include <library/json/json_value.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/memory/blob.h>
+#include <util/stream/mem.h>
 #include <util/system/mutex.h>
 
 
@@ -58,6 +60,15 @@ public:
         ::Load(inp, CtrData);
     }
 
+    /**
+     * Load ctr tables as views into memory of the stream, dataHolder must own that memory
+     * and is kept alive by provider and its clones.
+     */
+    void LoadNonOwning(TMemoryInput* in, const TBlob& dataHolder) {
+        CtrData.LoadNonOwning(in);
+        DataHolder = dataHolder;
+    }
+
     TString ModelPartIdentifier() const override {
         return "static_provider_v1";
     }
@@ -78,6 +89,7 @@ private:
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
+    TBlob DataHolder;
 };
 
 struct TStaticCtrOnFlightSerializationProvider: public ICtrProvider {
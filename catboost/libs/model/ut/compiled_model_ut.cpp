@@ -0,0 +1,135 @@
+#include <catboost/libs/model/compiled_model.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+static TFullModel RandomDepthsModel(int approxDimension, TFastRng64* rng) {
+    TFullModel model;
+    model.ObliviousTrees.FloatFeatures = {
+        TFloatFeature{
+            false, 0, 0,
+            {}, // bin splits 0..19
+            ""
+        },
+        TFloatFeature{
+            false, 1, 1,
+            {}, // bin splits 20..39
+            ""
+        }
+    };
+    for (auto& feature : model.ObliviousTrees.FloatFeatures) {
+        for (auto i : xrange(20)) {
+            feature.Borders.push_back(i * 0.05f);
+        }
+    }
+    model.ObliviousTrees.ApproxDimension = approxDimension;
+    for (auto treeIdx : xrange(50)) {
+        const int depth = treeIdx % 12;
+        TVector<int> splits;
+        for (auto depthIdx : xrange(depth)) {
+            Y_UNUSED(depthIdx);
+            splits.push_back(rng->Uniform(40));
+        }
+        model.ObliviousTrees.AddBinTree(splits);
+        for (auto leafIdx : xrange((1 << depth) * approxDimension)) {
+            Y_UNUSED(leafIdx);
+            model.ObliviousTrees.LeafValues.push_back(rng->GenRandReal1() - 0.5);
+        }
+    }
+    model.UpdateDynamicData();
+    return model;
+}
+
+Y_UNIT_TEST_SUITE(TCompiledModelTest) {
+    Y_UNIT_TEST(TestDepthGroups) {
+        TFastRng64 rng(0);
+        const auto model = RandomDepthsModel(1, &rng);
+        const TCompiledModel compiledModel(model, ECompiledLeafType::Float);
+        const auto& depthGroups = compiledModel.GetDepthGroups();
+        UNIT_ASSERT_VALUES_EQUAL(depthGroups.size(), 12);
+        size_t treeCount = 0;
+        for (auto i : xrange(depthGroups.size())) {
+            const auto& group = depthGroups[i];
+            UNIT_ASSERT_VALUES_EQUAL(group.Depth, i);
+            UNIT_ASSERT_VALUES_EQUAL(group.Splits.size(), group.TreeCount * group.Depth);
+            UNIT_ASSERT_VALUES_EQUAL(group.FloatLeafValues.size(), group.TreeCount << group.Depth);
+            UNIT_ASSERT(group.DoubleLeafValues.empty());
+            treeCount += group.TreeCount;
+        }
+        UNIT_ASSERT_VALUES_EQUAL(treeCount, model.GetTreeCount());
+    }
+
+    Y_UNIT_TEST(TestCalcFlat) {
+        TFastRng64 rng(42);
+        for (int approxDimension : {1, 3}) {
+            const auto model = RandomDepthsModel(approxDimension, &rng);
+            for (size_t docCount : {1, 7, 128, 300}) {
+                TVector<TVector<float>> data(docCount);
+                for (auto& doc : data) {
+                    doc = {(float)rng.GenRandReal1(), (float)rng.GenRandReal1()};
+                }
+                TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+                TVector<double> canonResult(docCount * approxDimension);
+                model.CalcFlat(features, canonResult);
+                for (auto leafType : {ECompiledLeafType::Double, ECompiledLeafType::Float, ECompiledLeafType::Int16}) {
+                    const TCompiledModel compiledModel(model, leafType);
+                    const double eps = compiledModel.GetMaxErrorBound() + 1e-9;
+                    TVector<double> result(docCount * approxDimension);
+                    compiledModel.CalcFlat(features, result);
+                    for (auto i : xrange(result.size())) {
+                        UNIT_ASSERT_DOUBLES_EQUAL(canonResult[i], result[i], eps);
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestAccuracyReport) {
+        TFastRng64 rng(17);
+        const auto model = RandomDepthsModel(3, &rng);
+        TVector<TVector<float>> data(1000);
+        for (auto& doc : data) {
+            doc = {(float)rng.GenRandReal1(), (float)rng.GenRandReal1()};
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+
+        const TCompiledModel doubleModel(model, ECompiledLeafType::Double);
+        const auto doubleReport = CalcCompiledModelAccuracyReport(model, doubleModel, features);
+        UNIT_ASSERT_VALUES_EQUAL(doubleReport.ObjectCount, data.size());
+        UNIT_ASSERT_VALUES_EQUAL(doubleReport.MaxErrorBound, 0.0);
+        UNIT_ASSERT(doubleReport.MaxAbsError < 1e-9);
+
+        size_t prevByteSize = doubleModel.GetLeafValuesByteSize();
+        double prevErrorBound = 0;
+        for (auto leafType : {ECompiledLeafType::Float, ECompiledLeafType::Int16}) {
+            const TCompiledModel compiledModel(model, leafType);
+            const auto report = CalcCompiledModelAccuracyReport(model, compiledModel, features);
+            UNIT_ASSERT(report.MaxAbsError <= report.MaxErrorBound + 1e-9);
+            UNIT_ASSERT(report.MeanAbsError <= report.MaxAbsError);
+            UNIT_ASSERT(report.MaxErrorBound > prevErrorBound);
+            UNIT_ASSERT(compiledModel.GetLeafValuesByteSize() < prevByteSize);
+            prevByteSize = compiledModel.GetLeafValuesByteSize();
+            prevErrorBound = report.MaxErrorBound;
+        }
+    }
+
+    Y_UNIT_TEST(TestOwnedModel) {
+        TFastRng64 rng(3);
+        auto model = RandomDepthsModel(1, &rng);
+        TVector<TVector<float>> data(100);
+        for (auto& doc : data) {
+            doc = {(float)rng.GenRandReal1(), (float)rng.GenRandReal1()};
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+        TVector<double> canonResult(data.size());
+        TCompiledModel(model, ECompiledLeafType::Int16).CalcFlat(features, canonResult);
+
+        const TCompiledModel ownedModel(std::move(model), ECompiledLeafType::Int16);
+        UNIT_ASSERT(ownedModel.GetModel().ObliviousTrees.LeafValues.empty());
+        TVector<double> result(data.size());
+        ownedModel.CalcFlat(features, result);
+        UNIT_ASSERT_VALUES_EQUAL(canonResult, result);
+    }
+}
@@ -1,11 +1,12 @@
+#include "model_test_helpers.h"
+
 #include <library/unittest/registar.h>
 
-#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/model/evaluation_context.h>
 #include <catboost/libs/model/formula_evaluator.h>
 #include <catboost/libs/model/model.h>
-#include <catboost/libs/train_lib/train_model.h>
 
-#include <util/folder/tempdir.h>
+#include <util/random/fast.h>
 
 
 using namespace NCB;
@@ -73,54 +74,6 @@ static TFullModel MultiValueFloatModel() {
     return model;
 }
 
-// Deterministically train model that has only 3 categoric features.
-static TFullModel TrainCatOnlyModel() {
-    TTempDir trainDir;
-
-    TDataProviders dataProviders;
-    dataProviders.Learn = CreateDataProvider(
-        [&] (IRawFeaturesOrderDataVisitor* visitor) {
-            TDataMetaInfo metaInfo;
-            metaInfo.HasTarget = true;
-            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
-                (ui32)3,
-                TVector<ui32>{0, 1, 2},
-                TVector<TString>{}
-            );
-
-            visitor->Start(metaInfo, 3, EObjectsOrder::Undefined, {});
-
-            visitor->AddCatFeature(0, TConstArrayRef<TStringBuf>{"a", "b", "c"});
-            visitor->AddCatFeature(1, TConstArrayRef<TStringBuf>{"d", "e", "f"});
-            visitor->AddCatFeature(2, TConstArrayRef<TStringBuf>{"g", "h", "k"});
-
-            visitor->AddTarget({1.0f, 0.0f, 0.2f});
-
-            visitor->Finish();
-        }
-    );
-    dataProviders.Test.push_back(dataProviders.Learn);
-
-    TFullModel model;
-    TEvalResult evalResult;
-    NJson::TJsonValue params;
-    params.InsertValue("iterations", 5);
-    params.InsertValue("random_seed", 1);
-    params.InsertValue("train_dir", trainDir.Name());
-    TrainModel(
-        params,
-        nullptr,
-        {},
-        {},
-        std::move(dataProviders),
-        "",
-        &model,
-        {&evalResult}
-    );
-
-    return model;
-}
-
 Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
     Y_UNIT_TEST(TestFlatCalcFloat) {
         auto modelCalcer = SimpleFloatModel();
@@ -189,4 +142,198 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         };
         UNIT_ASSERT_NO_EXCEPTION(applyBatch());
     }
+
+    Y_UNIT_TEST(TestEvaluationContext) {
+        auto modelCalcer = SimpleFloatModel();
+        TModelEvaluationContext context(modelCalcer);
+        const ui8* binFeaturesPtr = context.BinFeatures.data();
+        TFastRng64 rng(0);
+        for (auto i : xrange(100)) {
+            Y_UNUSED(i);
+            const TVector<float> features = {(float)rng.Uniform(600) - 300.0f, (float)rng.Uniform(2), (float)rng.Uniform(2)};
+            double canonResult = 0;
+            modelCalcer.CalcFlatSingle(features, MakeArrayRef(&canonResult, 1));
+            double result = 0;
+            modelCalcer.CalcFlatSingle(features, MakeArrayRef(&result, 1), context);
+            UNIT_ASSERT_VALUES_EQUAL(canonResult, result);
+        }
+        // buffers preallocated for full block are reused
+        UNIT_ASSERT_EQUAL(binFeaturesPtr, context.BinFeatures.data());
+
+        const auto catModel = TrainCatOnlyModel();
+        for (const auto& catFeatures : TVector<TVector<TStringBuf>>{{"a", "b", "c"}, {"d", "e", "f"}, {"a", "h", "z"}}) {
+            double canonResult = 0;
+            catModel.Calc({}, MakeArrayRef(&catFeatures, 1), MakeArrayRef(&canonResult, 1));
+            double result = 0;
+            catModel.Calc({}, catFeatures, MakeArrayRef(&result, 1), context);
+            UNIT_ASSERT_VALUES_EQUAL(canonResult, result);
+        }
+    }
+
+    Y_UNIT_TEST(TestEvaluationKernels) {
+        TFastRng64 rng(42);
+        TVector<float> borders;
+        for (auto i : xrange(300)) {
+            borders.push_back(-150.0f + i);
+        }
+        const size_t bucketCount = (borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
+        const auto& genericKernels = GetEvaluationKernels(EEvaluationIsa::Generic);
+        for (auto isa : {EEvaluationIsa::Sse2, EEvaluationIsa::Avx2, EEvaluationIsa::Avx512}) {
+            if (!IsEvaluationIsaSupported(isa)) {
+                continue;
+            }
+            const auto& kernels = GetEvaluationKernels(isa);
+            for (size_t docCount : {1, 15, 16, 33, 64, 100, 128}) {
+                TVector<float> values(docCount);
+                for (auto& value : values) {
+                    value = rng.GenRandReal1() * 400 - 200;
+                }
+                TVector<ui8> canonBins(docCount * bucketCount);
+                TVector<ui8> bins(docCount * bucketCount);
+                genericKernels.BinarizeFloats(values.data(), docCount, borders, docCount, canonBins.data());
+                kernels.BinarizeFloats(values.data(), docCount, borders, docCount, bins.data());
+                UNIT_ASSERT_VALUES_EQUAL(canonBins, bins);
+
+                if (!kernels.CalcIndexes) {
+                    continue;
+                }
+                for (int depth = 1; depth <= 8; ++depth) {
+                    TVector<TRepackedBin> splits(depth);
+                    for (auto& split : splits) {
+                        split.FeatureIndex = rng.Uniform(bucketCount);
+                        split.SplitIdx = rng.Uniform(256);
+                    }
+                    TVector<ui32> canonIndexes(docCount);
+                    CalcIndexes(false, bins.data(), docCount, canonIndexes.data(), splits.data(), depth);
+                    TVector<ui8> indexes(docCount);
+                    kernels.CalcIndexes(false, bins.data(), docCount, indexes.data(), splits.data(), depth);
+                    UNIT_ASSERT_VALUES_EQUAL(canonIndexes, TVector<ui32>(indexes.begin(), indexes.end()));
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestFlatCalcFloatLargeBatch) {
+        auto modelCalcer = SimpleFloatModel();
+        TFastRng64 rng(0);
+        TVector<TVector<float>> data(1000);
+        for (auto& doc : data) {
+            doc = {(float)rng.Uniform(600) - 300.0f, (float)rng.Uniform(2), (float)rng.Uniform(2)};
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+        TVector<double> result(data.size());
+        modelCalcer.CalcFlat(features, result);
+        for (size_t i = 0; i < data.size(); ++i) {
+            double singleResult = 0;
+            modelCalcer.CalcFlatSingle(data[i], MakeArrayRef(&singleResult, 1));
+            UNIT_ASSERT_VALUES_EQUAL(singleResult, result[i]);
+        }
+    }
+
+    Y_UNIT_TEST(TestBinarySearchBinarization) {
+        TFastRng64 rng(17);
+        for (auto isa : {EEvaluationIsa::Generic, EEvaluationIsa::Sse2, EEvaluationIsa::Avx2, EEvaluationIsa::Avx512}) {
+            if (!IsEvaluationIsaSupported(isa)) {
+                continue;
+            }
+            const auto& kernels = GetEvaluationKernels(isa);
+            for (size_t borderCount : {1, 2, 3, 100, 254, 255, 1024}) {
+                TVector<float> borders;
+                for (auto i : xrange(borderCount)) {
+                    borders.push_back(-1.0f + 2.0f * i / borderCount);
+                }
+                const size_t bucketCount = (borderCount + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
+                for (size_t docCount : {1, 17, 64}) {
+                    TVector<float> values(docCount);
+                    for (auto& value : values) {
+                        value = rng.GenRandReal1() * 3 - 1.5;
+                    }
+                    values[0] = borders[borderCount / 2];
+                    if (docCount > 1) {
+                        values[1] = std::numeric_limits<float>::quiet_NaN();
+                    }
+                    TVector<ui8> canonBins(docCount * bucketCount);
+                    TVector<ui8> bins(docCount * bucketCount);
+                    kernels.BinarizeFloats(values.data(), docCount, borders, docCount, canonBins.data());
+                    kernels.BinarizeFloatsBinarySearch(values.data(), docCount, borders, docCount, bins.data());
+                    UNIT_ASSERT_VALUES_EQUAL(canonBins, bins);
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestFlatCalcManyBorders) {
+        TFullModel model;
+        model.ObliviousTrees.FloatFeatures = {
+            TFloatFeature{
+                false, 0, 0,
+                {}, // bin splits 0..1023
+                ""
+            }
+        };
+        for (auto i : xrange(1024)) {
+            model.ObliviousTrees.FloatFeatures[0].Borders.push_back(i);
+        }
+        model.ObliviousTrees.AddBinTree({100, 500, 1000});
+        model.ObliviousTrees.LeafValues = {0., 1., 2., 3., 4., 5., 6., 7.};
+        model.UpdateDynamicData();
+
+        TVector<TVector<float>> data;
+        TVector<double> canonVals;
+        for (auto i : xrange(300)) {
+            const float value = i * 4 - 100;
+            data.push_back({value});
+            canonVals.push_back((value > 100) + 2 * (value > 500) + 4 * (value > 1000));
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+        TVector<double> result(data.size());
+        model.CalcFlat(features, result);
+        UNIT_ASSERT_VALUES_EQUAL(canonVals, result);
+    }
+
+    Y_UNIT_TEST(TestFlatCalcParallel) {
+        TFastRng64 rng(42);
+        TFullModel model;
+        model.ObliviousTrees.FloatFeatures = {
+            TFloatFeature{
+                false, 0, 0,
+                {-0.5f, 0.0f, 0.5f}, // bin splits 0, 1, 2
+                ""
+            },
+            TFloatFeature{
+                false, 1, 1,
+                {0.5f}, // bin split 3
+                ""
+            }
+        };
+        const size_t treeCount = 7;
+        for (auto treeIdx : xrange(treeCount)) {
+            model.ObliviousTrees.AddBinTree({(int)(treeIdx % 3), 3});
+        }
+        model.ObliviousTrees.ApproxDimension = 2;
+        model.ObliviousTrees.LeafValues.resize(treeCount * 4 * 2);
+        for (auto& leafValue : model.ObliviousTrees.LeafValues) {
+            leafValue = rng.GenRandReal1();
+        }
+        model.UpdateDynamicData();
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        for (size_t docCount : {0, 1, 5, 130, 1000}) {
+            TVector<TVector<float>> data(docCount);
+            for (auto& doc : data) {
+                doc = {(float)rng.GenRandReal1() * 2 - 1, (float)rng.GenRandReal1()};
+            }
+            TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+            for (auto treeEnd : {(size_t)1, (size_t)3, treeCount}) {
+                TVector<double> canonResult(docCount * 2);
+                model.CalcFlat(features, 0, treeEnd, canonResult);
+                TVector<double> result(docCount * 2);
+                model.CalcFlat(features, 0, treeEnd, result, &executor);
+                for (auto i : xrange(result.size())) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(canonResult[i], result[i], 1e-9);
+                }
+            }
+        }
+    }
 }
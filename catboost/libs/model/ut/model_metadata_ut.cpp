@@ -76,4 +76,34 @@ Y_UNIT_TEST_SUITE(TObliviousTreesMetadata) {
         UNIT_ASSERT_EQUAL(model.GetNumFloatFeatures(), model.GetMinimalSufficientFloatFeaturesVectorSize());
         UNIT_ASSERT_EQUAL(model.GetNumCatFeatures(), model.GetMinimalSufficientCatFeaturesVectorSize());
     }
+
+    Y_UNIT_TEST(TestBordersSortedness) {
+        TFullModel model;
+        model.ObliviousTrees.FloatFeatures = {
+            TFloatFeature {
+                false, 0, 0,
+                {1.f, 2.f},
+                ""
+            }
+        };
+        model.UpdateDynamicData();
+        UNIT_ASSERT(model.ObliviousTrees.AreAllBordersSorted());
+
+        model.ObliviousTrees.FloatFeatures[0].Borders = {2.f, 1.f};
+        model.UpdateDynamicData();
+        UNIT_ASSERT(!model.ObliviousTrees.AreAllBordersSorted());
+
+        // flag belongs to the model it was computed for
+        TFullModel sortedModel;
+        sortedModel.ObliviousTrees.FloatFeatures = {
+            TFloatFeature {
+                false, 0, 0,
+                {1.f, 2.f},
+                ""
+            }
+        };
+        sortedModel.UpdateDynamicData();
+        UNIT_ASSERT(sortedModel.ObliviousTrees.AreAllBordersSorted());
+        UNIT_ASSERT(!model.ObliviousTrees.AreAllBordersSorted());
+    }
 }
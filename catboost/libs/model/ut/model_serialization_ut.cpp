@@ -1,9 +1,31 @@
 #include "model_test_helpers.h"
 
+#include <catboost/libs/model/static_ctr_provider.h>
+
 #include <library/unittest/registar.h>
 
+#include <util/generic/ymath.h>
+#include <util/stream/file.h>
+
 using namespace std;
 
+static void AssertCtrTablesAreThin(const TFullModel& model, TStringBuf modelData = {}) {
+    const auto& ctrProvider = dynamic_cast<const TStaticCtrProvider&>(*model.CtrProvider);
+    UNIT_ASSERT(!ctrProvider.CtrData.LearnCtrs.empty());
+    for (const auto& [ctrBase, table] : ctrProvider.CtrData.LearnCtrs) {
+        Y_UNUSED(ctrBase);
+        UNIT_ASSERT(table.IsThin());
+        const auto buckets = table.GetIndexHashViewer().GetBuckets();
+        const auto blob = table.GetTypedArrayRefForBlobData<char>();
+        UNIT_ASSERT(reinterpret_cast<uintptr_t>(buckets.data()) % CTR_VALUE_TABLE_ALIGNMENT == 0);
+        UNIT_ASSERT(reinterpret_cast<uintptr_t>(blob.data()) % CTR_VALUE_TABLE_ALIGNMENT == 0);
+        if (!modelData.empty()) {
+            UNIT_ASSERT(blob.data() >= modelData.data());
+            UNIT_ASSERT(blob.data() + blob.size() <= modelData.data() + modelData.size());
+        }
+    }
+}
+
 Y_UNIT_TEST_SUITE(TModelSerialization) {
     Y_UNIT_TEST(TestSerializeDeserializeFullModel) {
         TFullModel trainedModel = TrainFloatCatboostModel();
@@ -23,4 +45,31 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.LeafValues, deserializedModel.ObliviousTrees.LeafValues);
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.TreeSplits, deserializedModel.ObliviousTrees.TreeSplits);
     }
+
+    Y_UNIT_TEST(TestMappedModelWithCtrs) {
+        TFullModel trainedModel = TrainCatOnlyModel();
+        OutputModel(trainedModel, "model_with_ctrs.cbm");
+
+        const TFullModel mappedModel = LoadFullModelMapped("model_with_ctrs.cbm");
+        UNIT_ASSERT_EQUAL(trainedModel, mappedModel);
+        AssertCtrTablesAreThin(mappedModel);
+
+        const TVector<TStringBuf> catFeatures[] = {{"a", "b", "c"}, {"d", "e", "f"}, {"g", "h", "k"}, {"a", "e", "x"}};
+        TVector<double> canonResults(Y_ARRAY_SIZE(catFeatures));
+        trainedModel.Calc({}, catFeatures, canonResults);
+        TVector<double> mappedResults(Y_ARRAY_SIZE(catFeatures));
+        mappedModel.Calc({}, catFeatures, mappedResults);
+        UNIT_ASSERT_EQUAL(canonResults, mappedResults);
+
+        const TString modelFileData = TIFStream("model_with_ctrs.cbm").ReadAll();
+        // zero-copy tables need a buffer aligned at least as the file mapping is
+        TVector<ui64> alignedBuffer(CeilDiv(modelFileData.size(), sizeof(ui64)));
+        memcpy(alignedBuffer.data(), modelFileData.data(), modelFileData.size());
+        const TStringBuf modelData(reinterpret_cast<const char*>(alignedBuffer.data()), modelFileData.size());
+        const TFullModel zeroCopyModel = ReadZeroCopyModel(modelData.data(), modelData.size());
+        AssertCtrTablesAreThin(zeroCopyModel, modelData);
+        TVector<double> zeroCopyResults(Y_ARRAY_SIZE(catFeatures));
+        zeroCopyModel.Calc({}, catFeatures, zeroCopyResults);
+        UNIT_ASSERT_EQUAL(canonResults, zeroCopyResults);
+    }
 }
@@ -5,6 +5,7 @@
 #include <catboost/libs/data_new/ut/lib/for_loader.h>
 #include <catboost/libs/train_lib/train_model.h>
 
+#include <util/folder/tempdir.h>
 #include <util/string/builder.h>
 
 
@@ -72,6 +73,54 @@ TFullModel TrainFloatCatboostModel(int iterations, int seed) {
     return model;
 }
 
+// Deterministically train model that has only 3 categoric features.
+TFullModel TrainCatOnlyModel() {
+    TTempDir trainDir;
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                (ui32)3,
+                TVector<ui32>{0, 1, 2},
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, 3, EObjectsOrder::Undefined, {});
+
+            visitor->AddCatFeature(0, TConstArrayRef<TStringBuf>{"a", "b", "c"});
+            visitor->AddCatFeature(1, TConstArrayRef<TStringBuf>{"d", "e", "f"});
+            visitor->AddCatFeature(2, TConstArrayRef<TStringBuf>{"g", "h", "k"});
+
+            visitor->AddTarget({1.0f, 0.0f, 0.2f});
+
+            visitor->Finish();
+        }
+    );
+    dataProviders.Test.push_back(dataProviders.Learn);
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 5);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", trainDir.Name());
+    TrainModel(
+        params,
+        nullptr,
+        {},
+        {},
+        std::move(dataProviders),
+        "",
+        &model,
+        {&evalResult}
+    );
+
+    return model;
+}
+
 TDataProviderPtr GetAdultPool() {
     TSrcData srcData;
     srcData.DsvFileData =
@@ -5,4 +5,7 @@
 
 TFullModel TrainFloatCatboostModel(int iterations = 5, int seed = 123);
 
+// Deterministically train model that has only 3 categoric features.
+TFullModel TrainCatOnlyModel();
+
 NCB::TDataProviderPtr GetAdultPool();
@@ -0,0 +1,125 @@
+#include "model_test_helpers.h"
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/model/multi_model_evaluator.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+// Random model on 3 float features and 1 categorical feature used in one hot splits, borders differ between models
+static TFullModel RandomOneHotModel(int approxDimension, TFastRng64* rng) {
+    TVector<TFloatFeature> floatFeatures;
+    for (auto featureIdx : xrange(3)) {
+        floatFeatures.emplace_back(false, featureIdx, featureIdx, TVector<float>());
+    }
+    TVector<TCatFeature> catFeatures(1);
+    catFeatures[0].FeatureIndex = 0;
+    catFeatures[0].FlatFeatureIndex = 3;
+    TObliviousTreeBuilder builder(floatFeatures, catFeatures, approxDimension);
+    for (auto treeIdx : xrange(20)) {
+        const int depth = 1 + treeIdx % 6;
+        TVector<TModelSplit> splits;
+        for (auto depthIdx : xrange(depth)) {
+            Y_UNUSED(depthIdx);
+            if (rng->Uniform(4) == 0) {
+                splits.emplace_back(TOneHotSplit(0, rng->Uniform(5)));
+            } else {
+                splits.emplace_back(TFloatSplit(rng->Uniform(3), rng->Uniform(100) / 100.0f));
+            }
+        }
+        TVector<double> leafValues((1 << depth) * approxDimension);
+        for (auto& value : leafValues) {
+            value = rng->GenRandReal1() - 0.5;
+        }
+        builder.AddTree(splits, leafValues, {});
+    }
+    TFullModel model;
+    model.ObliviousTrees = builder.Build();
+    model.UpdateDynamicData();
+    return model;
+}
+
+Y_UNIT_TEST_SUITE(TMultiModelEvaluatorTest) {
+    Y_UNIT_TEST(TestSharedBinarization) {
+        TFastRng64 rng(0);
+        TVector<TFullModel> models;
+        for (int approxDimension : {1, 3, 1, 2}) {
+            models.push_back(RandomOneHotModel(approxDimension, &rng));
+        }
+        const TMultiModelEvaluator evaluator(models);
+        UNIT_ASSERT_VALUES_EQUAL(evaluator.GetSharedBinarizationModelCount(), models.size());
+        for (size_t docCount : {1, 5, 128, 300}) {
+            TVector<TVector<float>> data(docCount);
+            for (auto& doc : data) {
+                doc = {
+                    (float)rng.GenRandReal1(),
+                    (float)rng.GenRandReal1(),
+                    (float)rng.GenRandReal1(),
+                    ConvertCatFeatureHashToFloat(rng.Uniform(6))
+                };
+            }
+            TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+            const auto results = evaluator.CalcFlat(features);
+            UNIT_ASSERT_VALUES_EQUAL(results.size(), models.size());
+            for (auto modelIdx : xrange(models.size())) {
+                TVector<double> canonResult(docCount * models[modelIdx].ObliviousTrees.ApproxDimension);
+                models[modelIdx].CalcFlat(features, canonResult);
+                UNIT_ASSERT_VALUES_EQUAL(canonResult, results[modelIdx]);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestNanValueTreatment) {
+        TFastRng64 rng(0);
+        TVector<TFullModel> models;
+        for (auto modelIdx : xrange(2)) {
+            Y_UNUSED(modelIdx);
+            models.push_back(RandomOneHotModel(1, &rng));
+        }
+        auto setNanValueTreatment = [] (TFullModel* model, NCatBoostFbs::ENanValueTreatment nanValueTreatment) {
+            auto& feature = model->ObliviousTrees.FloatFeatures[0];
+            feature.HasNans = true;
+            feature.NanValueTreatment = nanValueTreatment;
+            model->UpdateDynamicData();
+        };
+
+        // feature without nans is compatible with any treatment
+        setNanValueTreatment(&models[1], NCatBoostFbs::ENanValueTreatment_AsFalse);
+        const TMultiModelEvaluator evaluator(models);
+        UNIT_ASSERT_VALUES_EQUAL(evaluator.GetSharedBinarizationModelCount(), models.size());
+        TVector<TVector<float>> data(100);
+        for (auto& doc : data) {
+            doc = {(float)rng.GenRandReal1(), (float)rng.GenRandReal1(), (float)rng.GenRandReal1(), 0.0f};
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+        const auto results = evaluator.CalcFlat(features);
+        for (auto modelIdx : xrange(models.size())) {
+            TVector<double> canonResult(data.size());
+            models[modelIdx].CalcFlat(features, canonResult);
+            UNIT_ASSERT_VALUES_EQUAL(canonResult, results[modelIdx]);
+        }
+
+        setNanValueTreatment(&models[0], NCatBoostFbs::ENanValueTreatment_AsTrue);
+        UNIT_ASSERT_EXCEPTION(TMultiModelEvaluator{models}, TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestCtrModels) {
+        const auto model = TrainCatOnlyModel();
+        const TMultiModelEvaluator evaluator(TVector<TFullModel>{model, model});
+        UNIT_ASSERT_VALUES_EQUAL(evaluator.GetSharedBinarizationModelCount(), model.ObliviousTrees.CtrFeatures.empty() ? 2 : 0);
+        TVector<TVector<float>> data;
+        for (TStringBuf value : {"a", "b", "d", "k"}) {
+            const float hash = ConvertCatFeatureHashToFloat(CalcCatFeatureHash(value));
+            data.push_back({hash, hash, hash});
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+        TVector<double> canonResult(data.size());
+        model.CalcFlat(features, canonResult);
+        for (const auto& result : evaluator.CalcFlat(features)) {
+            UNIT_ASSERT_VALUES_EQUAL(canonResult, result);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_build_helper.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/str.h>
+
+
+/* Tree on 3 float features with borders 0.5:
+ *            f0
+ *          /    \
+ *        f1      leaf 2
+ *       /  \
+ *   leaf 0  f2
+ *          /  \
+ *      leaf 1  leaf 3
+ */
+static TFullModel SimpleNonSymmetricModel(int approxDimension) {
+    TVector<TFloatFeature> floatFeatures;
+    for (auto featureIdx : xrange(3)) {
+        floatFeatures.emplace_back(false, featureIdx, featureIdx, TVector<float>());
+    }
+    TObliviousTreeBuilder builder(floatFeatures, TVector<TCatFeature>(), approxDimension);
+    const TVector<TModelSplit> nodeSplits = {
+        TModelSplit(TFloatSplit(0, 0.5f)),
+        TModelSplit(TFloatSplit(1, 0.5f)),
+        TModelSplit(),
+        TModelSplit(TFloatSplit(2, 0.5f)),
+        TModelSplit(),
+        TModelSplit(),
+        TModelSplit()
+    };
+    // nodes are stored in preorder, leaf-only nodes have both steps zero
+    const TVector<TNonSymmetricTreeStepNode> stepNodes = {
+        {1, 6},
+        {1, 2},
+        {0, 0},
+        {1, 2},
+        {0, 0},
+        {0, 0},
+        {0, 0}
+    };
+    const TVector<ui32> nodeIdToLeafId = {Max<ui32>(), Max<ui32>(), 0, Max<ui32>(), 1, 3, 2};
+    TVector<double> leafValues;
+    for (auto leafIdx : xrange(4)) {
+        for (auto dim : xrange(approxDimension)) {
+            leafValues.push_back(leafIdx + 10 * dim);
+        }
+    }
+    builder.AddNonSymmetricTree(nodeSplits, stepNodes, nodeIdToLeafId, leafValues, {});
+    builder.AddNonSymmetricTree({TModelSplit()}, {{0, 0}}, {0}, TVector<double>(approxDimension, 100.0), {});
+    TFullModel model;
+    model.ObliviousTrees = builder.Build();
+    model.UpdateDynamicData();
+    return model;
+}
+
+static double CanonicalPrediction(TConstArrayRef<float> features, int dim) {
+    double leaf = 0;
+    if (features[0] > 0.5f) {
+        leaf = 2;
+    } else if (features[1] <= 0.5f) {
+        leaf = 0;
+    } else {
+        leaf = features[2] > 0.5f ? 3 : 1;
+    }
+    return leaf + 10 * dim + 100.0;
+}
+
+Y_UNIT_TEST_SUITE(TNonSymmetricTreesTest) {
+    Y_UNIT_TEST(TestEvaluation) {
+        TFastRng64 rng(0);
+        for (int approxDimension : {1, 3}) {
+            const auto model = SimpleNonSymmetricModel(approxDimension);
+            UNIT_ASSERT(!model.ObliviousTrees.IsOblivious());
+            for (size_t docCount : {1, 7, 300}) {
+                TVector<TVector<float>> data(docCount);
+                for (auto& doc : data) {
+                    doc = {(float)rng.GenRandReal1(), (float)rng.GenRandReal1(), (float)rng.GenRandReal1()};
+                }
+                TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+                TVector<double> result(docCount * approxDimension);
+                model.CalcFlat(features, result);
+                for (auto docId : xrange(docCount)) {
+                    for (auto dim : xrange(approxDimension)) {
+                        UNIT_ASSERT_DOUBLES_EQUAL(
+                            result[docId * approxDimension + dim],
+                            CanonicalPrediction(features[docId], dim),
+                            1e-9);
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestSerialization) {
+        const auto model = SimpleNonSymmetricModel(2);
+        TStringStream stream;
+        model.Save(&stream);
+        TFullModel deserializedModel;
+        deserializedModel.Load(&stream);
+        UNIT_ASSERT_EQUAL(model, deserializedModel);
+        UNIT_ASSERT_VALUES_EQUAL(
+            deserializedModel.ObliviousTrees.CalcTreeLeafCounts(),
+            TVector<size_t>({4, 1}));
+    }
+
+    Y_UNIT_TEST(TestTruncate) {
+        auto model = SimpleNonSymmetricModel(1);
+        model.ObliviousTrees.TruncateTrees(1, 2);
+        model.UpdateDynamicData();
+        const TVector<float> doc = {0.f, 1.f, 1.f};
+        TVector<double> result(1);
+        model.CalcFlat(TVector<TConstArrayRef<float>>{doc}, result);
+        UNIT_ASSERT_DOUBLES_EQUAL(result[0], 100.0, 1e-9);
+    }
+}
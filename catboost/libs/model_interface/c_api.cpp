@@ -1,12 +1,51 @@
 #include "c_api.h"
 
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/model/evaluation_context.h>
 #include <catboost/libs/model/model.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/ptr.h>
 #include <util/generic/singleton.h>
 #include <util/stream/file.h>
 #include <util/string/builder.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
+
+struct TModelCalcerHandleImpl {
+    TFullModel Model;
+    /**
+     * Empty if batch prediction is single threaded.
+     * Predictions hold their own reference, so SetPredictionThreadCount may replace executor while
+     * other threads still evaluate on the previous one, it is destroyed when they finish.
+     */
+    TAtomicSharedPtr<NPar::TLocalExecutor> Executor;
+    TAdaptiveLock ExecutorLock;
+
+    TAtomicSharedPtr<NPar::TLocalExecutor> GetExecutor() {
+        auto guard = Guard(ExecutorLock);
+        return Executor;
+    }
 
-#define FULL_MODEL_PTR(x) ((TFullModel*)(x))
+    void SetExecutor(TAtomicSharedPtr<NPar::TLocalExecutor> executor) {
+        with_lock (ExecutorLock) {
+            DoSwap(Executor, executor);
+        }
+        // previous executor is released outside of the lock
+    }
+};
+
+struct TModelEvaluationContextHandleImpl {
+    TModelEvaluationContext Context;
+    TVector<TStringBuf> CatFeatures;
+};
+
+#define CALCER_HANDLE_PTR(x) ((TModelCalcerHandleImpl*)(x))
+#define CONTEXT_HANDLE_PTR(x) ((TModelEvaluationContextHandleImpl*)(x))
+#define FULL_MODEL_PTR(x) (&CALCER_HANDLE_PTR(x)->Model)
+// reference returned by GetExecutor lives until the end of full expression with evaluation call
+#define EXECUTOR_PTR(x) (CALCER_HANDLE_PTR(x)->GetExecutor().Get())
 
 
 struct TErrorMessageHolder {
@@ -16,7 +55,7 @@ struct TErrorMessageHolder {
 extern "C" {
 EXPORT ModelCalcerHandle* ModelCalcerCreate() {
     try {
-        return new TFullModel;
+        return new TModelCalcerHandleImpl;
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
     }
@@ -30,7 +69,26 @@ EXPORT const char* GetErrorString() {
 
 EXPORT void ModelCalcerDelete(ModelCalcerHandle* modelHandle) {
     if (modelHandle != nullptr) {
-        delete FULL_MODEL_PTR(modelHandle);
+        delete CALCER_HANDLE_PTR(modelHandle);
+    }
+}
+
+EXPORT ModelEvaluationContextHandle* ModelEvaluationContextCreate(ModelCalcerHandle* modelHandle) {
+    try {
+        THolder<TModelEvaluationContextHandleImpl> contextHandle = MakeHolder<TModelEvaluationContextHandleImpl>();
+        contextHandle->Context.Prepare(*FULL_MODEL_PTR(modelHandle), 1);
+        contextHandle->CatFeatures.reserve(FULL_MODEL_PTR(modelHandle)->GetNumCatFeatures());
+        return contextHandle.Release();
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+    }
+
+    return nullptr;
+}
+
+EXPORT void ModelEvaluationContextDelete(ModelEvaluationContextHandle* contextHandle) {
+    if (contextHandle != nullptr) {
+        delete CONTEXT_HANDLE_PTR(contextHandle);
     }
 }
 
@@ -56,6 +114,22 @@ EXPORT bool LoadFullModelFromBuffer(ModelCalcerHandle* modelHandle, const void*
     return true;
 }
 
+EXPORT bool SetPredictionThreadCount(ModelCalcerHandle* modelHandle, int threadCount) {
+    try {
+        CB_ENSURE(threadCount > 0, "Thread count should be positive, got " << threadCount);
+        TAtomicSharedPtr<NPar::TLocalExecutor> executor;
+        if (threadCount > 1) {
+            executor = MakeAtomicShared<NPar::TLocalExecutor>();
+            executor->RunAdditionalThreads(threadCount - 1);
+        }
+        CALCER_HANDLE_PTR(modelHandle)->SetExecutor(std::move(executor));
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 EXPORT bool CalcModelPredictionFlat(ModelCalcerHandle* modelHandle, size_t docCount, const float** floatFeatures, size_t floatFeaturesSize, double* result, size_t resultSize) {
     try {
         if (docCount == 1) {
@@ -65,7 +139,7 @@ EXPORT bool CalcModelPredictionFlat(ModelCalcerHandle* modelHandle, size_t docCo
             for (size_t i = 0; i < docCount; ++i) {
                 featuresVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
             }
-            FULL_MODEL_PTR(modelHandle)->CalcFlat(featuresVec, TArrayRef<double>(result, resultSize));
+            FULL_MODEL_PTR(modelHandle)->CalcFlat(featuresVec, TArrayRef<double>(result, resultSize), EXECUTOR_PTR(modelHandle));
         }
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
@@ -89,7 +163,8 @@ EXPORT bool CalcModelPrediction(
                 catFeaturesVec[i][catFeatureIdx] = catFeatures[i][catFeatureIdx];
             }
         }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        const auto& model = *FULL_MODEL_PTR(modelHandle);
+        model.Calc(floatFeaturesVec, catFeaturesVec, 0, model.GetTreeCount(), TArrayRef<double>(result, resultSize), EXECUTOR_PTR(modelHandle));
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
@@ -117,6 +192,47 @@ EXPORT bool CalcModelPredictionSingle(
     return true;
 }
 
+EXPORT bool CalcModelPredictionFlatSingleWithContext(
+        ModelCalcerHandle* modelHandle,
+        ModelEvaluationContextHandle* contextHandle,
+        const float* floatFeatures, size_t floatFeaturesSize,
+        double* result, size_t resultSize) {
+    try {
+        FULL_MODEL_PTR(modelHandle)->CalcFlatSingle(
+            TConstArrayRef<float>(floatFeatures, floatFeaturesSize),
+            TArrayRef<double>(result, resultSize),
+            CONTEXT_HANDLE_PTR(contextHandle)->Context);
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+EXPORT bool CalcModelPredictionSingleWithContext(
+        ModelCalcerHandle* modelHandle,
+        ModelEvaluationContextHandle* contextHandle,
+        const float* floatFeatures, size_t floatFeaturesSize,
+        const char** catFeatures, size_t catFeaturesSize,
+        double* result, size_t resultSize) {
+    try {
+        auto& catFeaturesVec = CONTEXT_HANDLE_PTR(contextHandle)->CatFeatures;
+        catFeaturesVec.resize(catFeaturesSize);
+        for (size_t catFeatureIdx = 0; catFeatureIdx < catFeaturesSize; ++catFeatureIdx) {
+            catFeaturesVec[catFeatureIdx] = catFeatures[catFeatureIdx];
+        }
+        FULL_MODEL_PTR(modelHandle)->Calc(
+            TConstArrayRef<float>(floatFeatures, floatFeaturesSize),
+            catFeaturesVec,
+            TArrayRef<double>(result, resultSize),
+            CONTEXT_HANDLE_PTR(contextHandle)->Context);
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 EXPORT bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* modelHandle, size_t docCount,
                                                      const float** floatFeatures, size_t floatFeaturesSize,
                                                      const int** catFeatures, size_t catFeaturesSize,
@@ -128,7 +244,8 @@ EXPORT bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* modelHan
             floatFeaturesVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
             catFeaturesVec[i] = TConstArrayRef<int>(catFeatures[i], catFeaturesSize);
         }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        const auto& model = *FULL_MODEL_PTR(modelHandle);
+        model.Calc(floatFeaturesVec, catFeaturesVec, 0, model.GetTreeCount(), TArrayRef<double>(result, resultSize), EXECUTOR_PTR(modelHandle));
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
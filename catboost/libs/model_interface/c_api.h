@@ -17,6 +17,7 @@ extern "C" {
 #endif
 
 typedef void ModelCalcerHandle;
+typedef void ModelEvaluationContextHandle;
 
 /**
  * Create empty model handle
@@ -37,6 +38,21 @@ EXPORT void ModelCalcerDelete(ModelCalcerHandle* modelHandle);
  */
 EXPORT const char* GetErrorString();
 
+/**
+ * Create evaluation context for model handle.
+ * Context holds scratch buffers for single object predictions, so predictions with context don't allocate memory.
+ * Context is not thread safe: use one context per thread. Model handle can be shared between threads.
+ * @param calcer model handle, model should be already loaded
+ * @return nullptr if error occured
+ */
+EXPORT ModelEvaluationContextHandle* ModelEvaluationContextCreate(ModelCalcerHandle* modelHandle);
+
+/**
+ * Delete evaluation context handle
+ * @param contextHandle
+ */
+EXPORT void ModelEvaluationContextDelete(ModelEvaluationContextHandle* contextHandle);
+
 /**
  * Load model from file into given model handle
  * @param calcer
@@ -59,6 +75,18 @@ EXPORT bool LoadFullModelFromBuffer(
     const void* binaryBuffer,
     size_t binaryBufferSize);
 
+/**
+ * Use threadCount threads (including calling thread) for batch predictions on this model handle.
+ * Single object predictions are always evaluated in calling thread.
+ * Can be called while other threads run predictions on this handle, they finish on previous threads.
+ * @param calcer model handle
+ * @param threadCount thread count, 1 means single threaded evaluation (default)
+ * @return false if error occured
+ */
+EXPORT bool SetPredictionThreadCount(
+    ModelCalcerHandle* modelHandle,
+    int threadCount);
+
 /**
  * **Use this method only if you really understand what you want.**
  * Calculate raw model predictions on flat feature vectors
@@ -119,6 +147,42 @@ EXPORT bool CalcModelPredictionSingle(
         double* result, size_t resultSize);
 
 
+/**
+ * Same as CalcModelPredictionFlat for single object, but uses scratch buffers from evaluation context
+ * @param calcer model handle
+ * @param contextHandle evaluation context handle
+ * @param floatFeatures flat features array
+ * @param floatFeaturesSize flat features array size
+ * @param result pointer to user allocated results vector (or single double)
+ * @param resultSize result size should be equal to modelApproxDimension
+ * @return false if error occured
+ */
+EXPORT bool CalcModelPredictionFlatSingleWithContext(
+        ModelCalcerHandle* modelHandle,
+        ModelEvaluationContextHandle* contextHandle,
+        const float* floatFeatures, size_t floatFeaturesSize,
+        double* result, size_t resultSize);
+
+/**
+ * Same as CalcModelPredictionSingle, but uses scratch buffers from evaluation context
+ * @param calcer model handle
+ * @param contextHandle evaluation context handle
+ * @param floatFeatures array of float features
+ * @param floatFeaturesSize float feature count
+ * @param catFeatures array of char* categorical feature value pointers.
+ * Each string pointer should point to zero terminated string.
+ * @param catFeaturesSize categorical feature count
+ * @param result pointer to user allocated results vector (or single double)
+ * @param resultSize result size should be equal to modelApproxDimension
+ * @return false if error occured
+ */
+EXPORT bool CalcModelPredictionSingleWithContext(
+        ModelCalcerHandle* modelHandle,
+        ModelEvaluationContextHandle* contextHandle,
+        const float* floatFeatures, size_t floatFeaturesSize,
+        const char** catFeatures, size_t catFeaturesSize,
+        double* result, size_t resultSize);
+
 /**
  * Calculate raw model predictions on float features and hashed categorical feature values
  * @param calcer model handle
@@ -211,6 +211,16 @@ public:
         return InitFromFile(filename);
     }
 
+    /**
+     * Use threadCount threads for batch predictions
+     * @param[in] threadCount
+     */
+    void SetPredictionThreadCount(int threadCount) {
+        if (!::SetPredictionThreadCount(CalcerHolder.get(), threadCount)) {
+            throw std::runtime_error(GetErrorString());
+        }
+    }
+
     size_t GetTreeCount() const {
         return ::GetTreeCount(CalcerHolder.get());
     }
@@ -20,6 +20,23 @@ namespace NCatboostOptions {
                 }
                 break;
             }
+            case EBootstrapType::MVS:
+            case EBootstrapType::GOSS: {
+                if (TaskType == ETaskType::GPU) {
+                    ythrow TCatBoostException()
+                        << "Error: " << type << " bootstrap is not supported on GPU";
+                }
+                if (BaggingTemperature.IsSet()) {
+                    ythrow TCatBoostException() << "Error: bagging temperature available for bayesian bootstrap only";
+                }
+                if (type == EBootstrapType::GOSS) {
+                    CB_ENSURE(
+                        GetGossTopFraction() > 0 && GetGossTopFraction() < GetTakenFraction(),
+                        "GOSS top fraction should be in (0, subsample), current value: " << GetGossTopFraction()
+                    );
+                }
+                break;
+            }
             case EBootstrapType::Poisson: {
                 if (TaskType == ETaskType::CPU) {
                     ythrow TCatBoostException()
@@ -35,6 +52,9 @@ namespace NCatboostOptions {
                 break;
             }
         }
+        if (type != EBootstrapType::GOSS && GossTopFraction.IsSet()) {
+            ythrow TCatBoostException() << "Error: top fraction is available for GOSS bootstrap only";
+        }
     }
 
 }
@@ -13,6 +13,7 @@ namespace NCatboostOptions {
         explicit TBootstrapConfig(ETaskType taskType)
             : TakenFraction("subsample", 0.66f)
             , BaggingTemperature("bagging_temperature", 1.0)
+            , GossTopFraction("goss_top_fraction", 0.2f)
             , BootstrapType("type", EBootstrapType::Bayesian)
             , TaskType(taskType)
         {
@@ -35,6 +36,10 @@ namespace NCatboostOptions {
             return BaggingTemperature.Get();
         }
 
+        float GetGossTopFraction() const {
+            return GossTopFraction.Get();
+        }
+
         void Validate() const;
 
         TOption<float>& GetTakenFraction() {
@@ -45,12 +50,16 @@ namespace NCatboostOptions {
             return BaggingTemperature;
         }
 
+        TOption<float>& GetGossTopFraction() {
+            return GossTopFraction;
+        }
+
         TOption<EBootstrapType>& GetBootstrapType() {
             return BootstrapType;
         }
 
         void Load(const NJson::TJsonValue& options) {
-            CheckedLoad(options, &TakenFraction, &BaggingTemperature, &BootstrapType);
+            CheckedLoad(options, &TakenFraction, &BaggingTemperature, &GossTopFraction, &BootstrapType);
         }
 
         void Save(NJson::TJsonValue* options) const {
@@ -63,6 +72,10 @@ namespace NCatboostOptions {
                     SaveFields(options, BootstrapType);
                     break;
                 }
+                case EBootstrapType::GOSS: {
+                    SaveFields(options, TakenFraction, GossTopFraction, BootstrapType);
+                    break;
+                }
                 default: {
                     SaveFields(options, TakenFraction, BootstrapType);
                     break;
@@ -71,8 +84,8 @@ namespace NCatboostOptions {
         }
 
         bool operator==(const TBootstrapConfig& rhs) const {
-            return std::tie(TakenFraction, BaggingTemperature, BootstrapType) ==
-                   std::tie(rhs.TakenFraction, rhs.BaggingTemperature, rhs.BootstrapType);
+            return std::tie(TakenFraction, BaggingTemperature, GossTopFraction, BootstrapType) ==
+                   std::tie(rhs.TakenFraction, rhs.BaggingTemperature, rhs.GossTopFraction, rhs.BootstrapType);
         }
 
         bool operator!=(const TBootstrapConfig& rhs) const {
@@ -83,6 +96,7 @@ namespace NCatboostOptions {
     private:
         TOption<float> TakenFraction;
         TOption<float> BaggingTemperature;
+        TOption<float> GossTopFraction;
         TOption<EBootstrapType> BootstrapType;
         ETaskType TaskType;
     };
@@ -1,6 +1,7 @@
 #include "cat_feature_options.h"
 #include "json_helper.h"
 #include "restrictions.h"
+#include "system_options.h"
 
 #include <util/charset/utf8.h>
 #include <util/generic/maybe.h>
@@ -228,6 +229,8 @@ NCatboostOptions::TCatFeatureParams::TCatFeatureParams(ETaskType taskType)
     , CounterCalcMethod("counter_calc_method", ECounterCalc::Full)
     , StoreAllSimpleCtrs("store_all_simple_ctr", false, taskType)
     , CtrLeafCountLimit("ctr_leaf_count_limit", Max<ui64>(), taskType)
+    , StreamingOnlineCtrs("streaming_online_ctrs", false, taskType)
+    , OnlineCtrCacheSize("online_ctr_cache_size", "4gb", taskType)
     , TargetBorders("target_borders", TBinarizationOptions(EBorderSelectionType::MinEntropy, 1), taskType)
 {
     TargetBorders.GetUnchecked().DisableNanModeOption();
@@ -236,21 +239,22 @@ NCatboostOptions::TCatFeatureParams::TCatFeatureParams(ETaskType taskType)
 void NCatboostOptions::TCatFeatureParams::Load(const NJson::TJsonValue& options) {
     CheckedLoad(options,
             &SimpleCtrs, &CombinationCtrs, &PerFeatureCtrs, &MaxTensorComplexity, &OneHotMaxSize, &CounterCalcMethod,
-            &StoreAllSimpleCtrs, &CtrLeafCountLimit, &TargetBorders);
+            &StoreAllSimpleCtrs, &CtrLeafCountLimit, &StreamingOnlineCtrs, &OnlineCtrCacheSize, &TargetBorders);
     Validate();
 }
 
 void NCatboostOptions::TCatFeatureParams::Save(NJson::TJsonValue* options) const {
     SaveFields(options,
             SimpleCtrs, CombinationCtrs, PerFeatureCtrs, MaxTensorComplexity, OneHotMaxSize, CounterCalcMethod,
-            StoreAllSimpleCtrs, CtrLeafCountLimit, TargetBorders);
+            StoreAllSimpleCtrs, CtrLeafCountLimit, StreamingOnlineCtrs, OnlineCtrCacheSize, TargetBorders);
 }
 
 bool NCatboostOptions::TCatFeatureParams::operator==(const TCatFeatureParams& rhs) const {
     return std::tie(SimpleCtrs, CombinationCtrs, PerFeatureCtrs, MaxTensorComplexity, OneHotMaxSize, CounterCalcMethod,
-            StoreAllSimpleCtrs, CtrLeafCountLimit, TargetBorders) ==
+            StoreAllSimpleCtrs, CtrLeafCountLimit, StreamingOnlineCtrs, OnlineCtrCacheSize, TargetBorders) ==
         std::tie(rhs.SimpleCtrs, rhs.CombinationCtrs, rhs.PerFeatureCtrs, rhs.MaxTensorComplexity, rhs.OneHotMaxSize,
-                rhs.CounterCalcMethod, rhs.StoreAllSimpleCtrs, rhs.CtrLeafCountLimit, rhs.TargetBorders);
+                rhs.CounterCalcMethod, rhs.StoreAllSimpleCtrs, rhs.CtrLeafCountLimit, rhs.StreamingOnlineCtrs,
+                rhs.OnlineCtrCacheSize, rhs.TargetBorders);
 }
 
 bool NCatboostOptions::TCatFeatureParams::operator!=(const TCatFeatureParams& rhs) const {
@@ -267,6 +271,11 @@ void NCatboostOptions::TCatFeatureParams::Validate() const {
         CB_ENSURE(CtrLeafCountLimit.Get() > 0,
                 "Error: ctr_leaf_count_limit must be positive");
     }
+    if (!OnlineCtrCacheSize.IsUnimplementedForCurrentTask()) {
+        CB_ENSURE(StreamingOnlineCtrs.Get() || !OnlineCtrCacheSize.IsSet(),
+                "Error: online_ctr_cache_size is available with streaming_online_ctrs only");
+        ParseMemorySizeDescription(OnlineCtrCacheSize.Get());
+    }
 }
 
 void NCatboostOptions::TCatFeatureParams::AddSimpleCtrDescription(const TCtrDescription& description) {
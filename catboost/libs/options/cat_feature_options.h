@@ -84,6 +84,8 @@ namespace NCatboostOptions {
 
         TCpuOnlyOption<bool> StoreAllSimpleCtrs;
         TCpuOnlyOption<ui64> CtrLeafCountLimit;
+        TCpuOnlyOption<bool> StreamingOnlineCtrs;
+        TCpuOnlyOption<TString> OnlineCtrCacheSize;
 
         TGpuOnlyOption<TBinarizationOptions> TargetBorders;
     };
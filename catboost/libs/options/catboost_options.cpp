@@ -378,6 +378,18 @@ void NCatboostOptions::TCatBoostOptions::Validate() const {
         }
     }
 
+    const EBootstrapType bootstrapType = ObliviousTreeOptions->BootstrapConfig->GetBootstrapType();
+    if (bootstrapType == EBootstrapType::MVS || bootstrapType == EBootstrapType::GOSS) {
+        CB_ENSURE(BoostingOptions->BoostingType == EBoostingType::Plain, bootstrapType << " bootstrap requires plain boosting");
+        CB_ENSURE(!IsPairwiseScoring(lossFunction), bootstrapType << " bootstrap is not supported for pairwise loss functions");
+        CB_ENSURE(SystemOptions->IsSingleHost(), bootstrapType << " bootstrap is not supported for distributed training");
+    }
+
+    if (ObliviousTreeOptions->GrowingPolicy.GetUnchecked() == EGrowingPolicy::Depthwise) {
+        CB_ENSURE(!IsPairwiseScoring(lossFunction), "Depthwise grow policy is not supported for pairwise loss functions");
+        CB_ENSURE(SystemOptions->IsSingleHost(), "Depthwise grow policy is not supported for distributed training");
+    }
+
     ELeavesEstimation leavesEstimation = ObliviousTreeOptions->LeavesEstimationMethod;
     if (lossFunction == ELossFunction::Quantile ||
         lossFunction == ELossFunction::MAE ||
@@ -416,6 +428,12 @@ void NCatboostOptions::TCatBoostOptions::SetNotSpecifiedOptionsToDefaults() {
         CB_ENSURE(BoostingOptions->BoostingType.IsDefault(), "Boosting type should be plain for " << LossFunctionDescription->GetLossFunction());
     }
 
+    const EBootstrapType bootstrapType = ObliviousTreeOptions->BootstrapConfig->GetBootstrapType();
+    if (bootstrapType == EBootstrapType::MVS || bootstrapType == EBootstrapType::GOSS) {
+        // gradient based sampling uses derivatives of the single body tail of plain boosting
+        BoostingOptions->BoostingType.SetDefault(EBoostingType::Plain);
+    }
+
     switch (LossFunctionDescription->GetLossFunction()) {
         case ELossFunction::QueryCrossEntropy:
         case ELossFunction::YetiRankPairwise:
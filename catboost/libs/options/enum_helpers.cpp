@@ -259,6 +259,8 @@ bool AreZeroWeightsAfterBootstrap(EBootstrapType type) {
     switch (type) {
         case EBootstrapType::Bernoulli:
         case EBootstrapType::Poisson:
+        case EBootstrapType::MVS:
+        case EBootstrapType::GOSS:
             return true;
         default:
             return false;
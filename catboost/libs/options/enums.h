@@ -17,6 +17,11 @@ enum class ESamplingFrequency {
     PerTreeLevel
 };
 
+enum class EGrowingPolicy {
+    SymmetricTree,
+    Depthwise
+};
+
 enum class EFeatureType {
     Float,
     Categorical
@@ -70,6 +75,8 @@ enum class EBootstrapType {
     Poisson,
     Bayesian,
     Bernoulli,
+    MVS,  // minimal variance sampling: objects are taken with probability proportional to gradient norm
+    GOSS, // gradient-based one-side sampling: objects with largest gradients and a uniform sample of the others
     No
 };
 
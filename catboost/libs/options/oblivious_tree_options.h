@@ -33,6 +33,9 @@ namespace NCatboostOptions {
 
         TCpuOnlyOption<ESamplingFrequency> SamplingFrequency;
         TCpuOnlyOption<float> ModelSizeReg;
+        TCpuOnlyOption<EGrowingPolicy> GrowingPolicy;
+        // used only for non-symmetric trees
+        TCpuOnlyOption<ui32> MaxLeaves;
 
         // changing this parameter can affect results due to numerical accuracy differences
         TCpuOnlyOption<ui32> DevScoreCalcObjBlockSize;
@@ -246,6 +246,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "fold_size_loss_normalization", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "add_ridge_penalty_to_loss_function", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "sampling_frequency", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "grow_policy", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "max_leaves", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_max_ctr_complexity_for_border_cache", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "observations_to_bootstrap", &treeOptions, &seenKeys);
 
@@ -255,6 +257,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOptionWithNewKey(plainOptions, "bootstrap_type", "type", &bootstrapOptions, &seenKeys);
     CopyOption(plainOptions, "bagging_temperature", &bootstrapOptions, &seenKeys);
     CopyOption(plainOptions, "subsample", &bootstrapOptions, &seenKeys);
+    CopyOption(plainOptions, "goss_top_fraction", &bootstrapOptions, &seenKeys);
 
     //cat-features
     auto& ctrOptions = trainOptions["cat_feature_params"];
@@ -277,6 +280,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "store_all_simple_ctr", &ctrOptions, &seenKeys);
     CopyOption(plainOptions, "one_hot_max_size", &ctrOptions, &seenKeys);
     CopyOption(plainOptions, "ctr_leaf_count_limit", &ctrOptions, &seenKeys);
+    CopyOption(plainOptions, "streaming_online_ctrs", &ctrOptions, &seenKeys);
+    CopyOption(plainOptions, "online_ctr_cache_size", &ctrOptions, &seenKeys);
 
     //data processing
     auto& dataProcessingOptions = trainOptions["data_processing_options"];
@@ -12,18 +12,38 @@
 #include <catboost/libs/data_util/path_with_scheme.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/resource_holder.h>
 #include <catboost/libs/quantization_schema/serialization.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/mapfindptr.h>
+#include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 #include <util/generic/ylimits.h>
+#include <util/memory/blob.h>
+#include <util/system/align.h>
 #include <util/system/madvise.h>
 #include <util/system/types.h>
 
+#include <climits>
+
 
 namespace NCB {
 
+    namespace {
+        // keeps memory mapped pool file while features data is used in place,
+        // Blobs.front() is the file, the others hold decompressed chunks, see LoadQuantizedPool
+        struct TQuantizedPoolBlobsHolder : public IResourceHolder {
+            TVector<TBlob> Blobs;
+
+        public:
+            explicit TQuantizedPoolBlobsHolder(TVector<TBlob>&& blobs)
+                : Blobs(std::move(blobs))
+            {}
+        };
+    }
+
     class TCBQuantizedDataLoader final : public IQuantizedFeaturesDatasetLoader {
     public:
         explicit TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& args);
@@ -39,14 +59,37 @@ namespace NCB {
             IQuantizedFeaturesDataVisitor* visitor
         ) const;
 
-        static TLoadQuantizedPoolParameters GetLoadParameters() {
-            return {/*LockMemory*/ false, /*Precharge*/ false};
+        /* features stored as a single chunk of bytes aligned as in TCompressedArray are passed to visitor
+         * without copying, they refer to memory mapped pool file, so no memory is allocated for them
+         */
+        bool CanUseInPlace(const TVector<TQuantizedPool::TChunkDescription>& chunks) const;
+
+        static bool IsInBlob(TConstArrayRef<ui8> data, const TBlob& blob) {
+            const ui8* blobBegin = blob.AsUnsignedCharPtr();
+            return (data.begin() >= blobBegin) && (data.end() <= blobBegin + blob.Size());
+        }
+
+        /* Release memory of decompressed chunk that holds quants. Its pages can't be evicted as pages
+         * of the mapped file: they are on the heap and may be shared with other allocations.
+         */
+        void ReleaseDecompressedChunk(TConstArrayRef<ui8> quants) const;
+
+        // quants with padding up to the end of the last ui64 word, TCompressedArray reads whole words
+        static TConstArrayRef<ui8> GetPaddedQuants(const TQuantizedPool::TChunkDescription& descriptor) {
+            const TConstArrayRef<ui8> quants = *descriptor.Chunk->Quants();
+            return {quants.data(), AlignUp(quants.size(), sizeof(ui64))};
+        }
+
+        static TLoadQuantizedPoolParameters GetLoadParameters(NPar::TLocalExecutor* localExecutor) {
+            return {/*LockMemory*/ false, /*Precharge*/ false, localExecutor};
         }
 
     private:
         ui32 ObjectCount;
         TVector<bool> IsFeatureIgnored;
         TQuantizedPool QuantizedPool;
+        TIntrusivePtr<TQuantizedPoolBlobsHolder> QuantizedPoolBlobsHolder;
+        TVector<std::pair<const ui8*, size_t>> DecompressedChunkBlobIndices; // (blob begin, index in Blobs)
         TPathWithScheme PairsPath;
         TPathWithScheme GroupWeightsPath;
         TDataMetaInfo DataMetaInfo;
@@ -55,7 +98,7 @@ namespace NCB {
 
     TCBQuantizedDataLoader::TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& args)
         : ObjectCount(0) // inited later
-        , QuantizedPool(std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath.Path, GetLoadParameters())))
+        , QuantizedPool(std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath.Path, GetLoadParameters(args.CommonArgs.LocalExecutor))))
         , PairsPath(args.CommonArgs.PairsFilePath)
         , GroupWeightsPath(args.CommonArgs.GroupWeightsFilePath)
         , ObjectsOrder(args.CommonArgs.ObjectsOrder)
@@ -88,6 +131,47 @@ namespace NCB {
         ProcessIgnoredFeaturesList(allIgnoredFeatures, &DataMetaInfo, &IsFeatureIgnored);
     }
 
+    bool TCBQuantizedDataLoader::CanUseInPlace(const TVector<TQuantizedPool::TChunkDescription>& chunks) const {
+        if (chunks.size() != 1) {
+            return false;
+        }
+        const auto& descriptor = chunks.front();
+        const TConstArrayRef<ui8> quants = *descriptor.Chunk->Quants();
+        if (!((descriptor.DocumentOffset == 0)
+              && (descriptor.DocumentCount == ObjectCount)
+              && (descriptor.Chunk->BitsPerDocument() == CHAR_BIT)
+              && (quants.size() == ObjectCount)
+              && (reinterpret_cast<uintptr_t>(quants.data()) % alignof(ui64) == 0)))
+        {
+            return false;
+        }
+        // SaveQuantizedPool pads quants, but pools saved by older versions can end right after them
+        const TConstArrayRef<ui8> paddedQuants = GetPaddedQuants(descriptor);
+        return AnyOf(
+            QuantizedPoolBlobsHolder->Blobs,
+            [&] (const TBlob& blob) { return IsInBlob(paddedQuants, blob); }
+        );
+    }
+
+    void TCBQuantizedDataLoader::ReleaseDecompressedChunk(TConstArrayRef<ui8> quants) const {
+        const auto blobIndexIt = UpperBound(
+            DecompressedChunkBlobIndices.begin(),
+            DecompressedChunkBlobIndices.end(),
+            quants.data(),
+            [] (const ui8* data, const std::pair<const ui8*, size_t>& blobIndex) {
+                return data < blobIndex.first;
+            }
+        );
+        if (blobIndexIt == DecompressedChunkBlobIndices.begin()) {
+            return;
+        }
+        TBlob& blob = QuantizedPoolBlobsHolder->Blobs[std::prev(blobIndexIt)->second];
+        // each decompressed chunk has its own blob, it is empty if already released
+        if (IsInBlob(quants, blob)) {
+            blob.Drop();
+        }
+    }
+
     void TCBQuantizedDataLoader::AddColumn(
         const ui32 flatFeatureIndex,
         const ui32 baselineIndex,
@@ -98,12 +182,21 @@ namespace NCB {
         auto onColumn = [&](size_t sizeOfElement, auto&& callbackFunction) {
             constexpr size_t MIN_QUANTS_SIZE_TO_FREE_INDIVIDUALLY = 1 << 20;
 
+            const TBlob& poolFileBlob = QuantizedPoolBlobsHolder->Blobs.front();
+            const ui8* poolFileQuantsBegin = nullptr;
+            const ui8* poolFileQuantsEnd = nullptr;
+
             const auto& chunks = QuantizedPool.Chunks[localIndex];
             for (const auto& descriptor : chunks) {
                 CB_ENSURE(static_cast<size_t>(descriptor.Chunk->BitsPerDocument()) == sizeOfElement * 8);
                 // cast is safe, checked at the start
                 TConstArrayRef<ui8> quants = *descriptor.Chunk->Quants();
                 callbackFunction((ui32)descriptor.DocumentOffset, quants);
+
+                if (!IsInBlob(quants, poolFileBlob)) {
+                    ReleaseDecompressedChunk(quants);
+                    continue;
+                }
 #if !defined(_win_)
                 // TODO(akhropov): fix MadviseEvict on Windows: MLTOOLS-2440
 
@@ -112,23 +205,34 @@ namespace NCB {
                     MadviseEvict(quants.begin(), quants.size());
                 }
 #endif
+                poolFileQuantsBegin = poolFileQuantsBegin ? Min(poolFileQuantsBegin, quants.begin()) : quants.begin();
+                poolFileQuantsEnd = Max(poolFileQuantsEnd, quants.end());
             }
 
 #if !defined(_win_)
             // TODO(akhropov): fix MadviseEvict on Windows: MLTOOLS-2440
 
-            // Free no longer needed memory
-            if (chunks.size() > 0) {
-                auto begin = TConstArrayRef<ui8>(*(chunks.front().Chunk->Quants())).data();
-                auto backQuant = TConstArrayRef<ui8>(*(chunks.back().Chunk->Quants()));
-                auto end = backQuant.data() + backQuant.size();
-                MadviseEvict(begin, end - begin);
+            // Free no longer needed memory, only pages of mapped pool file are evicted
+            if (poolFileQuantsBegin != poolFileQuantsEnd) {
+                MadviseEvict(poolFileQuantsBegin, poolFileQuantsEnd - poolFileQuantsBegin);
             }
 #endif
         };
 
         switch (columnType) {
             case EColumn::Num:
+                if (CanUseInPlace(QuantizedPool.Chunks[localIndex])) {
+                    const auto& descriptor = QuantizedPool.Chunks[localIndex].front();
+                    visitor->AddFloatFeaturePart(
+                        flatFeatureIndex,
+                        (ui32)descriptor.DocumentOffset,
+                        TMaybeOwningConstArrayHolder<ui8>::CreateOwning(
+                            GetPaddedQuants(descriptor),
+                            QuantizedPoolBlobsHolder
+                        )
+                    );
+                    break;
+                }
                 onColumn(
                     sizeof(ui8),
                     [&] (ui32 objectOffset, TConstArrayRef<ui8> quants) {
@@ -233,6 +337,16 @@ namespace NCB {
             QuantizationSchemaFromProto(QuantizedPool.QuantizationSchema)
         );
 
+        // chunks refer to blobs memory, so it stays valid
+        QuantizedPoolBlobsHolder = MakeIntrusive<TQuantizedPoolBlobsHolder>(std::move(QuantizedPool.Blobs));
+        for (size_t blobIdx = 1; blobIdx < QuantizedPoolBlobsHolder->Blobs.size(); ++blobIdx) {
+            DecompressedChunkBlobIndices.emplace_back(
+                QuantizedPoolBlobsHolder->Blobs[blobIdx].AsUnsignedCharPtr(),
+                blobIdx
+            );
+        }
+        Sort(DecompressedChunkBlobIndices);
+
         ui32 baselineIndex = 0;
         const auto columnIndexToFlatIndex = GetColumnIndexToFlatIndexMap(QuantizedPool);
         for (const auto [columnIndex, localIndex] : QuantizedPool.ColumnIndexToLocalIndex) {
@@ -268,6 +382,8 @@ namespace NCB {
         }
 
         QuantizedPool = TQuantizedPool(); // release memory
+        QuantizedPoolBlobsHolder.Reset(); // is still referenced by features data used in place, if any
+        DecompressedChunkBlobIndices.clear();
         SetGroupWeights(GroupWeightsPath, ObjectCount, visitor);
         SetPairs(PairsPath, ObjectCount, visitor);
         visitor->Finish();
@@ -10,11 +10,16 @@
 
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 
+#include <library/blockcodecs/codecs.h>
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/digest/numeric.h>
 #include <util/folder/path.h>
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
+#include <util/generic/buffer.h>
+#include <util/generic/cast.h>
 #include <util/generic/deque.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
@@ -26,6 +31,7 @@
 #include <util/stream/length.h>
 #include <util/stream/mem.h>
 #include <util/stream/output.h>
+#include <util/system/align.h>
 #include <util/system/byteorder.h>
 #include <util/system/unaligned_mem.h>
 
@@ -41,6 +47,10 @@ static const char MagicEnd[] = "CatboostQuantizedPoolEnd";
 static const size_t MagicEndSize = Y_ARRAY_SIZE(MagicEnd);  // yes, with terminating zero
 static const ui32 Version = 1;
 static const ui32 VersionHash = IntHash(Version);
+// pools with compressed chunks get different version so that readers unaware of compression reject
+// them instead of reading garbage
+static const ui32 CompressedChunksVersion = 2;
+static const ui32 CompressedChunksVersionHash = IntHash(CompressedChunksVersion);
 
 template <typename T>
 static TDeque<ui32> CollectAndSortKeys(const T& m) {
@@ -111,20 +121,52 @@ namespace {
     };
 }
 
+static bool IsCompressed(const NCB::NIdl::TQuantizedFeatureChunk& chunk) {
+    return chunk.QuantsCodec() && chunk.QuantsCodec()->size();
+}
+
 static void WriteChunk(
     const NCB::TQuantizedPool::TChunkDescription& chunk,
+    const NBlockCodecs::ICodec* const codec,
     TCountingOutput* const output,
     TDeque<TChunkInfo>* const chunkInfos,
+    TBuffer* const compressedQuants,
     flatbuffers::FlatBufferBuilder* const builder) {
 
-    builder->Clear();
+    CB_ENSURE(!IsCompressed(*chunk.Chunk), "Chunks of quantized pool being saved must be uncompressed");
 
-    const auto quantsOffset = builder->CreateVector(
-        chunk.Chunk->Quants()->data(),
+    const TStringBuf quants(
+        reinterpret_cast<const char*>(chunk.Chunk->Quants()->data()),
         chunk.Chunk->Quants()->size());
+    if (codec) {
+        codec->Encode(quants, *compressedQuants);
+    }
+
+    builder->Clear();
+
+    flatbuffers::Offset<flatbuffers::Vector<ui8>> quantsOffset;
+    flatbuffers::Offset<flatbuffers::String> quantsCodecOffset;
+    if (codec && compressedQuants->Size() < quants.size()) {
+        quantsOffset = builder->CreateVector(
+            reinterpret_cast<const ui8*>(compressedQuants->Data()),
+            compressedQuants->Size());
+        quantsCodecOffset = builder->CreateString(codec->Name().data(), codec->Name().size());
+    } else {
+        // chunks are aligned by 16 in the file, so aligned quants can be used in place when pool is
+        // mapped into memory, see TCBQuantizedDataLoader; they are used as ui64 words, so they are
+        // followed by zero padding up to the end of the last word
+        builder->Pad(AlignUpSpace(quants.size(), sizeof(ui64)));
+        builder->ForceVectorAlignment(quants.size(), sizeof(ui8), 16);
+        quantsOffset = builder->CreateVector(
+            reinterpret_cast<const ui8*>(quants.data()),
+            quants.size());
+    }
     NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(*builder);
     chunkBuilder.add_BitsPerDocument(chunk.Chunk->BitsPerDocument());
     chunkBuilder.add_Quants(quantsOffset);
+    if (!quantsCodecOffset.IsNull()) {
+        chunkBuilder.add_QuantsCodec(quantsCodecOffset);
+    }
     builder->Finish(chunkBuilder.Finish());
 
     AddPadding(16, output);
@@ -135,10 +177,10 @@ static void WriteChunk(
     chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
 }
 
-static void WriteHeader(TCountingOutput* const output) {
+static void WriteHeader(const bool hasCompressedChunks, TCountingOutput* const output) {
     output->Write(Magic, MagicSize);
-    WriteLittleEndian(Version, output);
-    WriteLittleEndian(VersionHash, output);
+    WriteLittleEndian(hasCompressedChunks ? CompressedChunksVersion : Version, output);
+    WriteLittleEndian(hasCompressedChunks ? CompressedChunksVersionHash : VersionHash, output);
 
     const ui32 metainfoSize = 0;
     WriteLittleEndian(metainfoSize, output);
@@ -222,10 +264,19 @@ static TPoolMetainfo MakePoolMetainfo(
     return metainfo;
 }
 
-static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
+static void WriteAsOneFile(
+    const NCB::TQuantizedPool& pool,
+    const NCB::TSaveQuantizedPoolParameters& params,
+    IOutputStream* slave) {
+
     TCountingOutput output(slave);
 
-    WriteHeader(&output);
+    // header is written before chunks, so version is chosen by codec presence even if no chunk
+    // turns out to be compressed
+    const NBlockCodecs::ICodec* const codec = !params.ChunkCodec.empty()
+        ? NBlockCodecs::Codec(params.ChunkCodec)
+        : nullptr;
+    WriteHeader(codec != nullptr, &output);
 
     const auto chunksOffset = output.Counter();
 
@@ -234,11 +285,12 @@ static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave
     perFeatureChunkInfos.resize(pool.ColumnIndexToLocalIndex.size());
     {
         flatbuffers::FlatBufferBuilder builder;
+        TBuffer compressedQuants;
         for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
             const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
             auto* const chunkInfos = &perFeatureChunkInfos[localIndex];
             for (const auto& chunk : pool.Chunks[localIndex]) {
-                WriteChunk(chunk, &output, chunkInfos, &builder);
+                WriteChunk(chunk, codec, &output, chunkInfos, &compressedQuants, &builder);
             }
         }
     }
@@ -285,8 +337,12 @@ static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave
     output.Write(MagicEnd, MagicEndSize);
 }
 
-void NCB::SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* const output) {
-    WriteAsOneFile(pool, output);
+void NCB::SaveQuantizedPool(
+    const TQuantizedPool& pool,
+    IOutputStream* const output,
+    const TSaveQuantizedPoolParameters& params) {
+
+    WriteAsOneFile(pool, params, output);
 }
 
 static void ValidatePoolPart(const TConstArrayRef<char> blob) {
@@ -302,11 +358,11 @@ static void ReadHeader(TCountingInput* const input) {
 
     ui32 version;
     ReadLittleEndian(&version, input);
-    CB_ENSURE(Version == version);
+    CB_ENSURE(Version == version || CompressedChunksVersion == version, LabeledOutput(version));
 
     ui32 versionHash;
     ReadLittleEndian(&versionHash, input);
-    CB_ENSURE(VersionHash == versionHash);
+    CB_ENSURE(IntHash(version) == versionHash);
 
     ui32 metainfoSize;
     ReadLittleEndian(&metainfoSize, input);
@@ -574,6 +630,79 @@ static void CollectChunks(const TConstArrayRef<char> blob, NCB::TQuantizedPool&
     }
 }
 
+static TBlob DecompressChunk(const NCB::NIdl::TQuantizedFeatureChunk& chunk) {
+    const auto* const codec = NBlockCodecs::Codec(TStringBuf(
+        chunk.QuantsCodec()->data(),
+        chunk.QuantsCodec()->size()));
+    const TStringBuf compressedQuants(
+        reinterpret_cast<const char*>(chunk.Quants()->data()),
+        chunk.Quants()->size());
+    const size_t quantsSize = codec->DecompressedLength(compressedQuants);
+
+    // decompress directly into flatbuffer with the same layout as uncompressed chunk in the file
+    // has, so that decompressed quants can be used in place too
+    flatbuffers::FlatBufferBuilder builder(quantsSize + 64);
+    builder.Pad(AlignUpSpace(quantsSize, sizeof(ui64)));
+    builder.ForceVectorAlignment(quantsSize, sizeof(ui8), 16);
+    ui8* quants = nullptr;
+    const auto quantsOffset = builder.CreateUninitializedVector(quantsSize, &quants);
+    const auto decompressedSize = codec->Decompress(compressedQuants, quants);
+    CB_ENSURE(decompressedSize == quantsSize, LabeledOutput(decompressedSize, quantsSize));
+    NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(builder);
+    chunkBuilder.add_BitsPerDocument(chunk.BitsPerDocument());
+    chunkBuilder.add_Quants(quantsOffset);
+    builder.Finish(chunkBuilder.Finish());
+
+    // flatbuffer size is a multiple of 16, so 16-byte alignment of quants is preserved by the copy
+    TBuffer buffer(reinterpret_cast<const char*>(builder.GetBufferPointer()), builder.GetSize());
+    return TBlob::FromBuffer(buffer);
+}
+
+static void DecompressChunks(NPar::TLocalExecutor* const localExecutor, NCB::TQuantizedPool* const pool) {
+    TVector<size_t> compressedColumns;
+    for (size_t localIndex = 0; localIndex < pool->Chunks.size(); ++localIndex) {
+        const auto& chunks = pool->Chunks[localIndex];
+        if (AnyOf(chunks, [] (const auto& chunk) { return IsCompressed(*chunk.Chunk); })) {
+            compressedColumns.push_back(localIndex);
+        }
+    }
+
+    if (compressedColumns.empty()) {
+        return;
+    }
+
+    TVector<TVector<TBlob>> perColumnBlobs(compressedColumns.size());
+    const auto decompressColumn = [&] (const int i) {
+        for (auto& chunk : pool->Chunks[compressedColumns[i]]) {
+            if (!IsCompressed(*chunk.Chunk)) {
+                continue;
+            }
+
+            perColumnBlobs[i].push_back(DecompressChunk(*chunk.Chunk));
+            chunk.Chunk = flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(
+                perColumnBlobs[i].back().AsCharPtr());
+        }
+    };
+    if (localExecutor) {
+        localExecutor->ExecRangeWithThrow(
+            decompressColumn,
+            0,
+            SafeIntegerCast<int>(compressedColumns.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+    } else {
+        for (size_t i = 0; i < compressedColumns.size(); ++i) {
+            decompressColumn(i);
+        }
+    }
+
+    // blobs hold decompressed chunks memory, chunks of the file blob still point into the first one
+    for (auto& blobs : perColumnBlobs) {
+        for (auto& blob : blobs) {
+            pool->Blobs.push_back(std::move(blob));
+        }
+    }
+}
+
 NCB::TQuantizedPool NCB::LoadQuantizedPool(
     const TStringBuf path,
     const TLoadQuantizedPoolParameters& params) {
@@ -591,6 +720,7 @@ NCB::TQuantizedPool NCB::LoadQuantizedPool(
 
     ValidatePoolPart(blobView);
     CollectChunks(blobView, pool);
+    DecompressChunks(params.LocalExecutor, &pool);
 
     return pool;
 }
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <util/generic/fwd.h>
+#include <util/generic/string.h>
 #include <util/stream/fwd.h>
 
+namespace NPar {
+    class TLocalExecutor;
+}
+
 namespace NCB {
     struct TQuantizedPool;
     struct TQuantizedPoolDigest;
@@ -14,11 +19,26 @@ namespace NCB {
 }
 
 namespace NCB {
-    void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output);
+    struct TSaveQuantizedPoolParameters {
+        // Name of NBlockCodecs codec (e.g. "lz4" or "zstd_1") to compress chunks with, chunks are
+        // stored uncompressed if it is empty or if compression doesn't make chunk smaller.
+        //
+        // NOTE: pools with uncompressed chunks can be used in place when mapped into memory.
+        TString ChunkCodec;
+    };
+
+    void SaveQuantizedPool(
+        const TQuantizedPool& pool,
+        IOutputStream* output,
+        const TSaveQuantizedPoolParameters& params = {});
 
     struct TLoadQuantizedPoolParameters {
         bool LockMemory = true;
         bool Precharge = true;
+
+        // Compressed chunks are decompressed in parallel by columns, if it is nullptr they are
+        // decompressed in the calling thread.
+        NPar::TLocalExecutor* LocalExecutor = nullptr;
     };
 
     // Load quantized pool saved by `SaveQuantizedPool` from file.
@@ -19,6 +19,8 @@
 
 #include <library/unittest/registar.h>
 
+#include <functional>
+
 
 using namespace NCB;
 using namespace NCB::NDataNewUT;
@@ -65,6 +67,8 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
         TVector<ui32> IgnoredFeatures; // passed in args to loader
 
         EObjectsOrder ObjectsOrder = EObjectsOrder::Undefined;
+
+        TString ChunkCodec; // chunks are saved uncompressed if empty
     };
 
     struct TTestCase {
@@ -154,7 +158,7 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
 
         auto tmpFileName = MakeTempName();
         TFileOutput output(tmpFileName);
-        NCB::SaveQuantizedPool(pool, &output);
+        NCB::SaveQuantizedPool(pool, &output, {srcData.ChunkCodec});
         *dstPath = TPathWithScheme("quantized://" + tmpFileName);
         srcDataFiles->emplace_back(MakeHolder<TTempFile>(tmpFileName));
     }
@@ -175,7 +179,9 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
     }
 
 
-    void Test(const TTestCase& testCase) {
+    using TCheckDataProvider = std::function<void(const TPathWithScheme& poolPath, const TDataProvider& dataProvider)>;
+
+    void Test(const TTestCase& testCase, const TCheckDataProvider& checkDataProvider = {}) {
         TReadDatasetMainParams readDatasetMainParams;
 
         // TODO(akhropov): temporarily use THolder until TTempFile move semantic are fixed
@@ -196,6 +202,9 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
             &localExecutor
         );
 
+        if (checkDataProvider) {
+            checkDataProvider(readDatasetMainParams.PoolPath, *dataProvider);
+        }
         Compare<TQuantizedForCPUObjectsDataProvider>(std::move(dataProvider), testCase.ExpectedData);
     }
 
@@ -726,7 +735,48 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
     }
 
 
-    Y_UNIT_TEST(ReadDatasetMidSize) {
+    /* features used in place point into memory mapped pool file at the same offsets as their quants
+     * in the file, the pool is mapped here again to find these offsets
+     */
+    void CheckFloatFeaturesAreInPool(
+        const TPathWithScheme& poolPath,
+        const TDataProvider& dataProvider,
+        std::function<size_t(ui32)> floatFeatureIdxToColumnIndex
+    ) {
+        const auto pool = LoadQuantizedPool(poolPath.Path, {/*LockMemory*/ false, /*Precharge*/ false});
+        const char* poolFileData = pool.Blobs.front().AsCharPtr();
+        const size_t poolFileSize = pool.Blobs.front().Size();
+
+        const auto* objectsData
+            = dynamic_cast<const TQuantizedForCPUObjectsDataProvider*>(dataProvider.ObjectsData.Get());
+        UNIT_ASSERT(objectsData);
+        const ui32 featureCount = objectsData->GetFeaturesLayout()->GetFloatFeatureCount();
+        UNIT_ASSERT(featureCount > 0);
+
+        const char* mappedPoolFileData = nullptr;
+        for (auto floatFeatureIdx : xrange(featureCount)) {
+            const auto localIndex = pool.ColumnIndexToLocalIndex.at(floatFeatureIdxToColumnIndex(floatFeatureIdx));
+            const auto& chunks = pool.Chunks[localIndex];
+            UNIT_ASSERT_VALUES_EQUAL(chunks.size(), 1);
+            const size_t quantsOffset = (const char*)chunks.front().Chunk->Quants()->data() - poolFileData;
+            UNIT_ASSERT(quantsOffset < poolFileSize);
+
+            const char* featureData
+                = (*objectsData->GetFloatFeature(floatFeatureIdx))->GetCompressedData().GetSrc()->GetRawPtr();
+            if (!mappedPoolFileData) {
+                mappedPoolFileData = featureData - quantsOffset;
+            }
+            UNIT_ASSERT_EQUAL(featureData, mappedPoolFileData + quantsOffset);
+        }
+    }
+
+    // object count should be divisible by 5, objects are split into groups of this size
+    void TestMidSize(
+        ui32 documentCount,
+        size_t avgFeatureChunkSize,
+        bool checkFeaturesInPool = false,
+        const TString& chunkCodec = {}
+    ) {
         TTestCase testCase;
 
         // for this test case we set some srcData from expectedData explicitly, because data is big
@@ -737,7 +787,8 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
         const ui32 binCount = 5;
         const ui32 featureCount = 300;
 
-        srcData.DocumentCount = 100000;
+        srcData.DocumentCount = documentCount;
+        srcData.ChunkCodec = chunkCodec;
         srcData.LocalIndexToColumnIndex = {1};
         for (auto featureIdx : xrange(featureCount)) {
             srcData.LocalIndexToColumnIndex.push_back(featureIdx + 2);
@@ -775,7 +826,11 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
                 )
             );
             srcData.FloatFeatures.push_back(
-                GenerateSrcColumn<ui8>(*expectedData.Objects.FloatFeatures.back(), EColumn::Num, 5000)
+                GenerateSrcColumn<ui8>(
+                    *expectedData.Objects.FloatFeatures.back(),
+                    EColumn::Num,
+                    avgFeatureChunkSize
+                )
             );
         }
         srcData.ColumnNames.push_back("Target");
@@ -839,6 +894,37 @@ Y_UNIT_TEST_SUITE(LoadDataFromQuantized) {
         testCase.SrcData = std::move(srcData);
         testCase.ExpectedData = std::move(expectedData);
 
-        Test(testCase);
+        TCheckDataProvider checkDataProvider;
+        if (checkFeaturesInPool) {
+            checkDataProvider = [] (const TPathWithScheme& poolPath, const TDataProvider& dataProvider) {
+                CheckFloatFeaturesAreInPool(
+                    poolPath,
+                    dataProvider,
+                    [] (ui32 floatFeatureIdx) { return (size_t)floatFeatureIdx + 2; }
+                );
+            };
+        }
+        Test(testCase, checkDataProvider);
+    }
+
+    Y_UNIT_TEST(ReadDatasetMidSize) {
+        TestMidSize(100000, 5000);
+    }
+
+    // features data is used in place in memory mapped pool
+    Y_UNIT_TEST(ReadDatasetMidSizeSingleChunkFeatures) {
+        TestMidSize(100005, 2 * 100005, /*checkFeaturesInPool*/ true);
+    }
+
+    /* group ids and features compress well and are loaded from decompressed chunks, chunks that
+     * don't get smaller (e.g. of random targets) stay in the mapped file
+     */
+    Y_UNIT_TEST(ReadDatasetMidSizeCompressed) {
+        TestMidSize(100000, 5000, /*checkFeaturesInPool*/ false, "zstd_1");
+    }
+
+    // features are used in place in decompressed chunks
+    Y_UNIT_TEST(ReadDatasetMidSizeSingleChunkFeaturesCompressed) {
+        TestMidSize(100005, 2 * 100005, /*checkFeaturesInPool*/ false, "zstd_1");
     }
 }
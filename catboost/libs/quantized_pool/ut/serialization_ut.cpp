@@ -2,6 +2,7 @@
 #include "print.h"
 #include "serialization.h"
 
+#include <library/threading/local_executor/local_executor.h>
 #include <library/unittest/registar.h>
 
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
@@ -94,6 +95,43 @@ static NCB::TQuantizedPool MakeQuantizedPool() {
     return pool;
 }
 
+static NCB::TQuantizedPool MakeCompressibleQuantizedPool() {
+    static const size_t documentCount = 10000;
+
+    TVector<TBlob> blobs;
+    {
+        TVector<ui8> bins(documentCount);
+        for (size_t i = 0; i < documentCount; ++i) {
+            bins[i] = i % 7 == 0 ? 2 : 0;
+        }
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(NCB::NIdl::CreateTQuantizedFeatureChunk(
+            builder,
+            NCB::NIdl::EBitsPerDocumentFeature_BPDF_8,
+            builder.CreateVector(bins.data(), bins.size())));
+        blobs.push_back(TBlob::Copy(
+            builder.GetBufferPointer(),
+            builder.GetSize()));
+    }
+
+    NCB::TQuantizedPool pool;
+    pool.Blobs = std::move(blobs);
+    pool.ColumnIndexToLocalIndex.emplace(1, 0);
+    pool.ColumnTypes = {EColumn::Num};
+    pool.QuantizationSchema = MakeQuantizationSchema();
+    pool.DocumentCount = documentCount;
+    {
+        TVector<NCB::TQuantizedPool::TChunkDescription> chunks;
+        chunks.emplace_back(
+            0,
+            documentCount,
+            flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(pool.Blobs[0].AsCharPtr()));
+        pool.Chunks.push_back(std::move(chunks));
+    }
+
+    return pool;
+}
+
 static TString QuantizedPoolToString(const NCB::TQuantizedPool& pool) {
     TString str;
     TStringOutput output{str};
@@ -154,6 +192,52 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         UNIT_ASSERT_VALUES_EQUAL(loadedPoolAsText, poolAsText);
     }
 
+    Y_UNIT_TEST(TestSerializeDeserializeCompressed) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        // chunks of the first pool are too small to be compressed
+        for (const bool isCompressible : {false, true}) {
+            const auto pool = isCompressible ? MakeCompressibleQuantizedPool() : MakeQuantizedPool();
+            const auto poolAsText = QuantizedPoolToString(pool);
+
+            const auto uncompressedPath = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+            {
+                TFileOutput output(uncompressedPath.GetPath());
+                NCB::SaveQuantizedPool(pool, &output);
+            }
+
+            for (const TString codec : {"lz4", "zstd_1"}) {
+                const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.compressed.bin";
+                {
+                    TFileOutput output(path.GetPath());
+                    NCB::SaveQuantizedPool(pool, &output, {codec});
+                }
+
+                const auto size = GetFileLength(path.GetPath());
+                const auto uncompressedSize = GetFileLength(uncompressedPath.GetPath());
+                if (isCompressible) {
+                    UNIT_ASSERT(size < uncompressedSize);
+                } else {
+                    UNIT_ASSERT_VALUES_EQUAL(size, uncompressedSize);
+                }
+
+                for (auto* executor : {(NPar::TLocalExecutor*)nullptr, &localExecutor}) {
+                    const auto loadedPool = NCB::LoadQuantizedPool(path.GetPath(), {false, false, executor});
+                    UNIT_ASSERT_VALUES_EQUAL(QuantizedPoolToString(loadedPool), poolAsText);
+                    for (const auto& chunks : loadedPool.Chunks) {
+                        for (const auto& chunk : chunks) {
+                            UNIT_ASSERT(!chunk.Chunk->QuantsCodec() || chunk.Chunk->QuantsCodec()->size() == 0);
+                            UNIT_ASSERT_VALUES_EQUAL(
+                                reinterpret_cast<uintptr_t>(chunk.Chunk->Quants()->data()) % 16,
+                                0);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     Y_UNIT_TEST(TestLoadQuantizationSchema) {
         const auto pool = MakeQuantizedPool();
         const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
@@ -80,6 +80,10 @@ namespace NCatboostStandalone {
             throw std::runtime_error(
                 "trying to initialize TZeroCopyEvaluator from coreModel with categorical features");
         }
+        if (ObliviousTrees->NonSymmetricStepNodes() != nullptr && ObliviousTrees->NonSymmetricStepNodes()->size() != 0) {
+            throw std::runtime_error(
+                "trying to initialize TZeroCopyEvaluator from coreModel with non-symmetric trees");
+        }
         BinaryFeatureCount = 0;
         FloatFeatureCount = 0;
         for (const auto& ff : *ObliviousTrees->FloatFeatures()) {
@@ -0,0 +1,185 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/loggers/catboost_logger_helpers.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/getopt/small/last_getopt.h>
+#include <library/json/json_value.h>
+
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/stream/format.h>
+#include <util/stream/output.h>
+#include <util/system/hp_timer.h>
+
+/**
+ * Time-to-quality benchmark of object sampling on CPU.
+ * Binary classification datasets are generated with fixed seed, each bootstrap type is trained with
+ * the same plain boosting parameters, and the test loss reached by the first bootstrap type is used
+ * as the quality target for all of them.
+ */
+
+using namespace NCB;
+
+struct TBenchmarkParams {
+    int LearnDocCount = 0;
+    int TestDocCount = 0;
+    int FeatureCount = 0;
+    int Iterations = 0;
+    int Depth = 0;
+    float Subsample = 0;
+    int ThreadCount = 0;
+    ui64 Seed = 0;
+};
+
+struct TRunResult {
+    double Seconds = 0;
+    TVector<double> TestLossHistory; // [iter]
+    TVector<double> TimeHistory; // [iter]
+};
+
+static TDataProviderPtr GenerateDataset(int docCount, int featureCount, TFastRng64* rng) {
+    TVector<TVector<float>> features(featureCount); // [featureIdx][objectIdx]
+    for (auto& feature : features) {
+        feature.yresize(docCount);
+        for (auto& value : feature) {
+            value = rng->GenRandReal1();
+        }
+    }
+    // only a few features are informative, and their interactions matter
+    TVector<float> target(docCount);
+    for (auto docIdx : xrange(docCount)) {
+        double logit = 0;
+        for (auto featureIdx : xrange(Min(featureCount, 8))) {
+            const double centered = features[featureIdx][docIdx] - 0.5;
+            logit += (featureIdx % 2 ? 4.0 : -3.0) * centered;
+            if (featureIdx > 0) {
+                logit += 6.0 * centered * (features[featureIdx - 1][docIdx] - 0.5);
+            }
+        }
+        const double probability = 1.0 / (1.0 + exp(-logit));
+        target[docIdx] = rng->GenRandReal1() < probability ? 1.0f : 0.0f;
+    }
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                (ui32)featureCount,
+                TVector<ui32>{},
+                TVector<TString>{}
+            );
+            visitor->Start(metaInfo, docCount, EObjectsOrder::Undefined, {});
+            for (auto featureIdx : xrange(featureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(features[featureIdx]))
+                );
+            }
+            visitor->AddTarget(target);
+            visitor->Finish();
+        }
+    );
+}
+
+static TRunResult Train(const TBenchmarkParams& params, EBootstrapType bootstrapType, const TDataProviders& data) {
+    NJson::TJsonValue plainParams;
+    plainParams.InsertValue("loss_function", "Logloss");
+    plainParams.InsertValue("iterations", params.Iterations);
+    plainParams.InsertValue("depth", params.Depth);
+    plainParams.InsertValue("boosting_type", "Plain");
+    plainParams.InsertValue("bootstrap_type", ToString(bootstrapType));
+    if (bootstrapType != EBootstrapType::No && bootstrapType != EBootstrapType::Bayesian) {
+        plainParams.InsertValue("subsample", params.Subsample);
+    }
+    plainParams.InsertValue("random_seed", params.Seed);
+    plainParams.InsertValue("thread_count", params.ThreadCount);
+    plainParams.InsertValue("logging_level", "Silent");
+    plainParams.InsertValue("allow_writing_files", false);
+
+    TFullModel model;
+    TEvalResult testApprox;
+    TMetricsAndTimeLeftHistory history;
+    THPTimer timer;
+    TrainModel(plainParams, nullptr, Nothing(), Nothing(), data, "", &model, {&testApprox}, &history);
+
+    TRunResult result;
+    result.Seconds = timer.Passed();
+    for (auto iter : xrange(history.TestMetricsHistory.size())) {
+        result.TestLossHistory.push_back(history.TestMetricsHistory[iter][0].at("Logloss"));
+        result.TimeHistory.push_back(history.TimeHistory[iter].PassedTime);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    using namespace NLastGetopt;
+
+    TBenchmarkParams params;
+    TVector<EBootstrapType> bootstrapTypes;
+    TOpts opts = NLastGetopt::TOpts::Default();
+    opts.AddLongOption("bootstrap").RequiredArgument("LIST")
+        .Help("Comma separated bootstrap types, the first one defines the target test loss")
+        .DefaultValue("Bernoulli,MVS,GOSS")
+        .SplitHandler(&bootstrapTypes, ',');
+    opts.AddLongOption("learn-docs").RequiredArgument("INT")
+        .DefaultValue(200000)
+        .StoreResult(&params.LearnDocCount);
+    opts.AddLongOption("test-docs").RequiredArgument("INT")
+        .DefaultValue(50000)
+        .StoreResult(&params.TestDocCount);
+    opts.AddLongOption("features").RequiredArgument("INT")
+        .DefaultValue(50)
+        .StoreResult(&params.FeatureCount);
+    opts.AddLongOption("iterations").RequiredArgument("INT")
+        .DefaultValue(500)
+        .StoreResult(&params.Iterations);
+    opts.AddLongOption("depth").RequiredArgument("INT")
+        .DefaultValue(6)
+        .StoreResult(&params.Depth);
+    opts.AddLongOption("subsample").RequiredArgument("FLOAT")
+        .Help("Sample rate for Bernoulli, MVS and GOSS bootstrap")
+        .DefaultValue(0.15)
+        .StoreResult(&params.Subsample);
+    opts.AddLongOption('T', "thread-count").RequiredArgument("INT")
+        .DefaultValue(8)
+        .StoreResult(&params.ThreadCount);
+    opts.AddLongOption("seed").RequiredArgument("INT")
+        .DefaultValue(0)
+        .StoreResult(&params.Seed);
+    opts.SetFreeArgsNum(0);
+    TOptsParseResult args(&opts, argc, argv);
+
+    CB_ENSURE(!bootstrapTypes.empty(), "At least one bootstrap type is required");
+    CB_ENSURE(params.LearnDocCount > 0 && params.TestDocCount > 0, "Learn and test datasets should be nonempty");
+    CB_ENSURE(params.FeatureCount > 0, "At least one feature is required");
+
+    TFastRng64 rng(params.Seed);
+    TDataProviders data;
+    data.Learn = GenerateDataset(params.LearnDocCount, params.FeatureCount, &rng);
+    data.Test.push_back(GenerateDataset(params.TestDocCount, params.FeatureCount, &rng));
+
+    Cout << "bootstrap\tseconds\ttest_loss\tbest_test_loss\titers_to_target\tseconds_to_target" << Endl;
+    double targetLoss = 0;
+    for (auto runIdx : xrange(bootstrapTypes.size())) {
+        const auto result = Train(params, bootstrapTypes[runIdx], data);
+        CB_ENSURE(!result.TestLossHistory.empty(), "No test loss history");
+        const double bestLoss = *MinElement(result.TestLossHistory.begin(), result.TestLossHistory.end());
+        if (runIdx == 0) {
+            targetLoss = bestLoss;
+        }
+        Cout << bootstrapTypes[runIdx] << '\t'
+            << Prec(result.Seconds, PREC_POINT_DIGITS, 3) << '\t'
+            << Prec(result.TestLossHistory.back(), PREC_POINT_DIGITS, 6) << '\t'
+            << Prec(bestLoss, PREC_POINT_DIGITS, 6) << '\t';
+        const auto reached = FindIf(result.TestLossHistory, [=](double loss) { return loss <= targetLoss; });
+        if (reached != result.TestLossHistory.end()) {
+            const size_t iter = reached - result.TestLossHistory.begin();
+            Cout << iter + 1 << '\t' << Prec(result.TimeHistory[iter], PREC_POINT_DIGITS, 3) << Endl;
+        } else {
+            Cout << "-\t-" << Endl;
+        }
+    }
+    return 0;
+}
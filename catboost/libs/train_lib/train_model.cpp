@@ -35,6 +35,8 @@
 #include <library/grid_creator/binarization.h>
 #include <library/json/json_prettifier.h>
 
+#include <util/generic/cast.h>
+#include <util/generic/hash.h>
 #include <util/generic/scope.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
@@ -62,6 +64,55 @@ static void ShrinkModel(int itCount, const TCtrHelper& ctrsHelper, TLearnProgres
     }
 }
 
+namespace {
+    /* Node array of non-symmetric tree (see TObliviousTrees), NodeSplitIdx is an index in TSplitTree::Splits or -1
+     * for leaf nodes, NodeLeafIdx is a leaf index of the training tree with 2^depth leaves or Max<ui32>().
+     */
+    struct TNonSymmetricTreeNodes {
+        TVector<int> NodeSplitIdx;
+        TVector<TNonSymmetricTreeStepNode> StepNodes;
+        TVector<ui32> NodeLeafIdx;
+    };
+}
+
+static ui32 AddNonSymmetricTreeNode(
+    const TSplitTree& tree,
+    const THashMap<std::pair<int, int>, int>& depthAndLeafToSplitIdx,
+    int depth,
+    ui32 leafIdx,
+    TNonSymmetricTreeNodes* nodes
+) {
+    const auto splitIdx = depthAndLeafToSplitIdx.find(std::make_pair(depth, static_cast<int>(leafIdx)));
+    if (depth < tree.GetDepth() && splitIdx == depthAndLeafToSplitIdx.end()) {
+        // leaf without split on this level keeps its index
+        return AddNonSymmetricTreeNode(tree, depthAndLeafToSplitIdx, depth + 1, leafIdx, nodes);
+    }
+    const ui32 nodeIdx = nodes->StepNodes.size();
+    nodes->StepNodes.emplace_back();
+    if (depth == tree.GetDepth()) {
+        nodes->NodeSplitIdx.push_back(-1);
+        nodes->NodeLeafIdx.push_back(leafIdx);
+        return nodeIdx;
+    }
+    nodes->NodeSplitIdx.push_back(splitIdx->second);
+    nodes->NodeLeafIdx.push_back(Max<ui32>());
+    const ui32 leftNodeIdx = AddNonSymmetricTreeNode(tree, depthAndLeafToSplitIdx, depth + 1, leafIdx, nodes);
+    const ui32 rightNodeIdx = AddNonSymmetricTreeNode(tree, depthAndLeafToSplitIdx, depth + 1, leafIdx | (1u << depth), nodes);
+    nodes->StepNodes[nodeIdx].LeftSubtreeDiff = SafeIntegerCast<ui16>(leftNodeIdx - nodeIdx);
+    nodes->StepNodes[nodeIdx].RightSubtreeDiff = SafeIntegerCast<ui16>(rightNodeIdx - nodeIdx);
+    return nodeIdx;
+}
+
+static TNonSymmetricTreeNodes BuildNonSymmetricTreeNodes(const TSplitTree& tree) {
+    THashMap<std::pair<int, int>, int> depthAndLeafToSplitIdx;
+    for (int splitIdx : xrange(tree.Splits.ysize())) {
+        depthAndLeafToSplitIdx[std::make_pair(tree.GetSplitDepth(splitIdx), tree.SplitLeafIndices[splitIdx])] = splitIdx;
+    }
+    TNonSymmetricTreeNodes nodes;
+    AddNonSymmetricTreeNode(tree, depthAndLeafToSplitIdx, /*depth*/ 0, /*leafIdx*/ 0, &nodes);
+    return nodes;
+}
+
 static int GetThreadCount(const NCatboostOptions::TCatBoostOptions& options) {
     return Min<int>(options.SystemOptions->NumThreads, (int)NSystemInfo::CachedNumberOfCpus());
 }
@@ -247,14 +298,16 @@ static void Train(
                     CountSplits(ctx->LearnProgress.FloatFeatures),
                     *data.Learn->ObjectsData->GetQuantizedFeaturesInfo(),
                     ctx->Params.CatFeatureParams->OneHotMaxSize),
-                static_cast<int>(ctx->Params.ObliviousTreeOptions->MaxDepth)
+                static_cast<int>(ctx->Params.ObliviousTreeOptions->MaxDepth),
+                GetTreeLevelCacheSizeLimit(ctx->Params)
             );
         }
         ctx->SampledDocs.Create(
             ctx->LearnProgress.Folds,
             isPairwiseScoring,
             defaultCalcStatsObjBlockSize,
-            GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
+            GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig),
+            IsGradientBasedSampling(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
         ); // TODO(espetrov): create only if sample rate < 1
     }
 
@@ -489,16 +542,45 @@ namespace {
             THashMap<TFeatureCombination, TProjection> featureCombinationToProjectionMap;
             {
                 TObliviousTreeBuilder builder(ctx.LearnProgress.FloatFeatures, ctx.LearnProgress.CatFeatures, ctx.LearnProgress.ApproxDimension);
+                const bool isDepthwise = ctx.Params.ObliviousTreeOptions->GrowingPolicy == EGrowingPolicy::Depthwise;
                 for (size_t treeId = 0; treeId < ctx.LearnProgress.TreeStruct.size(); ++treeId) {
+                    const auto& tree = ctx.LearnProgress.TreeStruct[treeId];
                     TVector<TModelSplit> modelSplits;
-                    for (const auto& split : ctx.LearnProgress.TreeStruct[treeId].Splits) {
+                    for (const auto& split : tree.Splits) {
                         auto modelSplit = split.GetModelSplit(ctx, perfectHashedToHashedCatValuesMap);
                         modelSplits.push_back(modelSplit);
                         if (modelSplit.Type == ESplitType::OnlineCtr) {
                             featureCombinationToProjectionMap[modelSplit.OnlineCtr.Ctr.Base.Projection] = split.Ctr.Projection;
                         }
                     }
-                    builder.AddTree(modelSplits, ctx.LearnProgress.LeafValues[treeId], ctx.LearnProgress.TreeStats[treeId].LeafWeightsSum);
+                    const auto& treeLeafValues = ctx.LearnProgress.LeafValues[treeId];
+                    const auto& treeLeafWeights = ctx.LearnProgress.TreeStats[treeId].LeafWeightsSum;
+                    if (!isDepthwise) {
+                        builder.AddTree(modelSplits, treeLeafValues, treeLeafWeights);
+                        continue;
+                    }
+                    // only leaves of the node array are reachable, values of the others are dropped
+                    const auto nodes = BuildNonSymmetricTreeNodes(tree);
+                    const int approxDimension = ctx.LearnProgress.ApproxDimension;
+                    TVector<TModelSplit> nodeSplits;
+                    TVector<ui32> nodeIdToLeafId;
+                    TVector<double> leafValues;
+                    TVector<double> leafWeights;
+                    for (size_t nodeIdx : xrange(nodes.StepNodes.size())) {
+                        if (nodes.NodeSplitIdx[nodeIdx] != -1) {
+                            nodeSplits.push_back(modelSplits[nodes.NodeSplitIdx[nodeIdx]]);
+                            nodeIdToLeafId.push_back(Max<ui32>());
+                            continue;
+                        }
+                        const ui32 leafIdx = nodes.NodeLeafIdx[nodeIdx];
+                        nodeSplits.emplace_back();
+                        nodeIdToLeafId.push_back(leafWeights.size());
+                        for (int dim : xrange(approxDimension)) {
+                            leafValues.push_back(treeLeafValues[dim][leafIdx]);
+                        }
+                        leafWeights.push_back(treeLeafWeights[leafIdx]);
+                    }
+                    builder.AddNonSymmetricTree(nodeSplits, nodes.StepNodes, nodeIdToLeafId, leafValues, leafWeights);
                 }
                 obliviousTrees = builder.Build();
             }